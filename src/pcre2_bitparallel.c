@@ -0,0 +1,850 @@
+/*************************************************
+*      Perl-Compatible Regular Expressions       *
+*************************************************/
+
+/* PCRE is a library of functions to support regular expressions whose syntax
+and semantics are as close as possible to those of the Perl 5 language.
+
+                       Written by Philip Hazel
+     Original API code Copyright (c) 1997-2012 University of Cambridge
+          New API code Copyright (c) 2016-2022 University of Cambridge
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the University of Cambridge nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+
+/* This module contains the bit-parallel matcher. When a pattern is short and
+describes a regular language (no back references, assertions, atomic groups or
+possessive quantifiers, recursion, callouts, or verbs), pcre2_compile() builds
+the Glushkov automaton of the pattern, in which each single-character item is a
+position. A set of active positions fits in one 64-bit word, so the subject
+can be scanned with a few word operations per code unit, without any
+backtracking. The matcher can tell only whether a match exists, so it is used
+for PCRE2_NO_OVECTOR matching and for rejecting subjects that cannot match
+before running an interpreter. */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "pcre2_internal.h"
+
+/* The largest number of positions, and a maximum repeat count that stands for
+an unlimited repeat. */
+
+#define BP_POSITIONS_MAX  64
+#define BP_UNLIMITED      UINT32_MAX
+
+/* Working data while building a bit-parallel matcher. */
+
+typedef struct bp_build {
+  const compile_block *cb;        /* The compile data */
+  uint32_t count;                 /* Number of positions used */
+  uint64_t masks[257];            /* Positions for each code unit */
+  uint64_t follow[BP_POSITIONS_MAX];  /* Followers of each position */
+} bp_build;
+
+/* The properties of a fragment of a pattern. */
+
+typedef struct bp_frag {
+  uint64_t first;                 /* Positions that can start it */
+  uint64_t last;                  /* Positions that can end it */
+  BOOL nullable;                  /* TRUE if it can match an empty string */
+} bp_frag;
+
+
+
+/*************************************************
+*        Join two fragments of a pattern         *
+*************************************************/
+
+/* Each position that can end the first fragment can be followed by each
+position that can start the second.
+
+Arguments:
+  b           the build data
+  f           the first fragment, updated to be the joined fragment
+  g           the second fragment
+
+Returns:      nothing
+*/
+
+static void
+bp_concat(bp_build *b, bp_frag *f, const bp_frag *g)
+{
+uint32_t i;
+
+for (i = 0; i < b->count; i++)
+  if ((f->last & ((uint64_t)1 << i)) != 0) b->follow[i] |= g->first;
+
+f->first |= f->nullable? g->first : 0;
+f->last = g->last | (g->nullable? f->last : 0);
+f->nullable = f->nullable && g->nullable;
+}
+
+
+
+/*************************************************
+*          Make a fragment repeat itself         *
+*************************************************/
+
+/* Each position that can end the fragment can be followed by each position
+that can start it.
+
+Arguments:
+  b           the build data
+  f           the fragment
+
+Returns:      nothing
+*/
+
+static void
+bp_loop(bp_build *b, const bp_frag *f)
+{
+uint32_t i;
+
+for (i = 0; i < b->count; i++)
+  if ((f->last & ((uint64_t)1 << i)) != 0) b->follow[i] |= f->first;
+}
+
+
+
+/*************************************************
+*      Add a possibly repeated item of a pattern *
+*************************************************/
+
+/* A single-character item is added as one position for each copy that is
+needed. A minimum repeat becomes that many positions; an unlimited repeat
+makes the last of them (or an extra optional one) follow itself, and a limited
+one adds a chain of optional positions.
+
+Arguments:
+  b           the build data
+  set         a 32-byte bit map of the code units < 256 that the item matches
+  wide        TRUE if the item matches all code units > 255
+  min         the minimum repeat count
+  max         the maximum repeat count, or BP_UNLIMITED
+  f           where to return the fragment
+
+Returns:      FALSE if there are too many positions
+*/
+
+static BOOL
+bp_item(bp_build *b, const uint8_t *set, BOOL wide, uint32_t min, uint32_t max,
+  bp_frag *f)
+{
+uint32_t i;
+uint32_t n = (max == BP_UNLIMITED)? ((min == 0)? 1 : min) : max;
+
+f->first = f->last = 0;
+f->nullable = TRUE;
+
+if (n > BP_POSITIONS_MAX - b->count) return FALSE;
+
+for (i = 0; i < n; i++)
+  {
+  uint32_t c;
+  uint64_t bit = (uint64_t)1 << b->count;
+  bp_frag g;
+
+  for (c = 0; c < 256; c++)
+    if ((set[c/8] & (1u << (c%8))) != 0) b->masks[c] |= bit;
+  if (wide) b->masks[256] |= bit;
+
+  g.first = g.last = bit;
+  g.nullable = i >= min;
+  b->count++;
+  if (max == BP_UNLIMITED && i == n - 1) bp_loop(b, &g);
+  bp_concat(b, f, &g);
+  }
+
+return TRUE;
+}
+
+
+
+/*************************************************
+*     Find the code units a simple item matches  *
+*************************************************/
+
+/* The sets are exactly those for which match() would succeed in a pattern
+that is neither UTF nor UCP. A caseless character is matched differently when
+it is single and when it is repeated, so the two are distinguished.
+
+Arguments:
+  b           the build data
+  op          a single-character opcode
+  code        points to the data that follows it
+  single      TRUE if the item is not repeated
+  set         a 32-byte bit map to set
+  wideptr     set TRUE if the item matches all code units > 255
+
+Returns:      FALSE if the item is not supported
+*/
+
+static BOOL
+bp_item_set(bp_build *b, uint32_t op, PCRE2_SPTR code, BOOL single,
+  uint8_t *set, BOOL *wideptr)
+{
+const compile_block *cb = b->cb;
+BOOL negated = FALSE;
+uint32_t c, fc;
+int ctype;
+
+memset(set, 0, 32);
+*wideptr = FALSE;
+
+switch(op)
+  {
+  case OP_NOT:
+  case OP_NOTI:
+  negated = TRUE;
+  /* Fall through */
+
+  case OP_CHAR:
+  case OP_CHARI:
+  fc = *code;
+  if (fc > 255) return FALSE;
+  set[fc/8] |= 1u << (fc%8);
+  if (op == OP_CHARI && single)
+    {
+    for (c = 0; c < 256; c++)
+      if (cb->lcc[c] == cb->lcc[fc]) set[c/8] |= 1u << (c%8);
+    }
+  else if (op == OP_CHARI || op == OP_NOTI)
+    {
+    c = cb->fcc[fc];
+    set[c/8] |= 1u << (c%8);
+    }
+  break;
+
+  case OP_ANY:
+  if (cb->nltype == NLTYPE_FIXED)
+    {
+    if (cb->nllen != 1) return FALSE;
+    memset(set, 0xff, 32);
+    set[cb->nl[0]/8] &= ~(1u << (cb->nl[0]%8));
+    }
+  else
+    {
+#if PCRE2_CODE_UNIT_WIDTH != 8
+    if (cb->nltype == NLTYPE_ANY) return FALSE;  /* Some wide newlines */
+#endif
+    for (c = 0; c < 256; c++)
+      {
+      PCRE2_UCHAR buffer[1];
+      uint32_t len;
+      buffer[0] = c;
+      if (!PRIV(is_newline)(buffer, cb->nltype, buffer + 1, &len, FALSE))
+        set[c/8] |= 1u << (c%8);
+      }
+    }
+  *wideptr = TRUE;
+  return TRUE;
+
+  case OP_ALLANY:
+  memset(set, 0xff, 32);
+  *wideptr = TRUE;
+  return TRUE;
+
+  case OP_NOT_DIGIT: negated = TRUE; /* Fall through */
+  case OP_DIGIT: ctype = ctype_digit; goto CTYPES;
+  case OP_NOT_WHITESPACE: negated = TRUE; /* Fall through */
+  case OP_WHITESPACE: ctype = ctype_space; goto CTYPES;
+  case OP_NOT_WORDCHAR: negated = TRUE; /* Fall through */
+  case OP_WORDCHAR: ctype = ctype_word;
+
+  CTYPES:
+  for (c = 0; c < 256; c++)
+    if ((cb->ctypes[c] & ctype) != 0) set[c/8] |= 1u << (c%8);
+  break;
+
+  case OP_NCLASS:
+  *wideptr = TRUE;
+  /* Fall through */
+
+  case OP_CLASS:
+  memcpy(set, code, 32);
+  return TRUE;
+
+  default:
+  return FALSE;
+  }
+
+if (negated)
+  {
+  for (c = 0; c < 32; c++) set[c] = ~set[c];
+  *wideptr = TRUE;
+  }
+return TRUE;
+}
+
+
+
+/*************************************************
+*      Add the items of one alternative          *
+*************************************************/
+
+/* This is called for each alternative of a group. At the outer level, an
+alternative may start with ^, \A, or \G, and end with $, \z, or \Z; these are
+returned for checking by the caller.
+
+Arguments:
+  b           the build data
+  code        points to the first item of the alternative
+  outer       TRUE at the outer level of the pattern
+  sa          where to return the starting anchor opcode, or 0
+  ea          where to return the ending anchor opcode, or 0
+  f           where to return the fragment
+
+Returns:      pointer to the ALT or KETxxx that ends the alternative, or NULL if
+                the alternative is not supported
+*/
+
+static PCRE2_SPTR bp_group(bp_build *, PCRE2_SPTR, bp_frag *);
+
+static PCRE2_SPTR
+bp_alternative(bp_build *b, PCRE2_SPTR code, BOOL outer, uint32_t *sa,
+  uint32_t *ea, bp_frag *f)
+{
+BOOL at_start = TRUE;
+
+*sa = *ea = 0;
+f->first = f->last = 0;
+f->nullable = TRUE;
+
+for (; *code != OP_ALT && (*code < OP_KET || *code > OP_KETRPOS);
+     at_start = FALSE)
+  {
+  uint8_t set[32];
+  BOOL wide;
+  uint32_t op = *code;
+  uint32_t min = 1;
+  uint32_t max = 1;
+  bp_frag g;
+
+  switch(op)
+    {
+    case OP_CIRC:
+    case OP_SOD:
+    case OP_SOM:
+    if (!outer || !at_start) return NULL;
+    *sa = op;
+    code++;
+    continue;
+
+    case OP_DOLL:
+    case OP_EOD:
+    case OP_EODN:
+    if (!outer || (code[1] != OP_ALT && code[1] != OP_KET)) return NULL;
+    if (op != OP_EOD && b->cb->nltype != NLTYPE_FIXED) return NULL;
+    *ea = op;
+    code++;
+    continue;
+
+    case OP_BRAZERO:
+    case OP_BRAMINZERO:
+    code = bp_group(b, code + 1, &g);
+    if (code == NULL) return NULL;
+    g.nullable = TRUE;
+    bp_concat(b, f, &g);
+    continue;
+
+    case OP_SKIPZERO:
+    code++;
+    do code += GET(code, 1); while (*code == OP_ALT);
+    code += 1 + LINK_SIZE;
+    continue;
+
+    case OP_BRA:
+    case OP_CBRA:
+    case OP_SBRA:
+    case OP_SCBRA:
+    code = bp_group(b, code, &g);
+    if (code == NULL) return NULL;
+    bp_concat(b, f, &g);
+    continue;
+
+    case OP_CLASS:
+    case OP_NCLASS:
+    if (!bp_item_set(b, op, code + 1, TRUE, set, &wide)) return NULL;
+    code += 1 + 32 / sizeof(PCRE2_UCHAR);
+    switch(*code)
+      {
+      case OP_CRSTAR:
+      case OP_CRMINSTAR:
+      min = 0;
+      /* Fall through */
+
+      case OP_CRPLUS:
+      case OP_CRMINPLUS:
+      max = BP_UNLIMITED;
+      code++;
+      break;
+
+      case OP_CRQUERY:
+      case OP_CRMINQUERY:
+      min = 0;
+      code++;
+      break;
+
+      case OP_CRRANGE:
+      case OP_CRMINRANGE:
+      min = GET2(code, 1);
+      max = GET2(code, 1 + IMM2_SIZE);
+      if (max == 0) max = BP_UNLIMITED;
+      code += 1 + 2 * IMM2_SIZE;
+      break;
+
+      default:
+      if (*code >= OP_CRSTAR && *code <= OP_CRPOSRANGE) return NULL;
+      break;
+      }
+    break;
+
+    default:
+    if (op >= OP_STAR && op <= OP_TYPEPOSUPTO)
+      {
+      uint32_t base = (op >= OP_TYPESTAR)? OP_TYPESTAR :
+        OP_STAR + ((op - OP_STAR)/(OP_STARI - OP_STAR)) * (OP_STARI - OP_STAR);
+
+      code++;
+      switch(op - base)
+        {
+        case OP_STAR - OP_STAR:
+        case OP_MINSTAR - OP_STAR:
+        min = 0;
+        /* Fall through */
+
+        case OP_PLUS - OP_STAR:
+        case OP_MINPLUS - OP_STAR:
+        max = BP_UNLIMITED;
+        break;
+
+        case OP_QUERY - OP_STAR:
+        case OP_MINQUERY - OP_STAR:
+        min = 0;
+        break;
+
+        case OP_UPTO - OP_STAR:
+        case OP_MINUPTO - OP_STAR:
+        min = 0;
+        max = GET2(code, 0);
+        code += IMM2_SIZE;
+        break;
+
+        case OP_EXACT - OP_STAR:
+        min = max = GET2(code, 0);
+        code += IMM2_SIZE;
+        break;
+
+        default:  /* Possessive repeats */
+        return NULL;
+        }
+
+      if (base == OP_TYPESTAR) op = *code++;
+        else op = OP_CHAR + (base - OP_STAR)/(OP_STARI - OP_STAR);
+      if (!bp_item_set(b, op, code, FALSE, set, &wide)) return NULL;
+      }
+    else
+      {
+      code++;
+      if (!bp_item_set(b, op, code, TRUE, set, &wide)) return NULL;
+      }
+    if (op <= OP_NOTI && op >= OP_CHAR) code++;  /* Skip the character */
+    break;
+    }
+
+  if (!bp_item(b, set, wide, min, max, &g)) return NULL;
+  bp_concat(b, f, &g);
+  }
+
+return code;
+}
+
+
+
+/*************************************************
+*            Add a group of a pattern            *
+*************************************************/
+
+/* Capturing and non-capturing groups are treated alike, because captures do
+not matter. A group that ends with KETRMAX or KETRMIN can repeat itself; any
+other kind of group is not supported. Anchors are allowed only at the outer
+level, which is handled by the caller.
+
+Arguments:
+  b           the build data
+  code        points to the opening bracket
+  f           where to return the fragment
+
+Returns:      pointer after the closing bracket, or NULL if not supported
+*/
+
+static PCRE2_SPTR
+bp_group(bp_build *b, PCRE2_SPTR code, bp_frag *f)
+{
+if (*code != OP_BRA && *code != OP_CBRA && *code != OP_SBRA &&
+    *code != OP_SCBRA)
+  return NULL;
+
+f->first = f->last = 0;
+f->nullable = FALSE;
+
+for (;;)
+  {
+  uint32_t sa, ea;
+  bp_frag g;
+
+  code = bp_alternative(b, code + PRIV(OP_lengths)[*code], FALSE, &sa, &ea,
+    &g);
+  if (code == NULL) return NULL;
+  f->first |= g.first;
+  f->last |= g.last;
+  f->nullable |= g.nullable;
+  if (*code != OP_ALT) break;
+  }
+
+switch(*code)
+  {
+  case OP_KETRMAX:
+  case OP_KETRMIN:
+  bp_loop(b, f);
+  /* Fall through */
+
+  case OP_KET:
+  return code + 1 + LINK_SIZE;
+
+  default:
+  return NULL;
+  }
+}
+
+
+
+/*************************************************
+*         Build a bit-parallel matcher           *
+*************************************************/
+
+/* This is called by pcre2_compile() before auto-possessification, so that any
+possessive quantifier comes from the pattern. The pattern must have at most 64
+positions, must not match an empty string, and its anchors must be the same in
+every outer alternative. The caller must not pass a UTF or UCP pattern.
+
+Arguments:
+  codestart   points to the compiled pattern
+  cb          the compile data
+  memctl      memory control for getting the block
+
+Returns:      a new bit-parallel matcher, or NULL if not supported or if
+                there is no memory
+*/
+
+bitparallel *
+PRIV(bitparallel_build)(PCRE2_SPTR codestart, const compile_block *cb,
+  pcre2_memctl *memctl)
+{
+bp_build build;
+bp_build *b = &build;
+bitparallel *bp;
+bp_frag f;
+PCRE2_SPTR code = codestart;
+uint32_t sa = 0, ea = 0;
+uint32_t chunks, i, k, v;
+BOOL firstalt = TRUE;
+size_t size;
+
+/* When a newline may be CRLF, a match attempt that fails at CR is not retried
+at the following LF unless the pattern mentions CR or LF. This depends on where
+match attempts are made, which a bit-parallel matcher does not know. */
+
+if ((cb->nltype != NLTYPE_FIXED || cb->nllen == 2) &&
+    (cb->external_flags & PCRE2_HASCRORLF) == 0)
+  return NULL;
+
+memset(b, 0, sizeof(bp_build));
+b->cb = cb;
+f.first = f.last = 0;
+f.nullable = FALSE;
+
+/* Each outer alternative must have the same anchors. */
+
+for (;;)
+  {
+  uint32_t asa, aea;
+  bp_frag g;
+
+  code = bp_alternative(b, code + PRIV(OP_lengths)[*code], TRUE, &asa, &aea,
+    &g);
+  if (code == NULL) return NULL;
+  if (firstalt)
+    {
+    sa = asa;
+    ea = aea;
+    firstalt = FALSE;
+    }
+  else if (asa != sa || aea != ea) return NULL;
+  f.first |= g.first;
+  f.last |= g.last;
+  f.nullable |= g.nullable;
+  if (*code == OP_KET) break;
+  }
+
+if (*code != OP_KET || code[1 + LINK_SIZE] != OP_END || f.nullable ||
+    b->count == 0)
+  return NULL;
+
+chunks = (b->count + 7) / 8;
+size = offsetof(bitparallel, follow) + chunks * 256 * sizeof(uint64_t);
+bp = memctl->malloc(size, memctl->memory_data);
+if (bp == NULL) return NULL;
+
+bp->size = size;
+bp->first = f.first;
+bp->last = f.last;
+bp->loops = 0;
+bp->chunks = chunks;
+bp->nllen = cb->nllen;
+bp->nl[0] = cb->nl[0];
+bp->nl[1] = cb->nl[1];
+bp->start_anchor = sa;
+bp->end_anchor = ea;
+memcpy(bp->masks, b->masks, sizeof(b->masks));
+
+/* The follow table has an entry for each value of each byte of a set of
+positions. If every position is followed only by the next one and possibly
+itself, a shift can be used instead. */
+
+bp->shift = TRUE;
+for (i = 0; i < b->count; i++)
+  {
+  uint64_t bit = (uint64_t)1 << i;
+  uint64_t next = (i + 1 < b->count)? bit << 1 : 0;
+  bp->loops |= b->follow[i] & bit;
+  if ((b->follow[i] & ~bit) != next) bp->shift = FALSE;
+  }
+
+for (k = 0; k < chunks; k++)
+  {
+  for (v = 0; v < 256; v++)
+    {
+    uint64_t e = 0;
+    for (i = 0; i < 8; i++)
+      if ((v & (1u << i)) != 0 && 8*k + i < b->count) e |= b->follow[8*k + i];
+    bp->follow[k*256 + v] = e;
+    }
+  }
+
+return bp;
+}
+
+
+
+/*************************************************
+*       Match with a bit-parallel matcher        *
+*************************************************/
+
+/* The set of active positions is updated for each code unit of the subject,
+adding the starting positions unless the match is anchored, until a position
+that can end a match is reached. When the pattern or the options require the
+match to end at the end of the subject (or before a final newline for $ and
+\Z), that is checked instead. Only the presence of a match is found, and only
+options that affect it are handled: PCRE2_ANCHORED, PCRE2_ENDANCHORED,
+PCRE2_NOTBOL, and PCRE2_NOTEOL. The caller must not use this function for
+partial matching or when the start of a match is otherwise restricted.
+
+Arguments:
+  re              the compiled pattern
+  subject         the subject string
+  length          the length of the subject
+  start_offset    where to start in the subject
+  options         the match options
+
+Returns:          TRUE if there is a match
+*/
+
+BOOL
+PRIV(bitparallel_match)(const pcre2_real_code *re, PCRE2_SPTR subject,
+  PCRE2_SIZE length, PCRE2_SIZE start_offset, uint32_t options)
+{
+const bitparallel *bp = (const bitparallel *)re->bitparallel;
+const uint64_t *follow = bp->follow;
+PCRE2_SPTR p = subject + start_offset;
+PCRE2_SPTR end = subject + length;
+PCRE2_SPTR nlstart = NULL;
+uint64_t first = bp->first;
+uint64_t last = bp->last;
+uint64_t loops = bp->loops;
+uint64_t init = first;
+uint64_t d = 0;
+BOOL anchored = ((re->overall_options | options) & PCRE2_ANCHORED) != 0;
+BOOL atend = ((re->overall_options | options) & PCRE2_ENDANCHORED) != 0;
+BOOL has_first_cu = (re->flags & PCRE2_FIRSTSET) != 0;
+PCRE2_UCHAR first_cu = 0;
+PCRE2_UCHAR first_cu2 = 0;
+
+switch(bp->start_anchor)
+  {
+  case OP_CIRC:
+  if ((options & PCRE2_NOTBOL) != 0) return FALSE;
+  /* Fall through */
+
+  case OP_SOD:
+  if (start_offset != 0) return FALSE;
+  /* Fall through */
+
+  case OP_SOM:
+  anchored = TRUE;
+  break;
+  }
+
+/* A match that ends with $ or \Z may end before a newline at the end of the
+subject, unless it must end at the very end. */
+
+switch(bp->end_anchor)
+  {
+  case OP_DOLL:
+  if ((options & PCRE2_NOTEOL) != 0) return FALSE;
+  if ((re->overall_options & PCRE2_DOLLAR_ENDONLY) != 0)
+    {
+    atend = TRUE;
+    break;
+    }
+  /* Fall through */
+
+  case OP_EODN:
+  if (!atend && (PCRE2_SIZE)(end - p) >= bp->nllen &&
+      *(end - bp->nllen) == bp->nl[0] &&
+      (bp->nllen == 1 || end[-1] == bp->nl[1]))
+    nlstart = end - bp->nllen;
+  /* Fall through */
+
+  case OP_EOD:
+  atend = TRUE;
+  break;
+  }
+
+/* If there is a code unit that every match must contain, check that it is
+present before scanning. This is the same test that pcre2_match() makes. */
+
+if ((re->flags & PCRE2_LASTSET) != 0)
+  {
+  PCRE2_UCHAR req_cu = (PCRE2_UCHAR)(re->last_codeunit);
+  PCRE2_UCHAR req_cu2 = req_cu;
+  PCRE2_SPTR q = p;
+
+  if ((re->flags & PCRE2_LASTCASELESS) != 0)
+    req_cu2 = TABLE_GET(req_cu, re->tables + fcc_offset, req_cu);
+#if PCRE2_CODE_UNIT_WIDTH == 8
+  if (req_cu == req_cu2)
+    {
+    if (memchr(q, req_cu, end - q) == NULL) return FALSE;
+    }
+  else
+#endif
+    {
+    while (q < end && *q != req_cu && *q != req_cu2) q++;
+    if (q >= end) return FALSE;
+    }
+  }
+
+if (has_first_cu)
+  {
+  first_cu = first_cu2 = (PCRE2_UCHAR)(re->first_codeunit);
+  if ((re->flags & PCRE2_FIRSTCASELESS) != 0)
+    first_cu2 = TABLE_GET(first_cu, re->tables + fcc_offset, first_cu);
+  }
+
+for (; p < end; p++)
+  {
+  uint32_t c;
+  uint64_t t;
+
+  /* When no positions are active in an unanchored match, skip to the next
+  code unit that can start a match. */
+
+  if (d == 0 && !anchored)
+    {
+    if (has_first_cu)
+      {
+#if PCRE2_CODE_UNIT_WIDTH == 8
+      if (first_cu == first_cu2)
+        {
+        p = memchr(p, first_cu, end - p);
+        if (p == NULL) return FALSE;
+        }
+      else
+#endif
+        {
+        while (p < end && *p != first_cu && *p != first_cu2) p++;
+        if (p >= end) return FALSE;
+        }
+      }
+    else
+      {
+      for (; p < end; p++)
+        {
+        c = *p;
+#if PCRE2_CODE_UNIT_WIDTH != 8
+        if (c > 255) c = 256;
+#endif
+        if ((bp->masks[c] & first) != 0) break;
+        }
+      if (p >= end) return FALSE;
+      }
+    }
+
+  c = *p;
+  if (p == nlstart && (d & last) != 0) return TRUE;
+
+  if (bp->shift) t = (d << 1) | (d & loops); else
+    {
+    uint64_t s = d;
+    const uint64_t *table = follow;
+    for (t = 0; s != 0; s >>= 8, table += 256) t |= table[s & 0xff];
+    }
+
+#if PCRE2_CODE_UNIT_WIDTH != 8
+  if (c > 255) c = 256;
+#endif
+  d = (t | init) & bp->masks[c];
+
+  if (anchored)
+    {
+    if (d == 0) return FALSE;
+    init = 0;
+    }
+  if (!atend && (d & last) != 0) return TRUE;
+  }
+
+return (d & last) != 0;
+}
+
+/* End of pcre2_bitparallel.c */
@@ -0,0 +1,90 @@
+/*************************************************
+*      Perl-Compatible Regular Expressions       *
+*************************************************/
+
+/* PCRE is a library of functions to support regular expressions whose syntax
+and semantics are as close as possible to those of the Perl 5 language.
+
+                       Written by Philip Hazel
+     Original API code Copyright (c) 1997-2012 University of Cambridge
+          New API code Copyright (c) 2016-2022 University of Cambridge
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the University of Cambridge nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+
+/* This module contains the monotonic clock that is read by the matching
+functions to enforce a deadline that was set by pcre2_set_match_deadline(). */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#include "pcre2_internal.h"
+
+
+/*************************************************
+*          Read a monotonic clock                *
+*************************************************/
+
+/* The clock is read as rarely as possible, so the cost of the system call is
+spread over many matching steps. Where there is no monotonic clock, the time of
+day is used, which has a resolution of one second.
+
+Arguments:    none
+Returns:      the time in microseconds from an arbitrary starting point
+*/
+
+uint64_t
+PRIV(clock_usec)(void)
+{
+#if defined _WIN32
+LARGE_INTEGER frequency, counter;
+(void)QueryPerformanceFrequency(&frequency);
+(void)QueryPerformanceCounter(&counter);
+return (uint64_t)(counter.QuadPart / frequency.QuadPart) * 1000000u +
+  (uint64_t)(counter.QuadPart % frequency.QuadPart) * 1000000u /
+  (uint64_t)frequency.QuadPart;
+#elif defined HAVE_CLOCK_GETTIME && defined CLOCK_MONOTONIC
+struct timespec ts;
+(void)clock_gettime(CLOCK_MONOTONIC, &ts);
+return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+#else
+return (uint64_t)time(NULL) * 1000000u;
+#endif
+}
+
+/* End of pcre2_clock.c */
@@ -785,7 +785,7 @@ are allowed. */
    (PUBLIC_LITERAL_COMPILE_EXTRA_OPTIONS| \
     PCRE2_EXTRA_ALLOW_SURROGATE_ESCAPES|PCRE2_EXTRA_BAD_ESCAPE_IS_LITERAL| \
     PCRE2_EXTRA_ESCAPED_CR_IS_LF|PCRE2_EXTRA_ALT_BSUX| \
-    PCRE2_EXTRA_ALLOW_LOOKAROUND_BSK)
+    PCRE2_EXTRA_ALLOW_LOOKAROUND_BSK|PCRE2_EXTRA_AUTO_ENGINE)
 
 /* Compile time error code numbers. They are given names so that they can more
 easily be tracked. When a new number is added, the tables called eint1 and
@@ -1183,6 +1183,34 @@ return;
 
 
 
+/*************************************************
+*          Copy a bit-parallel matcher           *
+*************************************************/
+
+/* This is called when copying compiled code, after the main block has been
+copied. Unlike JIT data, a bit-parallel matcher is a plain block of memory.
+
+Arguments:
+  newcode     the new compiled code
+  code        the original compiled code
+
+Returns:      FALSE if there is no memory
+*/
+
+static BOOL
+copy_bitparallel(pcre2_code *newcode, const pcre2_code *code)
+{
+const bitparallel *bp = (const bitparallel *)code->bitparallel;
+
+if (bp == NULL) return TRUE;
+newcode->bitparallel = code->memctl.malloc(bp->size, code->memctl.memory_data);
+if (newcode->bitparallel == NULL) return FALSE;
+memcpy(newcode->bitparallel, bp, bp->size);
+return TRUE;
+}
+
+
+
 /*************************************************
 *               Copy compiled code               *
 *************************************************/
@@ -1202,6 +1230,12 @@ if (newcode == NULL) return NULL;
 memcpy(newcode, code, code->blocksize);
 newcode->executable_jit = NULL;
 
+if (!copy_bitparallel(newcode, code))
+  {
+  code->memctl.free((void *)newcode, code->memctl.memory_data);
+  return NULL;
+  }
+
 /* If the code is one that has been deserialized, increment the reference count
 in the decoded tables. */
 
@@ -1237,10 +1271,18 @@ if (newcode == NULL) return NULL;
 memcpy(newcode, code, code->blocksize);
 newcode->executable_jit = NULL;
 
+if (!copy_bitparallel(newcode, code))
+  {
+  code->memctl.free((void *)newcode, code->memctl.memory_data);
+  return NULL;
+  }
+
 newtables = code->memctl.malloc(TABLES_LENGTH + sizeof(PCRE2_SIZE),
   code->memctl.memory_data);
 if (newtables == NULL)
   {
+  if (newcode->bitparallel != NULL)
+    code->memctl.free(newcode->bitparallel, code->memctl.memory_data);
   code->memctl.free((void *)newcode, code->memctl.memory_data);
   return NULL;
   }
@@ -1269,6 +1311,9 @@ if (code != NULL)
   if (code->executable_jit != NULL)
     PRIV(jit_free)(code->executable_jit, &code->memctl);
 
+  if (code->bitparallel != NULL)
+    code->memctl.free(code->bitparallel, code->memctl.memory_data);
+
   if ((code->flags & PCRE2_DEREF_TABLES) != 0)
     {
     /* Decoded tables belong to the codes after deserialization, and they must
@@ -6254,6 +6299,8 @@ for (;; pptr++)
     /* Fall through */
     case META_COMMIT:
     case META_FAIL:
+    if (meta == META_SKIP || meta == META_COMMIT)
+      cb->external_flags |= PCRE2_STARTDEP;   /* Where a search starts matters */
     *code++ = verbops[(meta - META_MARK) >> 16];
     break;
 
@@ -6280,6 +6327,8 @@ for (;; pptr++)
     case META_MARK:
     case META_COMMIT_ARG:
     VERB_ARG:
+    if (meta == META_SKIP_ARG || meta == META_COMMIT_ARG)
+      cb->external_flags |= PCRE2_STARTDEP;   /* Where a search starts matters */
     *code++ = verbops[(meta - META_MARK) >> 16];
     /* The length is in characters. */
     verbarglen = *(++pptr);
@@ -7912,6 +7961,7 @@ for (;; pptr++)
     do a one-character lookbehind, and \A also behaves as if it does. */
 
     if (meta_arg == ESC_C) cb->external_flags |= PCRE2_HASBKC; /* Record */
+    if (meta_arg == ESC_G) cb->external_flags |= PCRE2_STARTDEP;
     if ((meta_arg == ESC_b || meta_arg == ESC_B || meta_arg == ESC_A) &&
          cb->max_lookbehind == 0)
       cb->max_lookbehind = 1;
@@ -8603,6 +8653,618 @@ return TRUE;
 
 
 
+/*************************************************
+*     Choose fallback engines for a pattern      *
+*************************************************/
+
+/* This is called when PCRE2_EXTRA_AUTO_ENGINE is set, before the pattern is
+auto-possessified. A pattern is liable to catastrophic backtracking if a
+repeated group contains an alternation, a variable repeat that can give
+characters back, or another repeated group. For such a pattern pcre2_match()
+can fall back to memoizing group failures and, when only the existence of a
+match is wanted, to DFA matching. Both require that the outcome of matching a
+group depends only on the subject position, so neither is chosen if there are
+back references, recursions, conditional groups, callouts, (*ACCEPT) or
+backtracking control verbs. DFA matching treats atomic groups and possessive
+quantifiers differently, so it is not chosen if the pattern contains any.
+
+Arguments:
+  code        points to the start of the compiled pattern
+  utf         TRUE in UTF mode
+
+Returns:      a bit map of PCRE2_ENGINE_MEMOIZE and PCRE2_ENGINE_DFA
+*/
+
+static uint32_t
+choose_engines(PCRE2_SPTR code, BOOL utf)
+{
+PCRE2_SPTR repeat_end = NULL;
+BOOL prone = FALSE;
+BOOL atomic = FALSE;
+
+for (;;)
+  {
+  PCRE2_SPTR ket;
+  PCRE2_UCHAR c = *code;
+
+  if (repeat_end != NULL && code > repeat_end) repeat_end = NULL;
+
+  switch(c)
+    {
+    case OP_END:
+    if (!prone) return 0;
+    return atomic? PCRE2_ENGINE_MEMOIZE : (PCRE2_ENGINE_MEMOIZE|PCRE2_ENGINE_DFA);
+
+    case OP_REF:
+    case OP_REFI:
+    case OP_DNREF:
+    case OP_DNREFI:
+    case OP_RECURSE:
+    case OP_COND:
+    case OP_SCOND:
+    case OP_CALLOUT:
+    case OP_CALLOUT_STR:
+    case OP_MARK:
+    case OP_PRUNE:
+    case OP_PRUNE_ARG:
+    case OP_SKIP:
+    case OP_SKIP_ARG:
+    case OP_THEN:
+    case OP_THEN_ARG:
+    case OP_COMMIT:
+    case OP_COMMIT_ARG:
+    case OP_ACCEPT:
+    case OP_ASSERT_ACCEPT:
+    case OP_CLOSE:
+    return 0;
+
+    /* A group whose ket repeats it starts a region in which backtracking may
+    multiply; a second one within it is itself a hazard. */
+
+    case OP_BRA:
+    case OP_CBRA:
+    case OP_SBRA:
+    case OP_SCBRA:
+    case OP_ONCE:
+    if (c == OP_ONCE) atomic = TRUE;
+    ket = code;
+    do ket += GET(ket, 1); while (*ket == OP_ALT);
+    if (*ket == OP_KETRMAX || *ket == OP_KETRMIN)
+      {
+      if (repeat_end != NULL) prone = TRUE;
+        else repeat_end = ket;
+      }
+    break;
+
+    case OP_ALT:
+    if (repeat_end != NULL) prone = TRUE;
+    break;
+
+    case OP_BRAPOS:
+    case OP_CBRAPOS:
+    case OP_SBRAPOS:
+    case OP_SCBRAPOS:
+    case OP_POSSTAR:
+    case OP_POSPLUS:
+    case OP_POSQUERY:
+    case OP_POSUPTO:
+    case OP_POSSTARI:
+    case OP_POSPLUSI:
+    case OP_POSQUERYI:
+    case OP_POSUPTOI:
+    case OP_NOTPOSSTAR:
+    case OP_NOTPOSPLUS:
+    case OP_NOTPOSQUERY:
+    case OP_NOTPOSUPTO:
+    case OP_NOTPOSSTARI:
+    case OP_NOTPOSPLUSI:
+    case OP_NOTPOSQUERYI:
+    case OP_NOTPOSUPTOI:
+    case OP_CRPOSSTAR:
+    case OP_CRPOSPLUS:
+    case OP_CRPOSQUERY:
+    case OP_CRPOSRANGE:
+    atomic = TRUE;
+    break;
+
+    case OP_STAR:
+    case OP_MINSTAR:
+    case OP_PLUS:
+    case OP_MINPLUS:
+    case OP_QUERY:
+    case OP_MINQUERY:
+    case OP_UPTO:
+    case OP_MINUPTO:
+    case OP_STARI:
+    case OP_MINSTARI:
+    case OP_PLUSI:
+    case OP_MINPLUSI:
+    case OP_QUERYI:
+    case OP_MINQUERYI:
+    case OP_UPTOI:
+    case OP_MINUPTOI:
+    case OP_NOTSTAR:
+    case OP_NOTMINSTAR:
+    case OP_NOTPLUS:
+    case OP_NOTMINPLUS:
+    case OP_NOTQUERY:
+    case OP_NOTMINQUERY:
+    case OP_NOTUPTO:
+    case OP_NOTMINUPTO:
+    case OP_NOTSTARI:
+    case OP_NOTMINSTARI:
+    case OP_NOTPLUSI:
+    case OP_NOTMINPLUSI:
+    case OP_NOTQUERYI:
+    case OP_NOTMINQUERYI:
+    case OP_NOTUPTOI:
+    case OP_NOTMINUPTOI:
+    case OP_CRSTAR:
+    case OP_CRMINSTAR:
+    case OP_CRPLUS:
+    case OP_CRMINPLUS:
+    case OP_CRQUERY:
+    case OP_CRMINQUERY:
+    if (repeat_end != NULL) prone = TRUE;
+    break;
+
+    case OP_CRRANGE:
+    case OP_CRMINRANGE:
+    if (repeat_end != NULL && GET2(code, 1) != GET2(code, 1 + IMM2_SIZE))
+      prone = TRUE;
+    break;
+
+    /* Repeated character types may be followed by \p or \P, which have two
+    extra code units of parameters. */
+
+    case OP_TYPESTAR:
+    case OP_TYPEMINSTAR:
+    case OP_TYPEPLUS:
+    case OP_TYPEMINPLUS:
+    case OP_TYPEQUERY:
+    case OP_TYPEMINQUERY:
+    if (repeat_end != NULL) prone = TRUE;
+    /* Fall through */
+
+    case OP_TYPEPOSSTAR:
+    case OP_TYPEPOSPLUS:
+    case OP_TYPEPOSQUERY:
+    if (c >= OP_TYPEPOSSTAR) atomic = TRUE;
+    if (code[1] == OP_PROP || code[1] == OP_NOTPROP) code += 2;
+    break;
+
+    case OP_TYPEUPTO:
+    case OP_TYPEMINUPTO:
+    if (repeat_end != NULL) prone = TRUE;
+    /* Fall through */
+
+    case OP_TYPEEXACT:
+    case OP_TYPEPOSUPTO:
+    if (c == OP_TYPEPOSUPTO) atomic = TRUE;
+    if (code[1 + IMM2_SIZE] == OP_PROP || code[1 + IMM2_SIZE] == OP_NOTPROP)
+      code += 2;
+    break;
+
+    /* XCLASS has a zero length in the table; the real length follows. */
+
+    case OP_XCLASS:
+    code += GET(code, 1) - PRIV(OP_lengths)[c];
+    break;
+    }
+
+  code += PRIV(OP_lengths)[c];
+
+  /* In UTF-8 and UTF-16 modes, opcodes that are followed by a character may be
+  followed by a multi-unit character. */
+
+#ifdef MAYBE_UTF_MULTI
+  if (utf && c >= OP_CHAR && c <= OP_NOTPOSUPTOI && HAS_EXTRALEN(code[-1]))
+    code += GET_EXTRALEN(code[-1]);
+#else
+  (void)(utf);  /* Keep compiler happy by referencing function argument */
+#endif
+  }
+}
+
+
+
+/*************************************************
+*    Check whether captures are ever read        *
+*************************************************/
+
+/* This is called after a successful compile. When nothing in the pattern
+looks at the values of captured substrings while matching, pcre2_match() can
+leave them out of its backtracking frames if the caller wants only the offsets
+of the whole match. They are read by back references, by conditions that test
+whether a group is set, and by callouts, which are passed the capture vector.
+
+Arguments:
+  code        points to the start of the compiled pattern
+  utf         TRUE in UTF mode
+
+Returns:      TRUE if captures are never read
+*/
+
+static BOOL
+captures_unread(PCRE2_SPTR code, BOOL utf)
+{
+for (;;)
+  {
+  PCRE2_UCHAR c = *code;
+
+  switch(c)
+    {
+    case OP_END:
+    return TRUE;
+
+    case OP_REF:
+    case OP_REFI:
+    case OP_DNREF:
+    case OP_DNREFI:
+    case OP_CREF:
+    case OP_DNCREF:
+    case OP_CALLOUT:
+    case OP_CALLOUT_STR:
+    return FALSE;
+
+    /* Repeated character types may be followed by \p or \P, which have two
+    extra code units of parameters. */
+
+    case OP_TYPESTAR:
+    case OP_TYPEMINSTAR:
+    case OP_TYPEPLUS:
+    case OP_TYPEMINPLUS:
+    case OP_TYPEQUERY:
+    case OP_TYPEMINQUERY:
+    case OP_TYPEPOSSTAR:
+    case OP_TYPEPOSPLUS:
+    case OP_TYPEPOSQUERY:
+    if (code[1] == OP_PROP || code[1] == OP_NOTPROP) code += 2;
+    break;
+
+    case OP_TYPEUPTO:
+    case OP_TYPEMINUPTO:
+    case OP_TYPEEXACT:
+    case OP_TYPEPOSUPTO:
+    if (code[1 + IMM2_SIZE] == OP_PROP || code[1 + IMM2_SIZE] == OP_NOTPROP)
+      code += 2;
+    break;
+
+    /* Verbs with an argument have its length after the opcode. XCLASS has a
+    zero length in the table; the real length follows. */
+
+    case OP_MARK:
+    case OP_COMMIT_ARG:
+    case OP_PRUNE_ARG:
+    case OP_SKIP_ARG:
+    case OP_THEN_ARG:
+    code += code[1];
+    break;
+
+    case OP_XCLASS:
+    code += GET(code, 1) - PRIV(OP_lengths)[c];
+    break;
+    }
+
+  code += PRIV(OP_lengths)[c];
+
+  /* In UTF-8 and UTF-16 modes, opcodes that are followed by a character may be
+  followed by a multi-unit character. */
+
+#ifdef MAYBE_UTF_MULTI
+  if (utf && c >= OP_CHAR && c <= OP_NOTPOSUPTOI && HAS_EXTRALEN(code[-1]))
+    code += GET_EXTRALEN(code[-1]);
+#else
+  (void)(utf);  /* Keep compiler happy by referencing function argument */
+#endif
+  }
+}
+
+
+
+/*************************************************
+*    Check an item for the one-pass matcher     *
+*************************************************/
+
+/* This is called by check_onepass() for each item in a group that is not
+itself a group or a zero-width assertion. Only single-character items that
+pcre2_match() can handle without backtracking are accepted, optionally with a
+repeat that never gives anything back, that is, an exact or possessive one.
+Caseless characters must be less than 128 so that their other case comes from
+the tables in all modes. If required, the set of code units that may start the
+item is added to a bit map, with wide characters (those above 255) represented
+only by a flag.
+
+Arguments:
+  code       points to the item
+  map        a 32-byte bit map to be updated, or NULL
+  wideptr    set TRUE if wide characters may start the item
+  minptr     where to return the item's minimum length
+  cb         points to the compile data block
+
+Returns:     pointer after the item, or NULL if it is not acceptable
+*/
+
+static PCRE2_SPTR
+onepass_item(PCRE2_SPTR code, uint8_t *map, BOOL *wideptr, uint32_t *minptr,
+  compile_block *cb)
+{
+PCRE2_UCHAR op = *code;
+uint32_t min = 1;
+uint32_t c = 0;
+int ctype = -1;
+BOOL negated = FALSE;
+const uint8_t *classbits = NULL;
+
+/* Repeated characters and character types: only exact and possessive repeats
+are acceptable. Set op to the equivalent single-item opcode. */
+
+if (op >= OP_STAR && op <= OP_TYPEPOSUPTO)
+  {
+  uint32_t base = (op >= OP_TYPESTAR)? OP_TYPESTAR :
+    OP_STAR + ((op - OP_STAR)/(OP_STARI - OP_STAR)) * (OP_STARI - OP_STAR);
+
+  switch(op - base)
+    {
+    case OP_EXACT - OP_STAR:
+    min = GET2(code, 1);
+    code += 1 + IMM2_SIZE;
+    break;
+
+    case OP_POSUPTO - OP_STAR:
+    min = 0;
+    code += 1 + IMM2_SIZE;
+    break;
+
+    case OP_POSSTAR - OP_STAR:
+    case OP_POSQUERY - OP_STAR:
+    min = 0;
+    /* Fall through */
+
+    case OP_POSPLUS - OP_STAR:
+    code++;
+    break;
+
+    default:
+    return NULL;
+    }
+
+  if (base == OP_TYPESTAR) op = *code++;
+    else op = OP_CHAR + (base - OP_STAR)/(OP_STARI - OP_STAR);
+  }
+else code++;
+
+/* Now code points to the data that follows the (possibly implied) single-item
+opcode. */
+
+switch(op)
+  {
+  case OP_CHARI:
+  case OP_NOTI:
+  if (*code > 127) return NULL;
+  /* Fall through */
+
+  case OP_CHAR:
+  case OP_NOT:
+  c = *code++;
+  negated = op == OP_NOT || op == OP_NOTI;
+  break;
+
+  case OP_ANY:
+  case OP_ALLANY:
+  negated = TRUE;
+  break;
+
+  case OP_NOT_DIGIT: negated = TRUE; /* Fall through */
+  case OP_DIGIT: ctype = cbit_digit; break;
+  case OP_NOT_WHITESPACE: negated = TRUE; /* Fall through */
+  case OP_WHITESPACE: ctype = cbit_space; break;
+  case OP_NOT_WORDCHAR: negated = TRUE; /* Fall through */
+  case OP_WORDCHAR: ctype = cbit_word; break;
+
+  case OP_NCLASS:
+  negated = TRUE;
+  /* Fall through */
+
+  case OP_CLASS:
+  classbits = (const uint8_t *)code;
+  code += 32 / sizeof(PCRE2_UCHAR);
+  switch(*code)
+    {
+    case OP_CRPOSSTAR:
+    case OP_CRPOSQUERY:
+    min = 0;
+    /* Fall through */
+
+    case OP_CRPOSPLUS:
+    code++;
+    break;
+
+    case OP_CRRANGE:
+    case OP_CRMINRANGE:
+    if (GET2(code, 1) == 0 || GET2(code, 1) != GET2(code, 1 + IMM2_SIZE))
+      return NULL;
+    /* Fall through */
+
+    case OP_CRPOSRANGE:
+    min = GET2(code, 1);
+    code += 1 + 2 * IMM2_SIZE;
+    break;
+
+    default:
+    if (*code >= OP_CRSTAR && *code <= OP_CRPOSRANGE) return NULL;
+    break;
+    }
+  break;
+
+  default:
+  return NULL;
+  }
+
+/* Add the possible starting code units to the map. A negated item is taken to
+allow any code unit; this is coarse, but it only costs eligibility. */
+
+if (map != NULL)
+  {
+  if (negated)
+    {
+    memset(map, 0xff, 32);
+    *wideptr = TRUE;
+    }
+  else if (classbits != NULL)
+    {
+    for (int i = 0; i < 32; i++) map[i] |= classbits[i];
+    }
+  else if (ctype >= 0)
+    {
+    for (int i = 0; i < 32; i++) map[i] |= cb->cbits[ctype + i];
+    }
+  else if (c > 255) *wideptr = TRUE;
+  else
+    {
+    map[c/8] |= 1u << (c%8);
+    if (op == OP_CHARI)
+      {
+      for (uint32_t i = 0; i < 256; i++)
+        if (cb->lcc[i] == cb->lcc[c] || i == cb->fcc[c])
+          map[i/8] |= 1u << (i%8);
+      }
+    }
+  }
+
+*minptr = min;
+return code;
+}
+
+
+
+/*************************************************
+*    Find the first code units of a branch      *
+*************************************************/
+
+/* This is called for each alternative of a group that has more than one, to
+find the code units that can start it. Leading zero-width assertions at the
+start of the subject are skipped. The first item must consume at least one
+character, and if it is a group, each of its alternatives must do so.
+
+Arguments:
+  code       points to the start of the alternative
+  map        a 32-byte bit map to be updated
+  wideptr    set TRUE if wide characters may start the alternative
+  cb         points to the compile data block
+
+Returns:     TRUE if the starting code units are known
+*/
+
+static BOOL
+onepass_first(PCRE2_SPTR code, uint8_t *map, BOOL *wideptr, compile_block *cb)
+{
+uint32_t min;
+
+while (*code == OP_CIRC || *code == OP_SOD || *code == OP_SOM) code++;
+
+if (*code == OP_BRA || *code == OP_CBRA)
+  {
+  do
+    {
+    if (!onepass_first(code + PRIV(OP_lengths)[*code], map, wideptr, cb))
+      return FALSE;
+    code += GET(code, 1);
+    }
+  while (*code == OP_ALT);
+  return TRUE;
+  }
+
+return onepass_item(code, map, wideptr, &min, cb) != NULL && min > 0;
+}
+
+
+
+/*************************************************
+*      Check for a pattern that is one-pass      *
+*************************************************/
+
+/* A pattern is one-pass if it can be matched by a single forward scan with no
+backtracking, as is done by match_onepass() in pcre2_match.c. This is the case when it
+consists only of non-repeated groups, simple anchors, and single-character
+items whose repeats give nothing back (either exact, or made possessive by the
+user or by auto-possessification). Groups may have alternatives only if the
+sets of code units that start them are disjoint, so that at most one of them
+can get past its first character. Such a pattern never needs to try another
+way once a character has been consumed. This function is called recursively
+for each group.
+
+Arguments:
+  code       points to a BRA or CBRA opcode
+  cb         points to the compile data block
+
+Returns:     TRUE if the group is one-pass
+*/
+
+static BOOL
+check_onepass(PCRE2_SPTR code, compile_block *cb)
+{
+uint8_t seen[32];
+BOOL seenwide = FALSE;
+BOOL multiple = code[GET(code, 1)] == OP_ALT;
+
+memset(seen, 0, 32);
+
+for (;;)
+  {
+  PCRE2_SPTR cc = code + PRIV(OP_lengths)[*code];
+
+  if (multiple)
+    {
+    uint8_t map[32];
+    BOOL wide = FALSE;
+
+    memset(map, 0, 32);
+    if (!onepass_first(cc, map, &wide, cb) || (wide && seenwide)) return FALSE;
+    for (int i = 0; i < 32; i++)
+      {
+      if ((map[i] & seen[i]) != 0) return FALSE;
+      seen[i] |= map[i];
+      }
+    seenwide |= wide;
+    }
+
+  while (*cc != OP_ALT && *cc != OP_KET)
+    {
+    uint32_t min;
+
+    switch(*cc)
+      {
+      case OP_BRA:
+      case OP_CBRA:
+      if (!check_onepass(cc, cb)) return FALSE;
+      do cc += GET(cc, 1); while (*cc == OP_ALT);
+      cc += 1 + LINK_SIZE;
+      break;
+
+      case OP_CIRC:
+      case OP_SOD:
+      case OP_SOM:
+      case OP_DOLL:
+      case OP_EOD:
+      case OP_EODN:
+      cc++;
+      break;
+
+      default:
+      cc = onepass_item(cc, NULL, NULL, &min, cb);
+      if (cc == NULL) return FALSE;
+      break;
+      }
+    }
+
+  if (*cc == OP_KET) return TRUE;
+  code = cc;
+  }
+}
+
+
+
 /*************************************************
 *   Scan compiled regex for recursion reference  *
 *************************************************/
@@ -10264,6 +10926,7 @@ memset((char *)re + sizeof(pcre2_real_code) - 8, 0, 8);
 re->memctl = ccontext->memctl;
 re->tables = tables;
 re->executable_jit = NULL;
+re->bitparallel = NULL;
 memset(re->start_bitmap, 0, 32 * sizeof(uint8_t));
 re->blocksize = re_blocksize;
 re->magic_number = MAGIC_NUMBER;
@@ -10274,8 +10937,12 @@ re->flags = PCRE2_CODE_UNIT_WIDTH/8 | cb.external_flags | setflags;
 re->limit_heap = limit_heap;
 re->limit_match = limit_match;
 re->limit_depth = limit_depth;
+re->engines = 0;
 re->first_codeunit = 0;
 re->last_codeunit = 0;
+re->req_literal_length = 0;
+re->start_literal_count = 0;
+re->start_range_count = 0;
 re->bsr_convention = bsr;
 re->newline_convention = newline;
 re->max_lookbehind = 0;
@@ -10415,10 +11082,25 @@ if (errorcode == 0 && cb.had_recurse)
 at this stage. */
 
 #ifdef DEBUG_CALL_PRINTINT
-pcre2_printint(re, stderr, TRUE);
+pcre2_printint(re, stderr, TRUE, NULL);
 fprintf(stderr, "Length=%lu Used=%lu\n", length, usedlength);
 #endif
 
+/* If the pattern describes a regular language and is short enough, build a
+bit-parallel matcher for it. This must be done before auto-possessification,
+so that any possessive quantifiers are known to be in the pattern itself. The
+matcher is an optimization, so failing to get memory for it is not an error. */
+
+if (errorcode == 0 && (re->overall_options & (PCRE2_UTF|PCRE2_UCP)) == 0)
+  re->bitparallel = PRIV(bitparallel_build)(codestart, &cb, &re->memctl);
+
+/* If automatic engine selection is requested, choose the engines that
+pcre2_match() can fall back on if a match backtracks too much. This too must be
+done before auto-possessification. */
+
+if (errorcode == 0 && (re->extra_options & PCRE2_EXTRA_AUTO_ENGINE) != 0)
+  re->engines = choose_engines(codestart, utf);
+
 /* Unless disabled, check whether any single character iterators can be
 auto-possessified. The function overwrites the appropriate opcode values, so
 the type of the pointer must be cast. NOTE: the intermediate variable "temp" is
@@ -10446,6 +11128,20 @@ if ((re->overall_options & PCRE2_ANCHORED) == 0 &&
      is_anchored(codestart, 0, &cb, 0, FALSE))
   re->overall_options |= PCRE2_ANCHORED;
 
+/* If the pattern can be matched by a single forward scan with no backtracking,
+say so, so that anchored matches can be done without using heap frames. This is
+checked only when neither UTF nor UCP is set, so that each character is one
+code unit and its other case (if any) comes from the tables. */
+
+if ((re->overall_options & (PCRE2_UTF|PCRE2_UCP)) == 0 &&
+     check_onepass(codestart, &cb))
+  re->flags |= PCRE2_ONEPASS;
+
+/* Record whether captured substrings are never read during matching, so that
+they need not be kept when the caller does not want them. */
+
+if (captures_unread(codestart, utf)) re->flags |= PCRE2_NOCAPREAD;
+
 /* Set up the first code unit or startline flag, the required code unit, and
 then study the pattern. This code need not be obeyed if PCRE2_NO_START_OPTIMIZE
 is set, as the data it would create will not be used. Note that a first code
@@ -10583,6 +11279,15 @@ if ((re->overall_options & PCRE2_NO_START_OPTIMIZE) == 0)
   if (re->minlength < minminlength) re->minlength = minminlength;
   }   /* End of start-of-match optimizations. */
 
+/* If automatic engine selection is requested, compile the pattern for JIT
+matching if that is available. Failure to JIT-compile is not an error; the
+interpreter is used instead. */
+
+#ifdef SUPPORT_JIT
+if ((re->extra_options & PCRE2_EXTRA_AUTO_ENGINE) != 0)
+  (void)pcre2_jit_compile(re, PCRE2_JIT_COMPLETE);
+#endif
+
 /* Control ends up here in all cases. When running under valgrind, make a
 pattern's terminating zero defined again. If memory was obtained for the parsed
 version of the pattern, free it before returning. Also free the list of named
@@ -173,7 +173,10 @@ const pcre2_match_context PRIV(default_match_context) = {
   PCRE2_UNSET,   /* Offset limit */
   HEAP_LIMIT,
   MATCH_LIMIT,
-  MATCH_LIMIT_DEPTH };
+  MATCH_LIMIT_DEPTH,
+  MEMO_LIMIT,
+  0,             /* Step limit */
+  0 };           /* Match deadline */
 
 /* The create function copies the default into the new memory, but must
 override the default memory handling functions if a gcontext was provided. */
@@ -429,6 +432,13 @@ mcontext->match_limit = limit;
 return 0;
 }
 
+PCRE2_EXP_DEFN int PCRE2_CALL_CONVENTION
+pcre2_set_match_deadline(pcre2_match_context *mcontext, uint32_t microseconds)
+{
+mcontext->deadline = microseconds;
+return 0;
+}
+
 PCRE2_EXP_DEFN int PCRE2_CALL_CONVENTION
 pcre2_set_depth_limit(pcre2_match_context *mcontext, uint32_t limit)
 {
@@ -436,6 +446,13 @@ mcontext->depth_limit = limit;
 return 0;
 }
 
+PCRE2_EXP_DEFN int PCRE2_CALL_CONVENTION
+pcre2_set_memo_limit(pcre2_match_context *mcontext, uint32_t limit)
+{
+mcontext->memo_limit = limit;
+return 0;
+}
+
 PCRE2_EXP_DEFN int PCRE2_CALL_CONVENTION
 pcre2_set_offset_limit(pcre2_match_context *mcontext, PCRE2_SIZE limit)
 {
@@ -443,6 +460,13 @@ mcontext->offset_limit = limit;
 return 0;
 }
 
+PCRE2_EXP_DEFN int PCRE2_CALL_CONVENTION
+pcre2_set_step_limit(pcre2_match_context *mcontext, uint32_t limit)
+{
+mcontext->step_limit = limit;
+return 0;
+}
+
 /* This function became obsolete at release 10.30. It is kept as a synonym for
 backwards compatibility. */
 
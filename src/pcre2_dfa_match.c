@@ -69,7 +69,38 @@ of internal_dfa_match(). (The supplied patch used a static vector, initialized
 only once - I suspect this was the cause of the problems with the tests.)
 
 Overall, I concluded that the gains in some cases did not outweigh the losses
-in others, so I abandoned this code. */
+in others, so I abandoned this code.
+
+For 10.40 a different scheme was added, aimed at patterns with very large
+numbers of alternatives, such as those built for pattern sets, where the linear
+search makes matching quadratic in the number of active states. At the top
+level only, once a character step has ended with more than DFA_INDEX_THRESHOLD
+active states, a vector with one stamp per code unit of the pattern is obtained
+from the heap (once per call of pcre2_dfa_match()), and counted against the
+heap limit. Each top-level character step uses a new stamp value, so the vector
+never needs re-initializing except when the stamp wraps. A state whose offset
+does not carry the current stamp cannot be a duplicate, so the linear search is
+needed only when it does.
+Recursive calls of internal_dfa_match() continue to use the linear search, and
+simple patterns never reach the threshold, so they are not affected.
+
+Also for 10.40, a transition cache (sometimes called a "lazy DFA") was added.
+For many patterns, what happens at each character step depends only on the
+list of states that are active at the start of the step and on the current
+character. For such patterns, once a step has been processed, the list of
+states that it produced can be remembered, and the next time the same list
+meets the same character, the result can be taken from the cache instead of
+processing every state again. After LAZY_START_STEPS top-level steps in one
+call of pcre2_dfa_match(), the pattern is checked (once only) to see if it
+contains only items that qualify, and if so, a cache of limited size is
+obtained from the heap. While the cache has the transitions that are needed,
+the subject is scanned by simple table lookup, without touching the state
+lists. A step that finds a match, that has no following states, or whose
+character is not cached (in UTF-8 mode, any character above 127) is always
+processed normally, so the results are the same as without the cache. If the
+cache fills up it is emptied and refilled, unless it is not being re-used
+enough to be worth it, in which case it is discarded and normal processing is
+used for the rest of the match. */
 
 
 #ifdef HAVE_CONFIG_H
@@ -86,7 +117,7 @@ in others, so I abandoned this code. */
   (PCRE2_ANCHORED|PCRE2_ENDANCHORED|PCRE2_NOTBOL|PCRE2_NOTEOL|PCRE2_NOTEMPTY| \
    PCRE2_NOTEMPTY_ATSTART|PCRE2_NO_UTF_CHECK|PCRE2_PARTIAL_HARD| \
    PCRE2_PARTIAL_SOFT|PCRE2_DFA_SHORTEST|PCRE2_DFA_RESTART| \
-   PCRE2_COPY_MATCHED_SUBJECT)
+   PCRE2_COPY_MATCHED_SUBJECT|PCRE2_NO_OVECTOR|PCRE2_RESUME)
 
 
 /*************************************************
@@ -319,6 +350,35 @@ finding the minimum heap requirement for a match. */
 #define RWS_OVEC_RSIZE  (1000*OVEC_UNIT)        /* Ovector for recursion */
 #define RWS_OVEC_OSIZE  (2*OVEC_UNIT)           /* Ovector in other cases */
 
+/* Number of active states after which the top-level duplicate state index is
+used (see the note about performance at the head of this module). */
+
+#define DFA_INDEX_THRESHOLD 64
+
+/* Parameters for the top-level transition cache (see the note about
+performance at the head of this module). LAZY_HASH_SIZE must be a power of two
+that is greater than LAZY_MAX_STATES; LAZY_POOL_SIZE is in ints. When the cache
+fills up, it is emptied only if the states in it have been used to skip at
+least LAZY_MIN_HITS characters each on average; otherwise it is abandoned. A
+transition value of LAZY_NORMAL means that the step must be processed normally,
+either because it finds a match or because no states remain. */
+
+#define LAZY_START_STEPS   64
+#define LAZY_MAX_STATES   256
+#define LAZY_HASH_SIZE    512
+#define LAZY_POOL_SIZE  65536
+#define LAZY_MIN_HITS      10
+#define LAZY_NORMAL       (-2)
+
+/* Code units that can index the transition vector. In UTF-8 mode, only
+single-unit characters are cached. */
+
+#if PCRE2_CODE_UNIT_WIDTH == 8
+#define LAZY_CACHEABLE(c) (!utf || (c) < 0x80)
+#else
+#define LAZY_CACHEABLE(c) ((c) < 256)
+#endif
+
 /* This structure is at the start of each workspace block. */
 
 typedef struct RWS_anchor {
@@ -450,6 +510,296 @@ return 0;
 
 
 
+/*************************************************
+*        Set up the transition cache             *
+*************************************************/
+
+/* This function is called when enough top-level character steps have been
+processed to make it worth trying the transition cache. The cache is used only
+when the processing of a state list depends on nothing but the current
+character. This rules out partial matching and any item that looks at the
+position in the subject, at other characters, or at previous matches, and any
+item that is handled by a recursive call of internal_dfa_match(). A whitelist
+of opcodes is used, so that anything unrecognized disables the cache.
+
+Argument:  the match block
+Returns:   nothing; mb->lazy is set if the cache is to be used
+*/
+
+static void
+lazy_start(dfa_match_block *mb)
+{
+dfa_lazy_cache *lazy;
+PCRE2_SPTR cc = mb->start_code;
+BOOL anyok = mb->nltype == NLTYPE_FIXED && mb->nllen == 1;
+size_t size = sizeof(dfa_lazy_cache) + LAZY_MAX_STATES*sizeof(dfa_lazy_state) +
+  LAZY_HASH_SIZE*sizeof(int32_t) + LAZY_POOL_SIZE*sizeof(int);
+uint32_t sizeK = (uint32_t)((size + 1023)/1024);
+#ifdef SUPPORT_UNICODE
+BOOL utf = (mb->poptions & PCRE2_UTF) != 0;
+#endif
+
+if ((mb->moptions &
+      (PCRE2_PARTIAL_HARD|PCRE2_PARTIAL_SOFT|PCRE2_DFA_RESTART)) != 0 ||
+    sizeK + mb->heap_used > mb->heap_limit)
+  return;
+
+for (;;)
+  {
+  uint32_t d;
+
+  switch (*cc)
+    {
+    case OP_END:
+    goto USE_CACHE;
+
+    case OP_ANY:
+    if (!anyok) return;
+    /* Fall through */
+
+    case OP_ALT:
+    case OP_KET:
+    case OP_KETRMAX:
+    case OP_KETRMIN:
+    case OP_BRA:
+    case OP_CBRA:
+    case OP_SBRA:
+    case OP_SCBRA:
+    case OP_BRAZERO:
+    case OP_BRAMINZERO:
+    case OP_SKIPZERO:
+    case OP_FAIL:
+    case OP_NOT_DIGIT:
+    case OP_DIGIT:
+    case OP_NOT_WHITESPACE:
+    case OP_WHITESPACE:
+    case OP_NOT_WORDCHAR:
+    case OP_WORDCHAR:
+    case OP_ALLANY:
+    case OP_NOTPROP:
+    case OP_PROP:
+    case OP_NOT_HSPACE:
+    case OP_HSPACE:
+    case OP_NOT_VSPACE:
+    case OP_VSPACE:
+    case OP_CLASS:
+    case OP_NCLASS:
+    case OP_CRSTAR:
+    case OP_CRMINSTAR:
+    case OP_CRPLUS:
+    case OP_CRMINPLUS:
+    case OP_CRQUERY:
+    case OP_CRMINQUERY:
+    case OP_CRRANGE:
+    case OP_CRMINRANGE:
+    case OP_CRPOSSTAR:
+    case OP_CRPOSPLUS:
+    case OP_CRPOSQUERY:
+    case OP_CRPOSRANGE:
+    cc += PRIV(OP_lengths)[*cc];
+    break;
+
+    case OP_CHAR:
+    case OP_CHARI:
+    case OP_NOT:
+    case OP_NOTI:
+    case OP_STAR:
+    case OP_MINSTAR:
+    case OP_PLUS:
+    case OP_MINPLUS:
+    case OP_QUERY:
+    case OP_MINQUERY:
+    case OP_UPTO:
+    case OP_MINUPTO:
+    case OP_EXACT:
+    case OP_POSSTAR:
+    case OP_POSPLUS:
+    case OP_POSQUERY:
+    case OP_POSUPTO:
+    case OP_STARI:
+    case OP_MINSTARI:
+    case OP_PLUSI:
+    case OP_MINPLUSI:
+    case OP_QUERYI:
+    case OP_MINQUERYI:
+    case OP_UPTOI:
+    case OP_MINUPTOI:
+    case OP_EXACTI:
+    case OP_POSSTARI:
+    case OP_POSPLUSI:
+    case OP_POSQUERYI:
+    case OP_POSUPTOI:
+    case OP_NOTSTAR:
+    case OP_NOTMINSTAR:
+    case OP_NOTPLUS:
+    case OP_NOTMINPLUS:
+    case OP_NOTQUERY:
+    case OP_NOTMINQUERY:
+    case OP_NOTUPTO:
+    case OP_NOTMINUPTO:
+    case OP_NOTEXACT:
+    case OP_NOTPOSSTAR:
+    case OP_NOTPOSPLUS:
+    case OP_NOTPOSQUERY:
+    case OP_NOTPOSUPTO:
+    case OP_NOTSTARI:
+    case OP_NOTMINSTARI:
+    case OP_NOTPLUSI:
+    case OP_NOTMINPLUSI:
+    case OP_NOTQUERYI:
+    case OP_NOTMINQUERYI:
+    case OP_NOTUPTOI:
+    case OP_NOTMINUPTOI:
+    case OP_NOTEXACTI:
+    case OP_NOTPOSSTARI:
+    case OP_NOTPOSPLUSI:
+    case OP_NOTPOSQUERYI:
+    case OP_NOTPOSUPTOI:
+    cc += PRIV(OP_lengths)[*cc];
+#ifdef SUPPORT_UNICODE
+    if (utf && HAS_EXTRALEN(cc[-1])) cc += GET_EXTRALEN(cc[-1]);
+#endif
+    break;
+
+    /* For character type repeats the type is the last code unit of the
+    fixed-length part of the item. */
+
+    case OP_TYPESTAR:
+    case OP_TYPEMINSTAR:
+    case OP_TYPEPLUS:
+    case OP_TYPEMINPLUS:
+    case OP_TYPEQUERY:
+    case OP_TYPEMINQUERY:
+    case OP_TYPEUPTO:
+    case OP_TYPEMINUPTO:
+    case OP_TYPEEXACT:
+    case OP_TYPEPOSSTAR:
+    case OP_TYPEPOSPLUS:
+    case OP_TYPEPOSQUERY:
+    case OP_TYPEPOSUPTO:
+    cc += PRIV(OP_lengths)[*cc];
+    d = cc[-1];
+    if (d == OP_ANYNL || d == OP_EXTUNI || d == OP_ANYBYTE ||
+        (d == OP_ANY && !anyok))
+      return;
+    if (d == OP_PROP || d == OP_NOTPROP) cc += 2;
+    break;
+
+#if defined SUPPORT_UNICODE || PCRE2_CODE_UNIT_WIDTH != 8
+    case OP_XCLASS:
+    cc += GET(cc, 1);
+    break;
+#endif
+
+    default:
+    return;
+    }
+  }
+
+USE_CACHE:
+lazy = mb->memctl.malloc(size, mb->memctl.memory_data);
+if (lazy == NULL) return;
+lazy->states = (dfa_lazy_state *)(lazy + 1);
+lazy->hashtab = (int32_t *)(lazy->states + LAZY_MAX_STATES);
+lazy->pool = (int *)(lazy->hashtab + LAZY_HASH_SIZE);
+memset(lazy->hashtab, 0xff, LAZY_HASH_SIZE*sizeof(int32_t));
+lazy->state_count = 0;
+lazy->pool_used = 0;
+lazy->flushes = 0;
+lazy->sizeK = sizeK;
+lazy->hits = 0;
+mb->heap_used += sizeK;
+mb->lazy = lazy;
+}
+
+
+
+/*************************************************
+*     Find or add a transition cache state       *
+*************************************************/
+
+/* This function looks up a top-level state list in the transition cache,
+adding it if it is not there. When the cache is full, it is emptied, unless the
+states in it have been used for so few characters that the cache is not paying
+its way, in which case it is abandoned for the rest of the match. Emptying the
+cache invalidates all state numbers, which the caller can detect by checking
+the flushes count.
+
+Arguments:
+  mb         the match block
+  list       the state list
+  count      the number of states in the list
+
+Returns:     the state number, or -1 if the list cannot be cached
+*/
+
+static int32_t
+lazy_state(dfa_match_block *mb, stateblock *list, int count)
+{
+dfa_lazy_cache *lazy = mb->lazy;
+dfa_lazy_state *state;
+uint32_t hash = (uint32_t)count;
+uint32_t h;
+int *p;
+int i;
+
+if ((uint32_t)count > LAZY_POOL_SIZE/2) return -1;
+
+for (i = 0; i < count; i++)
+  {
+  hash = (hash ^ (uint32_t)list[i].offset) * 0x01000193u;
+  hash = (hash ^ (uint32_t)list[i].count) * 0x01000193u;
+  }
+
+for (h = hash & (LAZY_HASH_SIZE - 1); lazy->hashtab[h] >= 0;
+     h = (h + 1) & (LAZY_HASH_SIZE - 1))
+  {
+  state = lazy->states + lazy->hashtab[h];
+  if (state->hash != hash || state->count != (uint32_t)count) continue;
+  p = lazy->pool + state->list;
+  for (i = 0; i < count; i++, p += 2)
+    if (p[0] != list[i].offset || p[1] != list[i].count) break;
+  if (i >= count) return lazy->hashtab[h];
+  }
+
+/* Not found; if the cache is full, empty or abandon it. */
+
+if (lazy->state_count >= LAZY_MAX_STATES ||
+    lazy->pool_used + 2*(uint32_t)count > LAZY_POOL_SIZE)
+  {
+  if (lazy->hits < (PCRE2_SIZE)lazy->state_count * LAZY_MIN_HITS)
+    {
+    mb->heap_used -= lazy->sizeK;
+    mb->memctl.free(lazy, mb->memctl.memory_data);
+    mb->lazy = NULL;
+    return -1;
+    }
+  memset(lazy->hashtab, 0xff, LAZY_HASH_SIZE*sizeof(int32_t));
+  lazy->state_count = 0;
+  lazy->pool_used = 0;
+  lazy->hits = 0;
+  lazy->flushes++;
+  h = hash & (LAZY_HASH_SIZE - 1);
+  }
+
+state = lazy->states + lazy->state_count;
+state->list = lazy->pool_used;
+state->count = (uint32_t)count;
+state->hash = hash;
+memset(state->next, 0xff, sizeof(state->next));
+p = lazy->pool + lazy->pool_used;
+for (i = 0; i < count; i++)
+  {
+  *p++ = list[i].offset;
+  *p++ = list[i].count;
+  }
+lazy->pool_used += 2*(uint32_t)count;
+lazy->hashtab[h] = (int32_t)lazy->state_count;
+return (int32_t)(lazy->state_count++);
+}
+
+
+
 /*************************************************
 *     Match a Regular Expression - DFA engine    *
 *************************************************/
@@ -537,7 +887,14 @@ const uint8_t *ctypes, *lcc, *fcc;
 PCRE2_SPTR ptr;
 PCRE2_SPTR end_code;
 dfa_recursion_info new_recursive;
-int active_count, new_count, match_count;
+int active_count = 0;
+int new_count, match_count;
+int32_t lazy_from = -1;
+int32_t lazy_next = -1;
+uint32_t lazy_char = 0;
+BOOL lazy_accept = FALSE;
+BOOL use_index;
+BOOL resumed = FALSE;
 
 /* Some fields in the mb block are frequently referenced, so we load them into
 independent variables in the hope that this will perform better. */
@@ -655,9 +1012,29 @@ else
   {
   end_code = this_start_code;
 
+  /* Resuming a suspended match: the list of states for the next character is
+  still in the workspace, and the other variables were saved in the match
+  block. */
+
+  if (rlevel == 1 && mb->resuming)
+    {
+    do { end_code += GET(end_code, 1); } while (*end_code == OP_ALT);
+    if (mb->suspend_first)
+      {
+      new_states = active_states;
+      active_states = new_states + wscount;
+      }
+    new_count = mb->suspend_count;
+    match_count = mb->suspend_match_count;
+    reset_could_continue = mb->suspend_could_continue;
+    lazy_next = mb->suspend_lazy_next;
+    mb->resuming = FALSE;
+    resumed = TRUE;
+    }
+
   /* Restarting */
 
-  if (rlevel == 1 && (mb->moptions & PCRE2_DFA_RESTART) != 0)
+  else if (rlevel == 1 && (mb->moptions & PCRE2_DFA_RESTART) != 0)
     {
     do { end_code += GET(end_code, 1); } while (*end_code == OP_ALT);
     new_count = workspace[1];
@@ -683,11 +1060,14 @@ else
     }
   }
 
-workspace[0] = 0;    /* Bit indicating which vector is current */
+/* The bit in workspace[0] indicates which vector is current. A resumed match
+finds it as it was left. */
+
+if (!resumed) workspace[0] = 0;
 
 /* Loop for scanning the subject */
 
-ptr = current_subject;
+ptr = resumed? mb->suspend_ptr : current_subject;
 for (;;)
   {
   int i, j;
@@ -698,8 +1078,79 @@ for (;;)
   BOOL could_continue = reset_could_continue;
   reset_could_continue = FALSE;
 
+  /* When a step limit is set, each character position at the top level uses
+  one step, plus one for each state that is active there. When there are not
+  enough steps left, the match is suspended before the character is processed,
+  except at the position where it was resumed, so that it always makes some
+  progress. */
+
+  if (rlevel == 1 && mb->steps_left != 0)
+    {
+    uint32_t steps = (uint32_t)new_count + 1;
+    if (steps < mb->steps_left) mb->steps_left -= steps;
+    else if (resumed) mb->steps_left = 1;
+    else
+      {
+      mb->suspend_ptr = ptr;
+      mb->suspend_first = new_states == (stateblock *)(workspace + 2);
+      mb->suspend_count = new_count;
+      mb->suspend_match_count = match_count;
+      mb->suspend_could_continue = could_continue;
+      mb->suspend_lazy_next = lazy_next;
+      return PCRE2_ERROR_SUSPENDED;
+      }
+    }
+  resumed = FALSE;
+
+  /* When a deadline is set, the clock is read whenever another
+  DEADLINE_CHECK_INTERVAL active states have been processed, at any level. */
+
+  if (mb->deadline_countdown != 0)
+    {
+    uint32_t states = (uint32_t)new_count + 1;
+    if (states < mb->deadline_countdown) mb->deadline_countdown -= states;
+    else
+      {
+      if (PRIV(clock_usec)() >= mb->deadline) return PCRE2_ERROR_DEADLINE;
+      mb->deadline_countdown = DEADLINE_CHECK_INTERVAL;
+      }
+    }
+
   if (ptr > mb->last_used_ptr) mb->last_used_ptr = ptr;
 
+  /* At the top level, use the duplicate state index if the previous character
+  step ended with a long list. The vector is obtained on first use and counted
+  against the heap limit; if it would exceed the limit, or cannot be obtained,
+  the linear search is used. */
+
+  use_index = FALSE;
+  if (rlevel == 1 && active_count > DFA_INDEX_THRESHOLD)
+    {
+    if (mb->state_index == NULL)
+      {
+      uint32_t sizeK = (uint32_t)
+        ((mb->code_length * sizeof(uint32_t) + 1023)/1024);
+      if (sizeK + mb->heap_used <= mb->heap_limit)
+        mb->state_index = mb->memctl.malloc(
+          mb->code_length * sizeof(uint32_t), mb->memctl.memory_data);
+      if (mb->state_index != NULL)
+        {
+        memset(mb->state_index, 0, mb->code_length * sizeof(uint32_t));
+        mb->state_index_stamp = 0;
+        mb->heap_used += sizeK;
+        }
+      }
+    if (mb->state_index != NULL)
+      {
+      if (++mb->state_index_stamp == 0)
+        {
+        memset(mb->state_index, 0, mb->code_length * sizeof(uint32_t));
+        mb->state_index_stamp = 1;
+        }
+      use_index = TRUE;
+      }
+    }
+
   /* Make the new state list into the active state list and empty the
   new state list. */
 
@@ -709,6 +1160,63 @@ for (;;)
   active_count = new_count;
   new_count = 0;
 
+  /* At the top level, once enough characters have been processed, try to set
+  up the transition cache. If it exists, follow its transitions along the
+  subject for as long as possible, and then load the state list for the
+  current position. */
+
+  lazy_from = -1;
+  if (rlevel == 1)
+    {
+    if (mb->lazy == NULL && mb->lazy_countdown > 0 &&
+        --mb->lazy_countdown == 0)
+      lazy_start(mb);
+
+    if (mb->lazy != NULL)
+      {
+      if (lazy_next < 0)
+        lazy_next = lazy_state(mb, active_states, active_count);
+
+      if (lazy_next >= 0)
+        {
+        dfa_lazy_cache *lazy = mb->lazy;
+        PCRE2_SPTR lazy_ptr = ptr;
+
+        while (ptr < end_subject && LAZY_CACHEABLE(*ptr))
+          {
+          int32_t next = lazy->states[lazy_next].next[*ptr];
+          if (next < 0) break;
+          lazy_next = next;
+          ptr++;
+          }
+
+        if (ptr > lazy_ptr)
+          {
+          dfa_lazy_state *state = lazy->states + lazy_next;
+          int *p = lazy->pool + state->list;
+
+          lazy->hits += (PCRE2_SIZE)(ptr - lazy_ptr);
+          active_count = (int)state->count;
+          for (i = 0; i < active_count; i++, p += 2)
+            {
+            active_states[i].offset = p[0];
+            active_states[i].count = p[1];
+            active_states[i].data = 0;
+            }
+          if (ptr > mb->last_used_ptr) mb->last_used_ptr = ptr;
+          }
+
+        if (ptr < end_subject && LAZY_CACHEABLE(*ptr))
+          {
+          lazy_from = lazy_next;
+          lazy_char = *ptr;
+          lazy_accept = FALSE;
+          }
+        }
+      }
+    lazy_next = -1;
+    }
+
   workspace[0] ^= 1;              /* Remember for the restarting feature */
   workspace[1] = active_count;
 
@@ -772,10 +1280,12 @@ for (;;)
       }
 
     /* Check for a duplicate state with the same count, and skip if found.
-    See the note at the head of this module about the possibility of improving
-    performance here. */
+    See the note at the head of this module about the index that is used to
+    avoid the linear search when there are many states. */
 
-    for (j = 0; j < i; j++)
+    if (use_index && mb->state_index[state_offset] != mb->state_index_stamp)
+      mb->state_index[state_offset] = mb->state_index_stamp;
+    else for (j = 0; j < i; j++)
       {
       if (active_states[j].offset == state_offset &&
           active_states[j].count == current_state->count)
@@ -878,6 +1388,7 @@ for (;;)
         }
       else
         {
+        lazy_accept = TRUE;
         if (ptr > current_subject ||
             ((mb->moptions & PCRE2_NOTEMPTY) == 0 &&
               ((mb->moptions & PCRE2_NOTEMPTY_ATSTART) == 0 ||
@@ -3214,6 +3725,20 @@ for (;;)
 
     }      /* End of loop scanning active states */
 
+  /* If this step started from a transition cache state, remember where it
+  went. Adding the new state list may empty the cache, in which case the
+  starting state number is no longer valid. */
+
+  if (lazy_from >= 0 && mb->lazy != NULL)
+    {
+    uint32_t flushes = mb->lazy->flushes;
+    if (new_count > 0)
+      lazy_next = lazy_state(mb, new_states, new_count);
+    if (mb->lazy != NULL && mb->lazy->flushes == flushes)
+      mb->lazy->states[lazy_from].next[lazy_char] =
+        (lazy_accept || lazy_next < 0)? LAZY_NORMAL : lazy_next;
+    }
+
   /* We have finished the processing at the current subject character. If no
   new states have been set for the next character, we have found all the
   matches that we are going to find. If partial matching has been requested,
@@ -3302,11 +3827,13 @@ int rc;
 int was_zero_terminated = 0;
 
 const pcre2_real_code *re = (const pcre2_real_code *)code;
+match_resume *resume = NULL;
 
 PCRE2_SPTR start_match;
 PCRE2_SPTR end_subject;
 PCRE2_SPTR bumpalong_limit;
 PCRE2_SPTR req_cu_ptr;
+PCRE2_SPTR req_lit_ptr;
 
 BOOL utf, anchored, startline, firstline;
 BOOL has_first_cu = FALSE;
@@ -3361,11 +3888,17 @@ if (length == PCRE2_ZERO_TERMINATED)
 if (wscount < 20) return PCRE2_ERROR_DFA_WSSIZE;
 if (start_offset > length) return PCRE2_ERROR_BADOFFSET;
 
-/* Partial matching and PCRE2_ENDANCHORED are currently not allowed at the same
-time. */
+/* Partial matching is currently not allowed at the same time as either
+PCRE2_ENDANCHORED or PCRE2_NO_OVECTOR, and restarting makes no sense without
+an ovector. */
 
 if ((options & (PCRE2_PARTIAL_HARD|PCRE2_PARTIAL_SOFT)) != 0 &&
-   ((re->overall_options | options) & PCRE2_ENDANCHORED) != 0)
+   (((re->overall_options | options) & PCRE2_ENDANCHORED) != 0 ||
+    (options & PCRE2_NO_OVECTOR) != 0))
+  return PCRE2_ERROR_BADOPTION;
+
+if ((options & (PCRE2_DFA_RESTART|PCRE2_NO_OVECTOR)) ==
+    (PCRE2_DFA_RESTART|PCRE2_NO_OVECTOR))
   return PCRE2_ERROR_BADOPTION;
 
 /* Invalid UTF support is not available for DFA matching. */
@@ -3401,22 +3934,99 @@ options |= (re->flags & FF) / ((FF & (~FF+1)) / (OO & (~OO+1)));
 #undef FF
 #undef OO
 
+/* A match that was suspended after using up its step limit is abandoned by
+any call that does not resume it. */
+
+if ((options & PCRE2_RESUME) == 0 && match_data->resume != NULL)
+  PRIV(match_resume_free)(match_data);
+
 /* If restarting after a partial match, do some sanity checks on the contents
-of the workspace. */
+of the workspace. This is not done when resuming a suspended match. */
 
-if ((options & PCRE2_DFA_RESTART) != 0)
+if ((options & (PCRE2_DFA_RESTART|PCRE2_RESUME)) == PCRE2_DFA_RESTART)
   {
   if ((workspace[0] & (-2)) != 0 || workspace[1] < 1 ||
     workspace[1] > (int)((wscount - 2)/INTS_PER_STATEBLOCK))
       return PCRE2_ERROR_DFA_BADRESTART;
   }
 
+/* Opcodes are not profiled by DFA matching, so any profile from an earlier
+match is no longer relevant. */
+
+match_data->profile_length = 0;
+
+/* When PCRE2_NO_OVECTOR is set, only the existence of a match is wanted. As in
+pcre2_match(), the bit-parallel matcher is used when it can be; otherwise an
+ordinary DFA match is done and its offsets are discarded. */
+
+if ((options & PCRE2_NO_OVECTOR) != 0)
+  {
+  if (re->bitparallel != NULL &&
+      (re->overall_options & PCRE2_FIRSTLINE) == 0 &&
+      (options & PCRE2_RESUME) == 0 &&
+      (mcontext == NULL || (mcontext->offset_limit == PCRE2_UNSET &&
+        mcontext->step_limit == 0)))
+    {
+    if ((match_data->flags & PCRE2_MD_COPIED_SUBJECT) != 0)
+      {
+      match_data->memctl.free((void *)match_data->subject,
+        match_data->memctl.memory_data);
+      match_data->flags &= ~PCRE2_MD_COPIED_SUBJECT;
+      }
+    rc = PRIV(bitparallel_match)(re, subject, length, start_offset, options)?
+      1 : PCRE2_ERROR_NOMATCH;
+    match_data->code = re;
+    match_data->subject = NULL;
+    match_data->mark = NULL;
+    match_data->matchedby = PCRE2_MATCHEDBY_DFA_INTERPRETER;
+    match_data->startchar = 0;
+    if ((match_data->flags & PCRE2_MD_STATISTICS) != 0)
+      {
+      memset(&match_data->statistics, 0, sizeof(pcre2_match_statistics));
+      match_data->statistics.engine = PCRE2_ENGINE_BITPARALLEL;
+      }
+    }
+  else
+    {
+    rc = pcre2_dfa_match(code, subject, length, start_offset,
+      options & ~(PCRE2_NO_OVECTOR|PCRE2_COPY_MATCHED_SUBJECT), match_data,
+      mcontext, workspace, wscount);
+    if (rc == 0) rc = 1;
+    }
+
+  if (rc > 0)
+    {
+    uint32_t i;
+    for (i = 0; i < 2 * (uint32_t)match_data->oveccount; i++)
+      match_data->ovector[i] = PCRE2_UNSET;
+    rc = 1;
+    }
+  match_data->rc = rc;
+  return rc;
+  }
+
+/* As in pcre2_match(), a suspended match can be resumed only with the same
+arguments, apart from the match context, from which only the step limit is
+taken. The workspace must also be the same. */
+
+if ((options & PCRE2_RESUME) != 0)
+  {
+  resume = match_data->resume;
+  options &= ~PCRE2_RESUME;
+  if (resume == NULL || resume->workspace != workspace ||
+      resume->wscount != wscount || resume->code != re ||
+      resume->subject != subject || resume->length != length ||
+      resume->start_offset != start_offset || resume->options != options)
+    return PCRE2_ERROR_BADRESUME;
+  }
+
 /* Set some local values */
 
 utf = (re->overall_options & PCRE2_UTF) != 0;
 start_match = subject + start_offset;
 end_subject = subject + length;
 req_cu_ptr = start_match - 1;
+req_lit_ptr = start_match - 1;
 anchored = (options & (PCRE2_ANCHORED|PCRE2_DFA_RESTART)) != 0 ||
   (re->overall_options & PCRE2_ANCHORED) != 0;
 
@@ -3450,6 +4060,8 @@ if (mcontext == NULL)
   mb->match_limit = PRIV(default_match_context).match_limit;
   mb->match_limit_depth = PRIV(default_match_context).depth_limit;
   mb->heap_limit = PRIV(default_match_context).heap_limit;
+  mb->steps_left = 0;
+  mb->deadline_countdown = 0;
   }
 else
   {
@@ -3465,11 +4077,29 @@ else
   mb->match_limit = mcontext->match_limit;
   mb->match_limit_depth = mcontext->depth_limit;
   mb->heap_limit = mcontext->heap_limit;
+  mb->steps_left = mcontext->step_limit;
+  mb->deadline_countdown = 0;
+  if (mcontext->deadline != 0)
+    {
+    mb->deadline = PRIV(clock_usec)() + mcontext->deadline;
+    mb->deadline_countdown = DEADLINE_CHECK_INTERVAL;
+    }
   }
 
 if (mb->match_limit > re->limit_match)
   mb->match_limit = re->limit_match;
 
+/* If statistics are wanted, they are collected afresh for each match. Only
+the starting positions are counted. */
+
+mb->stats = NULL;
+if ((match_data->flags & PCRE2_MD_STATISTICS) != 0)
+  {
+  mb->stats = &match_data->statistics;
+  memset(mb->stats, 0, sizeof(pcre2_match_statistics));
+  mb->stats->engine = PCRE2_ENGINE_DFA;
+  }
+
 if (mb->match_limit_depth > re->limit_depth)
   mb->match_limit_depth = re->limit_depth;
 
@@ -3488,6 +4118,13 @@ mb->moptions = options;
 mb->poptions = re->overall_options;
 mb->match_call_count = 0;
 mb->heap_used = 0;
+mb->state_index = NULL;
+mb->state_index_stamp = 0;
+mb->lazy = NULL;
+mb->lazy_countdown = LAZY_START_STEPS;
+mb->resuming = FALSE;
+mb->code_length = (re->blocksize - sizeof(pcre2_real_code) -
+  CU2BYTES(re->name_count * re->name_entry_size)) / (PCRE2_CODE_UNIT_WIDTH/8);
 
 /* Process the \R and newline settings. */
 
@@ -3533,10 +4170,11 @@ multiunit character. We check only the portion of the subject that is going to
 be inspected during matching - from the offset minus the maximum back reference
 to the given length. This saves time when a small part of a large subject is
 being matched by the use of a starting offset. Note that the maximum lookbehind
-is a number of characters, not code units. */
+is a number of characters, not code units. When a suspended match is resumed,
+the subject has already been checked. */
 
 #ifdef SUPPORT_UNICODE
-if (utf && (options & PCRE2_NO_UTF_CHECK) == 0)
+if (utf && (options & PCRE2_NO_UTF_CHECK) == 0 && resume == NULL)
   {
   PCRE2_SPTR check_subject = start_match;  /* start_match includes offset */
 
@@ -3639,12 +4277,49 @@ match_data->subject = NULL;  /* Default for no match */
 match_data->mark = NULL;
 match_data->matchedby = PCRE2_MATCHEDBY_DFA_INTERPRETER;
 
+/* When a suspended match is resumed, restore the match block, the callout
+block, and the variables of the bumpalong loop, and continue with the call of
+internal_dfa_match() that was suspended. The saved state is not needed after
+this. */
+
+if (resume != NULL)
+  {
+  uint32_t steps_left = mb->steps_left;
+  uint32_t deadline_countdown = mb->deadline_countdown;
+  uint64_t deadline = mb->deadline;
+  pcre2_match_statistics *stats = mb->stats;
+
+  *mb = resume->u.dmb;
+  mb->cb = &cb;
+  mb->steps_left = steps_left;
+  mb->deadline_countdown = deadline_countdown;
+  mb->deadline = deadline;
+  mb->stats = stats;
+  mb->resuming = TRUE;
+
+  cb = resume->cb;
+  start_match = resume->start_match;
+  end_subject = resume->end_subject;
+  req_cu_ptr = resume->req_cu_ptr;
+  req_lit_ptr = resume->req_lit_ptr;
+#if PCRE2_CODE_UNIT_WIDTH == 8
+  memchr_found_first_cu = resume->memchr_found_first_cu;
+  memchr_found_first_cu2 = resume->memchr_found_first_cu2;
+#endif
+
+  match_data->memctl.free(resume, match_data->memctl.memory_data);
+  match_data->resume = NULL;
+  goto RESUME_MATCH;
+  }
+
 /* Call the main matching function, looping for a non-anchored regex after a
 failed match. If not restarting, perform certain optimizations at the start of
 a match. */
 
 for (;;)
   {
+  PCRE2_SPTR scan_start = start_match;
+
   /* ----------------- Start of match optimizations ---------------- */
 
   /* There are some optimizations that avoid running the match if a known
@@ -3707,11 +4382,33 @@ for (;;)
         }
       }
 
-    /* Not anchored. Advance to a unique first code unit if there is one. */
+    /* Not anchored. If there is a set of literal strings, one of which must
+    start every match, advance to the first place where one of them occurs.
+    This is a better filter than a first code unit or the start bitmap, but it
+    is not used for partial matching, where a match may start with an
+    incomplete string at the end of the subject, or when the match must start
+    in the first line. Otherwise, advance to a unique first code unit if there
+    is one. */
 
     else
       {
-      if (has_first_cu)
+      if (re->start_literal_count > 0 && !firstline &&
+          (mb->moptions & (PCRE2_PARTIAL_HARD|PCRE2_PARTIAL_SOFT)) == 0)
+        {
+        start_match = PRIV(find_string_set)(start_match, end_subject,
+          re->start_literals, re->start_literal_count,
+          re->start_literal_length);
+        if (start_match == NULL)
+          {
+          if (mb->stats != NULL)
+            mb->stats->skipped_first_cu += end_subject - scan_start;
+          break;
+          }
+        if (mb->stats != NULL)
+          mb->stats->skipped_first_cu += start_match - scan_start;
+        }
+
+      else if (has_first_cu)
         {
         if (first_cu != first_cu2)  /* Caseless */
           {
@@ -3800,6 +4497,9 @@ for (;;)
         we also let the cycle run, because the matching string is legitimately
         allowed to start with the first code unit of a newline. */
 
+        if (mb->stats != NULL)
+          mb->stats->skipped_first_cu += start_match - scan_start;
+
         if ((mb->moptions & (PCRE2_PARTIAL_HARD|PCRE2_PARTIAL_SOFT)) == 0 &&
             start_match >= mb->end_subject)
           break;
@@ -3841,19 +4541,16 @@ for (;;)
       /* If there's no first code unit or a requirement for a multiline line
       start, advance to a non-unique first code unit if any have been
       identified. The bitmap contains only 256 bits. When code units are 16 or
-      32 bits wide, all code units greater than 254 set the 255 bit. */
+      32 bits wide, all code units greater than 254 set the 255 bit. If the
+      bitmap can be covered by a few ranges, the search uses vector
+      instructions where available. */
 
       else if (start_bits != NULL)
         {
-        while (start_match < end_subject)
-          {
-          uint32_t c = UCHAR21TEST(start_match);
-#if PCRE2_CODE_UNIT_WIDTH != 8
-          if (c > 255) c = 255;
-#endif
-          if ((start_bits[c/8] & (1u << (c&7))) != 0) break;
-          start_match++;
-          }
+        start_match = PRIV(find_start_bits)(start_match, end_subject,
+          start_bits, re->start_ranges, re->start_range_count);
+        if (mb->stats != NULL)
+          mb->stats->skipped_start_bits += start_match - scan_start;
 
         /* See comment above in first_cu checking about the next line. */
 
@@ -3948,7 +4645,12 @@ for (;;)
           /* If we can't find the required code unit, break the matching loop,
           forcing a match failure. */
 
-          if (p >= end_subject) break;
+          if (p >= end_subject)
+            {
+            if (mb->stats != NULL)
+              mb->stats->skipped_req_cu += end_subject - start_match;
+            break;
+            }
 
           /* If we have found the required code unit, save the point where we
           found it, so that we don't search again next time round the loop if
@@ -3957,6 +4659,34 @@ for (;;)
           req_cu_ptr = p;
           }
         }
+
+      /* A required literal string found by pcre2_study() is handled in the
+      same way. If every match starts with it, the starting point can be
+      advanced to where it was found, except when the match is constrained to
+      the first line. */
+
+      if (re->req_literal_length > 0 && start_match > req_lit_ptr)
+        {
+        PCRE2_SIZE check_length = end_subject - start_match;
+
+        if (check_length < REQ_CU_MAX ||
+              (!anchored && check_length < REQ_CU_MAX * 1000))
+          {
+          p = PRIV(find_string)(start_match, end_subject, re->req_literal,
+            re->req_literal_length);
+          if (p == NULL)
+            {
+            if (mb->stats != NULL)
+              mb->stats->skipped_req_cu += end_subject - start_match;
+            break;
+            }
+          req_lit_ptr = p;
+          }
+        }
+
+      if ((re->flags & PCRE2_LITSTART) != 0 && !anchored && !firstline &&
+          req_lit_ptr > start_match)
+        start_match = req_lit_ptr;
       }
     }
 
@@ -3972,6 +4702,7 @@ for (;;)
   mb->last_used_ptr = start_match;
   mb->recursive = NULL;
 
+  RESUME_MATCH:
   rc = internal_dfa_match(
     mb,                           /* fixed match data */
     mb->start_code,               /* this subexpression's code */
@@ -3984,6 +4715,49 @@ for (;;)
     0,                            /* function recurse level */
     base_recursion_workspace);    /* initial workspace for recursion */
 
+  if (mb->stats != NULL) mb->stats->start_positions++;
+
+  /* A suspended match is saved in the match data block. Its state lists stay
+  in the workspace, and the memory that the match block points to now belongs
+  to the saved match. The recursion workspace is freed as usual, so it no
+  longer counts towards the heap limit. */
+
+  if (rc == PCRE2_ERROR_SUSPENDED)
+    {
+    resume = match_data->memctl.malloc(sizeof(match_resume),
+      match_data->memctl.memory_data);
+    if (resume == NULL) rc = PCRE2_ERROR_NOMEMORY;
+    else
+      {
+      RWS_anchor *next;
+      for (next = rws->next; next != NULL; next = next->next)
+        mb->heap_used -= next->size/(1024/sizeof(int));
+
+      resume->code = re;
+      resume->subject = subject;
+      resume->length = length;
+      resume->start_offset = start_offset;
+      resume->options = options;
+      resume->workspace = workspace;
+      resume->wscount = wscount;
+      resume->start_match = start_match;
+      resume->end_subject = end_subject;
+      resume->req_cu_ptr = req_cu_ptr;
+      resume->req_lit_ptr = req_lit_ptr;
+#if PCRE2_CODE_UNIT_WIDTH == 8
+      resume->memchr_found_first_cu = memchr_found_first_cu;
+      resume->memchr_found_first_cu2 = memchr_found_first_cu2;
+#endif
+      resume->cb = cb;
+      resume->u.dmb = *mb;
+      match_data->resume = resume;
+      mb->state_index = NULL;
+      mb->lazy = NULL;
+      }
+    match_data->rc = rc;
+    goto EXIT;
+    }
+
   /* Anything other than "no match" means we are done, always; otherwise, carry
   on only if not anchored. */
 
@@ -4053,6 +4827,10 @@ while (rws->next != NULL)
   rws->next = next->next;
   mb->memctl.free(next, mb->memctl.memory_data);
   }
+if (mb->state_index != NULL)
+  mb->memctl.free(mb->state_index, mb->memctl.memory_data);
+if (mb->lazy != NULL)
+  mb->memctl.free(mb->lazy, mb->memctl.memory_data);
 
 return rc;
 }
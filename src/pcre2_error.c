@@ -272,6 +272,13 @@ static const unsigned char match_error_texts[] =
   /* 65 */
   "internal error - duplicate substitution match\0"
   "PCRE2_MATCH_INVALID_UTF is not supported for DFA matching\0"
+  "pattern item or option is not supported in a pattern set\0"
+  "pattern set has not been compiled\0"
+  "data cannot be added to a stream after its end\0"
+  /* 70 */
+  "match suspended after its step limit was used up\0"
+  "PCRE2_RESUME is set, but there is no suspended match with these arguments\0"
+  "match deadline passed\0"
   ;
 
 
@@ -87,6 +87,19 @@ such arrays. */
 #define PCRE2_KEEP_UNINITIALIZED
 #endif
 
+/* Some internal functions that scan strings can use vector instructions. Only
+those that the compiler's target is known to support are used: SSE2 on x86
+(always available on x86-64) and NEON on 64-bit ARM. There is no run-time
+detection of processor features. Modules that use these macros include the
+relevant header themselves. */
+
+#if defined __SSE2__ || defined _M_X64 || defined _M_AMD64 || \
+    (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#define PCRE2_SIMD_SSE2
+#elif defined __aarch64__ && defined __ARM_NEON
+#define PCRE2_SIMD_NEON
+#endif
+
 /* Older versions of MSVC lack snprintf(). This define allows for
 warning/error-free compilation and testing with MSVC compilers back to at least
 MSVC 10/2010. Except for VC6 (which is missing some fundamentals and fails). */
@@ -235,6 +248,43 @@ allocated on the stack. */
 
 #define DFA_START_RWS_SIZE 30720
 
+/* When PCRE2_MEMOIZE is set, pcre2_match() uses a bit vector to remember where
+groups have already failed. This is the default upper limit on its size, in
+kibibytes; it can be changed by pcre2_set_memo_limit(). If a match needs more,
+it runs without memoization. */
+
+#ifndef MEMO_LIMIT
+#define MEMO_LIMIT 1024
+#endif
+
+/* When PCRE2_EXTRA_AUTO_ENGINE has chosen a fallback engine for a pattern that
+may backtrack catastrophically, pcre2_match() first runs with its match limit
+reduced to this value plus the length of the subject. Only a match that
+exceeds it is run again with the fallback engine. */
+
+#ifndef AUTO_MATCH_BUDGET
+#define AUTO_MATCH_BUDGET 10000
+#endif
+
+/* When that fallback engine is pcre2_dfa_match(), its workspace is obtained
+from the match data's memory functions, with room for two lists of states
+that each have one state for every code unit of the compiled pattern, but not
+less than this many ints. If it turns out to be too small, memoization is used
+instead. */
+
+#ifndef AUTO_DFA_MIN_WSCOUNT
+#define AUTO_DFA_MIN_WSCOUNT 1000
+#endif
+
+/* When a deadline has been set by pcre2_set_match_deadline(), the matching
+functions read the clock only once in this many steps (backtracking frames for
+pcre2_match(), active states for pcre2_dfa_match(), and match limit counts or
+starting positions for JIT matching). */
+
+#ifndef DEADLINE_CHECK_INTERVAL
+#define DEADLINE_CHECK_INTERVAL 1000
+#endif
+
 /* Define the default BSR convention. */
 
 #ifdef BSR_ANYCRLF
@@ -529,6 +579,10 @@ bytes in a code unit in that mode. */
 #define PCRE2_DUPCAPUSED    0x00200000  /* contains (?| */
 #define PCRE2_HASBKC        0x00400000  /* contains \C */
 #define PCRE2_HASACCEPT     0x00800000  /* contains (*ACCEPT) */
+#define PCRE2_LITSTART      0x01000000  /* req_literal starts every match */
+#define PCRE2_ONEPASS       0x02000000  /* pattern can be matched in one pass */
+#define PCRE2_NOCAPREAD     0x04000000  /* captures are not read in matching */
+#define PCRE2_STARTDEP      0x08000000  /* contains \G, (*COMMIT), or (*SKIP) */
 
 #define PCRE2_MODE_MASK     (PCRE2_MODE8 | PCRE2_MODE16 | PCRE2_MODE32)
 
@@ -541,6 +595,8 @@ enum { PCRE2_MATCHEDBY_INTERPRETER,     /* pcre2_match() */
 /* Values for the flags field in a match data block. */
 
 #define PCRE2_MD_COPIED_SUBJECT  0x01u
+#define PCRE2_MD_STATISTICS      0x02u
+#define PCRE2_MD_PROFILE         0x04u
 
 /* Magic number to provide a small check against being handed junk. */
 
@@ -557,6 +613,23 @@ modes. */
 #define REQ_CU_MAX       2000
 #endif
 
+/* The maximum length, in code units, of the required literal string that is
+saved in a compiled pattern. A longer run of literal characters is truncated. */
+
+#define REQ_LITERAL_MAX  32
+
+/* The maximum number of literal strings, one per alternative, that may be
+saved as the possible starts of a match, and the maximum length of each. */
+
+#define START_LITERALS_MAX     8
+#define START_LITERAL_LENGTH   8
+
+/* The maximum number of code unit ranges that are used to cover the starting
+code unit bitmap when searching for the start of a match with vector
+instructions. */
+
+#define START_RANGES_MAX       3
+
 /* Offsets for the bitmap tables in the cbits set of tables. Each table
 contains a set of bits for a class map. Some classes are built by combining
 these tables. */
@@ -1826,6 +1899,28 @@ typedef struct {
   uint16_t bprops;    /* binary properties offset */
 } ucd_record;
 
+/* Types for the small set of thread functions that pcre2_match_parallel()
+uses. They are available only when thread support is enabled at build time. */
+
+#ifdef SUPPORT_THREADS
+#ifdef _WIN32
+#include <windows.h>
+typedef HANDLE            thread_handle;
+typedef CRITICAL_SECTION  thread_mutex;
+typedef CONDITION_VARIABLE thread_cond;
+typedef DWORD             thread_result;
+#define THREAD_CALL       WINAPI
+#else
+#include <pthread.h>
+typedef pthread_t         thread_handle;
+typedef pthread_mutex_t   thread_mutex;
+typedef pthread_cond_t    thread_cond;
+typedef void *            thread_result;
+#define THREAD_CALL
+#endif
+typedef thread_result (THREAD_CALL *thread_function)(void *);
+#endif  /* SUPPORT_THREADS */
+
 /* UCD access macros */
 
 #define UCD_BLOCK_SIZE 128
@@ -1974,7 +2069,10 @@ private structures. */
 #define compile_block                PCRE2_SUFFIX(compile_block_)
 #define dfa_match_block              PCRE2_SUFFIX(dfa_match_block_)
 #define match_block                  PCRE2_SUFFIX(match_block_)
+#define match_cache                  PCRE2_SUFFIX(match_cache_)
+#define match_resume                 PCRE2_SUFFIX(match_resume_)
 #define named_group                  PCRE2_SUFFIX(named_group_)
+#define pool_worker                  PCRE2_SUFFIX(pool_worker_)
 
 #include "pcre2_intmodedep.h"
 
@@ -1985,15 +2083,33 @@ not referenced from pcre2test, and must not be defined when no code unit width
 is available. */
 
 #define _pcre2_auto_possessify       PCRE2_SUFFIX(_pcre2_auto_possessify_)
+#define _pcre2_bitparallel_build     PCRE2_SUFFIX(_pcre2_bitparallel_build_)
+#define _pcre2_bitparallel_match     PCRE2_SUFFIX(_pcre2_bitparallel_match_)
 #define _pcre2_check_escape          PCRE2_SUFFIX(_pcre2_check_escape_)
+#define _pcre2_clock_usec            PCRE2_SUFFIX(_pcre2_clock_usec_)
 #define _pcre2_extuni                PCRE2_SUFFIX(_pcre2_extuni_)
 #define _pcre2_find_bracket          PCRE2_SUFFIX(_pcre2_find_bracket_)
+#define _pcre2_find_start_bits       PCRE2_SUFFIX(_pcre2_find_start_bits_)
+#define _pcre2_find_string           PCRE2_SUFFIX(_pcre2_find_string_)
+#define _pcre2_find_string_set       PCRE2_SUFFIX(_pcre2_find_string_set_)
 #define _pcre2_is_newline            PCRE2_SUFFIX(_pcre2_is_newline_)
 #define _pcre2_jit_free_rodata       PCRE2_SUFFIX(_pcre2_jit_free_rodata_)
 #define _pcre2_jit_free              PCRE2_SUFFIX(_pcre2_jit_free_)
 #define _pcre2_jit_get_size          PCRE2_SUFFIX(_pcre2_jit_get_size_)
 #define _pcre2_jit_get_target        PCRE2_SUFFIX(_pcre2_jit_get_target_)
+#define _pcre2_match_cached          PCRE2_SUFFIX(_pcre2_match_cached_)
+#define _pcre2_cond_broadcast        PCRE2_SUFFIX(_pcre2_cond_broadcast_)
+#define _pcre2_cond_destroy          PCRE2_SUFFIX(_pcre2_cond_destroy_)
+#define _pcre2_cond_init             PCRE2_SUFFIX(_pcre2_cond_init_)
+#define _pcre2_cond_wait             PCRE2_SUFFIX(_pcre2_cond_wait_)
+#define _pcre2_match_iterator_init   PCRE2_SUFFIX(_pcre2_match_iterator_init_)
+#define _pcre2_match_resume_free     PCRE2_SUFFIX(_pcre2_match_resume_free_)
 #define _pcre2_memctl_malloc         PCRE2_SUFFIX(_pcre2_memctl_malloc_)
+#define _pcre2_mutex_destroy         PCRE2_SUFFIX(_pcre2_mutex_destroy_)
+#define _pcre2_mutex_init            PCRE2_SUFFIX(_pcre2_mutex_init_)
+#define _pcre2_mutex_lock            PCRE2_SUFFIX(_pcre2_mutex_lock_)
+#define _pcre2_mutex_unlock          PCRE2_SUFFIX(_pcre2_mutex_unlock_)
+#define _pcre2_next_char             PCRE2_SUFFIX(_pcre2_next_char_)
 #define _pcre2_ord2utf               PCRE2_SUFFIX(_pcre2_ord2utf_)
 #define _pcre2_script_run            PCRE2_SUFFIX(_pcre2_script_run_)
 #define _pcre2_strcmp                PCRE2_SUFFIX(_pcre2_strcmp_)
@@ -2003,24 +2119,46 @@ is available. */
 #define _pcre2_strncmp               PCRE2_SUFFIX(_pcre2_strncmp_)
 #define _pcre2_strncmp_c8            PCRE2_SUFFIX(_pcre2_strncmp_c8_)
 #define _pcre2_study                 PCRE2_SUFFIX(_pcre2_study_)
+#define _pcre2_thread_create         PCRE2_SUFFIX(_pcre2_thread_create_)
+#define _pcre2_thread_join           PCRE2_SUFFIX(_pcre2_thread_join_)
 #define _pcre2_valid_utf             PCRE2_SUFFIX(_pcre2_valid_utf_)
 #define _pcre2_was_newline           PCRE2_SUFFIX(_pcre2_was_newline_)
 #define _pcre2_xclass                PCRE2_SUFFIX(_pcre2_xclass_)
 
 extern int          _pcre2_auto_possessify(PCRE2_UCHAR *,
                       const compile_block *);
+extern bitparallel *_pcre2_bitparallel_build(PCRE2_SPTR, const compile_block *,
+                      pcre2_memctl *);
+extern BOOL         _pcre2_bitparallel_match(const pcre2_real_code *,
+                      PCRE2_SPTR, PCRE2_SIZE, PCRE2_SIZE, uint32_t);
 extern int          _pcre2_check_escape(PCRE2_SPTR *, PCRE2_SPTR, uint32_t *,
                       int *, uint32_t, uint32_t, BOOL, compile_block *);
+extern uint64_t     _pcre2_clock_usec(void);
 extern PCRE2_SPTR   _pcre2_extuni(uint32_t, PCRE2_SPTR, PCRE2_SPTR, PCRE2_SPTR,
                       BOOL, int *);
 extern PCRE2_SPTR   _pcre2_find_bracket(PCRE2_SPTR, BOOL, int);
+extern PCRE2_SPTR   _pcre2_find_start_bits(PCRE2_SPTR, PCRE2_SPTR,
+                      const uint8_t *, const uint8_t *, uint32_t);
+extern PCRE2_SPTR   _pcre2_find_string(PCRE2_SPTR, PCRE2_SPTR, PCRE2_SPTR,
+                      PCRE2_SIZE);
+extern PCRE2_SPTR   _pcre2_find_string_set(PCRE2_SPTR, PCRE2_SPTR, PCRE2_SPTR,
+                      uint32_t, uint32_t);
 extern BOOL         _pcre2_is_newline(PCRE2_SPTR, uint32_t, PCRE2_SPTR,
                       uint32_t *, BOOL);
 extern void         _pcre2_jit_free_rodata(void *, void *);
 extern void         _pcre2_jit_free(void *, pcre2_memctl *);
 extern size_t       _pcre2_jit_get_size(void *);
 const char *        _pcre2_jit_get_target(void);
+extern int          _pcre2_match_cached(const pcre2_code *, PCRE2_SPTR,
+                      PCRE2_SIZE, PCRE2_SIZE, uint32_t, pcre2_match_data *,
+                      pcre2_match_context *, match_cache *);
+extern void         _pcre2_match_iterator_init(pcre2_real_match_iterator *,
+                      const pcre2_code *, PCRE2_SPTR, PCRE2_SIZE, PCRE2_SIZE,
+                      uint32_t);
+extern void         _pcre2_match_resume_free(pcre2_match_data *);
 extern void *       _pcre2_memctl_malloc(size_t, pcre2_memctl *);
+extern PCRE2_SIZE   _pcre2_next_char(const pcre2_real_code *, PCRE2_SPTR,
+                      PCRE2_SIZE, PCRE2_SIZE, BOOL);
 extern unsigned int _pcre2_ord2utf(uint32_t, PCRE2_UCHAR *);
 extern BOOL         _pcre2_script_run(PCRE2_SPTR, PCRE2_SPTR, BOOL);
 extern int          _pcre2_strcmp(PCRE2_SPTR, PCRE2_SPTR);
@@ -2035,6 +2173,22 @@ extern BOOL         _pcre2_was_newline(PCRE2_SPTR, uint32_t, PCRE2_SPTR,
                       uint32_t *, BOOL);
 extern BOOL         _pcre2_xclass(uint32_t, PCRE2_SPTR, BOOL);
 
+/* These functions exist only when thread support is enabled. */
+
+#ifdef SUPPORT_THREADS
+extern void         _pcre2_cond_broadcast(thread_cond *);
+extern void         _pcre2_cond_destroy(thread_cond *);
+extern BOOL         _pcre2_cond_init(thread_cond *);
+extern void         _pcre2_cond_wait(thread_cond *, thread_mutex *);
+extern void         _pcre2_mutex_destroy(thread_mutex *);
+extern BOOL         _pcre2_mutex_init(thread_mutex *);
+extern void         _pcre2_mutex_lock(thread_mutex *);
+extern void         _pcre2_mutex_unlock(thread_mutex *);
+extern BOOL         _pcre2_thread_create(thread_handle *, thread_function,
+                      void *);
+extern void         _pcre2_thread_join(thread_handle);
+#endif
+
 /* This function is needed only when memmove() is not available. */
 
 #if !defined(VPCOMPAT) && !defined(HAVE_MEMMOVE)
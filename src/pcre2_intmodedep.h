@@ -590,6 +590,9 @@ typedef struct pcre2_real_match_context {
   uint32_t heap_limit;
   uint32_t match_limit;
   uint32_t depth_limit;
+  uint32_t memo_limit;
+  uint32_t step_limit;
+  uint32_t deadline;
 } pcre2_real_match_context;
 
 /* The real convert context structure. */
@@ -619,6 +622,7 @@ typedef struct pcre2_real_code {
   pcre2_memctl memctl;            /* Memory control fields */
   const uint8_t *tables;          /* The character tables */
   void    *executable_jit;        /* Pointer to JIT code */
+  void    *bitparallel;           /* Pointer to bit-parallel matcher */
   uint8_t  start_bitmap[32];      /* Bitmap for starting code unit < 256 */
   CODE_BLOCKSIZE_TYPE blocksize;  /* Total (bytes) that was malloc-ed */
   uint32_t magic_number;          /* Paranoid and endianness check */
@@ -629,6 +633,7 @@ typedef struct pcre2_real_code {
   uint32_t limit_heap;            /* Limit set in the pattern */
   uint32_t limit_match;           /* Limit set in the pattern */
   uint32_t limit_depth;           /* Limit set in the pattern */
+  uint32_t engines;               /* Fallback engines chosen at compile time */
   uint32_t first_codeunit;        /* Starting code unit */
   uint32_t last_codeunit;         /* This codeunit must be seen */
   uint16_t bsr_convention;        /* What \R matches */
@@ -639,6 +644,13 @@ typedef struct pcre2_real_code {
   uint16_t top_backref;           /* Highest numbered back reference */
   uint16_t name_entry_size;       /* Size (code units) of table entries */
   uint16_t name_count;            /* Number of name entries in the table */
+  uint16_t req_literal_length;    /* Length of required literal, or 0 */
+  PCRE2_UCHAR req_literal[REQ_LITERAL_MAX];  /* Required literal string */
+  uint8_t  start_literal_count;    /* Number of starting literals, or 0 */
+  uint8_t  start_literal_length;   /* Length of each starting literal */
+  PCRE2_UCHAR start_literals[START_LITERALS_MAX * START_LITERAL_LENGTH];
+  uint8_t  start_range_count;      /* Number of start_bitmap ranges, or 0 */
+  uint8_t  start_ranges[2 * START_RANGES_MAX];  /* First and last of each */
 } pcre2_real_code;
 
 /* The real match data structure. Define ovector as large as it can ever
@@ -647,7 +659,15 @@ structure is obtained by calling pcre2_match_data_create(), which sets the size
 as the offset of ovector plus a pair of elements for each capturable string, so
 the size varies from call to call. As the maximum number of capturing
 subpatterns is 65535 we must allow for 65536 strings to include the overall
-match. (See also the heapframe structure below.) */
+match. (See also the heapframe structure below.)
+
+The heapframes field points to a vector of backtracking frames that
+pcre2_match() obtained from the heap when its initial vector on the stack was
+too small. It is kept in the match data block so that it can be re-used by
+subsequent matches, unless it is bigger than heapframes_limit. The resume field
+points to the saved state of a match that was suspended after using up its
+step limit, or is NULL. The statistics block is filled in by each match only
+when it has been enabled by pcre2_set_match_data_statistics(). */
 
 typedef struct pcre2_real_match_data {
   pcre2_memctl     memctl;
@@ -661,6 +681,14 @@ typedef struct pcre2_real_match_data {
   uint8_t          flags;         /* Various flags */
   uint16_t         oveccount;     /* Number of pairs */
   int              rc;            /* The return code from the match */
+  struct heapframe *heapframes;   /* Retained backtracking frames vector */
+  PCRE2_SIZE       heapframes_size;  /* Size of the vector (bytes) */
+  uint32_t         heapframes_limit; /* Largest vector to retain (KiB) */
+  struct match_resume *resume;    /* Suspended match, or NULL */
+  pcre2_match_statistics statistics; /* Valid if PCRE2_MD_STATISTICS is set */
+  PCRE2_SIZE      *profile;       /* Opcode execution counts, or NULL */
+  PCRE2_SIZE       profile_size;  /* Number of counts allocated */
+  PCRE2_SIZE       profile_length; /* Number of counts for the last match */
   PCRE2_SIZE       ovector[131072]; /* Must be last in the structure */
 } pcre2_real_match_data;
 
@@ -763,6 +791,179 @@ typedef struct pcre2_real_jit_stack {
   void* stack;
 } pcre2_real_jit_stack;
 
+/* Structures for a pattern set. The source of each pattern is kept in a single
+text vector so that the set can be recompiled when more patterns are added,
+together with the literal string, if any, that every match of the pattern must
+contain. When compiled, the patterns are combined into one or more "chunks",
+each of which contains a pattern for pcre2_match() and one for
+pcre2_dfa_match(). A pattern that has a required literal is compiled as a chunk
+on its own, which is run only if a prefilter finds its literal in the subject.
+The other patterns are combined into as few chunks as possible; more than one
+is used only if the combined pattern is too big for the link size or has too
+many capturing groups.
+
+The prefilter is an Aho-Corasick automaton for all the required literals. Each
+state has a sorted vector of transitions, and a list of the chunks whose
+literals end at the state. The transitions from the initial state for code
+units less than 256 are also kept in a table. */
+
+typedef struct pattern_set_item {
+  PCRE2_SIZE offset;              /* Offset of the pattern in the text */
+  PCRE2_SIZE length;              /* Length of the pattern */
+  PCRE2_SIZE literal_offset;      /* Offset of the required literal */
+  uint32_t   literal_length;      /* Length of the required literal, or 0 */
+  uint32_t   options;             /* Options for this pattern */
+} pattern_set_item;
+
+typedef struct pattern_set_chunk {
+  pcre2_real_code *code;          /* Combined pattern for pcre2_match() */
+  pcre2_real_code *dfa_code;      /* Combined pattern for pcre2_dfa_match() */
+  uint32_t first;                 /* Index of the first pattern id in ids */
+  uint32_t count;                 /* Number of patterns */
+} pattern_set_chunk;
+
+typedef struct pattern_set_state {
+  uint32_t fail;                  /* State to use when there is no transition */
+  uint32_t dict;                  /* Next state on the fail chain with output */
+  uint32_t trans;                 /* Index of the first transition */
+  uint32_t trans_count;           /* Number of transitions */
+  uint32_t out;                   /* Index of the first output chunk */
+  uint32_t out_count;             /* Number of output chunks */
+} pattern_set_state;
+
+typedef struct pattern_set_trans {
+  uint32_t c;                     /* Code unit */
+  uint32_t next;                  /* Next state */
+} pattern_set_trans;
+
+typedef struct pcre2_real_pattern_set {
+  pcre2_memctl memctl;            /* Memory control fields */
+  pcre2_real_compile_context ccontext;  /* Copy of the compile context */
+  uint32_t options;               /* Compile options for every pattern */
+  uint32_t pattern_count;         /* Number of patterns in the set */
+  uint32_t pattern_size;          /* Number of slots in patterns */
+  uint32_t chunk_count;           /* Number of compiled chunks */
+  uint32_t literal_chunk;         /* First chunk that is run by the prefilter */
+  BOOL compiled;                  /* TRUE when the chunks are up to date */
+  pattern_set_item *patterns;     /* Vector of patterns */
+  pattern_set_chunk *chunks;      /* Vector of compiled chunks */
+  uint32_t *ids;                  /* Pattern ids in chunk order */
+  pattern_set_state *states;      /* Prefilter states, or NULL */
+  pattern_set_trans *trans;       /* Prefilter transitions */
+  uint32_t *outputs;              /* Prefilter output chunks */
+  uint32_t root[256];             /* Transitions from the initial state */
+  PCRE2_UCHAR *text;              /* Source of all the patterns */
+  PCRE2_SIZE text_used;           /* Code units used in text */
+  PCRE2_SIZE text_size;           /* Code units available in text */
+} pcre2_real_pattern_set;
+
+/* Structure for a stream. The subject data that may still be needed is kept
+in the buffer. All the offsets except length and size are stream offsets, that
+is, offsets from the start of all the data that has been fed. */
+
+typedef struct pcre2_real_stream {
+  pcre2_memctl memctl;            /* Memory control fields */
+  const pcre2_real_code *code;    /* The pattern */
+  PCRE2_UCHAR *buffer;            /* Retained data */
+  PCRE2_SIZE size;                /* Code units available in buffer */
+  PCRE2_SIZE length;              /* Code units used in buffer */
+  PCRE2_SIZE base;                /* Stream offset of buffer[0] */
+  PCRE2_SIZE usable;              /* End of checked, complete characters */
+  PCRE2_SIZE search;              /* Where the next search starts */
+  PCRE2_SIZE partial_start;       /* Start of an outstanding DFA partial */
+  PCRE2_SIZE restart;             /* Where that partial match continues */
+  int *workspace;                 /* DFA workspace */
+  PCRE2_SIZE wscount;             /* Size of workspace in ints */
+  uint32_t options;               /* Options from pcre2_stream_create() */
+  uint32_t flags;                 /* Private flags */
+} pcre2_real_stream;
+
+/* Structure for the positions that the start of match optimizations in
+pcre2_match() have found in a subject, kept between the calls that a match
+iterator makes on the same subject. It also records whether the caller wants
+only the offsets of the whole match, in which case the interpreter can leave
+captures out of its backtracking frames, and it may set a limit on where a
+match may start, which works like an offset limit, but without the need for
+PCRE2_USE_OFFSET_LIMIT, because it is used only by the interpreter. */
+
+typedef struct match_cache {
+  PCRE2_SPTR end_subject;         /* The end of the subject they refer to */
+  PCRE2_SPTR last_start;          /* Where the last search finished */
+  PCRE2_SPTR first_cu;            /* First code unit found by memchr() */
+  PCRE2_SPTR first_cu2;           /* Other case of first code unit found */
+  PCRE2_SPTR req_cu;              /* Required code unit found */
+  PCRE2_SPTR req_lit;             /* Required literal found */
+  PCRE2_SPTR bumpalong_limit;     /* Last starting point, or NULL */
+  BOOL no_captures;               /* Captured substrings are not wanted */
+} match_cache;
+
+/* Structure for a match iterator, which finds the successive matches in one
+subject in the same way as pcre2test's /g option. Each search is normally done
+by pcre2_match(), but pcre2_match_parallel() replaces it with a function that
+can use the results of searches that were done in advance. */
+
+typedef struct pcre2_real_match_iterator {
+  pcre2_memctl memctl;            /* Memory control fields */
+  const pcre2_real_code *code;    /* The pattern */
+  PCRE2_SPTR subject;             /* The subject */
+  PCRE2_SIZE length;              /* Its length in code units */
+  PCRE2_SIZE offset;              /* Where the next search starts */
+  PCRE2_SIZE last_start;          /* Start of the previous match */
+  PCRE2_SIZE last_end;            /* End of the previous match */
+  PCRE2_SIZE retry_offset;        /* Where an empty match was last retried */
+  uint32_t options;               /* Options for every match */
+  uint32_t flags;                 /* Private flags */
+  match_cache cache;              /* Positions found by earlier searches */
+  int (*search)(struct pcre2_real_match_iterator *, PCRE2_SIZE, uint32_t,
+    pcre2_match_data *, pcre2_match_context *);  /* Search function or NULL */
+  void *search_data;              /* Data for the search function */
+} pcre2_real_match_iterator;
+
+/* Structures for a match pool, which matches one pattern against many
+subjects using a set of threads that persist from one run to the next. Each
+worker has its own match data, match context, and optional JIT stack. The
+subjects that a worker has still to do are the indexes from next up to end; it
+takes them from the front, while an idle worker may take the back half. */
+
+typedef struct pool_worker {
+  struct pcre2_real_match_pool *pool;  /* The pool it belongs to */
+  pcre2_match_data *match_data;   /* The worker's match data */
+  pcre2_jit_stack *jit_stack;     /* The worker's JIT stack, or NULL */
+  pcre2_real_match_context mcontext;  /* The worker's match context */
+  uint32_t next;                  /* The next subject to match */
+  uint32_t end;                   /* The end of its range of subjects */
+  int matched;                    /* Subjects matched in this run */
+#ifdef SUPPORT_THREADS
+  thread_handle handle;           /* The worker's thread (not worker 0) */
+  thread_mutex mutex;             /* Protects next and end */
+#endif
+} pool_worker;
+
+typedef struct pcre2_real_match_pool {
+  pcre2_memctl memctl;            /* Memory control fields */
+  const pcre2_real_code *code;    /* The pattern */
+  pool_worker *workers;           /* The workers (worker 0 is the caller) */
+  uint32_t worker_count;          /* The number of workers */
+  const PCRE2_SPTR *subjects;     /* The subjects for the current run */
+  const PCRE2_SIZE *lengths;      /* Their lengths, or NULL */
+  uint32_t options;               /* Options for every match */
+  PCRE2_SIZE *results;            /* Where to put the results, or NULL */
+  int (*callback)(uint32_t, int, pcre2_match_data *, void *);
+  void *callback_data;            /* Data for the callback */
+  int error;                      /* Error for the lowest failing subject */
+  uint32_t error_index;           /* The index of that subject */
+  int stop;                       /* Non-zero value from the callback; set
+                                     with every worker's lock held */
+#ifdef SUPPORT_THREADS
+  thread_mutex mutex;             /* Protects the fields below and above */
+  thread_cond start;              /* Signalled when a run starts */
+  thread_cond done;               /* Signalled when a worker finishes */
+  uint32_t generation;            /* Incremented for each run */
+  uint32_t active;                /* Threads still working on this run */
+  BOOL shutdown;                  /* The pool is being freed */
+#endif
+} pcre2_real_match_pool;
+
 /* Structure for items in a linked list that represents an explicit recursive
 call within the pattern when running pcre2_dfa_match(). */
 
@@ -849,6 +1050,29 @@ typedef struct heapframe_align {
 
 #define HEAPFRAME_ALIGNMENT offsetof(heapframe_align, frame)
 
+/* Structure for a bit-parallel matcher, built by pcre2_compile() for a short
+pattern that describes a regular language. Each bit stands for one position
+(a single-character item) in the pattern. The masks table gives the positions
+that each code unit can match, with entry 256 covering all wider code units.
+The follow table gives the positions that may follow any set of positions, as
+the union of one entry for each byte of the set. The structure is obtained
+with a size that holds only the follow entries that are needed. */
+
+typedef struct bitparallel {
+  size_t   size;                  /* Total size in bytes */
+  uint64_t first;                 /* Positions that can start a match */
+  uint64_t last;                  /* Positions that can end a match */
+  uint64_t loops;                 /* Positions that can follow themselves */
+  uint32_t chunks;                /* Number of bytes of positions */
+  uint32_t nllen;                 /* Newline length for $ and \Z */
+  uint32_t nl[2];                 /* Newline for $ and \Z */
+  uint8_t  shift;                 /* TRUE if follow is a shift plus loops */
+  uint8_t  start_anchor;          /* OP_CIRC, OP_SOD, OP_SOM, or 0 */
+  uint8_t  end_anchor;            /* OP_DOLL, OP_EOD, OP_EODN, or 0 */
+  uint64_t masks[257];            /* Positions that each code unit matches */
+  uint64_t follow[8 * 256];       /* Must be last in the structure */
+} bitparallel;
+
 /* Structure for passing "static" information around between the functions
 doing traditional NFA matching (pcre2_match() and friends). */
 
@@ -858,10 +1082,20 @@ typedef struct match_block {
   heapframe *match_frames;        /* Points to vector of frames */
   heapframe *match_frames_top;    /* Points after the end of the vector */
   heapframe *stack_frames;        /* The original vector on the stack */
+  pcre2_real_match_data *match_data;  /* Owner of a heap frames vector */
   PCRE2_SIZE heap_limit;          /* As it says */
   uint32_t match_limit;           /* As it says */
   uint32_t match_limit_depth;     /* As it says */
   uint32_t match_call_count;      /* Number of times a new frame is created */
+  uint32_t steps_left;            /* Steps before suspension, or 0 */
+  PCRE2_SIZE suspend_offset;      /* Frame to resume at, or PCRE2_UNSET */
+  uint32_t deadline_countdown;    /* Steps before the clock is read, or 0 */
+  uint64_t deadline;              /* Clock time at which to give up */
+  pcre2_match_statistics *stats;  /* Statistics to collect, or NULL */
+  PCRE2_SIZE *profile;            /* Opcode execution counts, or NULL */
+  uint32_t memo_count;            /* Number of memoized groups */
+  PCRE2_SPTR *memo_groups;        /* Sorted vector of memoized group opcodes */
+  uint8_t *memo_bits;             /* Failed (group, offset) bits, or NULL */
   BOOL hitend;                    /* Hit the end of the subject at some point */
   BOOL hasthen;                   /* Pattern contains (*THEN) */
   BOOL allowemptypartial;         /* Allow empty hard partial */
@@ -902,6 +1136,29 @@ typedef struct match_block {
 /* A similar structure is used for the same purpose by the DFA matching
 functions. */
 
+/* Structures for the pcre2_dfa_match() transition cache. Each cached state
+records a top-level state list (as offset/count pairs in the pool) and, for
+each code unit value less than 256, the number of the state that follows, or a
+negative value if the next step must be processed normally. */
+
+typedef struct dfa_lazy_state {
+  uint32_t list;                  /* Offset of state list in the pool */
+  uint32_t count;                 /* Number of states in the list */
+  uint32_t hash;                  /* Hash value of the list */
+  int32_t next[256];              /* Transitions */
+} dfa_lazy_state;
+
+typedef struct dfa_lazy_cache {
+  dfa_lazy_state *states;         /* Vector of cached states */
+  int32_t *hashtab;               /* Hash table of state numbers */
+  int *pool;                      /* Saved state lists */
+  uint32_t state_count;           /* Number of states in use */
+  uint32_t pool_used;             /* Number of ints used in the pool */
+  uint32_t flushes;               /* Number of times the cache was emptied */
+  uint32_t sizeK;                 /* Size of the whole block in kibibytes */
+  PCRE2_SIZE hits;                /* Characters skipped since last emptied */
+} dfa_lazy_cache;
+
 typedef struct dfa_match_block {
   pcre2_memctl memctl;            /* For general use */
   PCRE2_SPTR start_code;          /* Start of the compiled pattern */
@@ -927,8 +1184,56 @@ typedef struct dfa_match_block {
   void *callout_data;             /* To pass back to callouts */
   int (*callout)(pcre2_callout_block *,void *);  /* Callout function or NULL */
   dfa_recursion_info *recursive;  /* Linked list of recursion data */
+  uint32_t *state_index;          /* Duplicate state index, or NULL */
+  uint32_t state_index_stamp;     /* Current stamp for the index */
+  PCRE2_SIZE code_length;         /* Code units in the compiled pattern */
+  dfa_lazy_cache *lazy;           /* Transition cache, or NULL */
+  uint32_t lazy_countdown;        /* Top-level steps before cache is tried */
+  uint32_t steps_left;            /* Steps before suspension, or 0 */
+  uint32_t deadline_countdown;    /* Steps before the clock is read, or 0 */
+  uint64_t deadline;              /* Clock time at which to give up */
+  pcre2_match_statistics *stats;  /* Statistics to collect, or NULL */
+  BOOL resuming;                  /* Continue the suspended top-level state */
+  BOOL suspend_first;             /* Its states are in the first list */
+  BOOL suspend_could_continue;    /* Its partial matching flag */
+  int suspend_count;              /* Its number of states */
+  int suspend_match_count;        /* Its match count so far */
+  int32_t suspend_lazy_next;      /* Its transition cache state */
+  PCRE2_SPTR suspend_ptr;         /* Its position in the subject */
 } dfa_match_block;
 
+/* Structure for saving a match that has been suspended after using up its
+step limit, so that a call with PCRE2_RESUME can continue it. It is kept in
+the match data block, and it owns any memory that the match block points to.
+For the interpreter, the backtracking frames that are in use follow the
+structure in the same memory block; the DFA state lists are in the caller's
+workspace. */
+
+typedef struct match_resume {
+  const pcre2_real_code *code;    /* The arguments of the suspended match */
+  PCRE2_SPTR subject;
+  PCRE2_SIZE length;
+  PCRE2_SIZE start_offset;
+  uint32_t options;
+  int *workspace;                 /* DFA workspace, or NULL */
+  PCRE2_SIZE wscount;             /* Size of the DFA workspace */
+  PCRE2_SPTR start_match;         /* Bumpalong loop variables */
+  PCRE2_SPTR end_subject;
+  PCRE2_SPTR req_cu_ptr;
+  PCRE2_SPTR req_lit_ptr;
+  PCRE2_SPTR start_partial;
+  PCRE2_SPTR match_partial;
+  PCRE2_SPTR memchr_found_first_cu;
+  PCRE2_SPTR memchr_found_first_cu2;
+  uint32_t fragment_options;
+  PCRE2_SIZE frames_size;         /* Size of the saved frames */
+  pcre2_callout_block cb;         /* The callout block */
+  union {
+    match_block mb;               /* For pcre2_match() */
+    dfa_match_block dmb;          /* For pcre2_dfa_match() */
+  } u;
+} match_resume;
+
 #endif  /* PCRE2_PCRE2TEST */
 
 /* End of pcre2_intmodedep.h */
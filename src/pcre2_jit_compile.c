@@ -78,6 +78,16 @@ allocator->free(ptr, allocator->memory_data);
 
 #include "sljit/sljitLir.c"
 
+/* Writing a perf map for the generated code (PCRE2_JIT_PERF_MAP) is supported
+only on Linux, where the perf tool reads /tmp/perf-<pid>.map. The directory can
+be changed by setting PCRE2_JIT_PERF_MAP_DIR, for example for testing. */
+
+#if defined(__linux__)
+#define JIT_PERF_MAP
+#include <stdio.h>
+#include <unistd.h>
+#endif
+
 #if defined SLJIT_CONFIG_UNSUPPORTED && SLJIT_CONFIG_UNSUPPORTED
 #error Unsupported architecture
 #endif
@@ -186,8 +196,10 @@ typedef struct jit_arguments {
   int (*callout)(pcre2_callout_block *, void *);
   void *callout_data;
   /* Everything else after. */
+  uint64_t deadline;
   sljit_uw offset_limit;
   sljit_u32 limit_match;
+  sljit_u32 limit_extra;
   sljit_u32 oveccount;
   sljit_u32 options;
 } jit_arguments;
@@ -210,6 +222,7 @@ typedef struct jump_list {
 typedef struct stub_list {
   struct sljit_jump *start;
   struct sljit_label *quit;
+  jump_list **helper;
   struct stub_list *next;
 } stub_list;
 
@@ -585,6 +598,14 @@ typedef struct compare_context {
 #define POSSESSIVE1      (3 * sizeof(sljit_sw))
 /* Max limit of recursions. */
 #define LIMIT_MATCH      (4 * sizeof(sljit_sw))
+/* Part of the match limit handed out after the first chunk, and the
+start of the match attempt that it was handed out to. These two must be
+adjacent, since do_limit_check() receives a pointer to them. */
+#define LIMIT_USED       (5 * sizeof(sljit_sw))
+#define LIMIT_START      (6 * sizeof(sljit_sw))
+/* Return address and saved registers of the limit check helper. */
+#define LIMIT_RETURN     (7 * sizeof(sljit_sw))
+#define LIMIT_SAVED(i)   ((8 + (i)) * sizeof(sljit_sw))
 /* The output vector is stored on the stack, and contains pointers
 to characters. The vector data is divided into two groups: the first
 group contains the start / end character pointers, and the second is
@@ -3098,7 +3119,7 @@ if (list_item)
   }
 }
 
-static void add_stub(compiler_common *common, struct sljit_jump *start)
+static void add_stub(compiler_common *common, jump_list **helper, struct sljit_jump *start)
 {
 DEFINE_COMPILER;
 stub_list *list_item = sljit_alloc_memory(compiler, sizeof(stub_list));
@@ -3107,6 +3128,7 @@ if (list_item)
   {
   list_item->start = start;
   list_item->quit = LABEL();
+  list_item->helper = helper;
   list_item->next = common->stubs;
   common->stubs = list_item;
   }
@@ -3120,19 +3142,48 @@ stub_list *list_item = common->stubs;
 while (list_item)
   {
   JUMPHERE(list_item->start);
-  add_jump(compiler, &common->stackalloc, JUMP(SLJIT_FAST_CALL));
+  add_jump(compiler, list_item->helper, JUMP(SLJIT_FAST_CALL));
   JUMPTO(SLJIT_JUMP, list_item->quit);
   list_item = list_item->next;
   }
 common->stubs = NULL;
 }
 
+static sljit_sw SLJIT_FUNC do_limit_check(jit_arguments *arguments, sljit_uw *locals, PCRE2_SPTR start)
+{
+/* Called when COUNT_MATCH reaches zero and the rest of the match limit is
+handed out in chunks, which happens only when a deadline is set. The locals
+array holds LIMIT_USED and LIMIT_START; a new match attempt is recognized by
+its start, so the match code does not have to reset anything. Returns with
+the new value of COUNT_MATCH, 0 for the match limit or -1 when the deadline
+has passed. */
+
+sljit_uw count;
+
+if (locals[1] != (sljit_uw)start)
+  {
+  locals[0] = 0;
+  locals[1] = (sljit_uw)start;
+  }
+
+count = arguments->limit_extra - locals[0];
+if (count == 0)
+  return 0;
+if (count > DEADLINE_CHECK_INTERVAL)
+  count = DEADLINE_CHECK_INTERVAL;
+locals[0] += count;
+
+if (PRIV(clock_usec)() >= arguments->deadline)
+  return -1;
+return (sljit_sw)count;
+}
+
 static SLJIT_INLINE void count_match(compiler_common *common)
 {
 DEFINE_COMPILER;
 
 OP2(SLJIT_SUB | SLJIT_SET_Z, COUNT_MATCH, 0, COUNT_MATCH, 0, SLJIT_IMM, 1);
-add_jump(compiler, &common->calllimit, JUMP(SLJIT_ZERO));
+add_stub(common, &common->calllimit, JUMP(SLJIT_ZERO));
 }
 
 static SLJIT_INLINE void allocate_stack(compiler_common *common, int size)
@@ -3149,7 +3200,7 @@ OP1(SLJIT_MOV, RETURN_ADDR, 0, TMP1, 0);
 OP1(SLJIT_MOV, SLJIT_MEM1(SLJIT_SP), LOCALS0, TMP1, 0);
 OP1(SLJIT_MOV, SLJIT_MEM1(SLJIT_SP), LOCALS1, TMP1, 0);
 #endif
-add_stub(common, CMP(SLJIT_LESS, STACK_TOP, 0, STACK_LIMIT, 0));
+add_stub(common, &common->stackalloc, CMP(SLJIT_LESS, STACK_TOP, 0, STACK_LIMIT, 0));
 }
 
 static SLJIT_INLINE void free_stack(compiler_common *common, int size)
@@ -6432,6 +6483,16 @@ if (common->match_end_ptr != 0)
 
 start = LABEL();
 
+#ifdef JIT_HAS_FAST_FORWARD_RANGES_SIMD
+/* The ranges may cover code units that are not in the bitmap, so the code
+unit that is found is checked below, which returns here if it fails. */
+
+if (JIT_HAS_FAST_FORWARD_RANGES_SIMD && common->re->start_range_count > 0
+    && common->re->start_range_count <= FAST_FORWARD_RANGES_MAX)
+  fast_forward_ranges_simd(common, common->re->start_ranges, common->re->start_range_count, FALSE, STR_END,
+    common->mode == PCRE2_JIT_COMPLETE ? &common->failed_match : NULL);
+#endif
+
 partial_quit = CMP(SLJIT_GREATER_EQUAL, STR_PTR, 0, STR_END, 0);
 if (common->mode == PCRE2_JIT_COMPLETE)
   add_jump(compiler, &common->failed_match, partial_quit);
@@ -11428,6 +11489,161 @@ if (common->utf && HAS_EXTRALEN(*cc)) *end += GET_EXTRALEN(*cc);
 return cc;
 }
 
+#ifdef JIT_HAS_FAST_FORWARD_RANGES_SIMD
+
+static int bitset_to_ranges(const sljit_u8 *bitset, sljit_u8 *ranges)
+{
+/* Returns with the number of ranges, or 0 if more than
+FAST_FORWARD_RANGES_MAX ranges are needed. */
+int count = 0;
+int c;
+
+for (c = 0; c < 256; c++)
+  {
+  if ((bitset[c >> 3] & (1 << (c & 0x7))) == 0)
+    continue;
+
+  if (count > 0 && ranges[2 * count - 1] == c - 1)
+    ranges[2 * count - 1] = c;
+  else
+    {
+    if (count >= FAST_FORWARD_RANGES_MAX)
+      return 0;
+    ranges[2 * count] = c;
+    ranges[2 * count + 1] = c;
+    count++;
+    }
+  }
+
+return count;
+}
+
+static BOOL fast_forward_iterator_simd(compiler_common *common, PCRE2_UCHAR type, PCRE2_SPTR cc,
+  sljit_u32 max, jump_list **max_reached)
+{
+/* Skips the code units matched by a single character repeat with vector
+instructions when the set of matching code units, or the set of the others,
+consists of a few ranges. The scan stops before the first code unit which does
+not match, or before STR_END; the caller's loop continues from there. When max
+is not zero, it is the maximum number of code units to match, and the number
+that remains is left in TMP3. */
+DEFINE_COMPILER;
+sljit_u8 bitset[32];
+sljit_u8 ranges[2 * FAST_FORWARD_RANGES_MAX];
+const sljit_u8 *cbits = (const sljit_u8 *)common->ctypes - cbit_length;
+BOOL wide = FALSE;
+BOOL negated = FALSE;
+BOOL outside = TRUE;
+int count;
+int i;
+
+#ifdef SUPPORT_UNICODE
+if (common->utf)
+  return FALSE;
+#endif
+
+memset(bitset, 0, 32);
+
+switch(type)
+  {
+  case OP_NOT:
+  negated = TRUE;
+  /* Fall through */
+  case OP_CHAR:
+#if PCRE2_CODE_UNIT_WIDTH != 8
+  if (cc[0] >= 255)
+    return FALSE;
+#endif
+  bitset[cc[0] >> 3] = 1 << (cc[0] & 0x7);
+  break;
+
+  case OP_ANY:
+  if (common->nltype != NLTYPE_FIXED || common->newline >= 255)
+    return FALSE;
+  bitset[common->newline >> 3] = 1 << (common->newline & 0x7);
+  negated = TRUE;
+  break;
+
+  case OP_NOT_DIGIT:
+  case OP_DIGIT:
+  memcpy(bitset, cbits + cbit_digit, 32);
+  negated = type == OP_NOT_DIGIT;
+  break;
+
+  case OP_NOT_WHITESPACE:
+  case OP_WHITESPACE:
+  memcpy(bitset, cbits + cbit_space, 32);
+  negated = type == OP_NOT_WHITESPACE;
+  break;
+
+  case OP_NOT_WORDCHAR:
+  case OP_WORDCHAR:
+  memcpy(bitset, cbits + cbit_word, 32);
+  negated = type == OP_NOT_WORDCHAR;
+  break;
+
+  case OP_NCLASS:
+  wide = TRUE;
+  /* Fall through */
+  case OP_CLASS:
+  memcpy(bitset, cc, 32);
+  break;
+
+  default:
+  return FALSE;
+  }
+
+if (negated)
+  {
+  for (i = 0; i < 32; i++)
+    bitset[i] = ~bitset[i];
+  wide = !wide;
+  }
+
+#if PCRE2_CODE_UNIT_WIDTH != 8
+/* The 255 bit stands for all wider code units in the ranges. */
+if (((bitset[31] & 0x80) != 0) != wide)
+  return FALSE;
+#else
+SLJIT_UNUSED_ARG(wide);
+#endif
+
+count = bitset_to_ranges(bitset, ranges);
+if (count == 0)
+  {
+  /* Search for the first code unit which does not match instead. */
+  for (i = 0; i < 32; i++)
+    bitset[i] = ~bitset[i];
+  count = bitset_to_ranges(bitset, ranges);
+  outside = FALSE;
+  if (count == 0)
+    return FALSE;
+  }
+
+if (max == 0)
+  {
+  fast_forward_ranges_simd(common, ranges, count, outside, STR_END, NULL);
+  return TRUE;
+  }
+
+OP1(SLJIT_MOV, SLJIT_MEM1(SLJIT_SP), POSSESSIVE1, STR_PTR, 0);
+OP2(SLJIT_ADD, TMP3, 0, STR_PTR, 0, SLJIT_IMM, IN_UCHARS(max));
+OP2U(SLJIT_SUB | SLJIT_SET_GREATER, TMP3, 0, STR_END, 0);
+CMOV(SLJIT_GREATER, TMP3, STR_END, 0);
+
+fast_forward_ranges_simd(common, ranges, count, outside, TMP3, NULL);
+
+OP2(SLJIT_SUB, TMP1, 0, STR_PTR, 0, SLJIT_MEM1(SLJIT_SP), POSSESSIVE1);
+#if PCRE2_CODE_UNIT_WIDTH != 8
+OP2(SLJIT_LSHR, TMP1, 0, TMP1, 0, SLJIT_IMM, UCHAR_SHIFT);
+#endif
+OP2(SLJIT_SUB | SLJIT_SET_Z, TMP3, 0, SLJIT_IMM, max, TMP1, 0);
+add_jump(compiler, max_reached, JUMP(SLJIT_ZERO));
+return TRUE;
+}
+
+#endif /* JIT_HAS_FAST_FORWARD_RANGES_SIMD */
+
 static PCRE2_SPTR compile_iterator_matchingpath(compiler_common *common, PCRE2_SPTR cc, backtrack_common *parent)
 {
 DEFINE_COMPILER;
@@ -11450,6 +11666,7 @@ int base = (private_data_ptr == 0) ? SLJIT_MEM1(STACK_TOP) : SLJIT_MEM1(SLJIT_SP
 int offset0 = (private_data_ptr == 0) ? STACK(0) : private_data_ptr;
 int offset1 = (private_data_ptr == 0) ? STACK(1) : private_data_ptr + (int)sizeof(sljit_sw);
 int tmp_base, tmp_offset;
+BOOL vector_skip;
 #if defined SUPPORT_UNICODE && PCRE2_CODE_UNIT_WIDTH != 32
 BOOL use_tmp;
 #endif
@@ -11737,7 +11954,12 @@ switch(opcode)
     if (common->utf)
       OP1(SLJIT_MOV, use_tmp ? TMP3 : base, use_tmp ? 0 : offset0, STR_PTR, 0);
 #endif
-    if (opcode == OP_UPTO)
+    vector_skip = FALSE;
+#ifdef JIT_HAS_FAST_FORWARD_RANGES_SIMD
+    if (JIT_HAS_FAST_FORWARD_RANGES_SIMD)
+      vector_skip = fast_forward_iterator_simd(common, type, cc, opcode == OP_UPTO ? max : 0, &no_match);
+#endif
+    if (opcode == OP_UPTO && !vector_skip)
       OP1(SLJIT_MOV, tmp_base, tmp_offset, SLJIT_IMM, max);
 
     detect_partial_match(common, &no_match);
@@ -11854,6 +12076,11 @@ switch(opcode)
     }
 #endif
 
+#ifdef JIT_HAS_FAST_FORWARD_RANGES_SIMD
+  if (JIT_HAS_FAST_FORWARD_RANGES_SIMD)
+    fast_forward_iterator_simd(common, type, cc, 0, NULL);
+#endif
+
   detect_partial_match(common, &no_match);
   label = LABEL();
   compile_char1_matchingpath(common, type, cc, &no_char1_match, FALSE);
@@ -11907,7 +12134,13 @@ switch(opcode)
     break;
     }
 
-  OP1(SLJIT_MOV, tmp_base, tmp_offset, SLJIT_IMM, max);
+  vector_skip = FALSE;
+#ifdef JIT_HAS_FAST_FORWARD_RANGES_SIMD
+  if (JIT_HAS_FAST_FORWARD_RANGES_SIMD)
+    vector_skip = fast_forward_iterator_simd(common, type, cc, max, &no_match);
+#endif
+  if (!vector_skip)
+    OP1(SLJIT_MOV, tmp_base, tmp_offset, SLJIT_IMM, max);
 
   detect_partial_match(common, &no_match);
   label = LABEL();
@@ -13685,7 +13918,87 @@ OP_SRC(SLJIT_FAST_RETURN, TMP2, 0);
 #undef CURRENT_AS
 
 #define PUBLIC_JIT_COMPILE_CONFIGURATION_OPTIONS \
-  (PCRE2_JIT_INVALID_UTF)
+  (PCRE2_JIT_INVALID_UTF|PCRE2_JIT_PERF_MAP)
+
+/* The generated code is split into these regions in a perf map. Each starts
+at a label that is set only when a map is wanted; the first starts at the
+beginning of the code and the last ends at its end. */
+
+enum { PERF_ENTRY, PERF_START, PERF_MATCH, PERF_ACCEPT, PERF_BACKTRACK,
+       PERF_RETRY, PERF_RECURSE, PERF_HELPERS, PERF_REGIONS };
+
+#ifdef JIT_PERF_MAP
+static const char *perf_region_names[PERF_REGIONS] = {
+  "entry",      /* Function entry and argument loading */
+  "start",      /* Finding a starting position (fast forward) */
+  "match",      /* Matching path of the pattern */
+  "accept",     /* Setting the ovector after a match */
+  "backtrack",  /* Backtracking path of the pattern */
+  "retry",      /* Advancing to the next starting position */
+  "recurse",    /* Recursions and subroutine calls */
+  "helpers"     /* Shared helper routines */
+};
+
+/*************************************************
+*         Write perf map entries for code        *
+*************************************************/
+
+/* Each region of the code is added to /tmp/perf-<pid>.map as a symbol whose
+name includes a hash of the compiled pattern, so that the same pattern has the
+same name in every process. The entries are written with a single call so that
+entries from concurrent compilations are not interleaved. Failure to write the
+map is ignored.
+
+If PCRE2_JIT_PERF_MAP_DIR is set, the map is written in that directory instead
+of /tmp. The variable is ignored in setuid and setgid programs, and nothing is
+written if its value is too long.
+
+Arguments:
+  re          the compiled pattern
+  mode        the JIT compile mode
+  addrs       start addresses of the regions, plus the end of the code
+
+Returns:      nothing
+*/
+
+static void
+write_perf_map(pcre2_real_code *re, sljit_u32 mode, sljit_uw *addrs)
+{
+char filename[256];
+char buffer[PERF_REGIONS * 80];
+const char *dir = getenv("PCRE2_JIT_PERF_MAP_DIR");
+char *p = buffer;
+const uint8_t *code = (const uint8_t *)re + sizeof(pcre2_real_code);
+const uint8_t *end = (const uint8_t *)re + re->blocksize;
+const char *mode_name = (mode == PCRE2_JIT_COMPLETE)? "complete" :
+  (mode == PCRE2_JIT_PARTIAL_SOFT)? "partial_soft" : "partial_hard";
+uint32_t hash = 2166136261u;  /* FNV-1a */
+FILE *f;
+int i;
+
+for (; code < end; code++) hash = (hash ^ *code) * 16777619u;
+hash ^= re->overall_options;
+
+for (i = 0; i < PERF_REGIONS; i++)
+  {
+  if (addrs[i + 1] <= addrs[i]) continue;
+  p += sprintf(p, "%lx %lx pcre2:%08x:%s:%s\n", (unsigned long)addrs[i],
+    (unsigned long)(addrs[i + 1] - addrs[i]), hash, mode_name,
+    perf_region_names[i]);
+  }
+
+if (dir == NULL || *dir == 0 || getuid() != geteuid() ||
+    getgid() != getegid())
+  dir = "/tmp";
+else if (strlen(dir) > sizeof(filename) - 32) return;
+
+sprintf(filename, "%s/perf-%d.map", dir, (int)getpid());
+f = fopen(filename, "a");
+if (f == NULL) return;
+(void)fwrite(buffer, 1, p - buffer, f);
+fclose(f);
+}
+#endif  /* JIT_PERF_MAP */
 
 static int jit_compile(pcre2_code *code, sljit_u32 mode)
 {
@@ -13712,7 +14025,10 @@ struct sljit_jump *jump;
 struct sljit_jump *minlength_check_failed = NULL;
 struct sljit_jump *empty_match = NULL;
 struct sljit_jump *end_anchor_failed = NULL;
+struct sljit_jump *no_chunks;
 jump_list *reqcu_not_found = NULL;
+struct sljit_label *perf_labels[PERF_REGIONS];
+BOOL perf_map = (mode & PCRE2_JIT_PERF_MAP) != 0;
 
 SLJIT_ASSERT(tables);
 
@@ -13808,7 +14124,7 @@ else
 ccend = bracketend(common->start);
 
 /* Calculate the local space size on the stack. */
-common->ovector_start = LIMIT_MATCH + sizeof(sljit_sw);
+common->ovector_start = LIMIT_SAVED(5);
 common->optimized_cbracket = (sljit_u8 *)SLJIT_MALLOC(re->top_bracket + 1, allocator_data);
 if (!common->optimized_cbracket)
   return PCRE2_ERROR_NOMEMORY;
@@ -13939,6 +14255,7 @@ OP1(SLJIT_MOV, STACK_TOP, 0, SLJIT_MEM1(TMP2), SLJIT_OFFSETOF(struct sljit_stack
 OP1(SLJIT_MOV, STACK_LIMIT, 0, SLJIT_MEM1(TMP2), SLJIT_OFFSETOF(struct sljit_stack, start));
 OP2(SLJIT_ADD, TMP1, 0, TMP1, 0, SLJIT_IMM, 1);
 OP1(SLJIT_MOV, SLJIT_MEM1(SLJIT_SP), LIMIT_MATCH, TMP1, 0);
+OP1(SLJIT_MOV, SLJIT_MEM1(SLJIT_SP), LIMIT_START, SLJIT_IMM, 0);
 
 if (common->early_fail_start_ptr < common->early_fail_end_ptr)
   reset_early_fail(common);
@@ -13951,6 +14268,7 @@ if (common->control_head_ptr != 0)
   OP1(SLJIT_MOV, SLJIT_MEM1(SLJIT_SP), common->control_head_ptr, SLJIT_IMM, 0);
 
 /* Main part of the matching */
+if (perf_map) perf_labels[PERF_START] = LABEL();
 if ((re->overall_options & PCRE2_ANCHORED) == 0)
   {
   mainloop_label = mainloop_entry(common);
@@ -14002,6 +14320,7 @@ if (mode == PCRE2_JIT_PARTIAL_SOFT)
 else if (mode == PCRE2_JIT_PARTIAL_HARD)
   OP1(SLJIT_MOV, SLJIT_MEM1(SLJIT_SP), common->start_used_ptr, STR_PTR, 0);
 
+if (perf_map) perf_labels[PERF_MATCH] = LABEL();
 compile_matchingpath(common, common->start, ccend, &rootbacktrack);
 if (SLJIT_UNLIKELY(sljit_get_compiler_error(compiler)))
   {
@@ -14011,6 +14330,7 @@ if (SLJIT_UNLIKELY(sljit_get_compiler_error(compiler)))
   PRIV(jit_free_rodata)(common->read_only_data_head, allocator_data);
   return PCRE2_ERROR_NOMEMORY;
   }
+if (perf_map) perf_labels[PERF_ACCEPT] = LABEL();
 
 if ((re->overall_options & PCRE2_ENDANCHORED) != 0)
   end_anchor_failed = CMP(SLJIT_NOT_EQUAL, STR_PTR, 0, STR_END, 0);
@@ -14058,6 +14378,7 @@ if (mode != PCRE2_JIT_COMPLETE)
 
 if (common->might_be_empty)
   empty_match_backtrack_label = LABEL();
+if (perf_map) perf_labels[PERF_BACKTRACK] = LABEL();
 compile_backtrackingpath(common, rootbacktrack.top);
 if (SLJIT_UNLIKELY(sljit_get_compiler_error(compiler)))
   {
@@ -14070,6 +14391,7 @@ if (SLJIT_UNLIKELY(sljit_get_compiler_error(compiler)))
 
 SLJIT_ASSERT(rootbacktrack.prev == NULL);
 reset_match_label = LABEL();
+perf_labels[PERF_RETRY] = reset_match_label;
 
 if (mode == PCRE2_JIT_PARTIAL_SOFT)
   {
@@ -14138,6 +14460,7 @@ if (common->might_be_empty)
   JUMPTO(SLJIT_JUMP, empty_match_backtrack_label);
   }
 
+if (perf_map) perf_labels[PERF_RECURSE] = LABEL();
 common->fast_forward_bc_ptr = NULL;
 common->early_fail_start_ptr = 0;
 common->early_fail_end_ptr = 0;
@@ -14184,6 +14507,7 @@ common->quit_label = quit_label;
 
 /* Allocating stack, returns with PCRE_ERROR_JIT_STACKLIMIT if fails. */
 /* This is a (really) rare case. */
+if (perf_map) perf_labels[PERF_HELPERS] = LABEL();
 set_jumps(common->stackalloc, LABEL());
 /* RETURN_ADDR is not a saved register. */
 sljit_emit_fast_enter(compiler, SLJIT_MEM1(SLJIT_SP), LOCALS0);
@@ -14211,8 +14535,40 @@ JUMPHERE(jump);
 OP1(SLJIT_MOV, SLJIT_RETURN_REG, 0, SLJIT_IMM, PCRE2_ERROR_JIT_STACKLIMIT);
 JUMPTO(SLJIT_JUMP, common->quit_label);
 
-/* Call limit reached. */
+/* Call limit chunk used up. Without a deadline the whole limit is the first
+chunk, so the match limit has been reached and the clock is not read. */
 set_jumps(common->calllimit, LABEL());
+sljit_emit_fast_enter(compiler, SLJIT_MEM1(SLJIT_SP), LIMIT_RETURN);
+OP1(SLJIT_MOV, SLJIT_MEM1(SLJIT_SP), LIMIT_SAVED(0), SLJIT_R0, 0);
+OP1(SLJIT_MOV, SLJIT_R0, 0, ARGUMENTS, 0);
+OP1(SLJIT_MOV_U32, SLJIT_R0, 0, SLJIT_MEM1(SLJIT_R0), SLJIT_OFFSETOF(jit_arguments, limit_extra));
+no_chunks = CMP(SLJIT_EQUAL, SLJIT_R0, 0, SLJIT_IMM, 0);
+OP1(SLJIT_MOV, SLJIT_MEM1(SLJIT_SP), LIMIT_SAVED(1), SLJIT_R1, 0);
+OP1(SLJIT_MOV, SLJIT_MEM1(SLJIT_SP), LIMIT_SAVED(2), SLJIT_R2, 0);
+OP1(SLJIT_MOV, SLJIT_MEM1(SLJIT_SP), LIMIT_SAVED(3), SLJIT_R3, 0);
+OP1(SLJIT_MOV, SLJIT_MEM1(SLJIT_SP), LIMIT_SAVED(4), SLJIT_R4, 0);
+
+OP1(SLJIT_MOV, SLJIT_R0, 0, ARGUMENTS, 0);
+GET_LOCAL_BASE(SLJIT_R1, 0, LIMIT_USED);
+OP1(SLJIT_MOV, SLJIT_R2, 0, SLJIT_MEM1(SLJIT_SP), common->start_ptr);
+sljit_emit_icall(compiler, SLJIT_CALL, SLJIT_ARGS3(W, W, W, W), SLJIT_IMM, SLJIT_FUNC_ADDR(do_limit_check));
+
+jump = CMP(SLJIT_SIG_LESS_EQUAL, SLJIT_RETURN_REG, 0, SLJIT_IMM, 0);
+OP1(SLJIT_MOV, COUNT_MATCH, 0, SLJIT_RETURN_REG, 0);
+OP1(SLJIT_MOV, SLJIT_R0, 0, SLJIT_MEM1(SLJIT_SP), LIMIT_SAVED(0));
+OP1(SLJIT_MOV, SLJIT_R1, 0, SLJIT_MEM1(SLJIT_SP), LIMIT_SAVED(1));
+OP1(SLJIT_MOV, SLJIT_R2, 0, SLJIT_MEM1(SLJIT_SP), LIMIT_SAVED(2));
+OP1(SLJIT_MOV, SLJIT_R3, 0, SLJIT_MEM1(SLJIT_SP), LIMIT_SAVED(3));
+OP1(SLJIT_MOV, SLJIT_R4, 0, SLJIT_MEM1(SLJIT_SP), LIMIT_SAVED(4));
+OP_SRC(SLJIT_FAST_RETURN, SLJIT_MEM1(SLJIT_SP), LIMIT_RETURN);
+
+/* Match limit reached or deadline passed. */
+JUMPHERE(jump);
+jump = CMP(SLJIT_EQUAL, SLJIT_RETURN_REG, 0, SLJIT_IMM, 0);
+OP1(SLJIT_MOV, SLJIT_RETURN_REG, 0, SLJIT_IMM, PCRE2_ERROR_DEADLINE);
+JUMPTO(SLJIT_JUMP, common->quit_label);
+JUMPHERE(jump);
+JUMPHERE(no_chunks);
 OP1(SLJIT_MOV, SLJIT_RETURN_REG, 0, SLJIT_IMM, PCRE2_ERROR_MATCHLIMIT);
 JUMPTO(SLJIT_JUMP, common->quit_label);
 
@@ -14316,6 +14672,22 @@ SLJIT_FREE(common->private_data_ptrs, allocator_data);
 
 executable_func = sljit_generate_code(compiler);
 executable_size = sljit_get_generated_code_size(compiler);
+
+#ifdef JIT_PERF_MAP
+if (perf_map && executable_func != NULL)
+  {
+  sljit_uw addrs[PERF_REGIONS + 1];
+  int i;
+  addrs[PERF_ENTRY] = (sljit_uw)SLJIT_FUNC_ADDR(executable_func);
+  for (i = PERF_ENTRY + 1; i < PERF_REGIONS; i++)
+    addrs[i] = sljit_get_label_addr(perf_labels[i]);
+  addrs[PERF_REGIONS] = addrs[PERF_ENTRY] + executable_size;
+  write_perf_map(re, mode, addrs);
+  }
+#else
+(void)perf_labels;
+#endif
+
 sljit_free_compiler(compiler);
 
 if (executable_func == NULL)
@@ -14375,7 +14747,8 @@ Returns:        0: success or (*NOJIT) was used
 */
 
 #define PUBLIC_JIT_COMPILE_OPTIONS \
-  (PCRE2_JIT_COMPLETE|PCRE2_JIT_PARTIAL_SOFT|PCRE2_JIT_PARTIAL_HARD|PCRE2_JIT_INVALID_UTF)
+  (PCRE2_JIT_COMPLETE|PCRE2_JIT_PARTIAL_SOFT|PCRE2_JIT_PARTIAL_HARD|PCRE2_JIT_INVALID_UTF|\
+   PCRE2_JIT_PERF_MAP)
 
 PCRE2_EXP_DEFN int PCRE2_CALL_CONVENTION
 pcre2_jit_compile(pcre2_code *code, uint32_t options)
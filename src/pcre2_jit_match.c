@@ -136,6 +136,7 @@ if (mcontext != NULL)
   arguments.offset_limit = mcontext->offset_limit;
   arguments.limit_match = (mcontext->match_limit < re->limit_match)?
     mcontext->match_limit : re->limit_match;
+  arguments.deadline = mcontext->deadline;
   if (mcontext->jit_callback != NULL)
     jit_stack = mcontext->jit_callback(mcontext->jit_callback_data);
   else
@@ -148,9 +149,24 @@ else
   arguments.offset_limit = PCRE2_UNSET;
   arguments.limit_match = (MATCH_LIMIT < re->limit_match)?
     MATCH_LIMIT : re->limit_match;
+  arguments.deadline = 0;
   jit_stack = NULL;
   }
 
+/* With a deadline, the match limit is counted down in chunks so that the clock
+can be read between them. The first chunk is the limit itself otherwise. */
+
+arguments.limit_extra = 0;
+if (arguments.deadline != 0)
+  {
+  arguments.deadline += PRIV(clock_usec)();
+  if (arguments.limit_match >= DEADLINE_CHECK_INTERVAL)
+    {
+    arguments.limit_extra = arguments.limit_match - (DEADLINE_CHECK_INTERVAL - 1);
+    arguments.limit_match = DEADLINE_CHECK_INTERVAL - 1;
+    }
+  }
+
 
 max_oveccount = functions->top_bracket;
 if (oveccount > max_oveccount)
@@ -178,6 +194,17 @@ match_data->rightchar = 0;
 match_data->mark = arguments.mark_ptr;
 match_data->matchedby = PCRE2_MATCHEDBY_JIT;
 
+/* The JIT code does not count what it does, so only the engine is recorded in
+the statistics, and there is no opcode profile. */
+
+match_data->profile_length = 0;
+
+if ((match_data->flags & PCRE2_MD_STATISTICS) != 0)
+  {
+  memset(&match_data->statistics, 0, sizeof(pcre2_match_statistics));
+  match_data->statistics.engine = PCRE2_ENGINE_JIT;
+  }
+
 return match_data->rc;
 
 #endif  /* SUPPORT_JIT */
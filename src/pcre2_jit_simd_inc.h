@@ -99,16 +99,68 @@ return (sljit_s32)(value);
 #endif
 }
 
-static void load_from_mem_sse2(struct sljit_compiler *compiler, sljit_s32 dst_xmm_reg, sljit_s32 src_general_reg, sljit_s8 offset)
+/* The fast forward functions use 16 byte SSE2 vectors, or 32 byte AVX2 vectors
+when the CPU supports them. The AVX2 form of each instruction that combines two
+registers uses the destination as the first source, so it has the same effect
+as the SSE2 form on each half of the vector. Only xmm0-xmm7 (ymm0-ymm7) and the
+first eight general registers are used, so no REX prefixes are needed. The
+upper halves of the ymm registers must be cleared (vzeroupper) before leaving
+AVX2 code, to avoid penalties in code that uses SSE instructions. */
+
+static SLJIT_INLINE sljit_s32 get_vector_size(void)
+{
+return sljit_has_cpu_feature(SLJIT_HAS_AVX2) ? 32 : 16;
+}
+
+static void emit_vector_op(struct sljit_compiler *compiler, sljit_s32 vector_size, sljit_u8 opcode, sljit_s32 reg, sljit_s32 rm)
+{
+sljit_u8 instruction[4];
+sljit_s32 src1 = reg;
+
+SLJIT_ASSERT(reg < 8 && rm < 8);
+
+if (vector_size == 16)
+  {
+  instruction[0] = 0x66;
+  instruction[1] = 0x0f;
+  }
+else
+  {
+  /* MOVD, MOVDQA and PMOVMSKB have no second source (vvvv is 1111b).
+  MOVD only has a 128 bit form. */
+  if (opcode == 0x6e || opcode == 0x6f || opcode == 0xd7)
+    src1 = 0;
+
+  /* Two byte VEX prefix: R = 1, vvvv = ~src1, L = 1 (256 bit), pp = 01 (66) */
+  instruction[0] = 0xc5;
+  instruction[1] = 0x80 | ((~src1 & 0xf) << 3) | (opcode == 0x6e ? 0 : 0x4) | 0x1;
+  }
+
+instruction[2] = opcode;
+instruction[3] = 0xc0 | (reg << 3) | rm;
+sljit_emit_op_custom(compiler, instruction, 4);
+}
+
+static void load_from_mem_vector(struct sljit_compiler *compiler, sljit_s32 vector_size, sljit_s32 dst_xmm_reg, sljit_s32 src_general_reg, sljit_s8 offset)
 {
 sljit_u8 instruction[5];
+BOOL aligned = ((sljit_u8)offset & (vector_size - 1)) == 0;
 
 SLJIT_ASSERT(dst_xmm_reg < 8);
 SLJIT_ASSERT(src_general_reg < 8);
 
-/* MOVDQA xmm1, xmm2/m128 */
-instruction[0] = ((sljit_u8)offset & 0xf) == 0 ? 0x66 : 0xf3;
-instruction[1] = 0x0f;
+/* MOVDQA / MOVDQU xmm1, xmm2/m128 */
+if (vector_size == 16)
+  {
+  instruction[0] = aligned ? 0x66 : 0xf3;
+  instruction[1] = 0x0f;
+  }
+else
+  {
+  /* VMOVDQA / VMOVDQU ymm1, ymm2/m256 */
+  instruction[0] = 0xc5;
+  instruction[1] = aligned ? 0xfd : 0xfe;
+  }
 instruction[2] = 0x6f;
 
 if (offset == 0)
@@ -123,13 +175,48 @@ instruction[4] = (sljit_u8)offset;
 sljit_emit_op_custom(compiler, instruction, 5);
 }
 
-static void fast_forward_char_pair_sse2_compare(struct sljit_compiler *compiler, vector_compare_type compare_type,
-  int step, sljit_s32 dst_ind, sljit_s32 cmp1_ind, sljit_s32 cmp2_ind, sljit_s32 tmp_ind)
+static void broadcast_vector(struct sljit_compiler *compiler, sljit_s32 vector_size, sljit_s32 xmm_reg)
 {
-sljit_u8 instruction[4];
-instruction[0] = 0x66;
-instruction[1] = 0x0f;
+sljit_u8 instruction[5];
 
+if (vector_size == 16)
+  {
+  /* PSHUFD xmm1, xmm2/m128, imm8 */
+  instruction[0] = 0x66;
+  instruction[1] = 0x0f;
+  instruction[2] = 0x70;
+  instruction[3] = 0xc0 | (xmm_reg << 3) | xmm_reg;
+  instruction[4] = 0;
+  sljit_emit_op_custom(compiler, instruction, 5);
+  return;
+  }
+
+/* VPBROADCASTD ymm1, xmm2/m32 */
+instruction[0] = 0xc4;
+instruction[1] = 0xe2;
+instruction[2] = 0x7d;
+instruction[3] = 0x58;
+instruction[4] = 0xc0 | (xmm_reg << 3) | xmm_reg;
+sljit_emit_op_custom(compiler, instruction, 5);
+}
+
+static void leave_vector_code(struct sljit_compiler *compiler, sljit_s32 vector_size)
+{
+sljit_u8 instruction[3];
+
+if (vector_size == 16)
+  return;
+
+/* VZEROUPPER */
+instruction[0] = 0xc5;
+instruction[1] = 0xf8;
+instruction[2] = 0x77;
+sljit_emit_op_custom(compiler, instruction, 3);
+}
+
+static void fast_forward_char_pair_vector_compare(struct sljit_compiler *compiler, sljit_s32 vector_size,
+  vector_compare_type compare_type, int step, sljit_s32 dst_ind, sljit_s32 cmp1_ind, sljit_s32 cmp2_ind, sljit_s32 tmp_ind)
+{
 SLJIT_ASSERT(step >= 0 && step <= 3);
 
 if (compare_type != vector_compare_match2)
@@ -139,11 +226,7 @@ if (compare_type != vector_compare_match2)
     if (compare_type == vector_compare_match1i)
       {
       /* POR xmm1, xmm2/m128 */
-      /* instruction[0] = 0x66; */
-      /* instruction[1] = 0x0f; */
-      instruction[2] = 0xeb;
-      instruction[3] = 0xc0 | (dst_ind << 3) | cmp2_ind;
-      sljit_emit_op_custom(compiler, instruction, 4);
+      emit_vector_op(compiler, vector_size, 0xeb, dst_ind, cmp2_ind);
       }
     return;
     }
@@ -152,11 +235,7 @@ if (compare_type != vector_compare_match2)
     return;
 
   /* PCMPEQB/W/D xmm1, xmm2/m128 */
-  /* instruction[0] = 0x66; */
-  /* instruction[1] = 0x0f; */
-  instruction[2] = 0x74 + SSE2_COMPARE_TYPE_INDEX;
-  instruction[3] = 0xc0 | (dst_ind << 3) | cmp1_ind;
-  sljit_emit_op_custom(compiler, instruction, 4);
+  emit_vector_op(compiler, vector_size, 0x74 + SSE2_COMPARE_TYPE_INDEX, dst_ind, cmp1_ind);
   return;
   }
 
@@ -164,38 +243,22 @@ switch (step)
   {
   case 0:
   /* MOVDQA xmm1, xmm2/m128 */
-  /* instruction[0] = 0x66; */
-  /* instruction[1] = 0x0f; */
-  instruction[2] = 0x6f;
-  instruction[3] = 0xc0 | (tmp_ind << 3) | dst_ind;
-  sljit_emit_op_custom(compiler, instruction, 4);
+  emit_vector_op(compiler, vector_size, 0x6f, tmp_ind, dst_ind);
   return;
 
   case 1:
   /* PCMPEQB/W/D xmm1, xmm2/m128 */
-  /* instruction[0] = 0x66; */
-  /* instruction[1] = 0x0f; */
-  instruction[2] = 0x74 + SSE2_COMPARE_TYPE_INDEX;
-  instruction[3] = 0xc0 | (dst_ind << 3) | cmp1_ind;
-  sljit_emit_op_custom(compiler, instruction, 4);
+  emit_vector_op(compiler, vector_size, 0x74 + SSE2_COMPARE_TYPE_INDEX, dst_ind, cmp1_ind);
   return;
 
   case 2:
   /* PCMPEQB/W/D xmm1, xmm2/m128 */
-  /* instruction[0] = 0x66; */
-  /* instruction[1] = 0x0f; */
-  instruction[2] = 0x74 + SSE2_COMPARE_TYPE_INDEX;
-  instruction[3] = 0xc0 | (tmp_ind << 3) | cmp2_ind;
-  sljit_emit_op_custom(compiler, instruction, 4);
+  emit_vector_op(compiler, vector_size, 0x74 + SSE2_COMPARE_TYPE_INDEX, tmp_ind, cmp2_ind);
   return;
 
   case 3:
   /* POR xmm1, xmm2/m128 */
-  /* instruction[0] = 0x66; */
-  /* instruction[1] = 0x0f; */
-  instruction[2] = 0xeb;
-  instruction[3] = 0xc0 | (dst_ind << 3) | tmp_ind;
-  sljit_emit_op_custom(compiler, instruction, 4);
+  emit_vector_op(compiler, vector_size, 0xeb, dst_ind, tmp_ind);
   return;
   }
 }
@@ -213,6 +276,7 @@ struct sljit_label *restart;
 struct sljit_jump *quit;
 struct sljit_jump *partial_quit[2];
 vector_compare_type compare_type = vector_compare_match1;
+sljit_s32 vector_size = get_vector_size();
 sljit_s32 tmp1_reg_ind = sljit_get_register_index(TMP1);
 sljit_s32 str_ptr_reg_ind = sljit_get_register_index(STR_PTR);
 sljit_s32 data_ind = 0;
@@ -247,54 +311,38 @@ OP1(SLJIT_MOV, TMP1, 0, SLJIT_IMM, character_to_int32(char1 | bit));
 SLJIT_ASSERT(tmp1_reg_ind < 8);
 
 /* MOVD xmm, r/m32 */
-instruction[0] = 0x66;
-instruction[1] = 0x0f;
-instruction[2] = 0x6e;
-instruction[3] = 0xc0 | (cmp1_ind << 3) | tmp1_reg_ind;
-sljit_emit_op_custom(compiler, instruction, 4);
+emit_vector_op(compiler, vector_size, 0x6e, cmp1_ind, tmp1_reg_ind);
 
 if (char1 != char2)
   {
   OP1(SLJIT_MOV, TMP1, 0, SLJIT_IMM, character_to_int32(bit != 0 ? bit : char2));
 
   /* MOVD xmm, r/m32 */
-  instruction[3] = 0xc0 | (cmp2_ind << 3) | tmp1_reg_ind;
-  sljit_emit_op_custom(compiler, instruction, 4);
+  emit_vector_op(compiler, vector_size, 0x6e, cmp2_ind, tmp1_reg_ind);
   }
 
 OP1(SLJIT_MOV, TMP2, 0, STR_PTR, 0);
 
-/* PSHUFD xmm1, xmm2/m128, imm8 */
-/* instruction[0] = 0x66; */
-/* instruction[1] = 0x0f; */
-instruction[2] = 0x70;
-instruction[3] = 0xc0 | (cmp1_ind << 3) | cmp1_ind;
-instruction[4] = 0;
-sljit_emit_op_custom(compiler, instruction, 5);
-
-if (char1 != char2)
-  {
-  /* PSHUFD xmm1, xmm2/m128, imm8 */
-  instruction[3] = 0xc0 | (cmp2_ind << 3) | cmp2_ind;
-  sljit_emit_op_custom(compiler, instruction, 5);
-  }
+/* The broadcasts are repeated after a restart, because the upper halves of
+the registers are cleared when AVX2 code is left. */
 
 #if defined SUPPORT_UNICODE && PCRE2_CODE_UNIT_WIDTH != 32
 restart = LABEL();
 #endif
-OP2(SLJIT_AND, STR_PTR, 0, STR_PTR, 0, SLJIT_IMM, ~0xf);
-OP2(SLJIT_AND, TMP2, 0, TMP2, 0, SLJIT_IMM, 0xf);
 
-load_from_mem_sse2(compiler, data_ind, str_ptr_reg_ind, 0);
+broadcast_vector(compiler, vector_size, cmp1_ind);
+if (char1 != char2)
+  broadcast_vector(compiler, vector_size, cmp2_ind);
+
+OP2(SLJIT_AND, STR_PTR, 0, STR_PTR, 0, SLJIT_IMM, ~(vector_size - 1));
+OP2(SLJIT_AND, TMP2, 0, TMP2, 0, SLJIT_IMM, vector_size - 1);
+
+load_from_mem_vector(compiler, vector_size, data_ind, str_ptr_reg_ind, 0);
 for (i = 0; i < 4; i++)
-  fast_forward_char_pair_sse2_compare(compiler, compare_type, i, data_ind, cmp1_ind, cmp2_ind, tmp_ind);
+  fast_forward_char_pair_vector_compare(compiler, vector_size, compare_type, i, data_ind, cmp1_ind, cmp2_ind, tmp_ind);
 
 /* PMOVMSKB reg, xmm */
-/* instruction[0] = 0x66; */
-/* instruction[1] = 0x0f; */
-instruction[2] = 0xd7;
-instruction[3] = 0xc0 | (tmp1_reg_ind << 3) | data_ind;
-sljit_emit_op_custom(compiler, instruction, 4);
+emit_vector_op(compiler, vector_size, 0xd7, tmp1_reg_ind, data_ind);
 
 OP2(SLJIT_ADD, STR_PTR, 0, STR_PTR, 0, TMP2, 0);
 OP2(SLJIT_LSHR, TMP1, 0, TMP1, 0, TMP2, 0);
@@ -306,26 +354,23 @@ OP2(SLJIT_SUB, STR_PTR, 0, STR_PTR, 0, TMP2, 0);
 /* Second part (aligned) */
 start = LABEL();
 
-OP2(SLJIT_ADD, STR_PTR, 0, STR_PTR, 0, SLJIT_IMM, 16);
+OP2(SLJIT_ADD, STR_PTR, 0, STR_PTR, 0, SLJIT_IMM, vector_size);
 
 partial_quit[1] = CMP(SLJIT_GREATER_EQUAL, STR_PTR, 0, STR_END, 0);
-if (common->mode == PCRE2_JIT_COMPLETE)
+if (common->mode == PCRE2_JIT_COMPLETE && vector_size == 16)
   add_jump(compiler, &common->failed_match, partial_quit[1]);
 
-load_from_mem_sse2(compiler, data_ind, str_ptr_reg_ind, 0);
+load_from_mem_vector(compiler, vector_size, data_ind, str_ptr_reg_ind, 0);
 for (i = 0; i < 4; i++)
-  fast_forward_char_pair_sse2_compare(compiler, compare_type, i, data_ind, cmp1_ind, cmp2_ind, tmp_ind);
+  fast_forward_char_pair_vector_compare(compiler, vector_size, compare_type, i, data_ind, cmp1_ind, cmp2_ind, tmp_ind);
 
 /* PMOVMSKB reg, xmm */
-/* instruction[0] = 0x66; */
-/* instruction[1] = 0x0f; */
-instruction[2] = 0xd7;
-instruction[3] = 0xc0 | (tmp1_reg_ind << 3) | data_ind;
-sljit_emit_op_custom(compiler, instruction, 4);
+emit_vector_op(compiler, vector_size, 0xd7, tmp1_reg_ind, data_ind);
 
 CMPTO(SLJIT_ZERO, TMP1, 0, SLJIT_IMM, 0, start);
 
 JUMPHERE(quit);
+leave_vector_code(compiler, vector_size);
 
 /* BSF r32, r/m32 */
 instruction[0] = 0x0f;
@@ -337,14 +382,33 @@ OP2(SLJIT_ADD, STR_PTR, 0, STR_PTR, 0, TMP1, 0);
 
 if (common->mode != PCRE2_JIT_COMPLETE)
   {
+  if (vector_size != 16)
+    {
+    quit = JUMP(SLJIT_JUMP);
+    JUMPHERE(partial_quit[1]);
+    leave_vector_code(compiler, vector_size);
+    JUMPHERE(quit);
+    }
+  else
+    JUMPHERE(partial_quit[1]);
   JUMPHERE(partial_quit[0]);
-  JUMPHERE(partial_quit[1]);
   OP2U(SLJIT_SUB | SLJIT_SET_GREATER, STR_PTR, 0, STR_END, 0);
   CMOV(SLJIT_GREATER, STR_PTR, STR_END, 0);
   }
 else
+  {
   add_jump(compiler, &common->failed_match, CMP(SLJIT_GREATER_EQUAL, STR_PTR, 0, STR_END, 0));
 
+  if (vector_size != 16)
+    {
+    quit = JUMP(SLJIT_JUMP);
+    JUMPHERE(partial_quit[1]);
+    leave_vector_code(compiler, vector_size);
+    add_jump(compiler, &common->failed_match, JUMP(SLJIT_JUMP));
+    JUMPHERE(quit);
+    }
+  }
+
 #if defined SUPPORT_UNICODE && PCRE2_CODE_UNIT_WIDTH != 32
 if (common->utf && offset > 0)
   {
@@ -372,8 +436,10 @@ DEFINE_COMPILER;
 sljit_u8 instruction[8];
 struct sljit_label *start;
 struct sljit_jump *quit;
+struct sljit_jump *loop_quit;
 jump_list *not_found = NULL;
 vector_compare_type compare_type = vector_compare_match1;
+sljit_s32 vector_size = get_vector_size();
 sljit_s32 tmp1_reg_ind = sljit_get_register_index(TMP1);
 sljit_s32 str_ptr_reg_ind = sljit_get_register_index(STR_PTR);
 sljit_s32 data_ind = 0;
@@ -406,51 +472,31 @@ OP1(SLJIT_MOV, TMP1, 0, SLJIT_IMM, character_to_int32(char1 | bit));
 SLJIT_ASSERT(tmp1_reg_ind < 8);
 
 /* MOVD xmm, r/m32 */
-instruction[0] = 0x66;
-instruction[1] = 0x0f;
-instruction[2] = 0x6e;
-instruction[3] = 0xc0 | (cmp1_ind << 3) | tmp1_reg_ind;
-sljit_emit_op_custom(compiler, instruction, 4);
+emit_vector_op(compiler, vector_size, 0x6e, cmp1_ind, tmp1_reg_ind);
 
 if (char1 != char2)
   {
   OP1(SLJIT_MOV, TMP1, 0, SLJIT_IMM, character_to_int32(bit != 0 ? bit : char2));
 
   /* MOVD xmm, r/m32 */
-  instruction[3] = 0xc0 | (cmp2_ind << 3) | tmp1_reg_ind;
-  sljit_emit_op_custom(compiler, instruction, 4);
+  emit_vector_op(compiler, vector_size, 0x6e, cmp2_ind, tmp1_reg_ind);
   }
 
 OP1(SLJIT_MOV, STR_PTR, 0, TMP2, 0);
 
-/* PSHUFD xmm1, xmm2/m128, imm8 */
-/* instruction[0] = 0x66; */
-/* instruction[1] = 0x0f; */
-instruction[2] = 0x70;
-instruction[3] = 0xc0 | (cmp1_ind << 3) | cmp1_ind;
-instruction[4] = 0;
-sljit_emit_op_custom(compiler, instruction, 5);
-
+broadcast_vector(compiler, vector_size, cmp1_ind);
 if (char1 != char2)
-  {
-  /* PSHUFD xmm1, xmm2/m128, imm8 */
-  instruction[3] = 0xc0 | (cmp2_ind << 3) | cmp2_ind;
-  sljit_emit_op_custom(compiler, instruction, 5);
-  }
+  broadcast_vector(compiler, vector_size, cmp2_ind);
 
-OP2(SLJIT_AND, STR_PTR, 0, STR_PTR, 0, SLJIT_IMM, ~0xf);
-OP2(SLJIT_AND, TMP2, 0, TMP2, 0, SLJIT_IMM, 0xf);
+OP2(SLJIT_AND, STR_PTR, 0, STR_PTR, 0, SLJIT_IMM, ~(vector_size - 1));
+OP2(SLJIT_AND, TMP2, 0, TMP2, 0, SLJIT_IMM, vector_size - 1);
 
-load_from_mem_sse2(compiler, data_ind, str_ptr_reg_ind, 0);
+load_from_mem_vector(compiler, vector_size, data_ind, str_ptr_reg_ind, 0);
 for (i = 0; i < 4; i++)
-  fast_forward_char_pair_sse2_compare(compiler, compare_type, i, data_ind, cmp1_ind, cmp2_ind, tmp_ind);
+  fast_forward_char_pair_vector_compare(compiler, vector_size, compare_type, i, data_ind, cmp1_ind, cmp2_ind, tmp_ind);
 
 /* PMOVMSKB reg, xmm */
-/* instruction[0] = 0x66; */
-/* instruction[1] = 0x0f; */
-instruction[2] = 0xd7;
-instruction[3] = 0xc0 | (tmp1_reg_ind << 3) | data_ind;
-sljit_emit_op_custom(compiler, instruction, 4);
+emit_vector_op(compiler, vector_size, 0xd7, tmp1_reg_ind, data_ind);
 
 OP2(SLJIT_ADD, STR_PTR, 0, STR_PTR, 0, TMP2, 0);
 OP2(SLJIT_LSHR, TMP1, 0, TMP1, 0, TMP2, 0);
@@ -462,24 +508,23 @@ OP2(SLJIT_SUB, STR_PTR, 0, STR_PTR, 0, TMP2, 0);
 /* Second part (aligned) */
 start = LABEL();
 
-OP2(SLJIT_ADD, STR_PTR, 0, STR_PTR, 0, SLJIT_IMM, 16);
+OP2(SLJIT_ADD, STR_PTR, 0, STR_PTR, 0, SLJIT_IMM, vector_size);
 
-add_jump(compiler, &not_found, CMP(SLJIT_GREATER_EQUAL, STR_PTR, 0, STR_END, 0));
+loop_quit = CMP(SLJIT_GREATER_EQUAL, STR_PTR, 0, STR_END, 0);
+if (vector_size == 16)
+  add_jump(compiler, &not_found, loop_quit);
 
-load_from_mem_sse2(compiler, data_ind, str_ptr_reg_ind, 0);
+load_from_mem_vector(compiler, vector_size, data_ind, str_ptr_reg_ind, 0);
 for (i = 0; i < 4; i++)
-  fast_forward_char_pair_sse2_compare(compiler, compare_type, i, data_ind, cmp1_ind, cmp2_ind, tmp_ind);
+  fast_forward_char_pair_vector_compare(compiler, vector_size, compare_type, i, data_ind, cmp1_ind, cmp2_ind, tmp_ind);
 
 /* PMOVMSKB reg, xmm */
-/* instruction[0] = 0x66; */
-/* instruction[1] = 0x0f; */
-instruction[2] = 0xd7;
-instruction[3] = 0xc0 | (tmp1_reg_ind << 3) | data_ind;
-sljit_emit_op_custom(compiler, instruction, 4);
+emit_vector_op(compiler, vector_size, 0xd7, tmp1_reg_ind, data_ind);
 
 CMPTO(SLJIT_ZERO, TMP1, 0, SLJIT_IMM, 0, start);
 
 JUMPHERE(quit);
+leave_vector_code(compiler, vector_size);
 
 /* BSF r32, r/m32 */
 instruction[0] = 0x0f;
@@ -491,9 +536,187 @@ OP2(SLJIT_ADD, TMP1, 0, TMP1, 0, STR_PTR, 0);
 add_jump(compiler, &not_found, CMP(SLJIT_GREATER_EQUAL, TMP1, 0, STR_END, 0));
 
 OP1(SLJIT_MOV, STR_PTR, 0, TMP3, 0);
+
+if (vector_size != 16)
+  {
+  quit = JUMP(SLJIT_JUMP);
+  JUMPHERE(loop_quit);
+  leave_vector_code(compiler, vector_size);
+  add_jump(compiler, &not_found, JUMP(SLJIT_JUMP));
+  JUMPHERE(quit);
+  }
+
 return not_found;
 }
 
+/* The range searches compare the subject with up to three code unit ranges,
+and find the first code unit that is inside (or outside) all of them. They are
+used to find a code unit in the start bitmap, and to skip the code units that
+match a character repeat. A code unit c is in the range first..last when
+c - first <= last - first as unsigned numbers. SSE2 only has signed
+comparisons, so the top bit of both sides is flipped, which is folded into the
+subtraction. Each range needs two registers, and xmm6 and xmm7 must be
+preserved on Windows, so fewer ranges can be used there. */
+
+#define JIT_HAS_FAST_FORWARD_RANGES_SIMD (sljit_has_cpu_feature(SLJIT_HAS_SSE2))
+
+#ifdef _WIN64
+#define FAST_FORWARD_RANGES_MAX 2
+#else
+#define FAST_FORWARD_RANGES_MAX 3
+#endif
+
+static void fast_forward_ranges_vector_compare(struct sljit_compiler *compiler, sljit_s32 vector_size,
+  sljit_s32 count, BOOL outside, sljit_s32 str_ptr_reg_ind, sljit_s32 tmp1_reg_ind)
+{
+sljit_s32 data_ind = 0;
+sljit_s32 tmp_ind = 1;
+sljit_s32 dst_ind;
+int i;
+
+for (i = 0; i < count; i++)
+  {
+  dst_ind = (i == 0) ? data_ind : tmp_ind;
+  load_from_mem_vector(compiler, vector_size, dst_ind, str_ptr_reg_ind, 0);
+
+  /* PSUBB/W/D xmm1, xmm2/m128 */
+  emit_vector_op(compiler, vector_size, 0xf8 + SSE2_COMPARE_TYPE_INDEX, dst_ind, 2 + 2 * i);
+  /* PCMPGTB/W/D xmm1, xmm2/m128 */
+  emit_vector_op(compiler, vector_size, 0x64 + SSE2_COMPARE_TYPE_INDEX, dst_ind, 3 + 2 * i);
+
+  if (i > 0)
+    {
+    /* PAND xmm1, xmm2/m128 */
+    emit_vector_op(compiler, vector_size, 0xdb, data_ind, tmp_ind);
+    }
+  }
+
+/* PMOVMSKB reg, xmm */
+emit_vector_op(compiler, vector_size, 0xd7, tmp1_reg_ind, data_ind);
+
+/* The mask has a bit set for each byte which is outside all ranges. */
+if (!outside)
+  OP2(SLJIT_XOR32, TMP1, 0, TMP1, 0, SLJIT_IMM, vector_size == 16 ? 0xffff : -1);
+}
+
+/* The ranges are pairs of code units, and a range that ends at 255 includes
+all wider code units. The search stops at str_end, which is a register. If no
+code unit is found before it, the code jumps to not_found, or STR_PTR is set to
+str_end when not_found is NULL. */
+
+static void fast_forward_ranges_simd(compiler_common *common, const sljit_u8 *ranges, sljit_s32 count,
+  BOOL outside, sljit_s32 str_end, jump_list **not_found)
+{
+DEFINE_COMPILER;
+sljit_u8 instruction[8];
+struct sljit_label *start;
+struct sljit_jump *quit;
+struct sljit_jump *partial_quit[2];
+sljit_s32 vector_size = get_vector_size();
+sljit_s32 tmp1_reg_ind = sljit_get_register_index(TMP1);
+sljit_s32 str_ptr_reg_ind = sljit_get_register_index(STR_PTR);
+sljit_u32 sign = (sljit_u32)1 << (PCRE2_CODE_UNIT_WIDTH - 1);
+sljit_u32 first, last;
+int i;
+
+SLJIT_ASSERT(count > 0 && count <= FAST_FORWARD_RANGES_MAX);
+
+partial_quit[0] = CMP(SLJIT_GREATER_EQUAL, STR_PTR, 0, str_end, 0);
+if (not_found != NULL)
+  add_jump(compiler, not_found, partial_quit[0]);
+
+SLJIT_ASSERT(tmp1_reg_ind < 8);
+
+for (i = 0; i < count; i++)
+  {
+  first = ranges[2 * i];
+  last = ranges[2 * i + 1];
+#if PCRE2_CODE_UNIT_WIDTH != 8
+  if (last == 255)
+    last = MAX_NON_UTF_CHAR;
+#endif
+
+  OP1(SLJIT_MOV, TMP1, 0, SLJIT_IMM, character_to_int32((PCRE2_UCHAR)(first ^ sign)));
+  /* MOVD xmm, r/m32 */
+  emit_vector_op(compiler, vector_size, 0x6e, 2 + 2 * i, tmp1_reg_ind);
+
+  OP1(SLJIT_MOV, TMP1, 0, SLJIT_IMM, character_to_int32((PCRE2_UCHAR)((last - first) ^ sign)));
+  /* MOVD xmm, r/m32 */
+  emit_vector_op(compiler, vector_size, 0x6e, 3 + 2 * i, tmp1_reg_ind);
+
+  broadcast_vector(compiler, vector_size, 2 + 2 * i);
+  broadcast_vector(compiler, vector_size, 3 + 2 * i);
+  }
+
+/* First part (unaligned start) */
+
+OP1(SLJIT_MOV, TMP2, 0, STR_PTR, 0);
+OP2(SLJIT_AND, STR_PTR, 0, STR_PTR, 0, SLJIT_IMM, ~(vector_size - 1));
+OP2(SLJIT_AND, TMP2, 0, TMP2, 0, SLJIT_IMM, vector_size - 1);
+
+fast_forward_ranges_vector_compare(compiler, vector_size, count, outside, str_ptr_reg_ind, tmp1_reg_ind);
+
+OP2(SLJIT_ADD, STR_PTR, 0, STR_PTR, 0, TMP2, 0);
+OP2(SLJIT_LSHR, TMP1, 0, TMP1, 0, TMP2, 0);
+
+quit = CMP(SLJIT_NOT_ZERO, TMP1, 0, SLJIT_IMM, 0);
+
+OP2(SLJIT_SUB, STR_PTR, 0, STR_PTR, 0, TMP2, 0);
+
+/* Second part (aligned) */
+start = LABEL();
+
+OP2(SLJIT_ADD, STR_PTR, 0, STR_PTR, 0, SLJIT_IMM, vector_size);
+
+partial_quit[1] = CMP(SLJIT_GREATER_EQUAL, STR_PTR, 0, str_end, 0);
+if (not_found != NULL && vector_size == 16)
+  add_jump(compiler, not_found, partial_quit[1]);
+
+fast_forward_ranges_vector_compare(compiler, vector_size, count, outside, str_ptr_reg_ind, tmp1_reg_ind);
+
+CMPTO(SLJIT_ZERO, TMP1, 0, SLJIT_IMM, 0, start);
+
+JUMPHERE(quit);
+leave_vector_code(compiler, vector_size);
+
+/* BSF r32, r/m32 */
+instruction[0] = 0x0f;
+instruction[1] = 0xbc;
+instruction[2] = 0xc0 | (tmp1_reg_ind << 3) | tmp1_reg_ind;
+sljit_emit_op_custom(compiler, instruction, 3);
+
+OP2(SLJIT_ADD, STR_PTR, 0, STR_PTR, 0, TMP1, 0);
+
+if (not_found == NULL)
+  {
+  if (vector_size != 16)
+    {
+    quit = JUMP(SLJIT_JUMP);
+    JUMPHERE(partial_quit[1]);
+    leave_vector_code(compiler, vector_size);
+    JUMPHERE(quit);
+    }
+  else
+    JUMPHERE(partial_quit[1]);
+  JUMPHERE(partial_quit[0]);
+  OP2U(SLJIT_SUB | SLJIT_SET_GREATER, STR_PTR, 0, str_end, 0);
+  CMOV(SLJIT_GREATER, STR_PTR, str_end, 0);
+  }
+else
+  {
+  add_jump(compiler, not_found, CMP(SLJIT_GREATER_EQUAL, STR_PTR, 0, str_end, 0));
+
+  if (vector_size != 16)
+    {
+    quit = JUMP(SLJIT_JUMP);
+    JUMPHERE(partial_quit[1]);
+    leave_vector_code(compiler, vector_size);
+    add_jump(compiler, not_found, JUMP(SLJIT_JUMP));
+    JUMPHERE(quit);
+    }
+  }
+}
+
 #ifndef _WIN64
 
 #define JIT_HAS_FAST_FORWARD_CHAR_PAIR_SIMD (sljit_has_cpu_feature(SLJIT_HAS_SSE2))
@@ -505,6 +728,7 @@ DEFINE_COMPILER;
 sljit_u8 instruction[8];
 vector_compare_type compare1_type = vector_compare_match1;
 vector_compare_type compare2_type = vector_compare_match1;
+sljit_s32 vector_size = get_vector_size();
 sljit_u32 bit1 = 0;
 sljit_u32 bit2 = 0;
 sljit_u32 diff = IN_UCHARS(offs1 - offs2);
@@ -524,6 +748,7 @@ struct sljit_label *start;
 struct sljit_label *restart;
 #endif
 struct sljit_jump *jump[2];
+struct sljit_jump *loop_quit;
 int i;
 
 SLJIT_ASSERT(common->mode == PCRE2_JIT_COMPLETE && offs1 > offs2);
@@ -545,10 +770,6 @@ OP2(SLJIT_ADD, STR_PTR, 0, STR_PTR, 0, SLJIT_IMM, IN_UCHARS(offs1));
 add_jump(compiler, &common->failed_match, CMP(SLJIT_GREATER_EQUAL, STR_PTR, 0, STR_END, 0));
 
 /* MOVD xmm, r/m32 */
-instruction[0] = 0x66;
-instruction[1] = 0x0f;
-instruction[2] = 0x6e;
-
 if (char1a == char1b)
   OP1(SLJIT_MOV, TMP1, 0, SLJIT_IMM, character_to_int32(char1a));
 else
@@ -569,14 +790,10 @@ else
     }
   }
 
-instruction[3] = 0xc0 | (cmp1a_ind << 3) | tmp1_reg_ind;
-sljit_emit_op_custom(compiler, instruction, 4);
+emit_vector_op(compiler, vector_size, 0x6e, cmp1a_ind, tmp1_reg_ind);
 
 if (char1a != char1b)
-  {
-  instruction[3] = 0xc0 | (cmp1b_ind << 3) | tmp2_reg_ind;
-  sljit_emit_op_custom(compiler, instruction, 4);
-  }
+  emit_vector_op(compiler, vector_size, 0x6e, cmp1b_ind, tmp2_reg_ind);
 
 if (char2a == char2b)
   OP1(SLJIT_MOV, TMP1, 0, SLJIT_IMM, character_to_int32(char2a));
@@ -598,94 +815,91 @@ else
     }
   }
 
-instruction[3] = 0xc0 | (cmp2a_ind << 3) | tmp1_reg_ind;
-sljit_emit_op_custom(compiler, instruction, 4);
+emit_vector_op(compiler, vector_size, 0x6e, cmp2a_ind, tmp1_reg_ind);
 
 if (char2a != char2b)
-  {
-  instruction[3] = 0xc0 | (cmp2b_ind << 3) | tmp2_reg_ind;
-  sljit_emit_op_custom(compiler, instruction, 4);
-  }
+  emit_vector_op(compiler, vector_size, 0x6e, cmp2b_ind, tmp2_reg_ind);
 
-/* PSHUFD xmm1, xmm2/m128, imm8 */
-/* instruction[0] = 0x66; */
-/* instruction[1] = 0x0f; */
-instruction[2] = 0x70;
-instruction[4] = 0;
+/* The broadcasts are repeated after a restart, because the upper halves of
+the registers are cleared when AVX2 code is left. */
 
-instruction[3] = 0xc0 | (cmp1a_ind << 3) | cmp1a_ind;
-sljit_emit_op_custom(compiler, instruction, 5);
+#if defined SUPPORT_UNICODE && PCRE2_CODE_UNIT_WIDTH != 32
+restart = LABEL();
+#endif
+
+broadcast_vector(compiler, vector_size, cmp1a_ind);
 
 if (char1a != char1b)
-  {
-  instruction[3] = 0xc0 | (cmp1b_ind << 3) | cmp1b_ind;
-  sljit_emit_op_custom(compiler, instruction, 5);
-  }
+  broadcast_vector(compiler, vector_size, cmp1b_ind);
 
-instruction[3] = 0xc0 | (cmp2a_ind << 3) | cmp2a_ind;
-sljit_emit_op_custom(compiler, instruction, 5);
+broadcast_vector(compiler, vector_size, cmp2a_ind);
 
 if (char2a != char2b)
-  {
-  instruction[3] = 0xc0 | (cmp2b_ind << 3) | cmp2b_ind;
-  sljit_emit_op_custom(compiler, instruction, 5);
-  }
-
-#if defined SUPPORT_UNICODE && PCRE2_CODE_UNIT_WIDTH != 32
-restart = LABEL();
-#endif
+  broadcast_vector(compiler, vector_size, cmp2b_ind);
 
 OP2(SLJIT_SUB, TMP1, 0, STR_PTR, 0, SLJIT_IMM, diff);
 OP1(SLJIT_MOV, TMP2, 0, STR_PTR, 0);
-OP2(SLJIT_AND, STR_PTR, 0, STR_PTR, 0, SLJIT_IMM, ~0xf);
+OP2(SLJIT_AND, STR_PTR, 0, STR_PTR, 0, SLJIT_IMM, ~(vector_size - 1));
 
-load_from_mem_sse2(compiler, data1_ind, str_ptr_reg_ind, 0);
+load_from_mem_vector(compiler, vector_size, data1_ind, str_ptr_reg_ind, 0);
 
 jump[0] = CMP(SLJIT_GREATER_EQUAL, TMP1, 0, STR_PTR, 0);
 
-load_from_mem_sse2(compiler, data2_ind, str_ptr_reg_ind, -(sljit_s8)diff);
+load_from_mem_vector(compiler, vector_size, data2_ind, str_ptr_reg_ind, -(sljit_s8)diff);
 jump[1] = JUMP(SLJIT_JUMP);
 
 JUMPHERE(jump[0]);
 
-/* MOVDQA xmm1, xmm2/m128 */
-/* instruction[0] = 0x66; */
-/* instruction[1] = 0x0f; */
-instruction[2] = 0x6f;
-instruction[3] = 0xc0 | (data2_ind << 3) | data1_ind;
-sljit_emit_op_custom(compiler, instruction, 4);
+if (vector_size == 16)
+  {
+  /* MOVDQA xmm1, xmm2/m128 */
+  emit_vector_op(compiler, vector_size, 0x6f, data2_ind, data1_ind);
+
+  /* PSLLDQ xmm1, imm8 */
+  instruction[0] = 0x66;
+  instruction[1] = 0x0f;
+  instruction[2] = 0x73;
+  instruction[3] = 0xc0 | (7 << 3) | data2_ind;
+  instruction[4] = diff;
+  sljit_emit_op_custom(compiler, instruction, 5);
+  }
+else
+  {
+  /* The 256 bit byte shift is done in two steps, because VPSLLDQ shifts the
+  two halves separately. */
+
+  /* VPERM2I128 ymm1, ymm2, ymm3/m256, imm8 (low half zero, high half from
+  the low half of data1) */
+  instruction[0] = 0xc4;
+  instruction[1] = 0xe3;
+  instruction[2] = 0x05 | ((~data1_ind & 0xf) << 3);
+  instruction[3] = 0x46;
+  instruction[4] = 0xc0 | (data2_ind << 3) | data1_ind;
+  instruction[5] = 0x08;
+  sljit_emit_op_custom(compiler, instruction, 6);
 
-/* PSLLDQ xmm1, imm8 */
-/* instruction[0] = 0x66; */
-/* instruction[1] = 0x0f; */
-instruction[2] = 0x73;
-instruction[3] = 0xc0 | (7 << 3) | data2_ind;
-instruction[4] = diff;
-sljit_emit_op_custom(compiler, instruction, 5);
+  /* VPALIGNR ymm1, ymm2, ymm3/m256, imm8 */
+  instruction[3] = 0x0f;
+  instruction[4] = 0xc0 | (data2_ind << 3) | data2_ind;
+  instruction[5] = 16 - diff;
+  sljit_emit_op_custom(compiler, instruction, 6);
+  }
 
 JUMPHERE(jump[1]);
 
-OP2(SLJIT_AND, TMP2, 0, TMP2, 0, SLJIT_IMM, 0xf);
+OP2(SLJIT_AND, TMP2, 0, TMP2, 0, SLJIT_IMM, vector_size - 1);
 
 for (i = 0; i < 4; i++)
   {
-  fast_forward_char_pair_sse2_compare(compiler, compare2_type, i, data2_ind, cmp2a_ind, cmp2b_ind, tmp2_ind);
-  fast_forward_char_pair_sse2_compare(compiler, compare1_type, i, data1_ind, cmp1a_ind, cmp1b_ind, tmp1_ind);
+  fast_forward_char_pair_vector_compare(compiler, vector_size, compare2_type, i, data2_ind, cmp2a_ind, cmp2b_ind, tmp2_ind);
+  fast_forward_char_pair_vector_compare(compiler, vector_size, compare1_type, i, data1_ind, cmp1a_ind, cmp1b_ind, tmp1_ind);
   }
 
 /* PAND xmm1, xmm2/m128 */
-/* instruction[0] = 0x66; */
-/* instruction[1] = 0x0f; */
-instruction[2] = 0xdb;
-instruction[3] = 0xc0 | (data1_ind << 3) | data2_ind;
-sljit_emit_op_custom(compiler, instruction, 4);
+emit_vector_op(compiler, vector_size, 0xdb, data1_ind, data2_ind);
 
 /* PMOVMSKB reg, xmm */
-/* instruction[0] = 0x66; */
-/* instruction[1] = 0x0f; */
-instruction[2] = 0xd7;
-instruction[3] = 0xc0 | (tmp1_reg_ind << 3) | 0;
-sljit_emit_op_custom(compiler, instruction, 4);
+emit_vector_op(compiler, vector_size, 0xd7, tmp1_reg_ind, 0);
 
 /* Ignore matches before the first STR_PTR. */
 OP2(SLJIT_ADD, STR_PTR, 0, STR_PTR, 0, TMP2, 0);
@@ -698,35 +912,30 @@ OP2(SLJIT_SUB, STR_PTR, 0, STR_PTR, 0, TMP2, 0);
 /* Main loop. */
 start = LABEL();
 
-OP2(SLJIT_ADD, STR_PTR, 0, STR_PTR, 0, SLJIT_IMM, 16);
-add_jump(compiler, &common->failed_match, CMP(SLJIT_GREATER_EQUAL, STR_PTR, 0, STR_END, 0));
+OP2(SLJIT_ADD, STR_PTR, 0, STR_PTR, 0, SLJIT_IMM, vector_size);
+loop_quit = CMP(SLJIT_GREATER_EQUAL, STR_PTR, 0, STR_END, 0);
+if (vector_size == 16)
+  add_jump(compiler, &common->failed_match, loop_quit);
 
-load_from_mem_sse2(compiler, data1_ind, str_ptr_reg_ind, 0);
-load_from_mem_sse2(compiler, data2_ind, str_ptr_reg_ind, -(sljit_s8)diff);
+load_from_mem_vector(compiler, vector_size, data1_ind, str_ptr_reg_ind, 0);
+load_from_mem_vector(compiler, vector_size, data2_ind, str_ptr_reg_ind, -(sljit_s8)diff);
 
 for (i = 0; i < 4; i++)
   {
-  fast_forward_char_pair_sse2_compare(compiler, compare1_type, i, data1_ind, cmp1a_ind, cmp1b_ind, tmp2_ind);
-  fast_forward_char_pair_sse2_compare(compiler, compare2_type, i, data2_ind, cmp2a_ind, cmp2b_ind, tmp1_ind);
+  fast_forward_char_pair_vector_compare(compiler, vector_size, compare1_type, i, data1_ind, cmp1a_ind, cmp1b_ind, tmp2_ind);
+  fast_forward_char_pair_vector_compare(compiler, vector_size, compare2_type, i, data2_ind, cmp2a_ind, cmp2b_ind, tmp1_ind);
   }
 
 /* PAND xmm1, xmm2/m128 */
-/* instruction[0] = 0x66; */
-/* instruction[1] = 0x0f; */
-instruction[2] = 0xdb;
-instruction[3] = 0xc0 | (data1_ind << 3) | data2_ind;
-sljit_emit_op_custom(compiler, instruction, 4);
+emit_vector_op(compiler, vector_size, 0xdb, data1_ind, data2_ind);
 
 /* PMOVMSKB reg, xmm */
-/* instruction[0] = 0x66; */
-/* instruction[1] = 0x0f; */
-instruction[2] = 0xd7;
-instruction[3] = 0xc0 | (tmp1_reg_ind << 3) | 0;
-sljit_emit_op_custom(compiler, instruction, 4);
+emit_vector_op(compiler, vector_size, 0xd7, tmp1_reg_ind, 0);
 
 CMPTO(SLJIT_ZERO, TMP1, 0, SLJIT_IMM, 0, start);
 
 JUMPHERE(jump[0]);
+leave_vector_code(compiler, vector_size);
 
 /* BSF r32, r/m32 */
 instruction[0] = 0x0f;
@@ -738,6 +947,15 @@ OP2(SLJIT_ADD, STR_PTR, 0, STR_PTR, 0, TMP1, 0);
 
 add_jump(compiler, &common->failed_match, CMP(SLJIT_GREATER_EQUAL, STR_PTR, 0, STR_END, 0));
 
+if (vector_size != 16)
+  {
+  jump[0] = JUMP(SLJIT_JUMP);
+  JUMPHERE(loop_quit);
+  leave_vector_code(compiler, vector_size);
+  add_jump(compiler, &common->failed_match, JUMP(SLJIT_JUMP));
+  JUMPHERE(jump[0]);
+  }
+
 #if defined SUPPORT_UNICODE && PCRE2_CODE_UNIT_WIDTH != 32
 if (common->utf)
   {
@@ -69,7 +69,8 @@ information, and fields within it. */
 #define PUBLIC_MATCH_OPTIONS \
   (PCRE2_ANCHORED|PCRE2_ENDANCHORED|PCRE2_NOTBOL|PCRE2_NOTEOL|PCRE2_NOTEMPTY| \
    PCRE2_NOTEMPTY_ATSTART|PCRE2_NO_UTF_CHECK|PCRE2_PARTIAL_HARD| \
-   PCRE2_PARTIAL_SOFT|PCRE2_NO_JIT|PCRE2_COPY_MATCHED_SUBJECT)
+   PCRE2_PARTIAL_SOFT|PCRE2_NO_JIT|PCRE2_COPY_MATCHED_SUBJECT|PCRE2_MEMOIZE| \
+   PCRE2_NO_OVECTOR|PCRE2_RESUME)
 
 #define PUBLIC_JIT_MATCH_OPTIONS \
    (PCRE2_NO_UTF_CHECK|PCRE2_NOTBOL|PCRE2_NOTEOL|PCRE2_NOTEMPTY|\
@@ -476,6 +477,569 @@ return 0;  /* Match */
 
 
 
+/*************************************************
+*             Find memoizable groups            *
+*************************************************/
+
+/* This function is called when PCRE2_MEMOIZE is set, to find the groups for
+which a failure to match at a given subject position can be remembered. This
+is valid only if the outcome of everything that follows the start of the group
+depends on nothing except the subject position, so the whole pattern is
+rejected if it contains back references, recursions, conditional groups,
+callouts, (*ACCEPT) or backtracking control verbs. Within an eligible pattern,
+a non-atomic bracket (capturing or not) is a candidate unless it is nested
+within a group whose closing ket consults the position at which that group
+started: a repeated group (atomic or not), a possessive group, a script run, or
+an assertion. The outermost bracket is skipped, because it is entered only once
+at each starting position.
+
+Arguments:
+  code        points to the start of the compiled pattern
+  utf         TRUE in UTF mode
+  groups      where to put the group pointers, or NULL just to count them
+
+Returns:      the number of candidate groups, or 0 if none or not eligible
+*/
+
+static uint32_t
+find_memo_groups(PCRE2_SPTR code, BOOL utf, PCRE2_SPTR *groups)
+{
+PCRE2_SPTR restrict_end = NULL;
+uint32_t count = 0;
+
+code += PRIV(OP_lengths)[*code];
+
+for (;;)
+  {
+  PCRE2_SPTR ket;
+  PCRE2_UCHAR c = *code;
+
+  if (restrict_end != NULL && code > restrict_end) restrict_end = NULL;
+
+  switch(c)
+    {
+    case OP_END:
+    return count;
+
+    case OP_REF:
+    case OP_REFI:
+    case OP_DNREF:
+    case OP_DNREFI:
+    case OP_RECURSE:
+    case OP_COND:
+    case OP_SCOND:
+    case OP_CALLOUT:
+    case OP_CALLOUT_STR:
+    case OP_MARK:
+    case OP_PRUNE:
+    case OP_PRUNE_ARG:
+    case OP_SKIP:
+    case OP_SKIP_ARG:
+    case OP_THEN:
+    case OP_THEN_ARG:
+    case OP_COMMIT:
+    case OP_COMMIT_ARG:
+    case OP_ACCEPT:
+    case OP_ASSERT_ACCEPT:
+    case OP_CLOSE:
+    return 0;
+
+    /* Find the closing ket, which is needed for all kinds of group. */
+
+    case OP_BRA:
+    case OP_CBRA:
+    case OP_SBRA:
+    case OP_SCBRA:
+    case OP_BRAPOS:
+    case OP_CBRAPOS:
+    case OP_SBRAPOS:
+    case OP_SCBRAPOS:
+    case OP_ONCE:
+    case OP_SCRIPT_RUN:
+    case OP_ASSERT:
+    case OP_ASSERT_NOT:
+    case OP_ASSERTBACK:
+    case OP_ASSERTBACK_NOT:
+    case OP_ASSERT_NA:
+    case OP_ASSERTBACK_NA:
+    ket = code;
+    do ket += GET(ket, 1); while (*ket == OP_ALT);
+
+    if (restrict_end == NULL)
+      {
+      if (c == OP_BRA || c == OP_CBRA || c == OP_SBRA || c == OP_SCBRA)
+        {
+        if (groups != NULL) groups[count] = code;
+        count++;
+        if (*ket != OP_KET) restrict_end = ket;
+        }
+      else if (c != OP_ONCE || *ket != OP_KET) restrict_end = ket;
+      }
+    break;
+
+    /* Repeated character types may be followed by \p or \P, which have two
+    extra code units of parameters. */
+
+    case OP_TYPESTAR:
+    case OP_TYPEMINSTAR:
+    case OP_TYPEPLUS:
+    case OP_TYPEMINPLUS:
+    case OP_TYPEQUERY:
+    case OP_TYPEMINQUERY:
+    case OP_TYPEPOSSTAR:
+    case OP_TYPEPOSPLUS:
+    case OP_TYPEPOSQUERY:
+    if (code[1] == OP_PROP || code[1] == OP_NOTPROP) code += 2;
+    break;
+
+    case OP_TYPEUPTO:
+    case OP_TYPEMINUPTO:
+    case OP_TYPEEXACT:
+    case OP_TYPEPOSUPTO:
+    if (code[1 + IMM2_SIZE] == OP_PROP || code[1 + IMM2_SIZE] == OP_NOTPROP)
+      code += 2;
+    break;
+
+    /* XCLASS has a zero length in the table; the real length follows. */
+
+    case OP_XCLASS:
+    code += GET(code, 1) - PRIV(OP_lengths)[c];
+    break;
+    }
+
+  code += PRIV(OP_lengths)[c];
+
+  /* In UTF-8 and UTF-16 modes, opcodes that are followed by a character may be
+  followed by a multi-unit character. */
+
+#ifdef MAYBE_UTF_MULTI
+  if (utf && c >= OP_CHAR && c <= OP_NOTPOSUPTOI && HAS_EXTRALEN(code[-1]))
+    code += GET_EXTRALEN(code[-1]);
+#else
+  (void)(utf);  /* Keep compiler happy by referencing function argument */
+#endif
+  }
+}
+
+
+
+/*************************************************
+*     Find the memoization index of a group     *
+*************************************************/
+
+/* The memoized groups are held in order of their position in the pattern, so
+a binary search can be used.
+
+Arguments:
+  code        points to the opcode that starts a group
+  mb          points to the match block
+
+Returns:      the group's index, or MEMO_NONE if it is not memoized
+*/
+
+#define MEMO_NONE 0xffffffffu
+
+static uint32_t
+memo_group_index(PCRE2_SPTR code, match_block *mb)
+{
+uint32_t bot = 0;
+uint32_t top = mb->memo_count;
+
+while (top > bot)
+  {
+  uint32_t mid = (bot + top) / 2;
+  if (mb->memo_groups[mid] == code) return mid;
+  if (mb->memo_groups[mid] < code) bot = mid + 1; else top = mid;
+  }
+return MEMO_NONE;
+}
+
+
+
+/*************************************************
+*      Match a character in one-pass mode        *
+*************************************************/
+
+/* This is called by match_onepass_item() to check one subject character
+against a single-character item. The tests are the same as those in match()
+for a non-UTF, non-UCP pattern. Caseless characters are always less than 128.
+
+Arguments:
+  op          the single-character opcode
+  fc          the pattern character, for character opcodes
+  bits        the class bit map, for class opcodes
+  single      TRUE if the item is not repeated
+  eptr        points to the subject character
+  mb          points to the match block
+
+Returns:      TRUE if the character matches
+*/
+
+static BOOL
+onepass_char(uint32_t op, uint32_t fc, const uint8_t *bits, BOOL single,
+  PCRE2_SPTR eptr, match_block *mb)
+{
+uint32_t c = UCHAR21TEST(eptr);
+BOOL utf = FALSE;  /* Required by IS_NEWLINE() */
+
+switch(op)
+  {
+  case OP_CHAR:
+  return c == fc;
+
+  case OP_CHARI:
+  if (single) return mb->lcc[fc] == TABLE_GET(c, mb->lcc, c);
+  return c == fc || c == mb->fcc[fc];
+
+  case OP_NOT:
+  return c != fc;
+
+  case OP_NOTI:
+  return c != fc && c != mb->fcc[fc];
+
+  case OP_ANY:
+  return !IS_NEWLINE(eptr);
+
+  case OP_ALLANY:
+  return TRUE;
+
+  case OP_DIGIT:
+  return CHMAX_255(c) && (mb->ctypes[c] & ctype_digit) != 0;
+
+  case OP_NOT_DIGIT:
+  return !CHMAX_255(c) || (mb->ctypes[c] & ctype_digit) == 0;
+
+  case OP_WHITESPACE:
+  return CHMAX_255(c) && (mb->ctypes[c] & ctype_space) != 0;
+
+  case OP_NOT_WHITESPACE:
+  return !CHMAX_255(c) || (mb->ctypes[c] & ctype_space) == 0;
+
+  case OP_WORDCHAR:
+  return CHMAX_255(c) && (mb->ctypes[c] & ctype_word) != 0;
+
+  case OP_NOT_WORDCHAR:
+  return !CHMAX_255(c) || (mb->ctypes[c] & ctype_word) == 0;
+
+  case OP_CLASS:
+  return CHMAX_255(c) && (bits[c/8] & (1u << (c&7))) != 0;
+
+  case OP_NCLASS:
+  return !CHMAX_255(c) || (bits[c/8] & (1u << (c&7))) != 0;
+  }
+
+return FALSE;  /* Control never reaches here */
+}
+
+
+
+/*************************************************
+*    Match a repeatable item in one-pass mode    *
+*************************************************/
+
+/* This is called by match_onepass_group() for a single-character item,
+possibly repeated. Only the items accepted by check_onepass() in
+pcre2_compile.c are ever seen. A repeat is always exact or possessive, so as
+many characters as possible, up to the maximum, are taken.
+
+Arguments:
+  code        points to the item
+  eptrptr     points to the subject pointer, which is advanced
+  mb          points to the match block
+
+Returns:      pointer after the item, or NULL if it does not match
+*/
+
+static PCRE2_SPTR
+match_onepass_item(PCRE2_SPTR code, PCRE2_SPTR *eptrptr, match_block *mb)
+{
+PCRE2_SPTR eptr = *eptrptr;
+const uint8_t *bits = NULL;
+uint32_t op = *code;
+uint32_t fc = 0;
+uint32_t min = 1;
+uint32_t max = 1;
+uint32_t i;
+
+if (op >= OP_STAR && op <= OP_TYPEPOSUPTO)
+  {
+  uint32_t base = (op >= OP_TYPESTAR)? OP_TYPESTAR :
+    OP_STAR + ((op - OP_STAR)/(OP_STARI - OP_STAR)) * (OP_STARI - OP_STAR);
+
+  switch(op - base)
+    {
+    case OP_EXACT - OP_STAR:
+    min = max = GET2(code, 1);
+    code += 1 + IMM2_SIZE;
+    break;
+
+    case OP_POSUPTO - OP_STAR:
+    min = 0;
+    max = GET2(code, 1);
+    code += 1 + IMM2_SIZE;
+    break;
+
+    case OP_POSSTAR - OP_STAR:
+    min = 0;
+    max = UINT32_MAX;
+    code++;
+    break;
+
+    case OP_POSPLUS - OP_STAR:
+    max = UINT32_MAX;
+    code++;
+    break;
+
+    case OP_POSQUERY - OP_STAR:
+    min = 0;
+    code++;
+    break;
+    }
+
+  if (base == OP_TYPESTAR) op = *code++;
+    else op = OP_CHAR + (base - OP_STAR)/(OP_STARI - OP_STAR);
+  }
+else code++;
+
+/* Now code points to the data, if any, that follows the (possibly implied)
+single-item opcode. */
+
+switch(op)
+  {
+  case OP_CHAR:
+  case OP_CHARI:
+  case OP_NOT:
+  case OP_NOTI:
+  fc = *code++;
+  break;
+
+  case OP_CLASS:
+  case OP_NCLASS:
+  bits = (const uint8_t *)code;
+  code += 32 / sizeof(PCRE2_UCHAR);
+  switch(*code)
+    {
+    case OP_CRPOSSTAR:
+    min = 0;
+    /* Fall through */
+
+    case OP_CRPOSPLUS:
+    max = UINT32_MAX;
+    code++;
+    break;
+
+    case OP_CRPOSQUERY:
+    min = 0;
+    code++;
+    break;
+
+    case OP_CRRANGE:
+    case OP_CRMINRANGE:
+    case OP_CRPOSRANGE:
+    min = GET2(code, 1);
+    max = GET2(code, 1 + IMM2_SIZE);
+    if (max == 0) max = UINT32_MAX;
+    code += 1 + 2 * IMM2_SIZE;
+    break;
+    }
+  break;
+  }
+
+for (i = 0; i < max; i++)
+  {
+  if (eptr >= mb->end_subject ||
+      !onepass_char(op, fc, bits, max == 1, eptr, mb))
+    break;
+  eptr++;
+  }
+
+*eptrptr = eptr;
+return (i < min)? NULL : code;
+}
+
+
+
+/*************************************************
+*      Match a group in one-pass mode            *
+*************************************************/
+
+/* This is called recursively for each group of a pattern that has the
+PCRE2_ONEPASS flag, which check_onepass() in pcre2_compile.c sets only when
+at most one alternative of any group can get past its first character. Thus,
+if an alternative fails before consuming anything, the next one is tried, but
+if it fails after that, the whole match fails at this starting point. A
+capturing group's offsets are recorded when its end is reached; no group is
+repeated, so they are never overwritten.
+
+Arguments:
+  code        points to the BRA or CBRA opcode
+  eptrptr     points to the subject pointer, which is advanced
+  ovector     the capture offsets
+  otptr       points to the end of the used part of ovector
+  mb          points to the match block
+
+Returns:      TRUE if the group matches
+*/
+
+static BOOL
+match_onepass_group(PCRE2_SPTR code, PCRE2_SPTR *eptrptr, PCRE2_SIZE *ovector,
+  PCRE2_SIZE *otptr, match_block *mb)
+{
+PCRE2_SPTR bracode = code;
+PCRE2_SPTR start = *eptrptr;
+PCRE2_SPTR eptr;
+PCRE2_SPTR cc;
+BOOL utf = FALSE;  /* Required by IS_NEWLINE() */
+
+for (;;)
+  {
+  eptr = start;
+  cc = code + PRIV(OP_lengths)[*code];
+
+  while (*cc != OP_ALT && *cc != OP_KET)
+    {
+    switch(*cc)
+      {
+      case OP_BRA:
+      case OP_CBRA:
+      if (!match_onepass_group(cc, &eptr, ovector, otptr, mb)) goto FAILED;
+      do cc += GET(cc, 1); while (*cc == OP_ALT);
+      cc += 1 + LINK_SIZE;
+      break;
+
+      case OP_CIRC:
+      if (eptr != mb->start_subject || (mb->moptions & PCRE2_NOTBOL) != 0)
+        goto FAILED;
+      cc++;
+      break;
+
+      case OP_SOD:
+      if (eptr != mb->start_subject) goto FAILED;
+      cc++;
+      break;
+
+      case OP_SOM:
+      if (eptr != mb->start_subject + mb->start_offset) goto FAILED;
+      cc++;
+      break;
+
+      case OP_DOLL:
+      if ((mb->moptions & PCRE2_NOTEOL) != 0) goto FAILED;
+      if ((mb->poptions & PCRE2_DOLLAR_ENDONLY) == 0) goto ASSERT_NL_OR_EOS;
+      /* Fall through */
+
+      case OP_EOD:
+      if (eptr < mb->end_subject) goto FAILED;
+      cc++;
+      break;
+
+      case OP_EODN:
+      ASSERT_NL_OR_EOS:
+      if (eptr < mb->end_subject &&
+          (!IS_NEWLINE(eptr) || eptr != mb->end_subject - mb->nllen))
+        goto FAILED;
+      cc++;
+      break;
+
+      default:
+      cc = match_onepass_item(cc, &eptr, mb);
+      if (cc == NULL) goto FAILED;
+      break;
+      }
+    }
+
+  /* This alternative has matched. */
+
+  if (*bracode == OP_CBRA)
+    {
+    PCRE2_SIZE offset = (GET2(bracode, 1+LINK_SIZE) << 1) - 2;
+    ovector[offset] = start - mb->start_subject;
+    ovector[offset+1] = eptr - mb->start_subject;
+    if (offset >= *otptr) *otptr = offset + 2;
+    }
+  *eptrptr = eptr;
+  return TRUE;
+
+  /* This alternative has failed. Try the next one only if nothing has been
+  consumed. */
+
+  FAILED:
+  code += GET(code, 1);
+  if (*code != OP_ALT || eptr != start)
+    {
+    *eptrptr = eptr;
+    return FALSE;
+    }
+  }
+}
+
+
+
+/*************************************************
+*         Match a pattern in one pass            *
+*************************************************/
+
+/* This is called instead of match() for an anchored match of a pattern that
+has the PCRE2_ONEPASS flag, when partial matching is not requested. No
+backtracking frames are used; captures are collected in the ovector of the
+first frame, and the result is passed back in the same way as match() does.
+Match and depth limits do not apply, because the amount of work is bounded by
+the length of the subject.
+
+Arguments:
+  start_eptr    starting character in subject
+  ovector       pointer to the ovector
+  oveccount     number of pairs in ovector
+  top_bracket   number of capturing parentheses in the pattern
+  mb            pointer to "static" variables block
+
+Returns:        MATCH_MATCH if matched )  these values are >= 0
+                MATCH_NOMATCH if failed )
+*/
+
+static int
+match_onepass(PCRE2_SPTR start_eptr, PCRE2_SIZE *ovector, uint16_t oveccount,
+  uint16_t top_bracket, match_block *mb)
+{
+PCRE2_SPTR eptr = start_eptr;
+PCRE2_SIZE *fovector = mb->match_frames->ovector;
+PCRE2_SIZE offset_top = 0;
+uint32_t i;
+
+memset(fovector, 0xff, 2 * top_bracket * sizeof(PCRE2_SIZE));
+
+if (!match_onepass_group(mb->start_code, &eptr, fovector, &offset_top, mb))
+  return MATCH_NOMATCH;
+
+/* Apply the same end-of-match checks as match(). Because there is only one
+way of matching, failing them means there is no match here. */
+
+if (eptr == start_eptr &&
+     ((mb->moptions & PCRE2_NOTEMPTY) != 0 ||
+       ((mb->moptions & PCRE2_NOTEMPTY_ATSTART) != 0 &&
+         start_eptr == mb->start_subject + mb->start_offset)))
+  return MATCH_NOMATCH;
+
+if (eptr < mb->end_subject &&
+    ((mb->moptions | mb->poptions) & PCRE2_ENDANCHORED) != 0)
+  return MATCH_NOMATCH;
+
+mb->end_match_ptr = eptr;
+mb->end_offset_top = offset_top;
+mb->mark = NULL;
+if (eptr > mb->last_used_ptr) mb->last_used_ptr = eptr;
+
+ovector[0] = start_eptr - mb->start_subject;
+ovector[1] = eptr - mb->start_subject;
+
+i = 2 * ((top_bracket + 1 > oveccount)? oveccount : top_bracket + 1);
+memcpy(ovector + 2, fovector, (i - 2) * sizeof(PCRE2_SIZE));
+while (--i >= offset_top + 2) ovector[i] = PCRE2_UNSET;
+return MATCH_MATCH;
+}
+
+
+
 /******************************************************************************
 *******************************************************************************
                    "Recursion" in the match() function
@@ -492,7 +1056,9 @@ a refactoring that uses a vector of frames to remember backtracking points.
 This runs no slower, and possibly even a bit faster than the original recursive
 implementation. An initial vector of size START_FRAMES_SIZE (enough for maybe
 50 frames) is allocated on the system stack. If this is not big enough, the
-heap is used for a larger vector.
+heap is used for a larger vector. A heap vector belongs to the match data block
+and is retained for use by subsequent calls of pcre2_match(), so that matching
+that needs many frames does not repeatedly get and free the same memory.
 
 *******************************************************************************
 ******************************************************************************/
@@ -568,7 +1134,7 @@ Arguments:
    start_ecode  starting position in compiled code
    ovector      pointer to the final output vector
    oveccount    number of pairs in ovector
-   top_bracket  number of capturing parentheses in the pattern
+   top_bracket  number of capturing parentheses recorded in the frames
    frame_size   size of each backtracking frame
    mb           pointer to "static" variables block
 
@@ -627,6 +1193,17 @@ copied when a new frame is created. */
 
 frame_copy_size = frame_size - offsetof(heapframe, eptr);
 
+/* When a suspended match is resumed, the frames are as they were left, and
+processing continues with the frame that was current. */
+
+if (mb->suspend_offset != PCRE2_UNSET)
+  {
+  F = (heapframe *)((char *)mb->match_frames + mb->suspend_offset);
+  mb->suspend_offset = PCRE2_UNSET;
+  group_frame_type = 0;
+  goto RESUME_FRAME;
+  }
+
 /* Set up the first current frame at the start of the vector, and initialize
 fields that are not reset for new frames. */
 
@@ -647,7 +1224,9 @@ backtracking point. */
 MATCH_RECURSE:
 
 /* Set up a new backtracking frame. If the vector is full, get a new one
-on the heap, doubling the size, but constrained by the heap limit. */
+on the heap, doubling the size, but constrained by the heap limit. The new
+vector is owned by the match data block, and replaces any vector that was
+previously held there. */
 
 N = (heapframe *)((char *)F + frame_size);
 if (N >= mb->match_frames_top)
@@ -662,15 +1241,19 @@ if (N >= mb->match_frames_top)
     newsize = maxsize;
     }
 
-  new = mb->memctl.malloc(newsize, mb->memctl.memory_data);
+  new = mb->match_data->memctl.malloc(newsize,
+    mb->match_data->memctl.memory_data);
   if (new == NULL) return PCRE2_ERROR_NOMEMORY;
   memcpy(new, mb->match_frames, mb->frame_vector_size);
 
   F = (heapframe *)((char *)new + ((char *)F - (char *)mb->match_frames));
   N = (heapframe *)((char *)F + frame_size);
 
-  if (mb->match_frames != mb->stack_frames)
-    mb->memctl.free(mb->match_frames, mb->memctl.memory_data);
+  if (mb->match_data->heapframes != NULL)
+    mb->match_data->memctl.free(mb->match_data->heapframes,
+      mb->match_data->memctl.memory_data);
+  mb->match_data->heapframes = new;
+  mb->match_data->heapframes_size = newsize;
   mb->match_frames = new;
   mb->match_frames_top = (heapframe *)((char *)mb->match_frames + newsize);
   mb->frame_vector_size = newsize;
@@ -718,9 +1301,12 @@ memcpy((char *)N + offsetof(heapframe, eptr),
 N->rdepth = Frdepth + 1;
 F = N;
 
-/* Carry on processing with a new frame. */
+/* Carry on processing with a new frame. If statistics are being collected,
+keep track of the deepest frame. */
 
 NEW_FRAME:
+if (mb->stats != NULL && Frdepth >= mb->stats->peak_frames)
+  mb->stats->peak_frames = Frdepth + 1;
 Fgroup_frame_type = group_frame_type;
 Fecode = start_ecode;      /* Starting code pointer */
 Fback_frame = frame_size;  /* Default is go back one frame */
@@ -742,17 +1328,36 @@ if (group_frame_type != 0)
 /* This is the main processing loop. First check that we haven't recorded too
 many backtracks (search tree is too large), or that we haven't exceeded the
 recursive depth limit (used too many backtracking frames). If not, process the
-opcodes. */
+opcodes. When a step limit is set, each new frame is a step, and the match is
+suspended when there are none left. Everything needed to resume it is in the
+frames, apart from the offset of the current one. When a deadline is set, the
+clock is read every so often. When profiling, each opcode is counted as it is
+obeyed. */
 
 if (mb->match_call_count++ >= mb->match_limit) return PCRE2_ERROR_MATCHLIMIT;
 if (Frdepth >= mb->match_limit_depth) return PCRE2_ERROR_DEPTHLIMIT;
 
+if (mb->steps_left != 0 && --mb->steps_left == 0)
+  {
+  mb->suspend_offset = (char *)F - (char *)mb->match_frames;
+  return PCRE2_ERROR_SUSPENDED;
+  }
+
+if (mb->deadline_countdown != 0 && --mb->deadline_countdown == 0)
+  {
+  if (PRIV(clock_usec)() >= mb->deadline) return PCRE2_ERROR_DEADLINE;
+  mb->deadline_countdown = DEADLINE_CHECK_INTERVAL;
+  }
+
+RESUME_FRAME:
+
 for (;;)
   {
 #ifdef DEBUG_SHOW_OPS
 fprintf(stderr, "++ op=%d\n", *Fecode);
 #endif
 
+  if (mb->profile != NULL) mb->profile[Fecode - mb->start_code]++;
   Fop = (uint8_t)(*Fecode);  /* Cast needed for 16-bit and 32-bit modes */
   switch(Fop)
     {
@@ -780,9 +1385,12 @@ fprintf(stderr, "++ op=%d\n", *Fecode);
         }
       offset = (number << 1) - 2;
       Fcapture_last = number;
-      Fovector[offset] = P->eptr - mb->start_subject;
-      Fovector[offset+1] = Feptr - mb->start_subject;
-      if (offset >= Foffset_top) Foffset_top = offset + 2;
+      if (number <= top_bracket)
+        {
+        Fovector[offset] = P->eptr - mb->start_subject;
+        Fovector[offset+1] = Feptr - mb->start_subject;
+        if (offset >= Foffset_top) Foffset_top = offset + 2;
+        }
       }
     Fecode += PRIV(OP_lengths)[*Fecode];
     break;
@@ -2953,8 +3561,16 @@ fprintf(stderr, "++ op=%d\n", *Fecode);
           }
         break;
 
+        /* The code units up to the end of the subject have been inspected, so
+        a partial match is possible even though there are too few of them. */
+
         case OP_ANYBYTE:
-        if (Feptr > mb->end_subject - Lmin) RRETURN(MATCH_NOMATCH);
+        if (Feptr > mb->end_subject - Lmin)
+          {
+          Feptr = mb->end_subject;
+          SCHECK_PARTIAL();
+          RRETURN(MATCH_NOMATCH);
+          }
         Feptr += Lmin;
         break;
 
@@ -3192,9 +3808,13 @@ fprintf(stderr, "++ op=%d\n", *Fecode);
           }
         break;
 
+        /* As for OP_ANYBYTE in UTF mode, the characters up to the end of the
+        subject have been inspected. */
+
         case OP_ALLANY:
         if (Feptr > mb->end_subject - Lmin)
           {
+          Feptr = mb->end_subject;
           SCHECK_PARTIAL();
           RRETURN(MATCH_NOMATCH);
           }
@@ -5234,13 +5854,15 @@ fprintf(stderr, "++ op=%d\n", *Fecode);
     point. (Ideally we should test for a THEN within this group, but we don't
     have that information.) Don't do this if we are at the very top level,
     however, because that would make handling assertions and once-only brackets
-    messier when there is nothing to go back to. */
+    messier when there is nothing to go back to. Nor when memoizing, because the
+    failure of the final alternative must come back here to be recorded. */
 
 #define Lframe_type F->temp_32[0]     /* Set for all that use GROUPLOOP */
+#define Lmemo_index F->temp_32[1]     /* Used only in GROUPLOOP */
 #define Lnext_branch F->temp_sptr[0]  /* Used only in OP_BRA handling */
 
     case OP_BRA:
-    if (mb->hasthen || Frdepth == 0)
+    if (mb->hasthen || Frdepth == 0 || mb->memo_bits != NULL)
       {
       Lframe_type = 0;
       goto GROUPLOOP;
@@ -5286,7 +5908,24 @@ fprintf(stderr, "++ op=%d\n", *Fecode);
     case OP_SBRA:
     Lframe_type = GF_NOCAPTURE | Fop;
 
+    /* When memoizing, a group that has already failed at this subject
+    position is bound to fail again, so give up at once. Otherwise, remember
+    the failure if all the alternatives fail. */
+
     GROUPLOOP:
+    Lmemo_index = MEMO_NONE;
+    if (mb->memo_bits != NULL)
+      {
+      Lmemo_index = memo_group_index(Fecode, mb);
+      if (Lmemo_index != MEMO_NONE)
+        {
+        offset = Lmemo_index * (mb->end_subject - mb->start_subject + 1) +
+          (Feptr - mb->start_subject);
+        if ((mb->memo_bits[offset/8] & (1u << (offset%8))) != 0)
+          RRETURN(MATCH_NOMATCH);
+        }
+      }
+
     for (;;)
       {
       group_frame_type = Lframe_type;
@@ -5300,11 +5939,21 @@ fprintf(stderr, "++ op=%d\n", *Fecode);
         }
       if (rrc != MATCH_NOMATCH) RRETURN(rrc);
       Fecode += GET(Fecode, 1);
-      if (*Fecode != OP_ALT) RRETURN(MATCH_NOMATCH);
+      if (*Fecode != OP_ALT)
+        {
+        if (Lmemo_index != MEMO_NONE)
+          {
+          offset = Lmemo_index * (mb->end_subject - mb->start_subject + 1) +
+            (Feptr - mb->start_subject);
+          mb->memo_bits[offset/8] |= 1u << (offset%8);
+          }
+        RRETURN(MATCH_NOMATCH);
+        }
       }
     /* Control never reaches here. */
 
 #undef Lframe_type
+#undef Lmemo_index
 
 
     /* ===================================================================== */
@@ -5841,10 +6490,12 @@ fprintf(stderr, "++ op=%d\n", *Fecode);
         continue;  /* With next opcode */
         }
 
-      /* Deal with actual capturing. */
+      /* Deal with actual capturing, unless the frames have no room for
+      captures because they are not wanted. */
 
       offset = (number << 1) - 2;
       Fcapture_last = number;
+      if (number > top_bracket) break;
       Fovector[offset] = P->eptr - mb->start_subject;
       Fovector[offset+1] = Feptr - mb->start_subject;
       if (offset >= Foffset_top) Foffset_top = offset + 2;
@@ -6238,6 +6889,7 @@ if (Feptr > mb->last_used_ptr) mb->last_used_ptr = Feptr;
 if (Frdepth == 0) return rrc;                     /* Exit from the top level */
 F = (heapframe *)((char *)F - Fback_frame);       /* Backtrack */
 mb->cb->callout_flags |= PCRE2_CALLOUT_BACKTRACK; /* Note for callouts */
+if (mb->stats != NULL && rrc == MATCH_NOMATCH) mb->stats->backtracks++;
 
 #ifdef DEBUG_SHOW_RMATCH
 fprintf(stderr, "++ RETURN %d to %d\n", rrc, Freturn_id);
@@ -6269,6 +6921,40 @@ switch (Freturn_id)
 }
 
 
+/*************************************************
+*         Add statistics of an earlier run       *
+*************************************************/
+
+/* When a match is run more than once with different engines, the statistics
+of the final run are added to those of the earlier one, keeping the final
+engine.
+
+Arguments:
+  stats           the statistics of the final run
+  earlier         the statistics of the earlier run
+
+Returns:          nothing
+*/
+
+static void
+add_statistics(pcre2_match_statistics *stats,
+  const pcre2_match_statistics *earlier)
+{
+stats->match_calls += earlier->match_calls;
+stats->backtracks += earlier->backtracks;
+if (earlier->peak_frames > stats->peak_frames)
+  {
+  stats->peak_frames = earlier->peak_frames;
+  stats->peak_frames_size = earlier->peak_frames_size;
+  }
+stats->start_positions += earlier->start_positions;
+stats->skipped_first_cu += earlier->skipped_first_cu;
+stats->skipped_start_bits += earlier->skipped_start_bits;
+stats->skipped_req_cu += earlier->skipped_req_cu;
+}
+
+
+
 /*************************************************
 *           Match a Regular Expression           *
 *************************************************/
@@ -6285,6 +6971,8 @@ Arguments:
   options         option bits
   match_data      points to a match_data block
   mcontext        points a PCRE2 context
+  cache           points to positions remembered from a previous call on the
+                    same subject (for pcre2_match_all()), or is NULL
 
 Returns:          > 0 => success; value is the number of ovector pairs filled
                   = 0 => success, but ovector is not big enough
@@ -6293,15 +6981,17 @@ Returns:          > 0 => success; value is the number of ovector pairs filled
                   < -2 => some kind of unexpected problem
 */
 
-PCRE2_EXP_DEFN int PCRE2_CALL_CONVENTION
-pcre2_match(const pcre2_code *code, PCRE2_SPTR subject, PCRE2_SIZE length,
-  PCRE2_SIZE start_offset, uint32_t options, pcre2_match_data *match_data,
-  pcre2_match_context *mcontext)
+int
+PRIV(match_cached)(const pcre2_code *code, PCRE2_SPTR subject,
+  PCRE2_SIZE length, PCRE2_SIZE start_offset, uint32_t options,
+  pcre2_match_data *match_data, pcre2_match_context *mcontext,
+  match_cache *cache)
 {
 int rc;
 int was_zero_terminated = 0;
 const uint8_t *start_bits = NULL;
 const pcre2_real_code *re = (const pcre2_real_code *)code;
+match_resume *resume = NULL;
 
 BOOL anchored;
 BOOL firstline;
@@ -6324,6 +7014,7 @@ PCRE2_SPTR end_subject;
 PCRE2_SPTR true_end_subject;
 PCRE2_SPTR start_match;
 PCRE2_SPTR req_cu_ptr;
+PCRE2_SPTR req_lit_ptr;
 PCRE2_SPTR start_partial;
 PCRE2_SPTR match_partial;
 
@@ -6346,6 +7037,8 @@ BOOL jit_checked_utf = FALSE;
 #endif  /* SUPPORT_UNICODE */
 
 PCRE2_SIZE frame_size;
+PCRE2_SIZE heapframes_size;
+uint16_t frame_brackets;
 
 /* We need to have mb as a pointer to a match block, because the IS_NEWLINE
 macro is used below, and it expects NLBLOCK to be defined as a pointer. */
@@ -6375,6 +7068,7 @@ if (code == NULL || subject == NULL || match_data == NULL)
 
 start_match = subject + start_offset;
 req_cu_ptr = start_match - 1;
+req_lit_ptr = start_match - 1;
 if (length == PCRE2_ZERO_TERMINATED)
   {
   length = PRIV(strlen)(subject);
@@ -6417,7 +7111,8 @@ at compile time for the JIT code to be usable. */
 
 #ifdef SUPPORT_JIT
 use_jit = (re->executable_jit != NULL &&
-          (options & ~PUBLIC_JIT_MATCH_OPTIONS) == 0);
+          (options & ~PUBLIC_JIT_MATCH_OPTIONS) == 0 &&
+          (mcontext == NULL || mcontext->step_limit == 0));
 #endif
 
 /* Initialize UTF/UCP parameters. */
@@ -6433,11 +7128,12 @@ ucp = (re->overall_options & PCRE2_UCP) != 0;
 mb->partial = ((options & PCRE2_PARTIAL_HARD) != 0)? 2 :
               ((options & PCRE2_PARTIAL_SOFT) != 0)? 1 : 0;
 
-/* Partial matching and PCRE2_ENDANCHORED are currently not allowed at the same
-time. */
+/* Partial matching is currently not allowed at the same time as either
+PCRE2_ENDANCHORED or PCRE2_NO_OVECTOR. */
 
 if (mb->partial != 0 &&
-   ((re->overall_options | options) & PCRE2_ENDANCHORED) != 0)
+   (((re->overall_options | options) & PCRE2_ENDANCHORED) != 0 ||
+    (options & PCRE2_NO_OVECTOR) != 0))
   return PCRE2_ERROR_BADOPTION;
 
 /* It is an error to set an offset limit without setting the flag at compile
@@ -6462,6 +7158,199 @@ match_data->subject = NULL;
 
 match_data->startchar = 0;
 
+/* If statistics are wanted, they are collected afresh for each match. */
+
+mb->stats = NULL;
+if ((match_data->flags & PCRE2_MD_STATISTICS) != 0)
+  {
+  mb->stats = &match_data->statistics;
+  memset(mb->stats, 0, sizeof(pcre2_match_statistics));
+  mb->stats->engine = PCRE2_ENGINE_INTERPRETER;
+  }
+
+/* If profiling is enabled, there is a count for each code unit of the compiled
+code, zeroed for each match. Only match() counts opcodes, so JIT, one-pass, and
+bit-parallel matching, and the automatic choice of engines, are not used. */
+
+mb->profile = NULL;
+if ((match_data->flags & PCRE2_MD_PROFILE) != 0)
+  {
+  PCRE2_SIZE code_length = (re->blocksize - sizeof(pcre2_real_code)) /
+    (PCRE2_CODE_UNIT_WIDTH/8) - re->name_count * re->name_entry_size;
+  if (match_data->profile_size < code_length)
+    {
+    if (match_data->profile != NULL)
+      match_data->memctl.free(match_data->profile,
+        match_data->memctl.memory_data);
+    match_data->profile_size = 0;
+    match_data->profile = match_data->memctl.malloc(
+      code_length * sizeof(PCRE2_SIZE), match_data->memctl.memory_data);
+    if (match_data->profile == NULL) return PCRE2_ERROR_NOMEMORY;
+    match_data->profile_size = code_length;
+    }
+  memset(match_data->profile, 0, code_length * sizeof(PCRE2_SIZE));
+  match_data->profile_length = code_length;
+  mb->profile = match_data->profile;
+#ifdef SUPPORT_JIT
+  use_jit = FALSE;
+#endif
+  }
+
+/* A match that was suspended after using up its step limit is abandoned by
+any call that does not resume it. */
+
+if ((options & PCRE2_RESUME) == 0 && match_data->resume != NULL)
+  PRIV(match_resume_free)(match_data);
+
+
+/* ====================== Automatically chosen engines ====================== */
+
+/* When PCRE2_EXTRA_AUTO_ENGINE has chosen fallback engines for a pattern that
+may backtrack catastrophically, the match is first run with a match limit that
+suffices for ordinary subjects. Only if that is exceeded is the match run
+again, by DFA matching if only the existence of a match is wanted and the
+pattern allows it, or otherwise with memoization. The result is the same as
+that of an unrestricted match. Nothing is done if the caller's own limit is no
+larger, if memoization has been requested explicitly, or if the match may be
+suspended. A deadline covers all the runs together. */
+
+if (re->engines != 0 && mb->partial == 0 && mb->profile == NULL &&
+    (options & (PCRE2_MEMOIZE|PCRE2_RESUME)) == 0 &&
+    (mcontext == NULL || mcontext->step_limit == 0))
+  {
+  pcre2_match_context budget_context = (mcontext == NULL)?
+    PRIV(default_match_context) : *mcontext;
+  pcre2_match_statistics budget_stats;
+  uint32_t limit = budget_context.match_limit;
+  uint32_t deadline = budget_context.deadline;
+  uint64_t start_time = 0;
+
+  memset(&budget_stats, 0, sizeof(budget_stats));
+  if (re->limit_match < limit) limit = re->limit_match;
+  if (limit > AUTO_MATCH_BUDGET &&
+      length - start_offset < limit - AUTO_MATCH_BUDGET)
+    {
+    if (deadline != 0) start_time = PRIV(clock_usec)();
+    budget_context.match_limit =
+      AUTO_MATCH_BUDGET + (uint32_t)(length - start_offset);
+    rc = PRIV(match_cached)(code, subject, length, start_offset, options,
+      match_data, &budget_context, cache);
+    if (rc != PCRE2_ERROR_MATCHLIMIT) return rc;
+    if (mb->stats != NULL) budget_stats = *mb->stats;
+
+    /* Each later run is given what is left of the deadline, measured from
+    the start of the first run. */
+
+    if (deadline != 0)
+      {
+      uint64_t used = PRIV(clock_usec)() - start_time;
+      if (used >= deadline) return PCRE2_ERROR_DEADLINE;
+      budget_context = *mcontext;
+      budget_context.deadline = deadline - (uint32_t)used;
+      mcontext = &budget_context;
+      }
+
+    if ((options & PCRE2_NO_OVECTOR) != 0 &&
+        (re->engines & PCRE2_ENGINE_DFA) != 0 &&
+        ((re->overall_options | options) & PCRE2_ENDANCHORED) == 0)
+      {
+      PCRE2_SIZE wscount = 6 * ((re->blocksize - sizeof(pcre2_real_code)) /
+        (PCRE2_CODE_UNIT_WIDTH/8) - re->name_count * re->name_entry_size);
+      int *workspace;
+
+      if (wscount < AUTO_DFA_MIN_WSCOUNT) wscount = AUTO_DFA_MIN_WSCOUNT;
+      workspace = match_data->memctl.malloc(wscount * sizeof(int),
+        match_data->memctl.memory_data);
+      if (workspace != NULL)
+        {
+        rc = pcre2_dfa_match(code, subject, length, start_offset,
+          (options & ~PCRE2_NO_JIT) | PCRE2_DFA_SHORTEST, match_data, mcontext,
+          workspace, wscount);
+        match_data->memctl.free(workspace, match_data->memctl.memory_data);
+        if (rc > 0 || rc == PCRE2_ERROR_NOMATCH || rc == PCRE2_ERROR_DEADLINE)
+          {
+          if (mb->stats != NULL) add_statistics(mb->stats, &budget_stats);
+          return rc;
+          }
+        if (deadline != 0)
+          {
+          uint64_t used = PRIV(clock_usec)() - start_time;
+          if (used >= deadline) return PCRE2_ERROR_DEADLINE;
+          budget_context.deadline = deadline - (uint32_t)used;
+          }
+        }
+      }
+
+    rc = PRIV(match_cached)(code, subject, length, start_offset,
+      options | PCRE2_MEMOIZE, match_data, mcontext, cache);
+    if (mb->stats != NULL) add_statistics(mb->stats, &budget_stats);
+    return rc;
+    }
+  }
+
+
+/* ======================== Existence-only matching ======================== */
+
+/* When PCRE2_NO_OVECTOR is set, only the existence of a match is wanted. The
+bit-parallel matcher is used if the pattern has one, the start of a match is
+not restricted by PCRE2_FIRSTLINE or an offset limit, and the match cannot be
+suspended. Otherwise an ordinary match is done (by JIT if available) and its
+offsets are discarded; the interpreter is told that captured substrings are not
+wanted. Either way, a match yields 1 with the ovector unset. */
+
+if ((options & PCRE2_NO_OVECTOR) != 0)
+  {
+  if (re->bitparallel != NULL && mb->profile == NULL &&
+      (re->overall_options & PCRE2_FIRSTLINE) == 0 &&
+      (options & PCRE2_RESUME) == 0 &&
+      (mcontext == NULL || (mcontext->offset_limit == PCRE2_UNSET &&
+        mcontext->step_limit == 0)))
+    {
+    rc = PRIV(bitparallel_match)(re, subject, length, start_offset, options)?
+      1 : PCRE2_ERROR_NOMATCH;
+    match_data->code = re;
+    match_data->mark = NULL;
+    match_data->matchedby = PCRE2_MATCHEDBY_INTERPRETER;
+    if (mb->stats != NULL) mb->stats->engine = PCRE2_ENGINE_BITPARALLEL;
+    }
+  else
+    {
+    match_cache existence_cache;
+    memset(&existence_cache, 0, sizeof(match_cache));
+    existence_cache.no_captures = TRUE;
+    rc = PRIV(match_cached)(code, subject, length, start_offset,
+      options & ~(PCRE2_NO_OVECTOR|PCRE2_COPY_MATCHED_SUBJECT), match_data,
+      mcontext, &existence_cache);
+    if (rc == 0) rc = 1;
+    }
+
+  if (rc > 0)
+    {
+    uint32_t i;
+    for (i = 0; i < 2 * (uint32_t)match_data->oveccount; i++)
+      match_data->ovector[i] = PCRE2_UNSET;
+    rc = 1;
+    }
+  match_data->rc = rc;
+  return rc;
+  }
+
+
+/* =========================== Resuming a match ============================ */
+
+/* A suspended match can be resumed only with the same arguments, apart from
+the match context, from which only the step limit is taken. */
+
+if ((options & PCRE2_RESUME) != 0)
+  {
+  resume = match_data->resume;
+  options &= ~PCRE2_RESUME;
+  if (resume == NULL || resume->workspace != NULL || resume->code != re ||
+      resume->subject != subject || resume->length != length ||
+      resume->start_offset != start_offset || resume->options != options)
+    return PCRE2_ERROR_BADRESUME;
+  }
+
 
 /* ============================= JIT matching ============================== */
 
@@ -6582,10 +7471,11 @@ use of a starting offset. Note that the maximum lookbehind is a number of
 characters, not code units.
 
 Note also that support for invalid UTF forces a check, overriding the setting
-of PCRE2_NO_CHECK_UTF. */
+of PCRE2_NO_CHECK_UTF. When a suspended match is resumed, the subject has
+already been checked, and the results are restored below. */
 
 #ifdef SUPPORT_UNICODE
-if (utf &&
+if (utf && resume == NULL &&
 #ifdef SUPPORT_JIT
     !jit_checked_utf &&
 #endif
@@ -6717,6 +7607,9 @@ firstline = (re->overall_options & PCRE2_FIRSTLINE) != 0;
 startline = (re->flags & PCRE2_STARTLINE) != 0;
 bumpalong_limit = (mcontext->offset_limit == PCRE2_UNSET)?
   true_end_subject : subject + mcontext->offset_limit;
+if (cache != NULL && cache->bumpalong_limit != NULL &&
+    cache->bumpalong_limit < bumpalong_limit)
+  bumpalong_limit = cache->bumpalong_limit;
 
 /* Initialize and set up the fixed fields in the callout block, with a pointer
 in the match block. */
@@ -6804,10 +7697,18 @@ correct when calling match() more than once for non-anchored patterns.
 We must also pad frame_size for alignment to ensure subsequent frames are as
 aligned as heapframe. Whilst ovector is word-aligned due to being a PCRE2_SIZE
 array, that does not guarantee it is suitably aligned for pointers, as some
-architectures have pointers that are larger than a size_t. */
+architectures have pointers that are larger than a size_t.
+
+When the caller wants only the offsets of the whole match and nothing in the
+pattern reads captured substrings while matching, the vector is left out
+altogether, making the frames smaller and saving the work of recording
+captures. */
+
+frame_brackets = (cache != NULL && cache->no_captures &&
+  (re->flags & PCRE2_NOCAPREAD) != 0)? 0 : re->top_bracket;
 
 frame_size = (offsetof(heapframe, ovector) +
-  re->top_bracket * 2 * sizeof(PCRE2_SIZE) + HEAPFRAME_ALIGNMENT - 1) &
+  frame_brackets * 2 * sizeof(PCRE2_SIZE) + HEAPFRAME_ALIGNMENT - 1) &
   ~(HEAPFRAME_ALIGNMENT - 1);
 
 /* Limits set in the pattern override the match context only if they are
@@ -6822,15 +7723,44 @@ mb->match_limit = (mcontext->match_limit < re->limit_match)?
 mb->match_limit_depth = (mcontext->depth_limit < re->limit_depth)?
   mcontext->depth_limit : re->limit_depth;
 
+mb->steps_left = mcontext->step_limit;
+mb->suspend_offset = PCRE2_UNSET;
+
+/* A deadline is measured from the start of this call. The clock is read again
+only after every DEADLINE_CHECK_INTERVAL backtracking frames. */
+
+if (mcontext->deadline != 0)
+  {
+  mb->deadline = PRIV(clock_usec)() + mcontext->deadline;
+  mb->deadline_countdown = DEADLINE_CHECK_INTERVAL;
+  }
+else mb->deadline_countdown = 0;
+
+/* A frame vector that was retained in the match data block by a previous call
+can be used for as many frames as fit within the current heap limit. (The heap
+limit is in kibibytes.) */
+
+mb->match_data = match_data;
+heapframes_size = match_data->heapframes_size;
+if ((heapframes_size / 1024) > mb->heap_limit)
+  heapframes_size = mb->heap_limit * 1024;
+heapframes_size = (heapframes_size / frame_size) * frame_size;
+
 /* If a pattern has very many capturing parentheses, the frame size may be very
 large. Ensure that there are at least 10 available frames by getting an initial
 vector on the heap if necessary, except when the heap limit prevents this. Get
-fewer if possible. (The heap limit is in kibibytes.) */
+fewer if possible. Otherwise, start with the vector on the stack unless the
+retained heap vector is bigger. */
 
 if (frame_size <= START_FRAMES_SIZE/10)
   {
-  mb->match_frames = mb->stack_frames;   /* Initial frame vector on the stack */
   mb->frame_vector_size = ((START_FRAMES_SIZE/frame_size) * frame_size);
+  if (heapframes_size > mb->frame_vector_size)
+    {
+    mb->match_frames = match_data->heapframes;
+    mb->frame_vector_size = heapframes_size;
+    }
+  else mb->match_frames = mb->stack_frames;
   }
 else
   {
@@ -6840,9 +7770,19 @@ else
     if (frame_size > mb->heap_limit * 1024) return PCRE2_ERROR_HEAPLIMIT;
     mb->frame_vector_size = ((mb->heap_limit * 1024)/frame_size) * frame_size;
     }
-  mb->match_frames = mb->memctl.malloc(mb->frame_vector_size,
-    mb->memctl.memory_data);
-  if (mb->match_frames == NULL) return PCRE2_ERROR_NOMEMORY;
+  if (heapframes_size >= mb->frame_vector_size)
+    mb->frame_vector_size = heapframes_size;
+  else
+    {
+    match_data->memctl.free(match_data->heapframes,
+      match_data->memctl.memory_data);
+    match_data->heapframes_size = 0;
+    match_data->heapframes = match_data->memctl.malloc(mb->frame_vector_size,
+      match_data->memctl.memory_data);
+    if (match_data->heapframes == NULL) return PCRE2_ERROR_NOMEMORY;
+    match_data->heapframes_size = mb->frame_vector_size;
+    }
+  mb->match_frames = match_data->heapframes;
   }
 
 mb->match_frames_top =
@@ -6860,6 +7800,50 @@ mb->lcc = re->tables + lcc_offset;
 mb->fcc = re->tables + fcc_offset;
 mb->ctypes = re->tables + ctypes_offset;
 
+/* If memoization is requested, find the groups whose failures can be
+remembered and get a bit vector with one bit for each group at each subject
+position. The result of matching does not depend on the memoization, so if the
+pattern or the options make it unsafe, or the vector would exceed the memo
+limit (which is in kibibytes), or there is no memory, just do without it. The
+vector is kept across starting positions, because a group that fails at a
+given subject position fails whatever the starting position. A resumed match
+has its vector restored below. */
+
+mb->memo_bits = NULL;
+mb->memo_count = 0;
+
+if ((options & PCRE2_MEMOIZE) != 0 && mb->partial == 0 && resume == NULL &&
+    (options & (PCRE2_NOTEMPTY|PCRE2_NOTEMPTY_ATSTART)) == 0
+#ifdef SUPPORT_UNICODE
+    && !allow_invalid
+#endif
+    )
+  {
+  uint32_t count = find_memo_groups(mb->start_code, utf, NULL);
+  PCRE2_SIZE limit = (PCRE2_SIZE)(mcontext->memo_limit) * 1024;
+
+  if (count > 0 && (PCRE2_SIZE)(end_subject - subject + 1)/8 < limit/count)
+    {
+    PCRE2_SIZE bits_size =
+      ((PCRE2_SIZE)count * (end_subject - subject + 1) + 7)/8;
+    PCRE2_SIZE groups_size = count * sizeof(PCRE2_SPTR);
+
+    if (bits_size + groups_size <= limit)
+      {
+      mb->memo_groups = mb->memctl.malloc(groups_size + bits_size,
+        mb->memctl.memory_data);
+      if (mb->memo_groups != NULL)
+        {
+        mb->memo_count = find_memo_groups(mb->start_code, utf,
+          mb->memo_groups);
+        mb->memo_bits = (uint8_t *)(mb->memo_groups + count);
+        memset(mb->memo_bits, 0, bits_size);
+        if (mb->stats != NULL) mb->stats->engine = PCRE2_ENGINE_MEMOIZE;
+        }
+      }
+    }
+  }
+
 /* Set up the first code unit to match, if available. If there's no first code
 unit there may be a bitmap of possible first characters. */
 
@@ -6902,6 +7886,75 @@ if ((re->flags & PCRE2_LASTSET) != 0)
     }
   }
 
+/* When a suspended match is resumed, copy the frames that were in use into the
+vector that has just been set up, or into a new one on the heap if they do not
+fit. Then restore the match block (apart from the fields that describe the
+vector), the callout block, and the variables of the bumpalong loop, and
+continue with the call of match() that was suspended. The saved state is not
+needed after this. */
+
+if (resume != NULL)
+  {
+  heapframe *match_frames;
+  heapframe *match_frames_top;
+  PCRE2_SIZE frame_vector_size;
+  uint64_t deadline = mb->deadline;
+  uint32_t deadline_countdown = mb->deadline_countdown;
+  pcre2_match_statistics *stats = mb->stats;
+  PCRE2_SIZE *profile = mb->profile;
+
+  if (resume->frames_size > mb->frame_vector_size)
+    {
+    PCRE2_SIZE newsize = resume->u.mb.frame_vector_size;
+    heapframe *new = match_data->memctl.malloc(newsize,
+      match_data->memctl.memory_data);
+    if (new == NULL) return PCRE2_ERROR_NOMEMORY;
+    if (match_data->heapframes != NULL)
+      match_data->memctl.free(match_data->heapframes,
+        match_data->memctl.memory_data);
+    match_data->heapframes = new;
+    match_data->heapframes_size = newsize;
+    mb->match_frames = new;
+    mb->match_frames_top = (heapframe *)((char *)new + newsize);
+    mb->frame_vector_size = newsize;
+    }
+  memcpy(mb->match_frames, resume + 1, resume->frames_size);
+
+  match_frames = mb->match_frames;
+  match_frames_top = mb->match_frames_top;
+  frame_vector_size = mb->frame_vector_size;
+  *mb = resume->u.mb;
+  mb->match_frames = match_frames;
+  mb->match_frames_top = match_frames_top;
+  mb->frame_vector_size = frame_vector_size;
+  mb->stack_frames = (heapframe *)stack_frames_vector;
+  mb->cb = &cb;
+  mb->steps_left = mcontext->step_limit;
+  mb->deadline = deadline;
+  mb->deadline_countdown = deadline_countdown;
+  mb->stats = stats;
+  mb->profile = profile;
+
+  cb = resume->cb;
+  start_match = resume->start_match;
+  end_subject = resume->end_subject;
+  req_cu_ptr = resume->req_cu_ptr;
+  req_lit_ptr = resume->req_lit_ptr;
+  start_partial = resume->start_partial;
+  match_partial = resume->match_partial;
+#if PCRE2_CODE_UNIT_WIDTH == 8
+  memchr_found_first_cu = resume->memchr_found_first_cu;
+  memchr_found_first_cu2 = resume->memchr_found_first_cu2;
+#endif
+#ifdef SUPPORT_UNICODE
+  fragment_options = resume->fragment_options;
+#endif
+
+  match_data->memctl.free(resume, match_data->memctl.memory_data);
+  match_data->resume = NULL;
+  goto RESUME_MATCH;
+  }
+
 
 /* ==========================================================================*/
 
@@ -6920,9 +7973,27 @@ memchr_found_first_cu = NULL;
 memchr_found_first_cu2 = NULL;
 #endif
 
+/* When pcre2_match_all() is finding successive matches in the same subject,
+the positions that earlier calls found for the first and required code units
+can be used again, provided that this search does not start before the point
+at which they were found. With PCRE2_FIRSTLINE the scans stop at a newline
+that depends on the starting point, so the positions are not used. */
+
+if (cache != NULL && !firstline && cache->end_subject == end_subject &&
+    start_match >= cache->last_start)
+  {
+#if PCRE2_CODE_UNIT_WIDTH == 8
+  memchr_found_first_cu = cache->first_cu;
+  memchr_found_first_cu2 = cache->first_cu2;
+#endif
+  if (cache->req_cu > req_cu_ptr) req_cu_ptr = cache->req_cu;
+  if (cache->req_lit > req_lit_ptr) req_lit_ptr = cache->req_lit;
+  }
+
 for(;;)
   {
   PCRE2_SPTR new_start_match;
+  PCRE2_SPTR scan_start = start_match;
 
   /* ----------------- Start of match optimizations ---------------- */
 
@@ -6986,11 +8057,33 @@ for(;;)
         }
       }
 
-    /* Not anchored. Advance to a unique first code unit if there is one. */
+    /* Not anchored. If there is a set of literal strings, one of which must
+    start every match, advance to the first place where one of them occurs.
+    This is a better filter than a first code unit or the start bitmap, but it
+    is not used for partial matching, where a match may start with an
+    incomplete string at the end of the subject, or when the match must start
+    in the first line. Otherwise, advance to a unique first code unit if there
+    is one. */
 
     else
       {
-      if (has_first_cu)
+      if (re->start_literal_count > 0 && mb->partial == 0 && !firstline)
+        {
+        start_match = PRIV(find_string_set)(start_match, end_subject,
+          re->start_literals, re->start_literal_count,
+          re->start_literal_length);
+        if (start_match == NULL)
+          {
+          if (mb->stats != NULL)
+            mb->stats->skipped_first_cu += end_subject - scan_start;
+          rc = MATCH_NOMATCH;
+          break;
+          }
+        if (mb->stats != NULL)
+          mb->stats->skipped_first_cu += start_match - scan_start;
+        }
+
+      else if (has_first_cu)
         {
         if (first_cu != first_cu2)  /* Caseless */
           {
@@ -7080,6 +8173,9 @@ for(;;)
         string is legitimately allowed to start with the first code unit of a
         newline. */
 
+        if (mb->stats != NULL)
+          mb->stats->skipped_first_cu += start_match - scan_start;
+
         if (mb->partial == 0 && start_match >= mb->end_subject)
           {
           rc = MATCH_NOMATCH;
@@ -7123,19 +8219,16 @@ for(;;)
       /* If there's no first code unit or a requirement for a multiline line
       start, advance to a non-unique first code unit if any have been
       identified. The bitmap contains only 256 bits. When code units are 16 or
-      32 bits wide, all code units greater than 254 set the 255 bit. */
+      32 bits wide, all code units greater than 254 set the 255 bit. If the
+      bitmap can be covered by a few ranges, the search uses vector
+      instructions where available. */
 
       else if (start_bits != NULL)
         {
-        while (start_match < end_subject)
-          {
-          uint32_t c = UCHAR21TEST(start_match);
-#if PCRE2_CODE_UNIT_WIDTH != 8
-          if (c > 255) c = 255;
-#endif
-          if ((start_bits[c/8] & (1u << (c&7))) != 0) break;
-          start_match++;
-          }
+        start_match = PRIV(find_start_bits)(start_match, end_subject,
+          start_bits, re->start_ranges, re->start_range_count);
+        if (mb->stats != NULL)
+          mb->stats->skipped_start_bits += start_match - scan_start;
 
         /* See comment above in first_cu checking about the next few lines. */
 
@@ -7238,6 +8331,8 @@ for(;;)
 
           if (p >= end_subject)
             {
+            if (mb->stats != NULL)
+              mb->stats->skipped_req_cu += end_subject - start_match;
             rc = MATCH_NOMATCH;
             break;
             }
@@ -7249,6 +8344,36 @@ for(;;)
           req_cu_ptr = p;
           }
         }
+
+      /* If a required literal string was found by pcre2_study(), it too must
+      appear in the subject, and it is searched for in the same way as req_cu,
+      with the same limitation for long subjects. If every match must start
+      with the literal, we can advance the starting point to where it was
+      found, but not if the match is constrained to the first line. */
+
+      if (re->req_literal_length > 0 && start_match > req_lit_ptr)
+        {
+        PCRE2_SIZE check_length = end_subject - start_match;
+
+        if (check_length < REQ_CU_MAX ||
+              (!anchored && check_length < REQ_CU_MAX * 1000))
+          {
+          p = PRIV(find_string)(start_match, end_subject, re->req_literal,
+            re->req_literal_length);
+          if (p == NULL)
+            {
+            if (mb->stats != NULL)
+              mb->stats->skipped_req_cu += end_subject - start_match;
+            rc = MATCH_NOMATCH;
+            break;
+            }
+          req_lit_ptr = p;
+          }
+        }
+
+      if ((re->flags & PCRE2_LITSTART) != 0 && !anchored && !firstline &&
+          req_lit_ptr > start_match)
+        start_match = req_lit_ptr;
       }
     }
 
@@ -7279,8 +8404,25 @@ for(;;)
   mb->end_offset_top = 0;
   mb->skip_arg_count = 0;
 
-  rc = match(start_match, mb->start_code, match_data->ovector,
-    match_data->oveccount, re->top_bracket, frame_size, mb);
+  if ((re->flags & PCRE2_ONEPASS) != 0 && anchored && mb->partial == 0 &&
+      mb->steps_left == 0 && mb->profile == NULL)
+    {
+    rc = match_onepass(start_match, match_data->ovector,
+      match_data->oveccount, re->top_bracket, mb);
+    if (mb->stats != NULL) mb->stats->engine = PCRE2_ENGINE_ONEPASS;
+    }
+  else
+    {
+    RESUME_MATCH:
+    rc = match(start_match, mb->start_code, match_data->ovector,
+      match_data->oveccount, frame_brackets, frame_size, mb);
+    }
+
+  if (mb->stats != NULL)
+    {
+    mb->stats->start_positions++;
+    mb->stats->match_calls += mb->match_call_count;
+    }
 
   if (mb->hitend && start_partial == NULL)
     {
@@ -7400,6 +8542,50 @@ for(;;)
 
 ENDLOOP:
 
+if (mb->stats != NULL)
+  mb->stats->peak_frames_size = mb->stats->peak_frames * frame_size;
+
+/* A suspended match is saved in the match data block, with only the frames
+that are in use. The memoization vector now belongs to the saved match. */
+
+if (rc == PCRE2_ERROR_SUSPENDED)
+  {
+  PCRE2_SIZE frames_size = mb->suspend_offset + frame_size;
+
+  resume = match_data->memctl.malloc(sizeof(match_resume) + frames_size,
+    match_data->memctl.memory_data);
+  if (resume == NULL) rc = PCRE2_ERROR_NOMEMORY;
+  else
+    {
+    resume->code = re;
+    resume->subject = subject;
+    resume->length = length;
+    resume->start_offset = start_offset;
+    resume->options = options;
+    resume->workspace = NULL;
+    resume->wscount = 0;
+    resume->start_match = start_match;
+    resume->end_subject = end_subject;
+    resume->req_cu_ptr = req_cu_ptr;
+    resume->req_lit_ptr = req_lit_ptr;
+    resume->start_partial = start_partial;
+    resume->match_partial = match_partial;
+#if PCRE2_CODE_UNIT_WIDTH == 8
+    resume->memchr_found_first_cu = memchr_found_first_cu;
+    resume->memchr_found_first_cu2 = memchr_found_first_cu2;
+#endif
+#ifdef SUPPORT_UNICODE
+    resume->fragment_options = fragment_options;
+#endif
+    resume->frames_size = frames_size;
+    resume->cb = cb;
+    resume->u.mb = *mb;
+    memcpy(resume + 1, mb->match_frames, frames_size);
+    match_data->resume = resume;
+    mb->memo_bits = NULL;
+    }
+  }
+
 /* If end_subject != true_end_subject, it means we are handling invalid UTF,
 and have just processed a non-terminal fragment. If this resulted in no match
 or a partial match we must carry on to the next fragment (a partial match is
@@ -7463,10 +8649,38 @@ if (utf && end_subject != true_end_subject &&
   }
 #endif  /* SUPPORT_UNICODE */
 
-/* Release an enlarged frame vector that is on the heap. */
+/* Remember the positions that were found, for the next call. */
+
+if (cache != NULL)
+  {
+  cache->end_subject = end_subject;
+  cache->last_start = start_match;
+#if PCRE2_CODE_UNIT_WIDTH == 8
+  cache->first_cu = memchr_found_first_cu;
+  cache->first_cu2 = memchr_found_first_cu2;
+#endif
+  cache->req_cu = req_cu_ptr;
+  cache->req_lit = req_lit_ptr;
+  }
 
-if (mb->match_frames != mb->stack_frames)
-  mb->memctl.free(mb->match_frames, mb->memctl.memory_data);
+/* Release the memoization vector. */
+
+if (mb->memo_bits != NULL)
+  mb->memctl.free(mb->memo_groups, mb->memctl.memory_data);
+
+/* A frame vector on the heap is retained in the match data block for use by
+subsequent matches, unless it is bigger than the retention limit, which is in
+kibibytes. A limit of zero means that no vector is retained. */
+
+if (match_data->heapframes != NULL &&
+    (match_data->heapframes_limit == 0 ||
+     (match_data->heapframes_size / 1024) > match_data->heapframes_limit))
+  {
+  match_data->memctl.free(match_data->heapframes,
+    match_data->memctl.memory_data);
+  match_data->heapframes = NULL;
+  match_data->heapframes_size = 0;
+  }
 
 /* Fill in fields that are always returned in the match data. */
 
@@ -7533,4 +8747,22 @@ else match_data->rc = PCRE2_ERROR_NOMATCH;
 return match_data->rc;
 }
 
+
+
+/*************************************************
+*     Match a Regular Expression (public API)    *
+*************************************************/
+
+/* This is the external function; see PRIV(match_cached)() above for the
+arguments. */
+
+PCRE2_EXP_DEFN int PCRE2_CALL_CONVENTION
+pcre2_match(const pcre2_code *code, PCRE2_SPTR subject, PCRE2_SIZE length,
+  PCRE2_SIZE start_offset, uint32_t options, pcre2_match_data *match_data,
+  pcre2_match_context *mcontext)
+{
+return PRIV(match_cached)(code, subject, length, start_offset, options,
+  match_data, mcontext, NULL);
+}
+
 /* End of pcre2_match.c */
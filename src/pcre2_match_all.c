@@ -0,0 +1,403 @@
+/*************************************************
+*      Perl-Compatible Regular Expressions       *
+*************************************************/
+
+/* PCRE is a library of functions to support regular expressions whose syntax
+and semantics are as close as possible to those of the Perl 5 language.
+
+                       Written by Philip Hazel
+     Original API code Copyright (c) 1997-2012 University of Cambridge
+          New API code Copyright (c) 2016-2022 University of Cambridge
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the University of Cambridge nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+/* This module contains the match iterator functions, which find all the
+matches of a pattern in one subject, using the same rules as pcre2test's /g
+option (or the loop in pcre2demo) for moving on after an empty match, and
+deliver the offsets of the matched strings in batches, and
+pcre2_match_count(), which just counts them.
+
+Because every search is in the same subject, the UTF validity of the subject
+is checked only once, and the positions that pcre2_match() finds when it is
+looking for the first code unit or a required code unit or literal are
+remembered from one search to the next, so that the subject is not scanned
+again. */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "pcre2_internal.h"
+
+/* Options that can be given when an iterator is created. */
+
+#define PUBLIC_ITERATOR_OPTIONS \
+  (PCRE2_ANCHORED|PCRE2_NOTBOL|PCRE2_NOTEOL|PCRE2_NOTEMPTY|PCRE2_NO_JIT| \
+   PCRE2_NO_UTF_CHECK|PCRE2_MEMOIZE)
+
+/* The number of matches that pcre2_match_count() asks for in each call of
+pcre2_match_all(). */
+
+#define COUNT_BATCH 64
+
+/* Values for the flags field */
+
+#define ITERATOR_CHECKED    0x0001u  /* The subject's UTF has been checked */
+#define ITERATOR_RETRY      0x0002u  /* Retry after an empty match */
+#define ITERATOR_MATCHED    0x0004u  /* last_start and last_end are set */
+#define ITERATOR_DONE       0x0008u  /* No further match is possible */
+
+
+
+/*************************************************
+*         Initialize a match iterator            *
+*************************************************/
+
+/* This sets up everything except the memory control fields, for
+pcre2_match_iterator_create(), pcre2_match_count(), and
+pcre2_match_parallel(). The length must not be PCRE2_ZERO_TERMINATED.
+
+Arguments:
+  iterator      the iterator
+  code          points to the compiled pattern
+  subject       points to the subject string
+  length        length of subject string
+  start_offset  where to start in the subject string
+  options       option bits
+
+Returns:        nothing
+*/
+
+void
+PRIV(match_iterator_init)(pcre2_real_match_iterator *iterator,
+  const pcre2_code *code, PCRE2_SPTR subject, PCRE2_SIZE length,
+  PCRE2_SIZE start_offset, uint32_t options)
+{
+iterator->code = (const pcre2_real_code *)code;
+iterator->subject = subject;
+iterator->length = length;
+iterator->offset = start_offset;
+iterator->last_start = iterator->last_end = 0;
+iterator->retry_offset = PCRE2_UNSET;
+iterator->options = options;
+iterator->flags = 0;
+memset(&iterator->cache, 0, sizeof(match_cache));
+iterator->search = NULL;
+iterator->search_data = NULL;
+}
+
+
+
+/*************************************************
+*           Create a match iterator              *
+*************************************************/
+
+/* If no context is supplied, use the memory allocator from the code. The
+subject must remain unchanged while the iterator is in use.
+
+Arguments:
+  code          points to the compiled pattern
+  subject       points to the subject string
+  length        length of subject string, or PCRE2_ZERO_TERMINATED
+  start_offset  where to start in the subject string
+  options       option bits
+  gcontext      points to a general context or is NULL
+
+Returns:        pointer to the new iterator or NULL on failure
+*/
+
+PCRE2_EXP_DEFN pcre2_match_iterator * PCRE2_CALL_CONVENTION
+pcre2_match_iterator_create(const pcre2_code *code, PCRE2_SPTR subject,
+  PCRE2_SIZE length, PCRE2_SIZE start_offset, uint32_t options,
+  pcre2_general_context *gcontext)
+{
+pcre2_match_iterator *iterator;
+
+if (subject == NULL && length == 0) subject = (PCRE2_SPTR)"";
+if (code == NULL || subject == NULL ||
+    (options & ~PUBLIC_ITERATOR_OPTIONS) != 0)
+  return NULL;
+if (length == PCRE2_ZERO_TERMINATED) length = PRIV(strlen)(subject);
+if (gcontext == NULL) gcontext = (pcre2_general_context *)code;
+
+iterator = PRIV(memctl_malloc)(sizeof(pcre2_real_match_iterator),
+  (pcre2_memctl *)gcontext);
+if (iterator == NULL) return NULL;
+PRIV(match_iterator_init)(iterator, code, subject, length, start_offset, options);
+return iterator;
+}
+
+
+
+/*************************************************
+*            Free a match iterator               *
+*************************************************/
+
+PCRE2_EXP_DEFN void PCRE2_CALL_CONVENTION
+pcre2_match_iterator_free(pcre2_match_iterator *iterator)
+{
+if (iterator != NULL)
+  iterator->memctl.free(iterator, iterator->memctl.memory_data);
+}
+
+
+
+/*************************************************
+*           Advance by one character             *
+*************************************************/
+
+/* This is used when no non-empty match can be found at a point where there
+was an empty match, in which case a CRLF sequence counts as one character if it
+is a valid newline, and after a match that did not move forward. It is also
+used by the stream and segment functions, which move on in the same way.
+
+Arguments:
+  code        the compiled pattern
+  subject     the subject
+  length      the length of the subject
+  offset      the current offset, which is less than the length
+  crlf        TRUE if CRLF may count as one character
+
+Returns:      the offset of the next character
+*/
+
+PCRE2_SIZE
+PRIV(next_char)(const pcre2_real_code *code, PCRE2_SPTR subject,
+  PCRE2_SIZE length, PCRE2_SIZE offset, BOOL crlf)
+{
+uint16_t nl = code->newline_convention;
+
+if (crlf && (nl == PCRE2_NEWLINE_CRLF || nl == PCRE2_NEWLINE_ANY ||
+     nl == PCRE2_NEWLINE_ANYCRLF) &&
+    offset < length - 1 &&
+    subject[offset] == CHAR_CR && subject[offset + 1] == CHAR_NL)
+  return offset + 2;
+
+offset++;
+#ifdef SUPPORT_UNICODE
+if ((code->overall_options & PCRE2_UTF) != 0)
+  {
+  while (offset < length && NOT_FIRSTCU(subject[offset])) offset++;
+  }
+#endif
+return offset;
+}
+
+
+
+/*************************************************
+*            Find the next matches               *
+*************************************************/
+
+/* Up to count matches are found, and the offsets of the start and end of each
+matched string are put into the offsets vector, in pairs. The match data block
+is left holding the last match, so with a count of one, the captured
+substrings of each match can be inspected in the usual way. An error is
+returned only when no matches have been found by this call; otherwise the
+matches are returned, and the error is returned by the next call.
+
+Arguments:
+  iterator     the iterator
+  offsets      points to a vector of 2*count offsets
+  count        the maximum number of matches to find
+  match_data   points to a match data block
+  mcontext     points to a match context, or is NULL
+
+Returns:       > 0 => the number of matches found
+               = 0 => count was zero
+               PCRE2_ERROR_NOMATCH when there are no more matches
+               other negative values for errors
+*/
+
+PCRE2_EXP_DEFN int PCRE2_CALL_CONVENTION
+pcre2_match_all(pcre2_match_iterator *iterator, PCRE2_SIZE *offsets,
+  uint32_t count, pcre2_match_data *match_data, pcre2_match_context *mcontext)
+{
+uint32_t found = 0;
+int rc = PCRE2_ERROR_NOMATCH;
+
+if (iterator == NULL || match_data == NULL || (offsets == NULL && count > 0))
+  return PCRE2_ERROR_NULL;
+
+while (found < count && (iterator->flags & ITERATOR_DONE) == 0)
+  {
+  PCRE2_SIZE *ovector = match_data->ovector;
+  PCRE2_SIZE start = iterator->offset;
+  uint32_t moptions = iterator->options;
+
+  if ((iterator->flags & ITERATOR_CHECKED) != 0)
+    moptions |= PCRE2_NO_UTF_CHECK;
+  if ((iterator->flags & ITERATOR_RETRY) != 0)
+    moptions |= PCRE2_NOTEMPTY_ATSTART|PCRE2_ANCHORED;
+
+  rc = (iterator->search != NULL)?
+    iterator->search(iterator, start, moptions, match_data, mcontext) :
+    PRIV(match_cached)((const pcre2_code *)iterator->code, iterator->subject,
+      iterator->length, start, moptions, match_data, mcontext,
+      &iterator->cache);
+
+  /* After a failure to match, the search is over, unless it was a retry
+  after an empty match, in which case move on by one character, as if that
+  character had been matched. */
+
+  if (rc == PCRE2_ERROR_NOMATCH)
+    {
+    iterator->flags |= ITERATOR_CHECKED;
+    if ((iterator->flags & ITERATOR_RETRY) == 0)
+      {
+      iterator->flags |= ITERATOR_DONE;
+      break;
+      }
+    iterator->flags &= ~ITERATOR_RETRY;
+    iterator->offset = PRIV(next_char)(iterator->code, iterator->subject,
+      iterator->length, start, TRUE);
+    iterator->last_start = start;
+    iterator->last_end = iterator->offset;
+    continue;
+    }
+
+  if (rc < 0) break;
+  iterator->flags |= ITERATOR_CHECKED;
+  iterator->flags &= ~ITERATOR_RETRY;
+
+  /* A pattern that cannot match at its starting offset, such as /(?<=\G.)/,
+  can return the same empty match again when the search is restarted at the
+  point of the match. Discard it, and look for a non-empty match there. The
+  same match in any other circumstance means that the search is not moving
+  forward, so it is abandoned. */
+
+  if ((iterator->flags & ITERATOR_MATCHED) != 0 &&
+      ovector[0] == iterator->last_start && ovector[1] == iterator->last_end)
+    {
+    if (ovector[0] == ovector[1] && iterator->retry_offset != start)
+      {
+      iterator->flags |= ITERATOR_RETRY;
+      iterator->retry_offset = start;
+      continue;
+      }
+    iterator->flags |= ITERATOR_DONE;
+    rc = PCRE2_ERROR_NOMATCH;
+    break;
+    }
+
+  offsets[2*found] = ovector[0];
+  offsets[2*found + 1] = ovector[1];
+  found++;
+  iterator->flags |= ITERATOR_MATCHED;
+  iterator->last_start = ovector[0];
+  iterator->last_end = ovector[1];
+  iterator->offset = ovector[1];
+
+  /* After an empty match, stop at the end of the subject. Otherwise, try for
+  a non-empty match at the same point, unless the match was beyond the start
+  of the search, in which case a search from the match point is tried first
+  (see above). After a non-empty match whose end is not beyond its start,
+  which can happen when \K is used in an assertion, move on from the start. */
+
+  if (ovector[0] == ovector[1])
+    {
+    if (ovector[1] >= iterator->length) iterator->flags |= ITERATOR_DONE;
+      else if (ovector[0] <= start) iterator->flags |= ITERATOR_RETRY;
+    }
+  else if (ovector[1] <= match_data->startchar)
+    {
+    if (match_data->startchar >= iterator->length)
+      iterator->flags |= ITERATOR_DONE;
+    else
+      iterator->offset = PRIV(next_char)(iterator->code, iterator->subject,
+        iterator->length, match_data->startchar, FALSE);
+    }
+  }
+
+return (found > 0)? (int)found : (count == 0)? 0 : rc;
+}
+
+
+
+/*************************************************
+*          Count the matches in a subject        *
+*************************************************/
+
+/* The matches are found as for a match iterator, but only their number is
+wanted, so the interpreter is told that captured substrings are not needed. It
+can then leave them out of its backtracking frames, provided nothing in the
+pattern reads them. If no match data block is supplied, one is obtained and
+freed internally; otherwise its contents are undefined afterwards.
+
+Arguments:
+  code          points to the compiled pattern
+  subject       points to the subject string
+  length        length of subject string, or PCRE2_ZERO_TERMINATED
+  start_offset  where to start in the subject string
+  options       option bits
+  match_data    points to a match data block, or is NULL
+  mcontext      points to a match context, or is NULL
+
+Returns:        >= 0 => the number of matches
+                < 0  => an error code
+*/
+
+PCRE2_EXP_DEFN int PCRE2_CALL_CONVENTION
+pcre2_match_count(const pcre2_code *code, PCRE2_SPTR subject,
+  PCRE2_SIZE length, PCRE2_SIZE start_offset, uint32_t options,
+  pcre2_match_data *match_data, pcre2_match_context *mcontext)
+{
+int rc;
+int total = 0;
+pcre2_match_data *internal_match_data = NULL;
+pcre2_real_match_iterator iterator;
+PCRE2_SIZE offsets[2*COUNT_BATCH];
+
+if (subject == NULL && length == 0) subject = (PCRE2_SPTR)"";
+if (code == NULL || subject == NULL) return PCRE2_ERROR_NULL;
+if ((options & ~PUBLIC_ITERATOR_OPTIONS) != 0) return PCRE2_ERROR_BADOPTION;
+if (length == PCRE2_ZERO_TERMINATED) length = PRIV(strlen)(subject);
+
+if (match_data == NULL)
+  {
+  match_data = internal_match_data =
+    pcre2_match_data_create(1, (pcre2_general_context *)code);
+  if (match_data == NULL) return PCRE2_ERROR_NOMEMORY;
+  }
+
+PRIV(match_iterator_init)(&iterator, code, subject, length, start_offset, options);
+iterator.cache.no_captures = TRUE;
+
+while ((rc = pcre2_match_all(&iterator, offsets, COUNT_BATCH, match_data,
+    mcontext)) > 0)
+  total += rc;
+if (rc == PCRE2_ERROR_NOMATCH) rc = total;
+
+if (internal_match_data != NULL) pcre2_match_data_free(internal_match_data);
+return rc;
+}
+
+/* End of pcre2_match_all.c */
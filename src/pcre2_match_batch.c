@@ -0,0 +1,211 @@
+/*************************************************
+*      Perl-Compatible Regular Expressions       *
+*************************************************/
+
+/* PCRE is a library of functions to support regular expressions whose syntax
+and semantics are as close as possible to those of the Perl 5 language.
+
+                       Written by Philip Hazel
+     Original API code Copyright (c) 1997-2012 University of Cambridge
+          New API code Copyright (c) 2016-2022 University of Cambridge
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the University of Cambridge nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+
+/* This module contains pcre2_match_batch(), which matches a pattern against
+each of an array of subjects held in columnar form, that is, one buffer of
+code units holding all the subjects end to end, and a vector of offsets that
+says where each one starts (the layout of a string column in Apache Arrow).
+Only whether each subject matches, and optionally where its first match
+starts, is returned.
+
+The checks that pcre2_match() makes on its arguments are made only once, the
+UTF validity of the whole buffer is checked in one pass, and a pattern that has
+a bit-parallel matcher is run directly when only the existence of a match is
+wanted, so the cost per subject is little more than that of the match itself.
+*/
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "pcre2_internal.h"
+
+/* Options that can be given for a batch. */
+
+#define PUBLIC_BATCH_OPTIONS \
+  (PCRE2_ANCHORED|PCRE2_ENDANCHORED|PCRE2_NOTBOL|PCRE2_NOTEOL|PCRE2_NOTEMPTY| \
+   PCRE2_NOTEMPTY_ATSTART|PCRE2_NO_JIT|PCRE2_NO_UTF_CHECK|PCRE2_MEMOIZE)
+
+
+
+/*************************************************
+*      Match a pattern against many subjects     *
+*************************************************/
+
+/* Subject i occupies the code units of data from offsets[i] up to (but not
+including) offsets[i+1], so there must be count+1 offsets, in ascending order.
+Each subject is matched from its start, independently of the others; in
+particular, lookbehinds cannot see the end of the previous subject.
+
+If bitmap is not NULL, bit i%8 of bitmap[i/8] is set if subject i matches and
+cleared otherwise; other bits are not changed. If starts is not NULL, starts[i]
+is set to the offset within subject i at which its first match starts, or to
+PCRE2_UNSET if it does not match. The contents of the match data block, if one
+is supplied, are undefined afterwards, except that if an error occurs, the
+error details are in it, with offsets relative to the subject that caused the
+error. The results for the subjects before that one have been set.
+
+Arguments:
+  code          points to the compiled pattern
+  data          points to the code units of all the subjects
+  offsets       points to a vector of count+1 offsets
+  count         the number of subjects
+  options       option bits
+  bitmap        points to a vector of (count+7)/8 bytes, or is NULL
+  starts        points to a vector of count offsets, or is NULL
+  match_data    points to a match data block, or is NULL
+  mcontext      points to a match context, or is NULL
+
+Returns:        >= 0 => the number of subjects that match
+                < 0  => an error code
+*/
+
+PCRE2_EXP_DEFN int PCRE2_CALL_CONVENTION
+pcre2_match_batch(const pcre2_code *code, PCRE2_SPTR data,
+  const PCRE2_SIZE *offsets, uint32_t count, uint32_t options, uint8_t *bitmap,
+  PCRE2_SIZE *starts, pcre2_match_data *match_data,
+  pcre2_match_context *mcontext)
+{
+int rc = 0;
+int matched = 0;
+uint32_t i;
+BOOL use_bitparallel;
+#ifdef SUPPORT_UNICODE
+BOOL checked = FALSE;
+#endif
+const pcre2_real_code *re = (const pcre2_real_code *)code;
+pcre2_match_data *internal_match_data = NULL;
+match_cache cache;
+
+if (data == NULL && count == 0) data = (PCRE2_SPTR)"";
+if (code == NULL || data == NULL || offsets == NULL) return PCRE2_ERROR_NULL;
+if ((options & ~PUBLIC_BATCH_OPTIONS) != 0) return PCRE2_ERROR_BADOPTION;
+if (count > INT_MAX) return PCRE2_ERROR_BADDATA;
+if (re->magic_number != MAGIC_NUMBER) return PCRE2_ERROR_BADMAGIC;
+if ((re->flags & PCRE2_MODE_MASK) != PCRE2_CODE_UNIT_WIDTH/8)
+  return PCRE2_ERROR_BADMODE;
+if (offsets[count] < offsets[0]) return PCRE2_ERROR_BADOFFSET;
+
+/* A pattern that has a bit-parallel matcher (which is never the case for UTF
+or UCP) is run directly when the start of each match is not wanted, provided
+the start of a match is not restricted, as in the existence-only path of
+pcre2_match(). */
+
+use_bitparallel = starts == NULL && re->bitparallel != NULL &&
+  (re->overall_options & PCRE2_FIRSTLINE) == 0 &&
+  (mcontext == NULL || mcontext->offset_limit == PCRE2_UNSET);
+
+/* Otherwise a match data block is needed. One that holds just the offsets of
+the whole match is enough. */
+
+if (!use_bitparallel && match_data == NULL)
+  {
+  match_data = internal_match_data =
+    pcre2_match_data_create(1, (pcre2_general_context *)code);
+  if (match_data == NULL) return PCRE2_ERROR_NOMEMORY;
+  }
+
+/* Check the UTF validity of all the subjects at once. If all is well, a
+subject that starts and ends at character boundaries need not be checked
+again; one that does not must contain an invalid character, which is found
+when it is checked individually. If there is an error, each subject is checked
+as it is matched, so that the error is reported for the right one. */
+
+#ifdef SUPPORT_UNICODE
+if ((re->overall_options & (PCRE2_UTF|PCRE2_MATCH_INVALID_UTF)) == PCRE2_UTF &&
+    (options & PCRE2_NO_UTF_CHECK) == 0)
+  {
+  PCRE2_SIZE erroroffset;
+  checked = PRIV(valid_utf)(data + offsets[0], offsets[count] - offsets[0],
+    &erroroffset) == 0;
+  }
+#endif
+
+for (i = 0; i < count; i++)
+  {
+  PCRE2_SPTR subject = data + offsets[i];
+  PCRE2_SIZE length = offsets[i+1] - offsets[i];
+  PCRE2_SIZE start = PCRE2_UNSET;
+
+  if (offsets[i+1] < offsets[i])
+    {
+    rc = PCRE2_ERROR_BADOFFSET;
+    break;
+    }
+
+  if (use_bitparallel)
+    {
+    if (PRIV(bitparallel_match)(re, subject, length, 0, options)) start = 0;
+    }
+  else
+    {
+    uint32_t moptions = options;
+
+#ifdef SUPPORT_UNICODE
+    if (checked && (length == 0 || !NOT_FIRSTCU(subject[0])) &&
+        (offsets[i+1] == offsets[count] || !NOT_FIRSTCU(subject[length])))
+      moptions |= PCRE2_NO_UTF_CHECK;
+#endif
+
+    memset(&cache, 0, sizeof(match_cache));
+    cache.no_captures = TRUE;
+    rc = PRIV(match_cached)(code, subject, length, 0, moptions, match_data,
+      mcontext, &cache);
+    if (rc == PCRE2_ERROR_NOMATCH) rc = 0;
+      else if (rc < 0) break;
+      else start = match_data->ovector[0];
+    }
+
+  if (start != PCRE2_UNSET) matched++;
+  if (bitmap != NULL)
+    {
+    if (start != PCRE2_UNSET) bitmap[i/8] |= (uint8_t)(1u << (i%8));
+      else bitmap[i/8] &= (uint8_t)~(1u << (i%8));
+    }
+  if (starts != NULL) starts[i] = start;
+  }
+
+if (internal_match_data != NULL) pcre2_match_data_free(internal_match_data);
+return (rc < 0)? rc : matched;
+}
+
+/* End of pcre2_match_batch.c */
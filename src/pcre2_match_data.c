@@ -64,6 +64,13 @@ yield = PRIV(memctl_malloc)(
 if (yield == NULL) return NULL;
 yield->oveccount = oveccount;
 yield->flags = 0;
+yield->heapframes = NULL;
+yield->heapframes_size = 0;
+yield->heapframes_limit = UINT32_MAX;
+yield->resume = NULL;
+yield->profile = NULL;
+yield->profile_size = 0;
+yield->profile_length = 0;
 return yield;
 }
 
@@ -98,12 +105,58 @@ if (match_data != NULL)
   if ((match_data->flags & PCRE2_MD_COPIED_SUBJECT) != 0)
     match_data->memctl.free((void *)match_data->subject,
       match_data->memctl.memory_data);
+  if (match_data->heapframes != NULL)
+    match_data->memctl.free(match_data->heapframes,
+      match_data->memctl.memory_data);
+  if (match_data->resume != NULL) PRIV(match_resume_free)(match_data);
+  if (match_data->profile != NULL)
+    match_data->memctl.free(match_data->profile,
+      match_data->memctl.memory_data);
   match_data->memctl.free(match_data, match_data->memctl.memory_data);
   }
 }
 
 
 
+/*************************************************
+*         Abandon a suspended match              *
+*************************************************/
+
+/* A match that pcre2_match() or pcre2_dfa_match() suspended after using up its
+step limit is discarded when the match data block is used for another match or
+freed. The memory that its match block points to is freed with the allocator
+that obtained it.
+
+Argument:   the match data block
+Returns:    nothing
+*/
+
+void
+PRIV(match_resume_free)(pcre2_match_data *match_data)
+{
+match_resume *resume = match_data->resume;
+
+if (resume->workspace == NULL)
+  {
+  match_block *mb = &(resume->u.mb);
+  if (mb->memo_bits != NULL)
+    mb->memctl.free(mb->memo_groups, mb->memctl.memory_data);
+  }
+else
+  {
+  dfa_match_block *mb = &(resume->u.dmb);
+  if (mb->state_index != NULL)
+    mb->memctl.free(mb->state_index, mb->memctl.memory_data);
+  if (mb->lazy != NULL)
+    mb->memctl.free(mb->lazy, mb->memctl.memory_data);
+  }
+
+match_data->memctl.free(resume, match_data->memctl.memory_data);
+match_data->resume = NULL;
+}
+
+
+
 /*************************************************
 *         Get last mark in match                 *
 *************************************************/
@@ -163,4 +216,129 @@ return offsetof(pcre2_match_data, ovector) +
   2 * (match_data->oveccount) * sizeof(PCRE2_SIZE);
 }
 
+
+
+
+/*************************************************
+*    Get size of retained heap frames vector     *
+*************************************************/
+
+PCRE2_EXP_DEFN PCRE2_SIZE PCRE2_CALL_CONVENTION
+pcre2_get_match_data_heapframes_size(pcre2_match_data *match_data)
+{
+return match_data->heapframes_size;
+}
+
+
+
+/*************************************************
+*   Set limit for retained heap frames vector    *
+*************************************************/
+
+/* The limit is in kibibytes. If a vector that is bigger than the new limit is
+currently retained, it is freed at once; zero means retain nothing. */
+
+PCRE2_EXP_DEFN int PCRE2_CALL_CONVENTION
+pcre2_set_match_data_heapframes_limit(pcre2_match_data *match_data,
+  uint32_t limit)
+{
+match_data->heapframes_limit = limit;
+if (match_data->heapframes != NULL &&
+    (limit == 0 || (match_data->heapframes_size / 1024) > limit))
+  {
+  match_data->memctl.free(match_data->heapframes,
+    match_data->memctl.memory_data);
+  match_data->heapframes = NULL;
+  match_data->heapframes_size = 0;
+  }
+return 0;
+}
+
+
+
+/*************************************************
+*        Enable or disable match statistics      *
+*************************************************/
+
+/* When statistics are enabled, every match that uses the match data block
+records what it did in the statistics block, which is cleared at the start of
+each match. Collecting them costs a little time, so they are off by default. */
+
+PCRE2_EXP_DEFN int PCRE2_CALL_CONVENTION
+pcre2_set_match_data_statistics(pcre2_match_data *match_data, int enable)
+{
+if (enable != 0)
+  match_data->flags |= PCRE2_MD_STATISTICS;
+else
+  match_data->flags &= ~PCRE2_MD_STATISTICS;
+memset(&match_data->statistics, 0, sizeof(pcre2_match_statistics));
+return 0;
+}
+
+
+
+/*************************************************
+*          Get the match statistics              *
+*************************************************/
+
+/* Returns NULL if statistics have not been enabled. */
+
+PCRE2_EXP_DEFN const pcre2_match_statistics * PCRE2_CALL_CONVENTION
+pcre2_get_match_statistics(pcre2_match_data *match_data)
+{
+if ((match_data->flags & PCRE2_MD_STATISTICS) == 0) return NULL;
+return &match_data->statistics;
+}
+
+
+
+/*************************************************
+*      Enable or disable opcode profiling        *
+*************************************************/
+
+/* When profiling is enabled, pcre2_match() counts how many times each opcode
+of the compiled pattern is obeyed. The vector of counts is obtained when it is
+first needed and kept for re-use; it is freed when profiling is disabled. */
+
+PCRE2_EXP_DEFN int PCRE2_CALL_CONVENTION
+pcre2_set_match_data_profile(pcre2_match_data *match_data, int enable)
+{
+if (enable != 0)
+  match_data->flags |= PCRE2_MD_PROFILE;
+else
+  {
+  match_data->flags &= ~PCRE2_MD_PROFILE;
+  if (match_data->profile != NULL)
+    match_data->memctl.free(match_data->profile,
+      match_data->memctl.memory_data);
+  match_data->profile = NULL;
+  match_data->profile_size = 0;
+  }
+match_data->profile_length = 0;
+return 0;
+}
+
+
+
+/*************************************************
+*            Get the opcode profile              *
+*************************************************/
+
+/* The counts are indexed by the offset of each opcode in the compiled code, in
+code units. Returns NULL if profiling is not enabled or no profiled match has
+yet been done. */
+
+PCRE2_EXP_DEFN const PCRE2_SIZE * PCRE2_CALL_CONVENTION
+pcre2_get_match_profile(pcre2_match_data *match_data, PCRE2_SIZE *length)
+{
+if ((match_data->flags & PCRE2_MD_PROFILE) == 0 ||
+    match_data->profile_length == 0)
+  {
+  *length = 0;
+  return NULL;
+  }
+*length = match_data->profile_length;
+return match_data->profile;
+}
+
 /* End of pcre2_match_data.c */
@@ -0,0 +1,756 @@
+/*************************************************
+*      Perl-Compatible Regular Expressions       *
+*************************************************/
+
+/* PCRE is a library of functions to support regular expressions whose syntax
+and semantics are as close as possible to those of the Perl 5 language.
+
+                       Written by Philip Hazel
+     Original API code Copyright (c) 1997-2012 University of Cambridge
+          New API code Copyright (c) 2016-2022 University of Cambridge
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the University of Cambridge nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+
+/* This module contains pcre2_match_parallel(), which finds all the matches of
+a pattern in a large subject, as a match iterator would, but with the searching
+shared between several threads.
+
+The subject is divided into chunks, and each thread takes chunks in turn and
+runs an iterator from the start of each one, with every search limited to
+starting points inside the chunk. Because a search can see the whole subject,
+a match that starts in a chunk is allowed to end beyond it, and lookbehinds
+before it work as usual. The outcome of each search is recorded. When all the
+chunks have been done, the real iteration is run from the start of the subject
+in the calling thread, and each search that it needs is answered from the
+records wherever possible. A search that the records cannot answer, such as
+one that starts in the middle of a match that crossed into the next chunk, is
+done for real, but only as far as the next recorded search, whose result is
+then used. The matches are therefore exactly those that a serial iteration
+would find.
+
+A search that fails with an error, such as exceeding the match limit, ends the
+searching of its chunk, and the error is recorded. A serial iteration would stop
+there, so no later chunk is started, and any that are in progress give up. The
+final iteration returns the recorded error when it reaches the failed search,
+without running it again.
+
+This depends on the result of an attempt at a given starting point being the
+same whatever the starting point of the search. One exception is a LF that
+follows a CR, which pcre2_match() may skip when it moves on from the CR, but not
+when a search starts there; no chunk starts at such a point, and where a search
+needs to start at one, the first attempt is done for real. It is not so for
+patterns that:
+
+  . contain \G, (*COMMIT), or (*SKIP);
+  . are anchored;
+  . use PCRE2_FIRSTLINE;
+  . use (*NOTEMPTY_ATSTART).
+
+For these, as for small subjects, the matches are found by an ordinary
+iteration. The same happens if thread support was not enabled when PCRE2 was
+built.
+
+The match and depth limits are counted afresh at each starting point, so they
+have the same effect however the searches are divided. The heap and memo limits
+apply to each thread's own searches, so together the threads may use that much
+memory each. A step limit, however, is counted over a whole search, and the
+searches in the chunks are not the same as those of a serial iteration, so when
+one is set an ordinary iteration is used as well. */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "pcre2_internal.h"
+
+/* Options that can be given, which are the same as for a match iterator. */
+
+#define PUBLIC_PARALLEL_OPTIONS \
+  (PCRE2_ANCHORED|PCRE2_NOTBOL|PCRE2_NOTEOL|PCRE2_NOTEMPTY|PCRE2_NO_JIT| \
+   PCRE2_NO_UTF_CHECK|PCRE2_MEMOIZE)
+
+/* The number of matches that are taken from the iterator at once, the
+smallest chunk size that is chosen by default, the number of chunks per thread
+that is aimed for by default (more than one so that the threads stay busy when
+some chunks take longer than others), the largest number of chunks, and the
+initial size of the vector of records for a chunk. */
+
+#define PARALLEL_BATCH              64
+#define PARALLEL_MIN_CHUNK       16384
+#define PARALLEL_CHUNKS_PER_THREAD   4
+#define PARALLEL_MAX_CHUNKS      65536
+#define PARALLEL_RECORDS            32
+
+/* The callback type */
+
+typedef int (*parallel_callback)(PCRE2_SIZE, PCRE2_SIZE, void *);
+
+#ifdef SUPPORT_THREADS
+
+/* Structure for the outcome of one search within a chunk. All the starting
+points from start up to startchar failed to match, except that startchar
+matched, giving ovector. If startchar is PCRE2_UNSET, there was no match at any
+starting point from start up to the chunk's limit. */
+
+typedef struct search_record {
+  PCRE2_SIZE start;               /* Where the search started */
+  PCRE2_SIZE startchar;           /* Where the match started, or PCRE2_UNSET */
+  PCRE2_SIZE ovector[2];          /* The matched string */
+} search_record;
+
+/* Structure for a chunk. The limit is the last starting point that searches
+in the chunk may try, which is PCRE2_UNSET for the last chunk. If a search
+failed with an error, it follows the last record. */
+
+typedef struct chunk_block {
+  PCRE2_SIZE start;               /* The first starting point */
+  PCRE2_SIZE limit;               /* The last starting point */
+  search_record *records;         /* The outcomes of the searches */
+  PCRE2_SIZE count;               /* The number of records */
+  PCRE2_SIZE size;                /* The size of the records vector */
+  PCRE2_SIZE error_start;         /* Where the failed search started */
+  int error;                      /* Its error code, or zero */
+} chunk_block;
+
+/* Structure for the data that is shared by all the threads */
+
+typedef struct parallel_block {
+  const pcre2_code *code;         /* The pattern */
+  PCRE2_SPTR subject;             /* The subject */
+  PCRE2_SIZE length;              /* Its length */
+  PCRE2_SIZE offset_limit;        /* The caller's offset limit */
+  uint32_t options;               /* Options for the iterators */
+  BOOL use_offset_limit;          /* Limit searches by the offset limit */
+  pcre2_memctl *memctl;           /* For getting memory */
+  chunk_block *chunks;            /* The chunks */
+  uint32_t chunk_count;           /* The number of chunks */
+  uint32_t next_chunk;            /* The next chunk to be done */
+  uint32_t stop_chunk;            /* The first chunk with an error */
+  thread_mutex mutex;             /* Protects next_chunk and stop_chunk */
+} parallel_block;
+
+/* Structure for the data that is private to a thread, including the match
+context that it uses, which is a copy of the caller's. */
+
+typedef struct worker_block {
+  parallel_block *pb;             /* The shared data */
+  chunk_block *chunk;             /* The current chunk */
+  pcre2_match_data *match_data;   /* The thread's match data */
+  pcre2_real_match_context context;  /* The thread's match context */
+  uint32_t chunk_index;           /* The stitcher's current chunk */
+  PCRE2_SIZE record_index;        /* The stitcher's current record */
+} worker_block;
+#endif  /* SUPPORT_THREADS */
+
+
+
+/*************************************************
+*     Run an iterator and deliver the matches    *
+*************************************************/
+
+/*
+Arguments:
+  iterator       the iterator
+  match_data     the match data block
+  mcontext       the match context
+  callback       the function to call for each match, or NULL
+  callback_data  data for the callback
+
+Returns:         >= 0 => the number of matches
+                 < 0  => an error code
+                 or the callback's non-zero return
+*/
+
+static int
+deliver_matches(pcre2_real_match_iterator *iterator,
+  pcre2_match_data *match_data, pcre2_match_context *mcontext,
+  parallel_callback callback, void *callback_data)
+{
+int rc;
+int total = 0;
+PCRE2_SIZE offsets[2*PARALLEL_BATCH];
+
+while ((rc = pcre2_match_all(iterator, offsets, PARALLEL_BATCH, match_data,
+    mcontext)) > 0)
+  {
+  int i;
+  if (callback != NULL) for (i = 0; i < rc; i++)
+    {
+    int crc = callback(offsets[2*i], offsets[2*i+1], callback_data);
+    if (crc != 0) return crc;
+    }
+  total += rc;
+  }
+
+return (rc == PCRE2_ERROR_NOMATCH)? total : rc;
+}
+
+
+
+#ifdef SUPPORT_THREADS
+/*************************************************
+*        Check for a LF that follows a CR        *
+*************************************************/
+
+/* The attempts at such a point can differ according to whether the search
+starts there or moves on to it from the CR (see above).
+
+Arguments:
+  pb          the shared data
+  offset      the offset in the subject
+
+Returns:      TRUE if offset is at a LF that follows a CR
+*/
+
+static BOOL
+is_crlf_middle(parallel_block *pb, PCRE2_SIZE offset)
+{
+return offset > 0 && offset < pb->length &&
+  pb->subject[offset - 1] == CHAR_CR && pb->subject[offset] == CHAR_NL;
+}
+
+
+
+/*************************************************
+*         Search with a starting limit           *
+*************************************************/
+
+/* The limit is applied through the offset limit if the pattern allows it, so
+that JIT can be used; otherwise it is given to the interpreter in the match
+cache.
+
+Arguments:
+  pb           the shared data
+  start        where to start searching
+  limit        the last starting point, or PCRE2_UNSET
+  options      option bits
+  match_data   the match data block
+  mcontext     the thread's own match context
+  cache        the iterator's cache
+
+Returns:       the result of the search
+*/
+
+static int
+limited_search(parallel_block *pb, PCRE2_SIZE start, PCRE2_SIZE limit,
+  uint32_t options, pcre2_match_data *match_data,
+  pcre2_match_context *mcontext, match_cache *cache)
+{
+cache->bumpalong_limit = NULL;
+if (pb->use_offset_limit)
+  mcontext->offset_limit = (limit < pb->offset_limit)? limit : pb->offset_limit;
+else if (limit != PCRE2_UNSET)
+  {
+  cache->bumpalong_limit = pb->subject + limit;
+  options |= PCRE2_NO_JIT;
+  }
+return PRIV(match_cached)(pb->code, pb->subject, pb->length, start, options,
+  match_data, mcontext, cache);
+}
+
+
+
+/*************************************************
+*     Search within a chunk and record it        *
+*************************************************/
+
+/* This is the search function for the iterators that run in the threads.
+Retries after empty matches are not recorded, because the final iteration
+always does them itself. After an error, nothing more is done in the chunk or
+in any later one. A chunk that is abandoned because of an error in an earlier
+one keeps the records that it has; the final iteration searches the rest of it
+for itself if it ever gets that far.
+
+Arguments:
+  iterator     the iterator
+  start        where to start searching
+  options      option bits
+  match_data   the match data block
+  mcontext     the thread's own match context
+
+Returns:       the result of the search
+*/
+
+static int
+record_search(pcre2_real_match_iterator *iterator, PCRE2_SIZE start,
+  uint32_t options, pcre2_match_data *match_data,
+  pcre2_match_context *mcontext)
+{
+worker_block *wb = (worker_block *)iterator->search_data;
+parallel_block *pb = wb->pb;
+chunk_block *chunk = wb->chunk;
+uint32_t index = (uint32_t)(chunk - pb->chunks);
+uint32_t stop;
+search_record *record;
+int rc;
+
+if (start > chunk->limit) return PCRE2_ERROR_NOMATCH;
+
+PRIV(mutex_lock)(&pb->mutex);
+stop = pb->stop_chunk;
+PRIV(mutex_unlock)(&pb->mutex);
+if (index > stop) return PCRE2_ERROR_NOMATCH;
+
+rc = limited_search(pb, start, chunk->limit, options, match_data, mcontext,
+  &iterator->cache);
+
+if (rc < 0 && rc != PCRE2_ERROR_NOMATCH)
+  {
+  if ((options & PCRE2_NOTEMPTY_ATSTART) == 0)
+    {
+    chunk->error = rc;
+    chunk->error_start = start;
+    }
+  PRIV(mutex_lock)(&pb->mutex);
+  if (index < pb->stop_chunk) pb->stop_chunk = index;
+  PRIV(mutex_unlock)(&pb->mutex);
+  return rc;
+  }
+if ((options & PCRE2_NOTEMPTY_ATSTART) != 0) return rc;
+
+if (chunk->count >= chunk->size)
+  {
+  PCRE2_SIZE newsize = (chunk->size == 0)? PARALLEL_RECORDS : 2*chunk->size;
+  search_record *newrecords = PRIV(memctl_malloc)(
+    newsize * sizeof(search_record), pb->memctl);
+  if (newrecords == NULL) return PCRE2_ERROR_NOMEMORY;
+  if (chunk->count > 0)
+    memcpy(newrecords, chunk->records, chunk->count * sizeof(search_record));
+  if (chunk->records != NULL)
+    pb->memctl->free(chunk->records, pb->memctl->memory_data);
+  chunk->records = newrecords;
+  chunk->size = newsize;
+  }
+
+record = chunk->records + chunk->count++;
+record->start = start;
+if (rc < 0) record->startchar = PCRE2_UNSET; else
+  {
+  record->startchar = match_data->startchar;
+  record->ovector[0] = match_data->ovector[0];
+  record->ovector[1] = match_data->ovector[1];
+  }
+return rc;
+}
+
+
+
+/*************************************************
+*     Answer a search from the records           *
+*************************************************/
+
+/* This is the search function for the final iteration. The searches that it
+is asked for start at offsets that never decrease, so the current chunk and
+record are remembered from one call to the next.
+
+Arguments:
+  iterator     the iterator
+  start        where to start searching
+  options      option bits
+  match_data   the match data block
+  mcontext     the calling thread's copy of the match context
+
+Returns:       the result of the search
+*/
+
+static int
+stitch_search(pcre2_real_match_iterator *iterator, PCRE2_SIZE start,
+  uint32_t options, pcre2_match_data *match_data,
+  pcre2_match_context *mcontext)
+{
+worker_block *wb = (worker_block *)iterator->search_data;
+parallel_block *pb = wb->pb;
+
+/* A retry after an empty match is always done for real. */
+
+if ((options & PCRE2_NOTEMPTY_ATSTART) != 0)
+  return limited_search(pb, start, PCRE2_UNSET, options, match_data, mcontext,
+    &iterator->cache);
+
+for (;;)
+  {
+  chunk_block *chunk;
+  search_record *record;
+  PCRE2_SIZE next;
+  int rc;
+
+  /* Find the chunk that contains the starting point, and the first record
+  whose search covers it or comes after it. */
+
+  while (wb->chunk_index + 1 < pb->chunk_count &&
+         start >= pb->chunks[wb->chunk_index + 1].start)
+    {
+    wb->chunk_index++;
+    wb->record_index = 0;
+    }
+  chunk = pb->chunks + wb->chunk_index;
+
+  for (; wb->record_index < chunk->count; wb->record_index++)
+    {
+    record = chunk->records + wb->record_index;
+    if (start <= ((record->startchar == PCRE2_UNSET)?
+        chunk->limit : record->startchar)) break;
+    }
+
+  /* If a recorded search covers the starting point, its match is the answer.
+  If it failed, move on to the next chunk. A starting point at a LF that
+  follows a CR is tried on its own first, unless the recorded search started
+  there. */
+
+  if (wb->record_index < chunk->count &&
+      (record = chunk->records + wb->record_index)->start <= start)
+    {
+    if (record->start < start && is_crlf_middle(pb, start))
+      {
+      rc = limited_search(pb, start, start, options, match_data, mcontext,
+        &iterator->cache);
+      if (rc != PCRE2_ERROR_NOMATCH) return rc;
+      start++;
+      continue;
+      }
+    if (record->startchar != PCRE2_UNSET)
+      {
+      match_data->ovector[0] = record->ovector[0];
+      match_data->ovector[1] = record->ovector[1];
+      match_data->startchar = record->startchar;
+      match_data->rc = 1;
+      return 1;
+      }
+    if (chunk->limit == PCRE2_UNSET) return PCRE2_ERROR_NOMATCH;
+    start = chunk->limit + 1;
+    continue;
+    }
+
+  /* A search that starts where a recorded search failed with an error would
+  fail in the same way. */
+
+  if (wb->record_index >= chunk->count && chunk->error != 0 &&
+      start == chunk->error_start)
+    return chunk->error;
+
+  /* Otherwise, search as far as the next recorded search or failed search,
+  and if that fails, carry on from there. If the next search started at a LF
+  that follows a CR, this search decides about that point, and the next one
+  carries on after it. */
+
+  next = (wb->record_index < chunk->count)?
+    chunk->records[wb->record_index].start :
+    (chunk->error != 0 && start < chunk->error_start)? chunk->error_start :
+    (wb->chunk_index + 1 < pb->chunk_count)?
+    pb->chunks[wb->chunk_index + 1].start : PCRE2_UNSET;
+  if (next != PCRE2_UNSET && is_crlf_middle(pb, next))
+    {
+    rc = limited_search(pb, start, next, options, match_data, mcontext,
+      &iterator->cache);
+    if (rc != PCRE2_ERROR_NOMATCH) return rc;
+    start = next + 1;
+    continue;
+    }
+
+  rc = limited_search(pb, start, (next == PCRE2_UNSET)? PCRE2_UNSET : next - 1,
+    options, match_data, mcontext, &iterator->cache);
+  if (rc != PCRE2_ERROR_NOMATCH || next == PCRE2_UNSET) return rc;
+  start = next;
+  }
+}
+
+
+
+/*************************************************
+*        Search chunks until all are done        *
+*************************************************/
+
+/* This is run by each thread, including the calling thread.
+
+Argument:   points to the thread's worker block
+Returns:    zero
+*/
+
+static thread_result THREAD_CALL
+search_chunks(void *arg)
+{
+worker_block *wb = (worker_block *)arg;
+parallel_block *pb = wb->pb;
+
+for (;;)
+  {
+  uint32_t i;
+  pcre2_real_match_iterator iterator;
+  PCRE2_SIZE offsets[2*PARALLEL_BATCH];
+
+  PRIV(mutex_lock)(&pb->mutex);
+  i = pb->next_chunk;
+  if (i > pb->stop_chunk) i = pb->chunk_count;
+  if (i < pb->chunk_count) pb->next_chunk++;
+  PRIV(mutex_unlock)(&pb->mutex);
+  if (i >= pb->chunk_count) break;
+
+  wb->chunk = pb->chunks + i;
+  PRIV(match_iterator_init)(&iterator, pb->code, pb->subject, pb->length,
+    wb->chunk->start, pb->options);
+  iterator.cache.no_captures = TRUE;
+  iterator.search = record_search;
+  iterator.search_data = wb;
+  while (pcre2_match_all(&iterator, offsets, PARALLEL_BATCH, wb->match_data,
+    &wb->context) > 0) {}
+  }
+
+return 0;
+}
+#endif  /* SUPPORT_THREADS */
+
+
+
+/*************************************************
+*       Find all matches using several threads   *
+*************************************************/
+
+/* The matches are found as by a match iterator, and the callback, if there is
+one, is called for each of them in order, in the calling thread. If it returns
+a non-zero value, no more matches are delivered, and that value is returned.
+The subject is divided into chunks of chunk_size code units, or of a size
+chosen from the length of the subject and the number of threads if chunk_size
+is zero. Callouts and the memory management functions may be called from
+several threads at once. A JIT stack that is assigned in the match context is
+used only in the calling thread.
+
+Arguments:
+  code           points to the compiled pattern
+  subject        points to the subject string
+  length         length of subject string, or PCRE2_ZERO_TERMINATED
+  start_offset   where to start in the subject string
+  options        option bits
+  threads        the largest number of threads to use, including the caller
+  chunk_size     the size of each chunk, or zero
+  callback       the function to call for each match, or NULL
+  callback_data  data for the callback
+  mcontext       points to a match context, or is NULL
+
+Returns:         >= 0 => the number of matches
+                 < 0  => an error code
+                 or the callback's non-zero return
+*/
+
+PCRE2_EXP_DEFN int PCRE2_CALL_CONVENTION
+pcre2_match_parallel(const pcre2_code *code, PCRE2_SPTR subject,
+  PCRE2_SIZE length, PCRE2_SIZE start_offset, uint32_t options,
+  uint32_t threads, PCRE2_SIZE chunk_size,
+  int (*callback)(PCRE2_SIZE, PCRE2_SIZE, void *), void *callback_data,
+  pcre2_match_context *mcontext)
+{
+int rc;
+const pcre2_real_code *re = (const pcre2_real_code *)code;
+pcre2_memctl *memctl;
+pcre2_match_data *match_data;
+pcre2_real_match_iterator iterator;
+#ifdef SUPPORT_THREADS
+parallel_block pb;
+worker_block *workers;
+thread_handle *handles;
+PCRE2_SIZE end, range;
+uint32_t i, started, thread_count;
+#endif
+
+if (subject == NULL && length == 0) subject = (PCRE2_SPTR)"";
+if (code == NULL || subject == NULL) return PCRE2_ERROR_NULL;
+if ((options & ~PUBLIC_PARALLEL_OPTIONS) != 0) return PCRE2_ERROR_BADOPTION;
+if (re->magic_number != MAGIC_NUMBER) return PCRE2_ERROR_BADMAGIC;
+if ((re->flags & PCRE2_MODE_MASK) != PCRE2_CODE_UNIT_WIDTH/8)
+  return PCRE2_ERROR_BADMODE;
+if (length == PCRE2_ZERO_TERMINATED) length = PRIV(strlen)(subject);
+
+memctl = (mcontext == NULL)? (pcre2_memctl *)&re->memctl : &mcontext->memctl;
+match_data = pcre2_match_data_create(1, (pcre2_general_context *)memctl);
+if (match_data == NULL) return PCRE2_ERROR_NOMEMORY;
+
+PRIV(match_iterator_init)(&iterator, code, subject, length, start_offset,
+  options);
+iterator.cache.no_captures = TRUE;
+
+#ifdef SUPPORT_THREADS
+
+/* Decide whether the search can be divided. If not, or if anything goes
+wrong while setting up the threads, fall back to an ordinary iteration. */
+
+end = length;
+if (mcontext != NULL && mcontext->offset_limit < length)
+  end = mcontext->offset_limit;
+range = (start_offset < end)? end - start_offset : 0;
+if (chunk_size == 0)
+  {
+  chunk_size = (threads == 0)? range :
+    range / threads / PARALLEL_CHUNKS_PER_THREAD;
+  if (chunk_size < PARALLEL_MIN_CHUNK) chunk_size = PARALLEL_MIN_CHUNK;
+  }
+
+if (threads <= 1 || range <= chunk_size ||
+    ((options | re->overall_options) & PCRE2_ANCHORED) != 0 ||
+    (re->overall_options & PCRE2_FIRSTLINE) != 0 ||
+    (re->flags & (PCRE2_STARTDEP|PCRE2_NE_ATST_SET)) != 0 ||
+    (mcontext != NULL &&
+      (mcontext->step_limit != 0 ||
+      (mcontext->offset_limit != PCRE2_UNSET &&
+        (re->overall_options & PCRE2_USE_OFFSET_LIMIT) == 0))))
+  goto SERIAL;
+
+/* Check the UTF validity of the whole subject once. If it is not valid, or
+the starting offset is not at a character boundary, an ordinary iteration
+reports the error in the usual way. */
+
+#ifdef SUPPORT_UNICODE
+if ((re->overall_options & PCRE2_UTF) != 0)
+  {
+  if (NOT_FIRSTCU(subject[start_offset])) goto SERIAL;
+  if ((re->overall_options & PCRE2_MATCH_INVALID_UTF) == 0 &&
+      (options & PCRE2_NO_UTF_CHECK) == 0)
+    {
+    PCRE2_SIZE erroroffset;
+    if (PRIV(valid_utf)(subject, length, &erroroffset) != 0) goto SERIAL;
+    options |= PCRE2_NO_UTF_CHECK;
+    iterator.options = options;
+    }
+  }
+#endif
+
+if ((range - 1) / chunk_size >= PARALLEL_MAX_CHUNKS)
+  chunk_size = (range - 1) / PARALLEL_MAX_CHUNKS + 1;
+
+pb.code = code;
+pb.subject = subject;
+pb.length = length;
+pb.offset_limit = (mcontext == NULL)? PCRE2_UNSET : mcontext->offset_limit;
+pb.options = options;
+pb.use_offset_limit = (re->overall_options & PCRE2_USE_OFFSET_LIMIT) != 0;
+pb.memctl = memctl;
+pb.chunk_count = (uint32_t)((range - 1) / chunk_size + 1);
+pb.next_chunk = 0;
+pb.stop_chunk = pb.chunk_count;
+
+thread_count = (threads < pb.chunk_count)? threads : pb.chunk_count;
+pb.chunks = PRIV(memctl_malloc)(pb.chunk_count * sizeof(chunk_block) +
+  thread_count * (sizeof(worker_block) + sizeof(thread_handle)), memctl);
+if (pb.chunks == NULL) goto SERIAL;
+workers = (worker_block *)(pb.chunks + pb.chunk_count);
+handles = (thread_handle *)(workers + thread_count);
+
+if (!PRIV(mutex_init)(&pb.mutex))
+  {
+  memctl->free(pb.chunks, memctl->memory_data);
+  goto SERIAL;
+  }
+
+/* Set up the chunks. In UTF mode, each one must start at a character
+boundary, and none may start at a LF that follows a CR. */
+
+for (i = 0; i < pb.chunk_count; i++)
+  {
+  chunk_block *chunk = pb.chunks + i;
+  chunk->start = start_offset + i * chunk_size;
+#ifdef SUPPORT_UNICODE
+  if ((re->overall_options & PCRE2_UTF) != 0)
+    while (chunk->start < length && NOT_FIRSTCU(subject[chunk->start]))
+      chunk->start++;
+#endif
+  if (is_crlf_middle(&pb, chunk->start)) chunk->start++;
+  chunk->records = NULL;
+  chunk->count = chunk->size = 0;
+  chunk->error = 0;
+  if (i > 0) pb.chunks[i-1].limit = chunk->start - 1;
+  }
+pb.chunks[pb.chunk_count - 1].limit = PCRE2_UNSET;
+
+/* Set up the workers. The first belongs to the calling thread, and uses its
+match data block. The others get their own, and copies of the match context
+without the caller's JIT stack. A thread that cannot be set up takes no part;
+if necessary, the calling thread does all the chunks itself. */
+
+for (i = 0; i < thread_count; i++)
+  {
+  worker_block *wb = workers + i;
+  wb->pb = &pb;
+  wb->chunk_index = 0;
+  wb->record_index = 0;
+  wb->context = (mcontext == NULL)? PRIV(default_match_context) : *mcontext;
+  if (i == 0) wb->match_data = match_data; else
+    {
+#ifdef SUPPORT_JIT
+    wb->context.jit_callback = NULL;
+    wb->context.jit_callback_data = NULL;
+#endif
+    wb->match_data = pcre2_match_data_create(1,
+      (pcre2_general_context *)memctl);
+    }
+  }
+
+for (started = 1; started < thread_count; started++)
+  {
+  if (workers[started].match_data == NULL ||
+      !PRIV(thread_create)(handles + started, search_chunks,
+        workers + started))
+    break;
+  }
+
+(void)search_chunks(workers);
+for (i = 1; i < started; i++) PRIV(thread_join)(handles[i]);
+for (i = 1; i < thread_count; i++)
+  if (workers[i].match_data != NULL)
+    pcre2_match_data_free(workers[i].match_data);
+PRIV(mutex_destroy)(&pb.mutex);
+
+/* Now run the real iteration, using the records. */
+
+iterator.search = stitch_search;
+iterator.search_data = workers;
+workers->context.offset_limit = pb.offset_limit;
+rc = deliver_matches(&iterator, match_data,
+  (pcre2_match_context *)&workers->context, callback, callback_data);
+
+for (i = 0; i < pb.chunk_count; i++)
+  if (pb.chunks[i].records != NULL)
+    memctl->free(pb.chunks[i].records, memctl->memory_data);
+memctl->free(pb.chunks, memctl->memory_data);
+pcre2_match_data_free(match_data);
+return rc;
+
+SERIAL:
+#else
+(void)threads;
+(void)chunk_size;
+#endif  /* SUPPORT_THREADS */
+
+rc = deliver_matches(&iterator, match_data, mcontext, callback,
+  callback_data);
+pcre2_match_data_free(match_data);
+return rc;
+}
+
+/* End of pcre2_match_parallel.c */
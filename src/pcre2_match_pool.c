@@ -0,0 +1,647 @@
+/*************************************************
+*      Perl-Compatible Regular Expressions       *
+*************************************************/
+
+/* PCRE is a library of functions to support regular expressions whose syntax
+and semantics are as close as possible to those of the Perl 5 language.
+
+                       Written by Philip Hazel
+     Original API code Copyright (c) 1997-2012 University of Cambridge
+          New API code Copyright (c) 2016-2022 University of Cambridge
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the University of Cambridge nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+
+/* This module contains the functions for a match pool, which matches one
+pattern against each of a large set of subjects, sharing the work between a
+number of threads. The threads are created with the pool and wait between
+runs, and each has its own match data block and, optionally, its own JIT stack,
+so that nothing needs to be set up per subject or per run.
+
+At the start of a run, the subjects are divided evenly between the workers,
+each of which takes subjects one at a time from the front of its own range.
+When a worker's range is empty, it steals the back half of the range of
+another worker that still has subjects left, so that the load stays balanced
+even when some subjects take much longer to match than others. Each range has
+its own mutex, which is held only while an index is taken or a range is split,
+so there is little contention. The calling thread acts as one of the workers.
+
+If thread support was not enabled when PCRE2 was built, a pool has just one
+worker, and the subjects are matched in the calling thread. */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "pcre2_internal.h"
+
+/* Options that can be given for a run. */
+
+#define PUBLIC_POOL_OPTIONS \
+  (PCRE2_ANCHORED|PCRE2_ENDANCHORED|PCRE2_NOTBOL|PCRE2_NOTEOL|PCRE2_NOTEMPTY| \
+   PCRE2_NOTEMPTY_ATSTART|PCRE2_NO_JIT|PCRE2_NO_UTF_CHECK|PCRE2_MEMOIZE)
+
+/* The initial size of a worker's JIT stack. */
+
+#define POOL_JIT_STACK_START 32768
+
+
+
+/*************************************************
+*       Lock and unlock a worker's range         *
+*************************************************/
+
+/* When there is no thread support, there is only one worker, and these do
+nothing. */
+
+static void
+lock_worker(pool_worker *w)
+{
+#ifdef SUPPORT_THREADS
+PRIV(mutex_lock)(&w->mutex);
+#else
+(void)w;
+#endif
+}
+
+static void
+unlock_worker(pool_worker *w)
+{
+#ifdef SUPPORT_THREADS
+PRIV(mutex_unlock)(&w->mutex);
+#else
+(void)w;
+#endif
+}
+
+
+
+/*************************************************
+*         Find the next subject to match         *
+*************************************************/
+
+/* A worker first takes the next subject in its own range. If that is empty,
+it looks at each of the other workers in turn, starting with the one after
+itself, and takes the back half of the first non-empty range it finds (the
+whole range if only one subject is left). The first of these is returned, and
+the rest become the worker's own range.
+
+The stolen range is installed after the victim's lock has been released, so a
+run may have been stopped in between. The stop value is set only while every
+worker's lock is held (see stop_run() below), so it is checked under the
+worker's own lock both before taking a subject and before installing a stolen
+range; once a run has been stopped, nothing more is started.
+
+Arguments:
+  w           the worker
+  index       where to put the subject's index
+
+Returns:      TRUE if a subject was found; FALSE if there is no work left
+*/
+
+static BOOL
+next_subject(pool_worker *w, uint32_t *index)
+{
+BOOL found = FALSE;
+pcre2_real_match_pool *pool = w->pool;
+uint32_t self = (uint32_t)(w - pool->workers);
+uint32_t i;
+
+lock_worker(w);
+if (pool->stop != 0)
+  {
+  unlock_worker(w);
+  return FALSE;
+  }
+if (w->next < w->end)
+  {
+  *index = w->next++;
+  found = TRUE;
+  }
+unlock_worker(w);
+if (found) return TRUE;
+
+for (i = 1; i < pool->worker_count; i++)
+  {
+  uint32_t start = 0, end = 0;
+  pool_worker *victim = pool->workers + (self + i) % pool->worker_count;
+
+  lock_worker(victim);
+  if (pool->stop == 0 && victim->next < victim->end)
+    {
+    end = victim->end;
+    start = victim->next + (victim->end - victim->next) / 2;
+    victim->end = start;
+    found = TRUE;
+    }
+  unlock_worker(victim);
+
+  if (found)
+    {
+    lock_worker(w);
+    if (pool->stop != 0) found = FALSE;
+    else
+      {
+      *index = start;
+      w->next = start + 1;
+      w->end = end;
+      }
+    unlock_worker(w);
+    return found;
+    }
+  }
+
+return FALSE;
+}
+
+
+
+/*************************************************
+*          Stop a run early on request           *
+*************************************************/
+
+/* When a callback returns a non-zero value, the first such value is kept, and
+all the ranges are emptied so that no more subjects are started. Subjects that
+other workers are already matching are finished, and their callbacks are
+called as usual. The locks of all the workers are held, always taken in the
+same order, while the value is set, so a worker that holds its own lock sees
+either a run that has not stopped or one that has. next_subject() never holds
+more than one lock, so this cannot deadlock. */
+
+static void
+stop_run(pcre2_real_match_pool *pool, int value)
+{
+uint32_t i;
+
+for (i = 0; i < pool->worker_count; i++) lock_worker(pool->workers + i);
+if (pool->stop == 0) pool->stop = value;
+for (i = 0; i < pool->worker_count; i++)
+  {
+  pool_worker *w = pool->workers + i;
+  w->end = w->next;
+  unlock_worker(w);
+  }
+}
+
+
+
+/*************************************************
+*     Match subjects until there are none left   *
+*************************************************/
+
+/* This is what each worker does during a run. When there is no callback, the
+captured substrings are not needed, so the matching is done without them, as
+for pcre2_match_batch().
+
+Argument:   the worker
+Returns:    nothing
+*/
+
+static void
+run_worker(pool_worker *w)
+{
+uint32_t i;
+pcre2_real_match_pool *pool = w->pool;
+pcre2_match_context *mcontext = (pcre2_match_context *)&w->mcontext;
+match_cache cache;
+
+while (next_subject(w, &i))
+  {
+  int rc;
+  PCRE2_SPTR subject = pool->subjects[i];
+  PCRE2_SIZE length = (pool->lengths == NULL)?
+    PCRE2_ZERO_TERMINATED : pool->lengths[i];
+
+  if (pool->callback == NULL)
+    {
+    memset(&cache, 0, sizeof(match_cache));
+    cache.no_captures = TRUE;
+    rc = PRIV(match_cached)((const pcre2_code *)pool->code, subject, length,
+      0, pool->options, w->match_data, mcontext, &cache);
+    }
+  else rc = pcre2_match((const pcre2_code *)pool->code, subject, length, 0,
+    pool->options, w->match_data, mcontext);
+
+  if (rc >= 0) w->matched++;
+  else if (rc != PCRE2_ERROR_NOMATCH)
+    {
+#ifdef SUPPORT_THREADS
+    PRIV(mutex_lock)(&pool->mutex);
+#endif
+    if (i < pool->error_index)
+      {
+      pool->error = rc;
+      pool->error_index = i;
+      }
+#ifdef SUPPORT_THREADS
+    PRIV(mutex_unlock)(&pool->mutex);
+#endif
+    }
+
+  if (pool->results != NULL)
+    {
+    pool->results[2*i] = (rc >= 0)? w->match_data->ovector[0] : PCRE2_UNSET;
+    pool->results[2*i+1] = (rc >= 0)? w->match_data->ovector[1] : PCRE2_UNSET;
+    }
+
+  if (pool->callback != NULL)
+    {
+    int crc = pool->callback(i, rc, w->match_data, pool->callback_data);
+    if (crc != 0) stop_run(pool, crc);
+    }
+  }
+}
+
+
+
+#ifdef SUPPORT_THREADS
+/*************************************************
+*         The function for a pool thread         *
+*************************************************/
+
+/* Each thread other than the caller's waits for a run to start, takes part in
+it, and then reports that it has finished, until the pool is freed.
+
+Argument:   the worker
+Returns:    0
+*/
+
+static thread_result THREAD_CALL
+pool_thread(void *data)
+{
+pool_worker *w = (pool_worker *)data;
+pcre2_real_match_pool *pool = w->pool;
+uint32_t generation = 0;
+
+for (;;)
+  {
+  PRIV(mutex_lock)(&pool->mutex);
+  while (pool->generation == generation && !pool->shutdown)
+    PRIV(cond_wait)(&pool->start, &pool->mutex);
+  if (pool->shutdown)
+    {
+    PRIV(mutex_unlock)(&pool->mutex);
+    break;
+    }
+  generation = pool->generation;
+  PRIV(mutex_unlock)(&pool->mutex);
+
+  run_worker(w);
+
+  PRIV(mutex_lock)(&pool->mutex);
+  if (--pool->active == 0) PRIV(cond_broadcast)(&pool->done);
+  PRIV(mutex_unlock)(&pool->mutex);
+  }
+
+return 0;
+}
+#endif  /* SUPPORT_THREADS */
+
+
+
+/*************************************************
+*              Free a match pool                 *
+*************************************************/
+
+/* The threads are stopped before anything is freed. This is also used to tidy
+up a pool that could not be completely created, for which worker_count is the
+number of workers whose match data and JIT stack fields have been set. The
+started argument is the number of workers with threads, counting the caller as
+one; when it is zero, the mutexes and condition variables were never set up. */
+
+static void
+free_pool(pcre2_real_match_pool *pool, uint32_t started)
+{
+uint32_t i;
+
+#ifdef SUPPORT_THREADS
+if (started > 0)
+  {
+  PRIV(mutex_lock)(&pool->mutex);
+  pool->shutdown = TRUE;
+  PRIV(cond_broadcast)(&pool->start);
+  PRIV(mutex_unlock)(&pool->mutex);
+  for (i = 1; i < started; i++) PRIV(thread_join)(pool->workers[i].handle);
+  for (i = 0; i < pool->worker_count; i++)
+    PRIV(mutex_destroy)(&pool->workers[i].mutex);
+  PRIV(cond_destroy)(&pool->done);
+  PRIV(cond_destroy)(&pool->start);
+  PRIV(mutex_destroy)(&pool->mutex);
+  }
+#else
+(void)started;
+#endif
+
+for (i = 0; i < pool->worker_count; i++)
+  {
+  pool_worker *w = pool->workers + i;
+  if (w->match_data != NULL) pcre2_match_data_free(w->match_data);
+  if (w->jit_stack != NULL) pcre2_jit_stack_free(w->jit_stack);
+  }
+
+pool->memctl.free(pool, pool->memctl.memory_data);
+}
+
+
+
+/*************************************************
+*              Create a match pool               *
+*************************************************/
+
+/* The pool has the given number of workers, one of which is the thread that
+calls pcre2_match_pool_run(), so threads-1 new threads are started. If thread
+support is not available, there is always one worker. If jit_stack_size is not
+zero and JIT is supported, each worker gets a JIT stack that can grow to that
+size; otherwise JIT matching uses the stack from the match context of each
+run, or the default.
+
+Arguments:
+  code            points to the compiled pattern
+  threads         the number of workers
+  jit_stack_size  the maximum size of each worker's JIT stack, or 0
+  gcontext        points to a general context, or is NULL
+
+Returns:          a pointer to the pool, or NULL if the pattern is NULL or
+                    memory or a thread could not be obtained
+*/
+
+PCRE2_EXP_DEFN pcre2_match_pool * PCRE2_CALL_CONVENTION
+pcre2_match_pool_create(const pcre2_code *code, uint32_t threads,
+  PCRE2_SIZE jit_stack_size, pcre2_general_context *gcontext)
+{
+const pcre2_real_code *re = (const pcre2_real_code *)code;
+pcre2_real_match_pool *pool;
+uint32_t i;
+#ifdef SUPPORT_THREADS
+uint32_t started;
+#endif
+
+if (code == NULL) return NULL;
+if (threads == 0) threads = 1;
+#ifndef SUPPORT_THREADS
+threads = 1;
+#endif
+
+/* The size calculation can overflow only where size_t is 32 bits. */
+
+#if PCRE2_SIZE_MAX <= UINT32_MAX
+if (threads > (PCRE2_SIZE_MAX - sizeof(pcre2_real_match_pool)) /
+    sizeof(pool_worker))
+  return NULL;
+#endif
+
+pool = PRIV(memctl_malloc)(sizeof(pcre2_real_match_pool) +
+  threads * sizeof(pool_worker),
+  (gcontext == NULL)? (pcre2_memctl *)&re->memctl : (pcre2_memctl *)gcontext);
+if (pool == NULL) return NULL;
+
+pool->code = re;
+pool->workers = (pool_worker *)((char *)pool +
+  sizeof(pcre2_real_match_pool));
+pool->worker_count = 0;
+
+/* Give each worker its match data and JIT stack. */
+
+for (i = 0; i < threads; i++)
+  {
+  pool_worker *w = pool->workers + i;
+  w->pool = pool;
+  w->jit_stack = NULL;
+  w->match_data = pcre2_match_data_create_from_pattern(code,
+    (pcre2_general_context *)&pool->memctl);
+  pool->worker_count++;
+  if (w->match_data == NULL) goto FAILED;
+#ifdef SUPPORT_JIT
+  if (jit_stack_size > 0)
+    {
+    w->jit_stack = pcre2_jit_stack_create(
+      (jit_stack_size < POOL_JIT_STACK_START)?
+        jit_stack_size : POOL_JIT_STACK_START,
+      jit_stack_size, (pcre2_general_context *)&pool->memctl);
+    if (w->jit_stack == NULL) goto FAILED;
+    }
+#else
+  (void)jit_stack_size;
+#endif
+  }
+
+/* Start the threads. */
+
+#ifdef SUPPORT_THREADS
+pool->generation = 0;
+pool->active = 0;
+pool->shutdown = FALSE;
+
+if (!PRIV(mutex_init)(&pool->mutex)) goto FAILED;
+if (!PRIV(cond_init)(&pool->start))
+  {
+  PRIV(mutex_destroy)(&pool->mutex);
+  goto FAILED;
+  }
+if (!PRIV(cond_init)(&pool->done))
+  {
+  PRIV(cond_destroy)(&pool->start);
+  PRIV(mutex_destroy)(&pool->mutex);
+  goto FAILED;
+  }
+
+for (i = 0; i < threads; i++)
+  if (!PRIV(mutex_init)(&pool->workers[i].mutex)) break;
+if (i < threads)
+  {
+  while (i > 0) PRIV(mutex_destroy)(&pool->workers[--i].mutex);
+  PRIV(cond_destroy)(&pool->done);
+  PRIV(cond_destroy)(&pool->start);
+  PRIV(mutex_destroy)(&pool->mutex);
+  goto FAILED;
+  }
+
+/* If a thread cannot be started, those that have been are stopped. */
+
+for (started = 1; started < threads; started++)
+  {
+  if (!PRIV(thread_create)(&pool->workers[started].handle, pool_thread,
+      pool->workers + started))
+    {
+    free_pool(pool, started);
+    return NULL;
+    }
+  }
+#endif  /* SUPPORT_THREADS */
+
+return (pcre2_match_pool *)pool;
+
+FAILED:
+free_pool(pool, 0);
+return NULL;
+}
+
+
+
+/*************************************************
+*         Match a set of subjects in a pool      *
+*************************************************/
+
+/* Each subject is matched from its start, independently of the others, with
+the given options. The order in which the subjects are matched is not defined.
+
+If results is not NULL, it must point to a vector of 2*count offsets, in which
+results[2*i] and results[2*i+1] are set to the start and end of the first match
+in subject i, or both to PCRE2_UNSET if it does not match or there is an error.
+If callback is not NULL, it is called after each subject has been matched, with
+the subject's index, the return from pcre2_match(), the worker's match data
+block, which holds the details of the match, and callback_data. It may be
+called in any of the pool's threads, but the calls for any one subject happen
+in the same thread as its matching. If the callback returns a non-zero value,
+no more subjects are started, and the first such value is returned.
+
+A match context is copied for each worker, so a JIT stack that is assigned to
+it is used only if the pool was created without JIT stacks, and then only by
+the calling thread. The callouts in the context, if any, may be called in any
+of the threads. A pool must not be used for more than one run at once.
+
+Arguments:
+  pool            points to the pool
+  subjects        points to a vector of count subject pointers
+  lengths         points to a vector of count lengths, or is NULL if all the
+                    subjects are zero-terminated
+  count           the number of subjects
+  options         option bits
+  results         points to a vector of 2*count offsets, or is NULL
+  callback        a function to call for each subject, or NULL
+  callback_data   data for the callback
+  mcontext        points to a match context, or is NULL
+
+Returns:          >= 0 => the number of subjects that match
+                  < 0  => the error for the lowest numbered subject that
+                            had one; the other subjects are still matched
+                  or the non-zero value from the callback that stopped the run
+*/
+
+PCRE2_EXP_DEFN int PCRE2_CALL_CONVENTION
+pcre2_match_pool_run(pcre2_match_pool *mpool, const PCRE2_SPTR *subjects,
+  const PCRE2_SIZE *lengths, uint32_t count, uint32_t options,
+  PCRE2_SIZE *results, int (*callback)(uint32_t, int, pcre2_match_data *,
+  void *), void *callback_data, pcre2_match_context *mcontext)
+{
+pcre2_real_match_pool *pool = (pcre2_real_match_pool *)mpool;
+int matched = 0;
+uint32_t i, next, share, extra;
+
+if (pool == NULL || (subjects == NULL && count > 0)) return PCRE2_ERROR_NULL;
+if ((options & ~PUBLIC_POOL_OPTIONS) != 0) return PCRE2_ERROR_BADOPTION;
+if (count > INT_MAX) return PCRE2_ERROR_BADDATA;
+if (count == 0) return 0;
+
+pool->subjects = subjects;
+pool->lengths = lengths;
+pool->options = options;
+pool->results = results;
+pool->callback = callback;
+pool->callback_data = callback_data;
+pool->error = 0;
+pool->error_index = UINT32_MAX;
+pool->stop = 0;
+
+/* Divide the subjects evenly, and set up each worker's match context. Only
+the calling thread may use a JIT stack from the caller's context. */
+
+share = count / pool->worker_count;
+extra = count % pool->worker_count;
+next = 0;
+
+for (i = 0; i < pool->worker_count; i++)
+  {
+  pool_worker *w = pool->workers + i;
+  w->next = next;
+  next += share + ((i < extra)? 1 : 0);
+  w->end = next;
+  w->matched = 0;
+  w->mcontext = (mcontext == NULL)? PRIV(default_match_context) : *mcontext;
+#ifdef SUPPORT_JIT
+  if (w->jit_stack != NULL)
+    {
+    w->mcontext.jit_callback = NULL;
+    w->mcontext.jit_callback_data = w->jit_stack;
+    }
+  else if (i > 0)
+    {
+    w->mcontext.jit_callback = NULL;
+    w->mcontext.jit_callback_data = NULL;
+    }
+#endif
+  }
+
+/* Wake the other threads, join in, and wait for them to finish. */
+
+#ifdef SUPPORT_THREADS
+if (pool->worker_count > 1)
+  {
+  PRIV(mutex_lock)(&pool->mutex);
+  pool->active = pool->worker_count - 1;
+  pool->generation++;
+  PRIV(cond_broadcast)(&pool->start);
+  PRIV(mutex_unlock)(&pool->mutex);
+  }
+#endif
+
+run_worker(pool->workers);
+
+#ifdef SUPPORT_THREADS
+if (pool->worker_count > 1)
+  {
+  PRIV(mutex_lock)(&pool->mutex);
+  while (pool->active > 0) PRIV(cond_wait)(&pool->done, &pool->mutex);
+  PRIV(mutex_unlock)(&pool->mutex);
+  }
+#endif
+
+if (pool->stop != 0) return pool->stop;
+if (pool->error != 0) return pool->error;
+for (i = 0; i < pool->worker_count; i++) matched += pool->workers[i].matched;
+return matched;
+}
+
+
+
+/*************************************************
+*              Free a match pool                 *
+*************************************************/
+
+PCRE2_EXP_DEFN void PCRE2_CALL_CONVENTION
+pcre2_match_pool_free(pcre2_match_pool *mpool)
+{
+pcre2_real_match_pool *pool = (pcre2_real_match_pool *)mpool;
+if (pool == NULL) return;
+free_pool(pool, pool->worker_count);
+}
+
+/* End of pcre2_match_pool.c */
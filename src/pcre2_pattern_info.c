@@ -76,6 +76,7 @@ if (where == NULL)   /* Requests field length */
     case PCRE2_INFO_BSR:
     case PCRE2_INFO_CAPTURECOUNT:
     case PCRE2_INFO_DEPTHLIMIT:
+    case PCRE2_INFO_ELIGIBLE_ENGINES:
     case PCRE2_INFO_EXTRAOPTIONS:
     case PCRE2_INFO_FIRSTCODETYPE:
     case PCRE2_INFO_FIRSTCODEUNIT:
@@ -145,6 +146,17 @@ switch(what)
   if (re->limit_depth == UINT32_MAX) return PCRE2_ERROR_UNSET;
   break;
 
+  /* The interpreter is always available. The one-pass and bit-parallel
+  matchers are set up whenever a pattern is suitable; the other engines are
+  chosen when PCRE2_EXTRA_AUTO_ENGINE is set or JIT compilation is requested. */
+
+  case PCRE2_INFO_ELIGIBLE_ENGINES:
+  *((uint32_t *)where) = PCRE2_ENGINE_INTERPRETER | re->engines |
+    (((re->flags & PCRE2_ONEPASS) != 0)? PCRE2_ENGINE_ONEPASS : 0) |
+    ((re->bitparallel != NULL)? PCRE2_ENGINE_BITPARALLEL : 0) |
+    ((re->executable_jit != NULL)? PCRE2_ENGINE_JIT : 0);
+  break;
+
   case PCRE2_INFO_EXTRAOPTIONS:
   *((uint32_t *)where) = re->extra_options;
   break;
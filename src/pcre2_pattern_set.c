@@ -0,0 +1,1373 @@
+/*************************************************
+*      Perl-Compatible Regular Expressions       *
+*************************************************/
+
+/* PCRE is a library of functions to support regular expressions whose syntax
+and semantics are as close as possible to those of the Perl 5 language.
+
+                       Written by Philip Hazel
+     Original API code Copyright (c) 1997-2012 University of Cambridge
+          New API code Copyright (c) 2016-2022 University of Cambridge
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the University of Cambridge nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+/* This module contains the functions for pattern sets. A pattern set holds
+any number of independent patterns. When it is compiled, the patterns are
+combined into a single alternation, each branch of which is followed by a
+callout whose string argument is the pattern's id, and then by (*FAIL). A
+single call of pcre2_match() or pcre2_dfa_match() on the combined pattern
+therefore runs the callout once for every pattern that matches, and the
+callout records the id. For the interpreter and JIT each branch is atomic so
+that a pattern is reported at most once per starting position. For DFA
+matching the combined pattern starts with (?s:.*) and is anchored, so that the
+subject is scanned once only, with all the patterns active in parallel.
+
+Combining the patterns saves the overhead of separate calls and merges their
+start-of-match optimizations, but it does not make the cost independent of the
+number of patterns. The interpreter and JIT try every branch at each starting
+position that is not skipped, and the DFA matcher's work for each character
+grows with the number of active states. For this reason, patterns that have a
+required literal string (one that pcre2_compile() has found must be present in
+any match) are not combined. Instead, the subject is first scanned once by an
+Aho-Corasick automaton for all these literals, and only the patterns whose
+literals are present are matched, each on its own. The cost of the scan does
+not depend on the number of patterns. */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "pcre2_internal.h"
+
+/* Options that apply to a whole set. Some pcre2_compile() options cannot be
+supported: those that make the whole pattern anchored or literal, or that
+insert automatic callouts. */
+
+#define PUBLIC_PATTERN_SET_OPTIONS \
+  (PCRE2_ALLOW_EMPTY_CLASS|PCRE2_ALT_BSUX|PCRE2_ALT_CIRCUMFLEX| \
+   PCRE2_ALT_VERBNAMES|PCRE2_CASELESS|PCRE2_DOLLAR_ENDONLY|PCRE2_DOTALL| \
+   PCRE2_DUPNAMES|PCRE2_EXTENDED|PCRE2_EXTENDED_MORE| \
+   PCRE2_MATCH_INVALID_UTF|PCRE2_MATCH_UNSET_BACKREF|PCRE2_MULTILINE| \
+   PCRE2_NEVER_BACKSLASH_C|PCRE2_NEVER_UCP|PCRE2_NEVER_UTF| \
+   PCRE2_NO_AUTO_CAPTURE|PCRE2_NO_AUTO_POSSESS|PCRE2_NO_DOTSTAR_ANCHOR| \
+   PCRE2_NO_START_OPTIMIZE|PCRE2_NO_UTF_CHECK|PCRE2_UCP|PCRE2_UNGREEDY| \
+   PCRE2_UTF)
+
+/* Options that can be given for an individual pattern. These are the ones
+that can be expressed by an option setting such as (?i) at the start of the
+pattern. */
+
+#define PUBLIC_PATTERN_SET_ADD_OPTIONS \
+  (PCRE2_CASELESS|PCRE2_DOTALL|PCRE2_DUPNAMES|PCRE2_EXTENDED| \
+   PCRE2_EXTENDED_MORE|PCRE2_MULTILINE|PCRE2_NO_AUTO_CAPTURE|PCRE2_UNGREEDY)
+
+/* Options for matching a set. The options that control what counts as a
+complete match cannot be supported because the combined pattern never matches;
+it always reaches (*FAIL). */
+
+#define PUBLIC_PATTERN_SET_MATCH_OPTIONS \
+  (PCRE2_NO_JIT|PCRE2_NO_UTF_CHECK|PCRE2_NOTBOL|PCRE2_NOTEOL)
+
+#define PUBLIC_PATTERN_SET_DFA_MATCH_OPTIONS \
+  (PCRE2_NO_UTF_CHECK|PCRE2_NOTBOL|PCRE2_NOTEOL)
+
+/* The number of patterns in a set for which the match-time record of which
+patterns have matched can be kept on the stack. */
+
+#define FOUND_STACK_PATTERNS 8192
+
+/* Starting size of the DFA workspace, in ints. It is doubled as necessary. */
+
+#define DFA_START_WSCOUNT 1000
+
+/* The two forms of combined pattern */
+
+enum { FORM_MATCH, FORM_DFA };
+
+/* Value used for "no chunk" when building the prefilter. */
+
+#define NO_CHUNK UINT32_MAX
+
+/* Structure for passing data to the callout function at match time. */
+
+typedef struct set_match_state {
+  uint32_t *found;                /* Bit vector of matched pattern ids */
+  uint32_t  count;                /* Number of patterns matched so far */
+  uint32_t  remaining;            /* Unmatched patterns in the current chunk */
+  BOOL      all_found;            /* TRUE when remaining reached zero */
+} set_match_state;
+
+
+
+/*************************************************
+*          Copy ASCII text into a pattern        *
+*************************************************/
+
+/* The characters of the wrapping text are added one by one so that they are
+converted to the appropriate code unit width. If the buffer is NULL, only the
+length is computed.
+
+Arguments:
+  buffer      where to put the text, or NULL
+  offset      current offset in the buffer
+  s           zero-terminated text
+
+Returns:      the new offset
+*/
+
+static PCRE2_SIZE
+add_text(PCRE2_UCHAR *buffer, PCRE2_SIZE offset, const char *s)
+{
+for (; *s != 0; s++)
+  {
+  if (buffer != NULL) buffer[offset] = (PCRE2_UCHAR)(uint8_t)*s;
+  offset++;
+  }
+return offset;
+}
+
+
+
+/*************************************************
+*          Wrap one pattern for combining        *
+*************************************************/
+
+/* The source of one pattern is wrapped in a group, preceded by settings for
+its own options, and followed by the callout that records its id. The
+terminating \E ends any \Q sequence in the pattern, and is ignored otherwise.
+In extended mode it is followed by a newline, to end any trailing comment.
+Word and line matching are implemented here for each pattern, as they would be
+by pcre2_compile() for the whole combined pattern.
+
+Arguments:
+  set         the pattern set
+  id          the pattern's id
+  form        FORM_MATCH or FORM_DFA
+  buffer      where to put the text, or NULL to compute the length
+  offset      current offset in the buffer
+
+Returns:      the new offset
+*/
+
+static PCRE2_SIZE
+wrap_pattern(pcre2_real_pattern_set *set, uint32_t id, int form,
+  PCRE2_UCHAR *buffer, PCRE2_SIZE offset)
+{
+pattern_set_item *item = set->patterns + id;
+uint32_t options = item->options;
+uint32_t extra_options = set->ccontext.extra_options;
+char digits[12];
+char *dp = digits + sizeof(digits) - 1;
+
+offset = add_text(buffer, offset, (form == FORM_MATCH)?
+  STR_LEFT_PARENTHESIS STR_QUESTION_MARK STR_GREATER_THAN_SIGN :
+  STR_LEFT_PARENTHESIS STR_QUESTION_MARK STR_COLON);
+
+if (options != 0)
+  {
+  offset = add_text(buffer, offset, STR_LEFT_PARENTHESIS STR_QUESTION_MARK);
+  if ((options & PCRE2_CASELESS) != 0)
+    offset = add_text(buffer, offset, STR_i);
+  if ((options & PCRE2_DUPNAMES) != 0)
+    offset = add_text(buffer, offset, STR_J);
+  if ((options & PCRE2_MULTILINE) != 0)
+    offset = add_text(buffer, offset, STR_m);
+  if ((options & PCRE2_NO_AUTO_CAPTURE) != 0)
+    offset = add_text(buffer, offset, STR_n);
+  if ((options & PCRE2_DOTALL) != 0)
+    offset = add_text(buffer, offset, STR_s);
+  if ((options & PCRE2_UNGREEDY) != 0)
+    offset = add_text(buffer, offset, STR_U);
+  if ((options & PCRE2_EXTENDED_MORE) != 0)
+    offset = add_text(buffer, offset, STR_x STR_x);
+  else if ((options & PCRE2_EXTENDED) != 0)
+    offset = add_text(buffer, offset, STR_x);
+  offset = add_text(buffer, offset, STR_RIGHT_PARENTHESIS);
+  }
+
+if ((extra_options & PCRE2_EXTRA_MATCH_LINE) != 0)
+  offset = add_text(buffer, offset,
+    STR_CIRCUMFLEX_ACCENT STR_LEFT_PARENTHESIS STR_QUESTION_MARK STR_COLON);
+else if ((extra_options & PCRE2_EXTRA_MATCH_WORD) != 0)
+  offset = add_text(buffer, offset,
+    STR_BACKSLASH STR_b STR_LEFT_PARENTHESIS STR_QUESTION_MARK STR_COLON);
+
+if (buffer != NULL)
+  memcpy(buffer + offset, set->text + item->offset, CU2BYTES(item->length));
+offset += item->length;
+
+offset = add_text(buffer, offset, STR_BACKSLASH STR_E);
+
+if (((set->options | options) & (PCRE2_EXTENDED|PCRE2_EXTENDED_MORE)) != 0)
+  {
+  switch (set->ccontext.newline_convention)
+    {
+    case PCRE2_NEWLINE_CR:
+    offset = add_text(buffer, offset, STR_CR);
+    break;
+
+    case PCRE2_NEWLINE_CRLF:
+    offset = add_text(buffer, offset, STR_CR STR_NL);
+    break;
+
+    case PCRE2_NEWLINE_NUL:
+    if (buffer != NULL) buffer[offset] = 0;
+    offset++;
+    break;
+
+    default:
+    offset = add_text(buffer, offset, STR_NL);
+    break;
+    }
+  }
+
+if ((extra_options & PCRE2_EXTRA_MATCH_LINE) != 0)
+  offset = add_text(buffer, offset, STR_RIGHT_PARENTHESIS STR_DOLLAR_SIGN);
+else if ((extra_options & PCRE2_EXTRA_MATCH_WORD) != 0)
+  offset = add_text(buffer, offset, STR_RIGHT_PARENTHESIS STR_BACKSLASH STR_b);
+
+*dp = 0;
+do { *(--dp) = CHAR_0 + id % 10; id /= 10; } while (id != 0);
+
+offset = add_text(buffer, offset, STR_RIGHT_PARENTHESIS STR_LEFT_PARENTHESIS
+  STR_QUESTION_MARK STR_C STR_LEFT_CURLY_BRACKET);
+offset = add_text(buffer, offset, dp);
+return add_text(buffer, offset, STR_RIGHT_CURLY_BRACKET STR_RIGHT_PARENTHESIS
+  STR_LEFT_PARENTHESIS STR_ASTERISK STR_F STR_RIGHT_PARENTHESIS);
+}
+
+
+
+/*************************************************
+*         Compile a range of wrapped patterns    *
+*************************************************/
+
+/* This builds a combined pattern for the given list of patterns and compiles
+it. It is also used for checking a single pattern when it is added.
+
+Arguments:
+  set          the pattern set
+  ids          the pattern ids
+  count        the number of patterns
+  form         FORM_MATCH or FORM_DFA
+  errorcode    where to put an error code
+
+Returns:       the compiled pattern, or NULL on error
+*/
+
+static pcre2_code *
+compile_combined(pcre2_real_pattern_set *set, const uint32_t *ids,
+  uint32_t count, int form, int *errorcode)
+{
+pcre2_code *code;
+pcre2_real_compile_context ccontext;
+PCRE2_UCHAR *buffer;
+PCRE2_SIZE length, erroroffset;
+uint32_t options;
+uint32_t i;
+
+/* Compute the length of the combined pattern, then build it. */
+
+length = (form == FORM_DFA)? 10 : 0;
+for (i = 0; i < count; i++)
+  length = wrap_pattern(set, ids[i], form, NULL, length) + 1;
+
+buffer = set->memctl.malloc(CU2BYTES(length), set->memctl.memory_data);
+if (buffer == NULL)
+  {
+  *errorcode = PCRE2_ERROR_NOMEMORY;
+  return NULL;
+  }
+
+length = 0;
+if (form == FORM_DFA)
+  length = add_text(buffer, 0, STR_LEFT_PARENTHESIS STR_QUESTION_MARK STR_s
+    STR_COLON STR_DOT STR_ASTERISK STR_RIGHT_PARENTHESIS STR_LEFT_PARENTHESIS
+    STR_QUESTION_MARK STR_COLON);
+
+for (i = 0; i < count; i++)
+  {
+  if (i != 0) length = add_text(buffer, length, STR_VERTICAL_LINE);
+  length = wrap_pattern(set, ids[i], form, buffer, length);
+  }
+
+if (form == FORM_DFA)
+  length = add_text(buffer, length, STR_RIGHT_PARENTHESIS);
+
+/* Word and line matching have been done for each pattern. The length limit
+applies to the individual patterns, not the combined one. Captured substrings
+are never used, so numbered groups do not capture, and names may be
+duplicated. */
+
+ccontext = set->ccontext;
+ccontext.max_pattern_length = PCRE2_UNSET;
+ccontext.extra_options &= ~(PCRE2_EXTRA_MATCH_LINE|PCRE2_EXTRA_MATCH_WORD);
+
+options = set->options | PCRE2_NO_AUTO_CAPTURE | PCRE2_DUPNAMES;
+if (form == FORM_DFA) options |= PCRE2_ANCHORED;
+
+code = pcre2_compile(buffer, length, options, errorcode, &erroroffset,
+  &ccontext);
+set->memctl.free(buffer, set->memctl.memory_data);
+return code;
+}
+
+
+
+/*************************************************
+*     Check a compiled pattern for a set         *
+*************************************************/
+
+/* Items that refer to other groups by number cannot be supported, because the
+group numbers change when patterns are combined. Callouts are reserved for
+recording the pattern ids. (*ACCEPT) and the backtracking control verbs would
+affect the other patterns in the combined pattern, and are not supported by
+DFA matching in any case.
+
+Arguments:
+  code        the compiled pattern
+
+Returns:      TRUE if the pattern can be used in a set
+*/
+
+static BOOL
+check_pattern(pcre2_code *code)
+{
+pcre2_real_code *re = (pcre2_real_code *)code;
+PCRE2_SPTR cc = (PCRE2_SPTR)((uint8_t *)re + sizeof(pcre2_real_code))
+     + re->name_count * re->name_entry_size;
+#ifdef SUPPORT_UNICODE
+BOOL utf = (re->overall_options & PCRE2_UTF) != 0;
+#endif
+
+/* Start-of-pattern items such as (*UTF) or (*LIMIT_MATCH=) would not be
+recognized after the first pattern. PCRE2_ANCHORED may have been added to the
+overall options because the pattern is automatically anchored. */
+
+if ((re->flags & (PCRE2_NL_SET|PCRE2_BSR_SET|PCRE2_NOJIT|
+      PCRE2_NOTEMPTY_SET|PCRE2_NE_ATST_SET)) != 0 ||
+    (re->overall_options & ~PCRE2_ANCHORED) != re->compile_options ||
+    re->limit_heap != UINT32_MAX ||
+    re->limit_match != UINT32_MAX ||
+    re->limit_depth != UINT32_MAX)
+  return FALSE;
+
+for (;;)
+  {
+  switch (*cc)
+    {
+    case OP_END:
+    return TRUE;
+
+    case OP_ACCEPT:
+    case OP_CALLOUT:
+    case OP_CALLOUT_STR:
+    case OP_COMMIT:
+    case OP_COMMIT_ARG:
+    case OP_CREF:
+    case OP_DNCREF:
+    case OP_DNREF:
+    case OP_DNREFI:
+    case OP_DNRREF:
+    case OP_MARK:
+    case OP_PRUNE:
+    case OP_PRUNE_ARG:
+    case OP_RECURSE:
+    case OP_REF:
+    case OP_REFI:
+    case OP_RREF:
+    case OP_SKIP:
+    case OP_SKIP_ARG:
+    case OP_THEN:
+    case OP_THEN_ARG:
+    return FALSE;
+
+    case OP_CHAR:
+    case OP_CHARI:
+    case OP_NOT:
+    case OP_NOTI:
+    case OP_STAR:
+    case OP_MINSTAR:
+    case OP_PLUS:
+    case OP_MINPLUS:
+    case OP_QUERY:
+    case OP_MINQUERY:
+    case OP_UPTO:
+    case OP_MINUPTO:
+    case OP_EXACT:
+    case OP_POSSTAR:
+    case OP_POSPLUS:
+    case OP_POSQUERY:
+    case OP_POSUPTO:
+    case OP_STARI:
+    case OP_MINSTARI:
+    case OP_PLUSI:
+    case OP_MINPLUSI:
+    case OP_QUERYI:
+    case OP_MINQUERYI:
+    case OP_UPTOI:
+    case OP_MINUPTOI:
+    case OP_EXACTI:
+    case OP_POSSTARI:
+    case OP_POSPLUSI:
+    case OP_POSQUERYI:
+    case OP_POSUPTOI:
+    case OP_NOTSTAR:
+    case OP_NOTMINSTAR:
+    case OP_NOTPLUS:
+    case OP_NOTMINPLUS:
+    case OP_NOTQUERY:
+    case OP_NOTMINQUERY:
+    case OP_NOTUPTO:
+    case OP_NOTMINUPTO:
+    case OP_NOTEXACT:
+    case OP_NOTPOSSTAR:
+    case OP_NOTPOSPLUS:
+    case OP_NOTPOSQUERY:
+    case OP_NOTPOSUPTO:
+    case OP_NOTSTARI:
+    case OP_NOTMINSTARI:
+    case OP_NOTPLUSI:
+    case OP_NOTMINPLUSI:
+    case OP_NOTQUERYI:
+    case OP_NOTMINQUERYI:
+    case OP_NOTUPTOI:
+    case OP_NOTMINUPTOI:
+    case OP_NOTEXACTI:
+    case OP_NOTPOSSTARI:
+    case OP_NOTPOSPLUSI:
+    case OP_NOTPOSQUERYI:
+    case OP_NOTPOSUPTOI:
+    cc += PRIV(OP_lengths)[*cc];
+#ifdef SUPPORT_UNICODE
+    if (utf && HAS_EXTRALEN(cc[-1])) cc += GET_EXTRALEN(cc[-1]);
+#endif
+    break;
+
+    case OP_TYPESTAR:
+    case OP_TYPEMINSTAR:
+    case OP_TYPEPLUS:
+    case OP_TYPEMINPLUS:
+    case OP_TYPEQUERY:
+    case OP_TYPEMINQUERY:
+    case OP_TYPEUPTO:
+    case OP_TYPEMINUPTO:
+    case OP_TYPEEXACT:
+    case OP_TYPEPOSSTAR:
+    case OP_TYPEPOSPLUS:
+    case OP_TYPEPOSQUERY:
+    case OP_TYPEPOSUPTO:
+    cc += PRIV(OP_lengths)[*cc];
+#ifdef SUPPORT_UNICODE
+    if (cc[-1] == OP_PROP || cc[-1] == OP_NOTPROP) cc += 2;
+#endif
+    break;
+
+#if defined SUPPORT_UNICODE || PCRE2_CODE_UNIT_WIDTH != 8
+    case OP_XCLASS:
+    cc += GET(cc, 1);
+    break;
+#endif
+
+    default:
+    cc += PRIV(OP_lengths)[*cc];
+    break;
+    }
+  }
+}
+
+
+
+/*************************************************
+*             Create a pattern set               *
+*************************************************/
+
+/* The compile context is copied, so it may be freed after this call, but the
+character tables, if any, must remain available while the set is in use.
+
+Arguments:
+  options     compile options for all the patterns
+  ccontext    points to a compile context or is NULL
+
+Returns:      pointer to the new set or NULL on failure
+*/
+
+PCRE2_EXP_DEFN pcre2_pattern_set * PCRE2_CALL_CONVENTION
+pcre2_pattern_set_create(uint32_t options, pcre2_compile_context *ccontext)
+{
+pcre2_pattern_set *set;
+
+if ((options & ~PUBLIC_PATTERN_SET_OPTIONS) != 0) return NULL;
+if (ccontext == NULL)
+  ccontext = (pcre2_compile_context *)(&PRIV(default_compile_context));
+
+set = PRIV(memctl_malloc)(sizeof(pcre2_real_pattern_set),
+  (pcre2_memctl *)ccontext);
+if (set == NULL) return NULL;
+
+set->ccontext = *ccontext;
+set->options = options;
+set->pattern_count = 0;
+set->pattern_size = 0;
+set->chunk_count = 0;
+set->literal_chunk = 0;
+set->compiled = FALSE;
+set->patterns = NULL;
+set->chunks = NULL;
+set->ids = NULL;
+set->states = NULL;
+set->trans = NULL;
+set->outputs = NULL;
+set->text = NULL;
+set->text_used = 0;
+set->text_size = 0;
+return set;
+}
+
+
+
+/*************************************************
+*     Free the compiled chunks of a set          *
+*************************************************/
+
+static void
+free_chunks(pcre2_real_pattern_set *set)
+{
+uint32_t i;
+for (i = 0; i < set->chunk_count; i++)
+  {
+  pcre2_code_free(set->chunks[i].code);
+  pcre2_code_free(set->chunks[i].dfa_code);
+  }
+if (set->chunks != NULL) set->memctl.free(set->chunks, set->memctl.memory_data);
+if (set->ids != NULL) set->memctl.free(set->ids, set->memctl.memory_data);
+if (set->states != NULL)
+  set->memctl.free(set->states, set->memctl.memory_data);
+set->chunks = NULL;
+set->ids = NULL;
+set->states = NULL;
+set->trans = NULL;
+set->outputs = NULL;
+set->chunk_count = 0;
+set->literal_chunk = 0;
+set->compiled = FALSE;
+}
+
+
+
+/*************************************************
+*              Free a pattern set                *
+*************************************************/
+
+PCRE2_EXP_DEFN void PCRE2_CALL_CONVENTION
+pcre2_pattern_set_free(pcre2_pattern_set *set)
+{
+if (set != NULL)
+  {
+  free_chunks(set);
+  if (set->patterns != NULL)
+    set->memctl.free(set->patterns, set->memctl.memory_data);
+  if (set->text != NULL)
+    set->memctl.free(set->text, set->memctl.memory_data);
+  set->memctl.free(set, set->memctl.memory_data);
+  }
+}
+
+
+
+/*************************************************
+*            Add a pattern to a set              *
+*************************************************/
+
+/* The pattern is compiled on its own so that errors can be reported exactly
+as pcre2_compile() would report them. It is then checked for items that cannot
+be used in a set, and its required literal string, if any, is saved for the
+prefilter. Finally it is compiled in the form in which it will be combined with
+the other patterns. The patterns are given ids 0, 1, 2, ... in the order in
+which they are added. Adding a pattern to a compiled set discards the compiled
+form.
+
+Arguments:
+  set           the pattern set
+  pattern       the pattern string
+  length        length of the pattern, or PCRE2_ZERO_TERMINATED
+  options       options for this pattern
+  erroroffset   where to put an offset for a compile error
+
+Returns:        0 for success, else an error code (+ve or -ve)
+*/
+
+PCRE2_EXP_DEFN int PCRE2_CALL_CONVENTION
+pcre2_pattern_set_add(pcre2_pattern_set *set, PCRE2_SPTR pattern,
+  PCRE2_SIZE length, uint32_t options, PCRE2_SIZE *erroroffset)
+{
+pcre2_code *code;
+pattern_set_item *item;
+PCRE2_UCHAR literal[REQ_LITERAL_MAX];
+uint32_t literal_length;
+int errorcode;
+uint32_t id;
+
+if (erroroffset == NULL) return PCRE2_ERROR_NULL;
+*erroroffset = 0;
+if (set == NULL || pattern == NULL) return PCRE2_ERROR_NULL;
+if ((options & ~PUBLIC_PATTERN_SET_ADD_OPTIONS) != 0)
+  return PCRE2_ERROR_BADOPTION;
+if (set->pattern_count == UINT32_MAX) return PCRE2_ERROR_NOMEMORY;
+
+/* Compile the pattern on its own, and check it. */
+
+code = pcre2_compile(pattern, length, set->options|options, &errorcode,
+  erroroffset, &set->ccontext);
+if (code == NULL) return errorcode;
+if (!check_pattern(code))
+  {
+  pcre2_code_free(code);
+  return PCRE2_ERROR_PATTERN_SET_UNSUPPORTED;
+  }
+literal_length = ((pcre2_real_code *)code)->req_literal_length;
+memcpy(literal, ((pcre2_real_code *)code)->req_literal,
+  CU2BYTES(literal_length));
+pcre2_code_free(code);
+
+if (length == PCRE2_ZERO_TERMINATED) length = PRIV(strlen)(pattern);
+
+/* Make sure there is room for the pattern. */
+
+if (set->pattern_count >= set->pattern_size)
+  {
+  uint32_t newsize = (set->pattern_size == 0)? 16 :
+    (set->pattern_size > UINT32_MAX/2)? UINT32_MAX : 2*set->pattern_size;
+  pattern_set_item *newpatterns = set->memctl.malloc(
+    newsize * sizeof(pattern_set_item), set->memctl.memory_data);
+  if (newpatterns == NULL) return PCRE2_ERROR_NOMEMORY;
+  if (set->patterns != NULL)
+    {
+    memcpy(newpatterns, set->patterns,
+      set->pattern_count * sizeof(pattern_set_item));
+    set->memctl.free(set->patterns, set->memctl.memory_data);
+    }
+  set->patterns = newpatterns;
+  set->pattern_size = newsize;
+  }
+
+if (set->text_size - set->text_used < length + literal_length)
+  {
+  PCRE2_SIZE newsize = 2*set->text_size;
+  PCRE2_UCHAR *newtext;
+  if (newsize < set->text_used + length + literal_length)
+    newsize = set->text_used + length + literal_length;
+  if (newsize < 1024) newsize = 1024;
+  newtext = set->memctl.malloc(CU2BYTES(newsize), set->memctl.memory_data);
+  if (newtext == NULL) return PCRE2_ERROR_NOMEMORY;
+  if (set->text != NULL)
+    {
+    memcpy(newtext, set->text, CU2BYTES(set->text_used));
+    set->memctl.free(set->text, set->memctl.memory_data);
+    }
+  set->text = newtext;
+  set->text_size = newsize;
+  }
+
+id = set->pattern_count;
+item = set->patterns + id;
+item->offset = set->text_used;
+item->length = length;
+item->literal_offset = set->text_used + length;
+item->literal_length = literal_length;
+item->options = options;
+memcpy(set->text + set->text_used, pattern, CU2BYTES(length));
+memcpy(set->text + item->literal_offset, literal, CU2BYTES(literal_length));
+
+/* Check that the pattern can be combined with others. This fails if, for
+example, a start-of-pattern item is not at the start, or the pattern ends in a
+comment that was started by setting extended mode within the pattern. */
+
+code = compile_combined(set, &id, 1, FORM_MATCH, &errorcode);
+if (code == NULL)
+  return (errorcode == PCRE2_ERROR_NOMEMORY)? errorcode :
+    PCRE2_ERROR_PATTERN_SET_UNSUPPORTED;
+pcre2_code_free(code);
+
+set->text_used += length + literal_length;
+set->pattern_count++;
+free_chunks(set);
+return 0;
+}
+
+
+
+/*************************************************
+*        Compile chunks of a pattern set         *
+*************************************************/
+
+/* The given range of the ids vector is compiled as a single chunk if possible.
+If the combined pattern is too large, the range is split into two halves, and
+each half is handled recursively.
+
+Arguments:
+  set          the pattern set
+  first        index of the first pattern id in the ids vector
+  count        the number of patterns
+
+Returns:       0 for success, else an error code (+ve or -ve)
+*/
+
+static int
+compile_chunks(pcre2_real_pattern_set *set, uint32_t first, uint32_t count)
+{
+int errorcode;
+pattern_set_chunk *chunk = set->chunks + set->chunk_count;
+pcre2_code *code = compile_combined(set, set->ids + first, count, FORM_MATCH,
+  &errorcode);
+pcre2_code *dfa_code = NULL;
+
+if (code != NULL)
+  {
+  dfa_code = compile_combined(set, set->ids + first, count, FORM_DFA,
+    &errorcode);
+  if (dfa_code == NULL) pcre2_code_free(code);
+  }
+
+if (dfa_code == NULL)
+  {
+  if (count > 1 && (errorcode == PCRE2_ERROR_PATTERN_TOO_LARGE ||
+                    errorcode == PCRE2_ERROR_TOO_MANY_CAPTURES))
+    {
+    int rc = compile_chunks(set, first, count/2);
+    if (rc != 0) return rc;
+    return compile_chunks(set, first + count/2, count - count/2);
+    }
+  return errorcode;
+  }
+
+chunk->code = code;
+chunk->dfa_code = dfa_code;
+chunk->first = first;
+chunk->count = count;
+set->chunk_count++;
+return 0;
+}
+
+
+
+/*************************************************
+*       Follow a transition in the prefilter     *
+*************************************************/
+
+/* The transitions from each state are sorted by code unit, so a binary chop
+is used.
+
+Arguments:
+  set         the pattern set
+  state       the current state
+  c           the next code unit
+
+Returns:      the next state, or 0 if there is no transition
+*/
+
+static uint32_t
+next_state(const pcre2_real_pattern_set *set, uint32_t state, uint32_t c)
+{
+const pattern_set_state *st = set->states + state;
+const pattern_set_trans *trans = set->trans + st->trans;
+uint32_t bot = 0;
+uint32_t top = st->trans_count;
+
+while (bot < top)
+  {
+  uint32_t mid = (bot + top)/2;
+  if (trans[mid].c == c) return trans[mid].next;
+  if (trans[mid].c < c) bot = mid + 1; else top = mid;
+  }
+
+return 0;
+}
+
+
+
+/*************************************************
+*           Build the prefilter                  *
+*************************************************/
+
+/* The required literals of the chunks from set->literal_chunk onwards are
+first put into a trie, using temporary vectors in which each state has a list
+of children that is kept in code unit order, and a list of the chunks whose
+literals end there. The trie is then copied, breadth first, into the final
+vectors, and the failure and dictionary links are added as each state's
+children are copied. A state's failure link is to the state for the longest
+proper suffix of its string that is in the trie; its dictionary link is to the
+nearest state on the failure chain whose list of chunks is not empty. Both are
+always to shallower states, which have already been copied.
+
+Argument:   the pattern set
+Returns:    0 for success, else an error code
+*/
+
+static int
+build_prefilter(pcre2_real_pattern_set *set)
+{
+uint32_t literal_count = set->chunk_count - set->literal_chunk;
+uint32_t state_count = 1;
+uint32_t trans_count = 0;
+uint32_t out_count = 0;
+uint32_t head = 0;
+uint32_t tail = 1;
+uint32_t i, j, k, s;
+uint32_t *work, *unit, *child, *sibling, *outhead, *outnext, *queue;
+PCRE2_SIZE size = 1;
+
+if (literal_count == 0) return 0;
+
+for (i = set->literal_chunk; i < set->chunk_count; i++)
+  size += set->patterns[set->ids[set->chunks[i].first]].literal_length;
+if (size > UINT32_MAX/8) return PCRE2_ERROR_NOMEMORY;
+
+work = set->memctl.malloc((5*size + literal_count) * sizeof(uint32_t),
+  set->memctl.memory_data);
+if (work == NULL) return PCRE2_ERROR_NOMEMORY;
+unit = work;
+child = unit + size;
+sibling = child + size;
+outhead = sibling + size;
+queue = outhead + size;
+outnext = queue + size;
+
+set->states = set->memctl.malloc(size * sizeof(pattern_set_state) +
+  (size - 1) * sizeof(pattern_set_trans) + literal_count * sizeof(uint32_t),
+  set->memctl.memory_data);
+if (set->states == NULL)
+  {
+  set->memctl.free(work, set->memctl.memory_data);
+  return PCRE2_ERROR_NOMEMORY;
+  }
+set->trans = (pattern_set_trans *)(set->states + size);
+set->outputs = (uint32_t *)(set->trans + (size - 1));
+
+/* Build the trie. State 0 is the root, so 0 can be used to mean "none" in the
+lists of children. */
+
+child[0] = 0;
+outhead[0] = NO_CHUNK;
+
+for (i = set->literal_chunk; i < set->chunk_count; i++)
+  {
+  pattern_set_item *item = set->patterns + set->ids[set->chunks[i].first];
+  PCRE2_SPTR literal = set->text + item->literal_offset;
+
+  s = 0;
+  for (j = 0; j < item->literal_length; j++)
+    {
+    uint32_t c = literal[j];
+    uint32_t *link = child + s;
+    while (*link != 0 && unit[*link] < c) link = sibling + *link;
+    if (*link != 0 && unit[*link] == c) s = *link; else
+      {
+      s = state_count++;
+      unit[s] = c;
+      child[s] = 0;
+      outhead[s] = NO_CHUNK;
+      sibling[s] = *link;
+      *link = s;
+      }
+    }
+
+  outnext[i - set->literal_chunk] = outhead[s];
+  outhead[s] = i;
+  }
+
+/* Copy the states breadth first, adding the links. */
+
+queue[0] = 0;
+set->states[0].fail = 0;
+set->states[0].dict = 0;
+
+while (head < tail)
+  {
+  uint32_t u = queue[head++];
+  pattern_set_state *st = set->states + u;
+
+  st->out = out_count;
+  for (k = outhead[u]; k != NO_CHUNK; k = outnext[k - set->literal_chunk])
+    set->outputs[out_count++] = k;
+  st->out_count = out_count - st->out;
+
+  st->trans = trans_count;
+  for (s = child[u]; s != 0; s = sibling[s])
+    {
+    set->trans[trans_count].c = unit[s];
+    set->trans[trans_count++].next = s;
+    queue[tail++] = s;
+    }
+  st->trans_count = trans_count - st->trans;
+
+  for (s = child[u]; s != 0; s = sibling[s])
+    {
+    uint32_t f = 0;
+    if (u != 0)
+      {
+      f = st->fail;
+      for (;;)
+        {
+        uint32_t t = next_state(set, f, unit[s]);
+        if (t != 0) { f = t; break; }
+        if (f == 0) break;
+        f = set->states[f].fail;
+        }
+      }
+    set->states[s].fail = f;
+    set->states[s].dict = (outhead[f] != NO_CHUNK)? f : set->states[f].dict;
+    }
+  }
+
+for (i = 0; i < 256; i++) set->root[i] = next_state(set, 0, i);
+
+set->memctl.free(work, set->memctl.memory_data);
+return 0;
+}
+
+
+
+/*************************************************
+*            Compile a pattern set               *
+*************************************************/
+
+/* The patterns that have no required literal are put first in the ids vector,
+and combined into as few chunks as possible. Each of the others is compiled as
+a chunk on its own, and its literal is added to the prefilter.
+
+Argument:   the pattern set
+Returns:    0 for success, else an error code (+ve or -ve)
+*/
+
+PCRE2_EXP_DEFN int PCRE2_CALL_CONVENTION
+pcre2_pattern_set_compile(pcre2_pattern_set *set)
+{
+int rc = 0;
+uint32_t i, n, first;
+
+if (set == NULL) return PCRE2_ERROR_NULL;
+free_chunks(set);
+
+if (set->pattern_count > 0)
+  {
+  set->chunks = set->memctl.malloc(
+    set->pattern_count * sizeof(pattern_set_chunk), set->memctl.memory_data);
+  set->ids = set->memctl.malloc(set->pattern_count * sizeof(uint32_t),
+    set->memctl.memory_data);
+  if (set->chunks == NULL || set->ids == NULL)
+    {
+    free_chunks(set);
+    return PCRE2_ERROR_NOMEMORY;
+    }
+
+  for (i = 0, n = 0; i < set->pattern_count; i++)
+    if (set->patterns[i].literal_length == 0) set->ids[n++] = i;
+  if (n > 0) rc = compile_chunks(set, 0, n);
+  set->literal_chunk = set->chunk_count;
+
+  for (i = 0, first = n; i < set->pattern_count; i++)
+    if (set->patterns[i].literal_length != 0) set->ids[n++] = i;
+  for (i = first; rc == 0 && i < set->pattern_count; i++)
+    rc = compile_chunks(set, i, 1);
+
+  if (rc == 0) rc = build_prefilter(set);
+  if (rc != 0)
+    {
+    free_chunks(set);
+    return rc;
+    }
+  }
+
+set->compiled = TRUE;
+return 0;
+}
+
+
+
+/*************************************************
+*         JIT compile a pattern set              *
+*************************************************/
+
+/* Only the patterns that are used by pcre2_pattern_set_match() are JIT
+compiled.
+
+Arguments:
+  set         the pattern set
+  options     options for pcre2_jit_compile()
+
+Returns:      0 for success, else an error code
+*/
+
+PCRE2_EXP_DEFN int PCRE2_CALL_CONVENTION
+pcre2_pattern_set_jit_compile(pcre2_pattern_set *set, uint32_t options)
+{
+uint32_t i;
+
+if (set == NULL) return PCRE2_ERROR_NULL;
+if (!set->compiled) return PCRE2_ERROR_PATTERN_SET_UNCOMPILED;
+
+for (i = 0; i < set->chunk_count; i++)
+  {
+  int rc = pcre2_jit_compile(set->chunks[i].code, options);
+  if (rc != 0) return rc;
+  }
+
+return 0;
+}
+
+
+
+/*************************************************
+*       Callout function for recording ids       *
+*************************************************/
+
+/* The callout string is the id of the pattern that has just matched. Once
+every pattern in the current chunk has matched there is no point in going on,
+so matching is abandoned.
+
+Arguments:
+  cb          the callout block
+  data        the match state
+
+Returns:      1 to continue matching (by failing at this point), or
+              PCRE2_ERROR_CALLOUT to abandon the match
+*/
+
+static int
+record_id(pcre2_callout_block *cb, void *data)
+{
+set_match_state *state = (set_match_state *)data;
+uint32_t id = 0;
+PCRE2_SIZE i;
+
+for (i = 0; i < cb->callout_string_length; i++)
+  id = id * 10 + (cb->callout_string[i] - CHAR_0);
+
+if ((state->found[id/32] & (1u << (id%32))) == 0)
+  {
+  state->found[id/32] |= 1u << (id%32);
+  state->count++;
+  if (--state->remaining == 0)
+    {
+    state->all_found = TRUE;
+    return PCRE2_ERROR_CALLOUT;
+    }
+  }
+
+return 1;
+}
+
+
+
+/*************************************************
+*      Scan a subject with the prefilter         *
+*************************************************/
+
+/* The subject is scanned once, and a bit is set for each chunk whose literal
+is found. When a state is reached, the chunks listed at that state and at the
+states on its dictionary chain are recorded. Each chunk is listed at only one
+state, so if the first chunk at a state has already been recorded, that state
+and the rest of its chain have already been handled. The scan stops early if
+every chunk has been recorded.
+
+Arguments:
+  set          the pattern set
+  ptr          where to start in the subject
+  end          the end of the subject
+  candidates   the bit vector of chunks to be run
+
+Returns:       nothing
+*/
+
+static void
+prefilter(const pcre2_real_pattern_set *set, PCRE2_SPTR ptr, PCRE2_SPTR end,
+  uint32_t *candidates)
+{
+uint32_t remaining = set->chunk_count - set->literal_chunk;
+uint32_t s = 0;
+
+for (; ptr < end; ptr++)
+  {
+  uint32_t c = *ptr;
+  uint32_t t;
+
+  for (;;)
+    {
+    if (s == 0)
+      {
+      s = (c < 256)? set->root[c] : next_state(set, 0, c);
+      break;
+      }
+    t = next_state(set, s, c);
+    if (t != 0)
+      {
+      s = t;
+      break;
+      }
+    s = set->states[s].fail;
+    }
+
+  t = (set->states[s].out_count != 0)? s : set->states[s].dict;
+  while (t != 0)
+    {
+    const pattern_set_state *st = set->states + t;
+    const uint32_t *out = set->outputs + st->out;
+    const uint32_t *outend = out + st->out_count;
+
+    if ((candidates[*out/32] & (1u << (*out%32))) != 0) break;
+    for (; out < outend; out++) candidates[*out/32] |= 1u << (*out%32);
+    remaining -= st->out_count;
+    if (remaining == 0) return;
+    t = st->dict;
+    }
+  }
+}
+
+
+
+/*************************************************
+*        Match a pattern set, either way         *
+*************************************************/
+
+/* This is the common code for pcre2_pattern_set_match() and
+pcre2_pattern_set_dfa_match(). If no match data block is supplied, one is
+obtained and freed here. The match context is copied so that the callout can
+be set. The chunks that have no required literal are always run; the others
+are run only if the prefilter finds their literals. However, if nothing else
+has been run, the last chunk is run when the subject must be checked for valid
+UTF or the starting offset is too big, so that errors are reported as usual.
+
+Arguments:
+  set            the pattern set
+  subject        the subject string
+  length         length of subject string, or PCRE2_ZERO_TERMINATED
+  start_offset   where to start in the subject string
+  options        option bits
+  match_data     match data block, or NULL
+  mcontext       a match context, or NULL
+  ids            where to put the ids of the matching patterns
+  idcount        the number of elements in ids
+  dfa            TRUE for DFA matching
+
+Returns:         the number of patterns that matched, or a negative error
+*/
+
+static int
+pattern_set_match(const pcre2_pattern_set *set, PCRE2_SPTR subject,
+  PCRE2_SIZE length, PCRE2_SIZE start_offset, uint32_t options,
+  pcre2_match_data *match_data, pcre2_match_context *mcontext, uint32_t *ids,
+  uint32_t idcount, BOOL dfa)
+{
+int rc = 0;
+int local_workspace[DFA_START_WSCOUNT];
+int *workspace = local_workspace;
+PCRE2_SIZE wscount = DFA_START_WSCOUNT;
+uint32_t local_found[2*FOUND_STACK_PATTERNS/32];
+uint32_t *candidates;
+uint32_t foundsize;
+uint32_t i, n;
+BOOL must_run;
+pcre2_match_data *internal_match_data = NULL;
+pcre2_real_match_context local_mcontext;
+set_match_state state;
+
+if (set == NULL || (subject == NULL && length != 0) ||
+    (ids == NULL && idcount != 0))
+  return PCRE2_ERROR_NULL;
+if ((options & ~(dfa? PUBLIC_PATTERN_SET_DFA_MATCH_OPTIONS :
+    PUBLIC_PATTERN_SET_MATCH_OPTIONS)) != 0)
+  return PCRE2_ERROR_BADOPTION;
+if (!set->compiled) return PCRE2_ERROR_PATTERN_SET_UNCOMPILED;
+if (set->pattern_count == 0) return 0;
+
+/* Set up the record of matched patterns, and the record of the chunks whose
+literals are present. There are never more chunks than patterns. */
+
+foundsize = (set->pattern_count + 31)/32;
+state.found = local_found;
+if (set->pattern_count > FOUND_STACK_PATTERNS)
+  {
+  state.found = set->memctl.malloc(2 * foundsize * sizeof(uint32_t),
+    set->memctl.memory_data);
+  if (state.found == NULL) return PCRE2_ERROR_NOMEMORY;
+  }
+memset(state.found, 0, 2 * foundsize * sizeof(uint32_t));
+candidates = state.found + foundsize;
+state.count = 0;
+
+if (subject != NULL && length == PCRE2_ZERO_TERMINATED)
+  length = PRIV(strlen)(subject);
+if (set->states != NULL && start_offset < length)
+  prefilter(set, subject + start_offset, subject + length, candidates);
+must_run = start_offset > length || ((set->options & PCRE2_UTF) != 0 &&
+  (options & PCRE2_NO_UTF_CHECK) == 0);
+
+if (match_data == NULL)
+  {
+  match_data = internal_match_data =
+    pcre2_match_data_create(1, (pcre2_general_context *)set);
+  if (match_data == NULL)
+    {
+    rc = PCRE2_ERROR_NOMEMORY;
+    goto EXIT;
+    }
+  }
+
+if (mcontext == NULL)
+  mcontext = (pcre2_match_context *)(&PRIV(default_match_context));
+local_mcontext = *mcontext;
+local_mcontext.callout = record_id;
+local_mcontext.callout_data = &state;
+
+/* Run the chunks in turn. The subject's UTF validity needs to be checked only
+once. */
+
+for (i = 0; i < set->chunk_count; i++)
+  {
+  const pattern_set_chunk *chunk = set->chunks + i;
+
+  if (i >= set->literal_chunk && (candidates[i/32] & (1u << (i%32))) == 0 &&
+      (!must_run || i != set->chunk_count - 1))
+    continue;
+
+  state.remaining = chunk->count;
+  state.all_found = FALSE;
+
+  if (!dfa)
+    {
+    rc = pcre2_match(chunk->code, subject, length, start_offset, options,
+      match_data, &local_mcontext);
+    }
+  else for (;;)
+    {
+    rc = pcre2_dfa_match(chunk->dfa_code, subject, length, start_offset,
+      options, match_data, &local_mcontext, workspace, wscount);
+    if (rc != PCRE2_ERROR_DFA_WSSIZE || wscount > INT_MAX/2) break;
+
+    /* The workspace is too small; patterns that have already been recorded
+    do not need to be recorded again, so just try again with more. */
+
+    if (workspace != local_workspace)
+      set->memctl.free(workspace, set->memctl.memory_data);
+    wscount *= 2;
+    workspace = set->memctl.malloc(wscount * sizeof(int),
+      set->memctl.memory_data);
+    if (workspace == NULL)
+      {
+      workspace = local_workspace;
+      rc = PCRE2_ERROR_NOMEMORY;
+      goto EXIT;
+      }
+    }
+
+  if (rc == PCRE2_ERROR_NOMATCH || (rc == PCRE2_ERROR_CALLOUT &&
+      state.all_found)) rc = 0;
+  else if (rc >= 0) rc = PCRE2_ERROR_INTERNAL;
+  if (rc != 0) goto EXIT;
+
+  options |= PCRE2_NO_UTF_CHECK;
+  must_run = FALSE;
+  }
+
+/* Return the ids of the patterns that matched, in order. */
+
+for (i = 0, n = 0; i < foundsize && n < idcount; i++)
+  {
+  uint32_t bits = state.found[i];
+  uint32_t id = i*32;
+  for (; bits != 0 && n < idcount; bits >>= 1, id++)
+    if ((bits & 1) != 0) ids[n++] = id;
+  }
+
+rc = (state.count > INT_MAX)? INT_MAX : (int)state.count;
+
+EXIT:
+if (workspace != local_workspace)
+  set->memctl.free(workspace, set->memctl.memory_data);
+if (internal_match_data != NULL) pcre2_match_data_free(internal_match_data);
+if (state.found != local_found)
+  set->memctl.free(state.found, set->memctl.memory_data);
+return rc;
+}
+
+
+
+/*************************************************
+*            Match a pattern set                 *
+*************************************************/
+
+/* The patterns are matched by pcre2_match(), which uses JIT if the set has
+been JIT compiled.
+
+Arguments:
+  set            the pattern set
+  subject        the subject string
+  length         length of subject string, or PCRE2_ZERO_TERMINATED
+  start_offset   where to start in the subject string
+  options        option bits
+  match_data     match data block, or NULL
+  mcontext       a match context, or NULL
+  ids            where to put the ids of the matching patterns
+  idcount        the number of elements in ids
+
+Returns:         the number of patterns that matched, or a negative error
+*/
+
+PCRE2_EXP_DEFN int PCRE2_CALL_CONVENTION
+pcre2_pattern_set_match(const pcre2_pattern_set *set, PCRE2_SPTR subject,
+  PCRE2_SIZE length, PCRE2_SIZE start_offset, uint32_t options,
+  pcre2_match_data *match_data, pcre2_match_context *mcontext, uint32_t *ids,
+  uint32_t idcount)
+{
+return pattern_set_match(set, subject, length, start_offset, options,
+  match_data, mcontext, ids, idcount, FALSE);
+}
+
+
+
+/*************************************************
+*        Match a pattern set using DFA           *
+*************************************************/
+
+/* The arguments and the return are as for pcre2_pattern_set_match(). */
+
+PCRE2_EXP_DEFN int PCRE2_CALL_CONVENTION
+pcre2_pattern_set_dfa_match(const pcre2_pattern_set *set, PCRE2_SPTR subject,
+  PCRE2_SIZE length, PCRE2_SIZE start_offset, uint32_t options,
+  pcre2_match_data *match_data, pcre2_match_context *mcontext, uint32_t *ids,
+  uint32_t idcount)
+{
+return pattern_set_match(set, subject, length, start_offset, options,
+  match_data, mcontext, ids, idcount, TRUE);
+}
+
+/* End of pcre2_pattern_set.c */
@@ -325,18 +325,22 @@ else
 
 /* The print_lengths flag controls whether offsets and lengths of items are
 printed. Lenths can be turned off from pcre2test so that automatic tests on
-bytecode can be written that do not depend on the value of LINK_SIZE.
+bytecode can be written that do not depend on the value of LINK_SIZE. If a
+vector of counts (indexed by code offset) is given, as obtained by profiling a
+match, each item is preceded by its count.
 
 Arguments:
   re              a compiled pattern
   f               the file to write to
   print_lengths   show various lengths
+  counts          opcode execution counts, or NULL
 
 Returns:          nothing
 */
 
 static void
-pcre2_printint(pcre2_code *re, FILE *f, BOOL print_lengths)
+pcre2_printint(pcre2_code *re, FILE *f, BOOL print_lengths,
+  const PCRE2_SIZE *counts)
 {
 PCRE2_SPTR codestart, nametable, code;
 uint32_t nesize = re->name_entry_size;
@@ -353,6 +357,9 @@ for(;;)
   const char *flag = "  ";
   unsigned int extra = 0;
 
+  if (counts != NULL)
+    fprintf(f, "%9lu", (unsigned long int)counts[code - codestart]);
+
   if (print_lengths)
     fprintf(f, "%3d ", (int)(code - codestart));
   else
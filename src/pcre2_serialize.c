@@ -145,6 +145,8 @@ for (i = 0; i < number_of_codes; i++)
     sizeof(void *));
   (void)memset(dst_bytes + offsetof(pcre2_real_code, executable_jit), 0,
     sizeof(void *));        
+  (void)memset(dst_bytes + offsetof(pcre2_real_code, bitparallel), 0,
+    sizeof(void *));
  
   dst_bytes += re->blocksize;
   }
@@ -241,6 +243,7 @@ for (i = 0; i < number_of_codes; i++)
 
   dst_re->tables = tables;
   dst_re->executable_jit = NULL;
+  dst_re->bitparallel = NULL;
   dst_re->flags |= PCRE2_DEREF_TABLES;
 
   codes[i] = dst_re;
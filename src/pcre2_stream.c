@@ -0,0 +1,1542 @@
+/*************************************************
+*      Perl-Compatible Regular Expressions       *
+*************************************************/
+
+/* PCRE is a library of functions to support regular expressions whose syntax
+and semantics are as close as possible to those of the Perl 5 language.
+
+                       Written by Philip Hazel
+     Original API code Copyright (c) 1997-2012 University of Cambridge
+          New API code Copyright (c) 2016-2022 University of Cambridge
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the University of Cambridge nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+/* This module contains the functions for matching subjects that are not in
+one piece: streams, which are fed the subject in chunks, and segmented
+subjects, which are supplied all at once as a vector of separate pieces.
+
+A stream is created for a compiled pattern and is then fed the subject in
+chunks of any size. Each call of pcre2_stream_feed() returns the next complete
+match, with offsets that are relative to the start of the whole stream, or "no
+match" when more data is needed.
+
+The stream keeps only the data that a later match might need. When matching
+with pcre2_match(), each search is done with PCRE2_PARTIAL_HARD until the end
+of the stream is signalled. After a partial match, the data from the start of
+the partial match is kept, and the match is re-run from there when more data
+arrives. Otherwise, only a window of characters for lookbehinds and for
+assertions such as \b is kept. After an empty match, the search moves on in the
+same way as a global match of the whole subject: a non-empty match is tried at
+the same point, and then the search continues from the next character.
+
+The data kept for a partial match is not limited, because a limit would lose
+matches. Each feed re-runs the match over all of it, so a partial match that
+spans many chunks costs O(retained x feeds) in all. This is documented for
+users, who can bound it by feeding larger chunks or by using a pattern whose
+matches have a bounded length.
+
+The searches for successive matches start at different points from those of a
+global match of the whole subject, which cannot change the result except for
+patterns that contain \G, (*COMMIT), (*SKIP), or (*NOTEMPTY_ATSTART), or that
+are compiled with PCRE2_FIRSTLINE. These are not supported unless they are
+anchored.
+
+When matching with pcre2_dfa_match(), the stream owns the workspace, and after
+a partial match it continues with PCRE2_DFA_RESTART, so that no data is
+scanned twice while the partial match continues. The data from the start of
+the partial match is still kept, because if the restarted match fails, that
+data must be searched again. The restart is used only for patterns whose items
+pcre2_dfa_match() handles entirely within its list of active states. Items such
+as assertions and atomic groups are matched by separate, nested matches, which
+the restart cannot continue, so for patterns that contain them the data from
+the start of the partial match is searched again instead.
+
+A segmented subject is searched in place, one segment at a time, using the
+same partial matching technique. Only the data around segment boundaries that
+a match might span is copied. The searches start at different points from a
+single search of the whole subject, so for an unanchored pattern whose matches
+depend on where a search starts, the whole subject after the starting offset
+is copied and searched once instead. */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "pcre2_internal.h"
+
+/* Options that can be given when a stream is created. */
+
+#define PUBLIC_STREAM_OPTIONS \
+  (PCRE2_ANCHORED|PCRE2_NOTBOL|PCRE2_NOTEOL|PCRE2_NOTEMPTY|PCRE2_NO_JIT| \
+   PCRE2_NO_UTF_CHECK|PCRE2_STREAM_DFA)
+
+/* Options that can be given when a stream is fed. */
+
+#define PUBLIC_STREAM_FEED_OPTIONS (PCRE2_STREAM_END)
+
+/* Options for matching a segmented subject */
+
+#define PUBLIC_SEGMENT_OPTIONS \
+  (PCRE2_ANCHORED|PCRE2_NOTBOL|PCRE2_NOTEOL|PCRE2_NOTEMPTY| \
+   PCRE2_NOTEMPTY_ATSTART|PCRE2_NO_JIT|PCRE2_NO_UTF_CHECK)
+
+/* Starting size of the data buffer, in code units, and of the DFA workspace,
+in ints. Both are doubled as necessary. */
+
+#define STREAM_START_SIZE 1024
+#define DFA_START_WSCOUNT 1000
+
+/* Values for the flags field */
+
+#define STREAM_ENDED        0x0001u  /* PCRE2_STREAM_END has been given */
+#define STREAM_DONE         0x0002u  /* No further match is possible */
+#define STREAM_AFTER_EMPTY  0x0004u  /* Last match was empty at search point */
+#define STREAM_WAITING      0x0008u  /* Nothing more to do until new data */
+#define STREAM_RESTART      0x0010u  /* A DFA partial match is outstanding */
+#define STREAM_NO_RESTART   0x0020u  /* DFA partial matches are re-searched */
+
+
+
+/*************************************************
+*    Check for results that depend on searches   *
+*************************************************/
+
+/* This function is used by both the stream and the segment functions. It
+checks for a pattern whose matches depend on where each search starts, not
+just on where each match starts. When a subject is not in one piece, the
+searches for successive matches start at different points from those of a
+global match of the whole subject, so such a pattern can be matched only if it
+is anchored.
+
+Arguments:
+  code        the compiled pattern
+  options     the matching options
+
+Returns:      TRUE if the pattern cannot be matched in pieces
+*/
+
+static BOOL
+start_dependent(const pcre2_real_code *code, uint32_t options)
+{
+if (((options | code->overall_options) & PCRE2_ANCHORED) != 0) return FALSE;
+return (code->flags & (PCRE2_STARTDEP|PCRE2_NE_ATST_SET)) != 0 ||
+  (code->overall_options & PCRE2_FIRSTLINE) != 0;
+}
+
+
+
+/*************************************************
+*     Check whether a DFA restart is possible    *
+*************************************************/
+
+/* PCRE2_DFA_RESTART continues a match from the active states that were saved
+at the end of the previous data. Assertions, atomic and possessive groups,
+conditional groups, and recursions are matched by nested calls that look ahead
+of the current point, and the states of a nested call are not saved, so a
+restart would be wrong if a partial match ended inside one. A whitelist of
+opcodes is used, so that anything unrecognized prevents restarting.
+
+Argument:     the compiled pattern
+Returns:      TRUE if partial matches can be continued by restarting
+*/
+
+static BOOL
+restart_possible(const pcre2_real_code *code)
+{
+PCRE2_SPTR cc = (PCRE2_SPTR)((const uint8_t *)code +
+  sizeof(pcre2_real_code)) + code->name_entry_size * code->name_count;
+#ifdef SUPPORT_UNICODE
+BOOL utf = (code->overall_options & PCRE2_UTF) != 0;
+#endif
+
+for (;;)
+  {
+  switch (*cc)
+    {
+    case OP_END:
+    return TRUE;
+
+    case OP_SOD:
+    case OP_SOM:
+    case OP_NOT_WORD_BOUNDARY:
+    case OP_WORD_BOUNDARY:
+    case OP_NOT_DIGIT:
+    case OP_DIGIT:
+    case OP_NOT_WHITESPACE:
+    case OP_WHITESPACE:
+    case OP_NOT_WORDCHAR:
+    case OP_WORDCHAR:
+    case OP_ANY:
+    case OP_ALLANY:
+    case OP_ANYBYTE:
+    case OP_NOTPROP:
+    case OP_PROP:
+    case OP_ANYNL:
+    case OP_NOT_HSPACE:
+    case OP_HSPACE:
+    case OP_NOT_VSPACE:
+    case OP_VSPACE:
+    case OP_EXTUNI:
+    case OP_EODN:
+    case OP_EOD:
+    case OP_DOLL:
+    case OP_DOLLM:
+    case OP_CIRC:
+    case OP_CIRCM:
+    case OP_CLASS:
+    case OP_NCLASS:
+    case OP_CRSTAR:
+    case OP_CRMINSTAR:
+    case OP_CRPLUS:
+    case OP_CRMINPLUS:
+    case OP_CRQUERY:
+    case OP_CRMINQUERY:
+    case OP_CRRANGE:
+    case OP_CRMINRANGE:
+    case OP_CRPOSSTAR:
+    case OP_CRPOSPLUS:
+    case OP_CRPOSQUERY:
+    case OP_CRPOSRANGE:
+    case OP_ALT:
+    case OP_KET:
+    case OP_KETRMAX:
+    case OP_KETRMIN:
+    case OP_BRA:
+    case OP_CBRA:
+    case OP_SBRA:
+    case OP_SCBRA:
+    case OP_BRAZERO:
+    case OP_BRAMINZERO:
+    case OP_SKIPZERO:
+    case OP_CALLOUT:
+    case OP_FAIL:
+    cc += PRIV(OP_lengths)[*cc];
+    break;
+
+    case OP_CHAR:
+    case OP_CHARI:
+    case OP_NOT:
+    case OP_NOTI:
+    case OP_STAR:
+    case OP_MINSTAR:
+    case OP_PLUS:
+    case OP_MINPLUS:
+    case OP_QUERY:
+    case OP_MINQUERY:
+    case OP_UPTO:
+    case OP_MINUPTO:
+    case OP_EXACT:
+    case OP_POSSTAR:
+    case OP_POSPLUS:
+    case OP_POSQUERY:
+    case OP_POSUPTO:
+    case OP_STARI:
+    case OP_MINSTARI:
+    case OP_PLUSI:
+    case OP_MINPLUSI:
+    case OP_QUERYI:
+    case OP_MINQUERYI:
+    case OP_UPTOI:
+    case OP_MINUPTOI:
+    case OP_EXACTI:
+    case OP_POSSTARI:
+    case OP_POSPLUSI:
+    case OP_POSQUERYI:
+    case OP_POSUPTOI:
+    case OP_NOTSTAR:
+    case OP_NOTMINSTAR:
+    case OP_NOTPLUS:
+    case OP_NOTMINPLUS:
+    case OP_NOTQUERY:
+    case OP_NOTMINQUERY:
+    case OP_NOTUPTO:
+    case OP_NOTMINUPTO:
+    case OP_NOTEXACT:
+    case OP_NOTPOSSTAR:
+    case OP_NOTPOSPLUS:
+    case OP_NOTPOSQUERY:
+    case OP_NOTPOSUPTO:
+    case OP_NOTSTARI:
+    case OP_NOTMINSTARI:
+    case OP_NOTPLUSI:
+    case OP_NOTMINPLUSI:
+    case OP_NOTQUERYI:
+    case OP_NOTMINQUERYI:
+    case OP_NOTUPTOI:
+    case OP_NOTMINUPTOI:
+    case OP_NOTEXACTI:
+    case OP_NOTPOSSTARI:
+    case OP_NOTPOSPLUSI:
+    case OP_NOTPOSQUERYI:
+    case OP_NOTPOSUPTOI:
+    cc += PRIV(OP_lengths)[*cc];
+#ifdef SUPPORT_UNICODE
+    if (utf && HAS_EXTRALEN(cc[-1])) cc += GET_EXTRALEN(cc[-1]);
+#endif
+    break;
+
+    /* For character type repeats the type is the last code unit of the
+    fixed-length part of the item. */
+
+    case OP_TYPESTAR:
+    case OP_TYPEMINSTAR:
+    case OP_TYPEPLUS:
+    case OP_TYPEMINPLUS:
+    case OP_TYPEQUERY:
+    case OP_TYPEMINQUERY:
+    case OP_TYPEUPTO:
+    case OP_TYPEMINUPTO:
+    case OP_TYPEEXACT:
+    case OP_TYPEPOSSTAR:
+    case OP_TYPEPOSPLUS:
+    case OP_TYPEPOSQUERY:
+    case OP_TYPEPOSUPTO:
+    cc += PRIV(OP_lengths)[*cc];
+    if (cc[-1] == OP_PROP || cc[-1] == OP_NOTPROP) cc += 2;
+    break;
+
+#if defined SUPPORT_UNICODE || PCRE2_CODE_UNIT_WIDTH != 8
+    case OP_XCLASS:
+    cc += GET(cc, 1);
+    break;
+#endif
+
+    case OP_CALLOUT_STR:
+    cc += GET(cc, 1 + 2*LINK_SIZE);
+    break;
+
+    default:
+    return FALSE;
+    }
+  }
+}
+
+
+
+/*************************************************
+*              Create a stream                   *
+*************************************************/
+
+/* If no context is supplied, use the memory allocator from the code.
+
+Arguments:
+  code        points to the compiled pattern
+  options     option bits
+  gcontext    points to a general context or is NULL
+
+Returns:      pointer to the new stream or NULL on failure
+*/
+
+PCRE2_EXP_DEFN pcre2_stream * PCRE2_CALL_CONVENTION
+pcre2_stream_create(const pcre2_code *code, uint32_t options,
+  pcre2_general_context *gcontext)
+{
+pcre2_stream *stream;
+
+if (code == NULL || (options & ~PUBLIC_STREAM_OPTIONS) != 0 ||
+    start_dependent(code, options))
+  return NULL;
+if (gcontext == NULL) gcontext = (pcre2_general_context *)code;
+
+stream = PRIV(memctl_malloc)(sizeof(pcre2_real_stream),
+  (pcre2_memctl *)gcontext);
+if (stream == NULL) return NULL;
+
+stream->code = code;
+stream->options = options;
+stream->flags = 0;
+stream->base = 0;
+stream->usable = 0;
+stream->search = 0;
+stream->partial_start = 0;
+stream->restart = 0;
+stream->length = 0;
+stream->size = STREAM_START_SIZE;
+stream->wscount = 0;
+stream->workspace = NULL;
+
+stream->buffer = stream->memctl.malloc(CU2BYTES(stream->size),
+  stream->memctl.memory_data);
+if (stream->buffer == NULL)
+  {
+  stream->memctl.free(stream, stream->memctl.memory_data);
+  return NULL;
+  }
+
+if ((options & PCRE2_STREAM_DFA) != 0)
+  {
+  if (!restart_possible(code)) stream->flags |= STREAM_NO_RESTART;
+  stream->wscount = DFA_START_WSCOUNT;
+  stream->workspace = stream->memctl.malloc(
+    stream->wscount * sizeof(int), stream->memctl.memory_data);
+  if (stream->workspace == NULL)
+    {
+    pcre2_stream_free(stream);
+    return NULL;
+    }
+  }
+
+return stream;
+}
+
+
+
+/*************************************************
+*               Free a stream                    *
+*************************************************/
+
+PCRE2_EXP_DEFN void PCRE2_CALL_CONVENTION
+pcre2_stream_free(pcre2_stream *stream)
+{
+if (stream != NULL)
+  {
+  if (stream->buffer != NULL)
+    stream->memctl.free(stream->buffer, stream->memctl.memory_data);
+  if (stream->workspace != NULL)
+    stream->memctl.free(stream->workspace, stream->memctl.memory_data);
+  stream->memctl.free(stream, stream->memctl.memory_data);
+  }
+}
+
+
+
+/*************************************************
+*      Move back over a number of characters     *
+*************************************************/
+
+/* This is used to find the start of the window of data that must be kept for
+lookbehinds. It stops at the start of the retained data.
+
+Arguments:
+  stream      the stream
+  offset      stream offset to start from
+  count       number of characters
+
+Returns:      stream offset of the start of the window
+*/
+
+static PCRE2_SIZE
+back_chars(pcre2_real_stream *stream, PCRE2_SIZE offset, uint32_t count)
+{
+PCRE2_SPTR p = stream->buffer + (offset - stream->base);
+#ifdef SUPPORT_UNICODE
+BOOL utf = (stream->code->overall_options & PCRE2_UTF) != 0;
+#endif
+
+for (; count > 0 && p > stream->buffer; count--)
+  {
+  p--;
+#ifdef SUPPORT_UNICODE
+  if (utf) { while (p > stream->buffer && NOT_FIRSTCU(*p)) p--; }
+#endif
+  }
+
+return stream->base + (PCRE2_SIZE)(p - stream->buffer);
+}
+
+
+
+/*************************************************
+*        Find the length of the usable data      *
+*************************************************/
+
+/* When more data may follow, some characters at the end of the data are held
+back. In UTF mode, the data may end in the middle of a character, which cannot
+be matched until the rest of it arrives. Also, any newline characters at the
+end are held back, because until it is known whether more data follows, a match
+for $ or \Z before a final newline could be wrong. Holding them back turns such
+a match into a partial match at the end of the data. For simplicity, any
+character that is a newline in some convention is held back.
+
+Arguments:
+  code        the compiled pattern
+  buffer      the data
+  length      its length in code units
+
+Returns:      the length of the data that can be matched
+*/
+
+static PCRE2_SIZE
+usable_length(const pcre2_real_code *code, PCRE2_SPTR buffer,
+  PCRE2_SIZE length)
+{
+BOOL nulnl = code->newline_convention == PCRE2_NEWLINE_NUL;
+#ifdef SUPPORT_UNICODE
+BOOL utf = (code->overall_options & PCRE2_UTF) != 0;
+
+#if PCRE2_CODE_UNIT_WIDTH == 8
+if (utf)
+  {
+  PCRE2_SIZE i = length;
+  while (i > 0 && length - i < 3 && NOT_FIRSTCU(buffer[i-1])) i--;
+  if (i > 0 && buffer[i-1] >= 0xc0u &&
+      length - i < PRIV(utf8_table4)[buffer[i-1] & 0x3fu])
+    length = i - 1;
+  }
+#elif PCRE2_CODE_UNIT_WIDTH == 16
+if (utf && length > 0 && (buffer[length-1] & 0xfc00u) == 0xd800u) length--;
+#endif
+#endif  /* SUPPORT_UNICODE */
+
+while (length > 0)
+  {
+  uint32_t c;
+  PCRE2_SIZE i = length - 1;
+#ifdef SUPPORT_UNICODE
+  if (utf)
+    {
+    PCRE2_SPTR p;
+    while (i > 0 && NOT_FIRSTCU(buffer[i])) i--;
+    p = buffer + i;
+    GETCHAR(c, p);
+    }
+  else
+#endif
+  c = buffer[i];
+
+  if (nulnl)
+    {
+    if (c != 0) break;
+    }
+  else if (c != CHAR_LF && c != CHAR_CR && c != CHAR_VT && c != CHAR_FF &&
+           c != CHAR_NEL && c != 0x2028u && c != 0x2029u) break;
+  length = i;
+  }
+
+return length;
+}
+
+
+
+/*************************************************
+*           Add a chunk of data to a stream      *
+*************************************************/
+
+/* Data that can no longer be needed is discarded first. This is everything
+before the lookbehind window that precedes the next search position or, when
+a DFA partial match is outstanding, the start of that partial match. The
+window is one character longer than the longest lookbehind, so that no
+lookbehind can reach the start of the buffer, where \A would wrongly match. It
+is always at least two characters, so that assertions such as \b can inspect
+the previous character, and a multiline circumflex can recognize a preceding
+CRLF.
+
+Arguments:
+  stream      the stream
+  data        the new data
+  length      its length in code units
+
+Returns:      TRUE if OK; FALSE if memory could not be obtained
+*/
+
+static BOOL
+add_data(pcre2_real_stream *stream, PCRE2_SPTR data, PCRE2_SIZE length)
+{
+PCRE2_SIZE keep = ((stream->flags & STREAM_RESTART) != 0)?
+  stream->partial_start : stream->search;
+uint32_t window = stream->code->max_lookbehind + 1;
+
+keep = back_chars(stream, keep, (window > 2)? window : 2) - stream->base;
+if (keep > 0)
+  {
+  stream->length -= keep;
+  memmove(stream->buffer, stream->buffer + keep, CU2BYTES(stream->length));
+  stream->base += keep;
+  }
+
+if (length > stream->size - stream->length)
+  {
+  PCRE2_UCHAR *newbuffer;
+  PCRE2_SIZE newsize = stream->size;
+
+  do
+    {
+    if (newsize > PCRE2_SIZE_MAX/(2*PCRE2_CODE_UNIT_WIDTH/8)) return FALSE;
+    newsize *= 2;
+    }
+  while (length > newsize - stream->length);
+
+  newbuffer = stream->memctl.malloc(CU2BYTES(newsize),
+    stream->memctl.memory_data);
+  if (newbuffer == NULL) return FALSE;
+  memcpy(newbuffer, stream->buffer, CU2BYTES(stream->length));
+  stream->memctl.free(stream->buffer, stream->memctl.memory_data);
+  stream->buffer = newbuffer;
+  stream->size = newsize;
+  }
+
+memcpy(stream->buffer + stream->length, data, CU2BYTES(length));
+stream->length += length;
+return TRUE;
+}
+
+
+
+/*************************************************
+*     Make the offsets of a match whole offsets  *
+*************************************************/
+
+/* Matches are found in a buffer that holds only part of a stream or segmented
+subject. The subject pointer is cleared because the buffer's contents may
+change, and the offsets no longer relate to it.
+
+Arguments:
+  match_data  the match data
+  rc          the return from the matching function
+  base        the offset of the buffer in the whole subject
+  start       if not PCRE2_UNSET, an offset for the start of each matched
+                string (used after a DFA restart)
+
+Returns:      nothing
+*/
+
+static void
+adjust_offsets(pcre2_match_data *match_data, int rc, PCRE2_SIZE base,
+  PCRE2_SIZE start)
+{
+PCRE2_SIZE *ovector = match_data->ovector;
+uint32_t count = (rc == 0 || (uint32_t)rc > match_data->oveccount)?
+  match_data->oveccount : (uint32_t)rc;
+uint32_t i;
+
+for (i = 0; i < 2*count; i++)
+  {
+  if (ovector[i] != PCRE2_UNSET) ovector[i] += base;
+  }
+if (start != PCRE2_UNSET)
+  {
+  for (i = 0; i < 2*count; i += 2) ovector[i] = start;
+  }
+
+match_data->startchar += base;
+match_data->leftchar += base;
+match_data->rightchar += base;
+match_data->subject = NULL;
+}
+
+
+
+/*************************************************
+*     Move on after an empty match in a stream   *
+*************************************************/
+
+/* This is called when there is no non-empty match at the point of an empty
+match. As in a global match of the whole subject, the search moves on by one
+character, or over CRLF if it is a valid newline.
+
+Arguments:
+  stream      the stream
+
+Returns:      TRUE if there is data to search; FALSE if not
+*/
+
+static BOOL
+move_on(pcre2_real_stream *stream)
+{
+stream->flags &= ~STREAM_AFTER_EMPTY;
+if (stream->search >= stream->usable)
+  {
+  stream->flags |= STREAM_DONE;
+  return FALSE;
+  }
+stream->search = stream->base + PRIV(next_char)(stream->code, stream->buffer,
+  stream->usable - stream->base, stream->search - stream->base, TRUE);
+if ((stream->flags & STREAM_ENDED) == 0 && stream->search >= stream->usable)
+  {
+  stream->flags |= STREAM_WAITING;
+  return FALSE;
+  }
+return TRUE;
+}
+
+
+
+/*************************************************
+*          Feed data to a stream and match       *
+*************************************************/
+
+/* The data is added to the stream, and the next complete match is sought. A
+match is complete only if more data could not change it, so until the end of
+the stream is signalled, matches that reach the end of the data are held back.
+To collect all the matches, call again with no data until "no match" is
+returned.
+
+Arguments:
+  stream        the stream
+  data          the next chunk of the subject
+  length        length of the chunk, or PCRE2_ZERO_TERMINATED
+  options       option bits
+  match_data    points to a match data block
+  mcontext      points to a match context or is NULL
+
+Returns:        > 0 => success; value is the number of ovector pairs filled
+                = 0 => success, but ovector is not big enough
+                PCRE2_ERROR_NOMATCH => no further match until more data
+                < 0 => some other error
+*/
+
+PCRE2_EXP_DEFN int PCRE2_CALL_CONVENTION
+pcre2_stream_feed(pcre2_stream *stream, PCRE2_SPTR data, PCRE2_SIZE length,
+  uint32_t options, pcre2_match_data *match_data,
+  pcre2_match_context *mcontext)
+{
+int rc;
+uint32_t moptions;
+PCRE2_SIZE end;
+PCRE2_SIZE *ovector;
+const pcre2_real_code *re;
+BOOL dfa, anchored;
+
+if (stream == NULL || match_data == NULL || (data == NULL && length != 0))
+  return PCRE2_ERROR_NULL;
+if ((options & ~PUBLIC_STREAM_FEED_OPTIONS) != 0) return PCRE2_ERROR_BADOPTION;
+if (length == PCRE2_ZERO_TERMINATED) length = PRIV(strlen)(data);
+
+re = stream->code;
+ovector = match_data->ovector;
+dfa = (stream->options & PCRE2_STREAM_DFA) != 0;
+anchored = ((stream->options | re->overall_options) & PCRE2_ANCHORED) != 0;
+
+/* Add the new data, unless the stream has ended or no more matches are
+possible. */
+
+if ((stream->flags & STREAM_ENDED) != 0)
+  {
+  if (length != 0) return PCRE2_ERROR_STREAM_ENDED;
+  }
+else
+  {
+  if ((stream->flags & STREAM_DONE) != 0) return PCRE2_ERROR_NOMATCH;
+  if (length != 0 && !add_data(stream, data, length))
+    return PCRE2_ERROR_NOMEMORY;
+  if ((options & PCRE2_STREAM_END) != 0)
+    stream->flags = (stream->flags | STREAM_ENDED) & ~STREAM_WAITING;
+  }
+
+/* Find the end of the data that can be matched. If it has not moved since
+the last search that needed more data, there is nothing to do. */
+
+end = ((stream->flags & STREAM_ENDED) != 0)?
+  stream->base + stream->length :
+  stream->base + usable_length(re, stream->buffer, stream->length);
+if (end > stream->usable) stream->flags &= ~STREAM_WAITING;
+
+if ((stream->flags & (STREAM_DONE|STREAM_WAITING)) != 0)
+  return PCRE2_ERROR_NOMATCH;
+
+/* In UTF mode, check the new complete characters, so that the matching
+functions need not check the whole buffer each time. */
+
+#ifdef SUPPORT_UNICODE
+if ((re->overall_options & PCRE2_UTF) != 0 &&
+    (re->overall_options & PCRE2_MATCH_INVALID_UTF) == 0 &&
+    (stream->options & PCRE2_NO_UTF_CHECK) == 0 &&
+    end > stream->usable)
+  {
+  PCRE2_SIZE erroroffset;
+  rc = PRIV(valid_utf)(stream->buffer + (stream->usable - stream->base),
+    end - stream->usable, &erroroffset);
+  if (rc != 0)
+    {
+    match_data->startchar = stream->usable + erroroffset;
+    match_data->rc = rc;
+    return rc;
+    }
+  }
+#endif
+stream->usable = end;
+
+/* Until the end of the stream, there is no point in searching at the end of
+the data. Any match there must be empty, and it can equally well be found when
+more data arrives. */
+
+if ((stream->flags & STREAM_ENDED) == 0 && stream->search >= stream->usable)
+  {
+  stream->flags |= STREAM_WAITING;
+  return PCRE2_ERROR_NOMATCH;
+  }
+
+/* Set up the options for the matching function. PCRE2_NOTEOL applies only to
+the real end of the subject. */
+
+moptions = (stream->options & (PCRE2_ANCHORED|PCRE2_NOTBOL|PCRE2_NOTEMPTY)) |
+  PCRE2_NO_UTF_CHECK;
+if (!dfa) moptions |= stream->options & PCRE2_NO_JIT;
+if (stream->base > 0) moptions |= PCRE2_NOTBOL;
+if ((stream->flags & STREAM_ENDED) == 0) moptions |= PCRE2_PARTIAL_HARD;
+  else moptions |= stream->options & PCRE2_NOTEOL;
+
+/* Matching with pcre2_match(): the search starts either after the previous
+match or at the start of a previous partial match. After an empty match, the
+first search is for a non-empty match at the same point, as in a global match
+loop. If there is none, the search moves on. */
+
+if (!dfa)
+  {
+  for (;;)
+    {
+    uint32_t xoptions = ((stream->flags & STREAM_AFTER_EMPTY) != 0)?
+      PCRE2_NOTEMPTY_ATSTART|PCRE2_ANCHORED : 0;
+
+    rc = pcre2_match(re, stream->buffer, stream->usable - stream->base,
+      stream->search - stream->base, moptions | xoptions, match_data,
+      mcontext);
+
+    if (rc == PCRE2_ERROR_PARTIAL)
+      {
+      stream->search = stream->base + ovector[0];
+      stream->flags |= STREAM_WAITING;
+      return PCRE2_ERROR_NOMATCH;
+      }
+
+    if (rc == PCRE2_ERROR_NOMATCH)
+      {
+      if (xoptions != 0)
+        {
+        if (move_on(stream)) continue;
+        return rc;
+        }
+      if ((stream->flags & STREAM_ENDED) != 0 ||
+          (anchored && stream->search < stream->usable))
+        stream->flags |= STREAM_DONE;
+      else
+        {
+        stream->search = stream->usable;
+        stream->flags |= STREAM_WAITING;
+        }
+      return rc;
+      }
+
+    if (rc < 0) return rc;
+
+    adjust_offsets(match_data, rc, stream->base, PCRE2_UNSET);
+    stream->search = ovector[1];
+    if (ovector[0] == ovector[1]) stream->flags |= STREAM_AFTER_EMPTY;
+      else stream->flags &= ~STREAM_AFTER_EMPTY;
+    return rc;
+    }
+  }
+
+/* Matching with pcre2_dfa_match(). If a partial match is outstanding,
+continue it with the new data. If it fails, or if the workspace turns out to
+be too small, fall through to search again from the start of the partial
+match. A failed restart does not mean that there is no match there, because a
+shorter match that ended in an earlier chunk is not remembered. Empty matches
+are handled as for pcre2_match(). */
+
+for (;;)
+  {
+  uint32_t xoptions = ((stream->flags & STREAM_AFTER_EMPTY) != 0)?
+    PCRE2_NOTEMPTY_ATSTART|PCRE2_ANCHORED : 0;
+
+  if ((stream->flags & STREAM_RESTART) != 0)
+    {
+    rc = pcre2_dfa_match(re, stream->buffer, stream->usable - stream->base,
+      stream->restart - stream->base, moptions | PCRE2_DFA_RESTART |
+        ((stream->restart == stream->partial_start)? xoptions : 0),
+      match_data, mcontext, stream->workspace, stream->wscount);
+
+    if (rc == PCRE2_ERROR_PARTIAL)
+      {
+      stream->restart = stream->usable;
+      stream->flags |= STREAM_WAITING;
+      return PCRE2_ERROR_NOMATCH;
+      }
+
+    stream->flags &= ~STREAM_RESTART;
+
+    if (rc >= 0)
+      {
+      adjust_offsets(match_data, rc, stream->base,
+        stream->partial_start);
+      stream->search = ovector[1];
+      if (ovector[0] == ovector[1]) stream->flags |= STREAM_AFTER_EMPTY;
+        else stream->flags &= ~STREAM_AFTER_EMPTY;
+      return rc;
+      }
+
+    if (rc != PCRE2_ERROR_NOMATCH && rc != PCRE2_ERROR_DFA_WSSIZE) return rc;
+    }
+
+  rc = pcre2_dfa_match(re, stream->buffer, stream->usable - stream->base,
+    stream->search - stream->base, moptions | xoptions, match_data, mcontext,
+    stream->workspace, stream->wscount);
+
+  /* If the workspace is too small, double its size and try again. */
+
+  if (rc == PCRE2_ERROR_DFA_WSSIZE)
+    {
+    int *newworkspace;
+    if (stream->wscount > INT_MAX/2) return rc;
+    newworkspace = stream->memctl.malloc(2 * stream->wscount * sizeof(int),
+      stream->memctl.memory_data);
+    if (newworkspace == NULL) return PCRE2_ERROR_NOMEMORY;
+    stream->memctl.free(stream->workspace, stream->memctl.memory_data);
+    stream->workspace = newworkspace;
+    stream->wscount *= 2;
+    continue;
+    }
+
+  if (rc == PCRE2_ERROR_PARTIAL)
+    {
+    stream->partial_start = stream->base + ovector[0];
+    stream->restart = stream->usable;
+    stream->search = stream->partial_start;
+    stream->flags |= STREAM_WAITING;
+    if ((stream->flags & STREAM_NO_RESTART) == 0)
+      stream->flags |= STREAM_RESTART;
+    return PCRE2_ERROR_NOMATCH;
+    }
+
+  if (rc == PCRE2_ERROR_NOMATCH)
+    {
+    if (xoptions != 0)
+      {
+      if (move_on(stream)) continue;
+      return rc;
+      }
+    if ((stream->flags & STREAM_ENDED) != 0 ||
+        (anchored && stream->search < stream->usable))
+      stream->flags |= STREAM_DONE;
+    else
+      {
+      stream->search = stream->usable;
+      stream->flags |= STREAM_WAITING;
+      }
+    return rc;
+    }
+
+  if (rc < 0) return rc;
+
+  adjust_offsets(match_data, rc, stream->base, PCRE2_UNSET);
+  stream->search = ovector[1];
+  if (ovector[0] == ovector[1]) stream->flags |= STREAM_AFTER_EMPTY;
+    else stream->flags &= ~STREAM_AFTER_EMPTY;
+  return rc;
+  }
+}
+
+/*************************************************
+*     Find the segment that contains an offset   *
+*************************************************/
+
+/* Segmented subjects are searched more or less in order, so the search starts
+from a known segment and moves in either direction. An offset at the boundary
+between two segments is taken to be in the later one, except at the end of the
+subject, which is in the last non-empty segment.
+
+Arguments:
+  segments    the segment vector
+  last        the index of the last non-empty segment
+  index       the segment to start from
+  baseptr     points to the offset of that segment; updated
+  offset      the offset in the whole subject
+
+Returns:      the index of the segment that contains the offset
+*/
+
+static uint32_t
+find_segment(const pcre2_segment *segments, uint32_t last, uint32_t index,
+  PCRE2_SIZE *baseptr, PCRE2_SIZE offset)
+{
+PCRE2_SIZE base = *baseptr;
+
+while (offset < base) base -= segments[--index].length;
+while (index < last && offset >= base + segments[index].length)
+  base += segments[index++].length;
+
+*baseptr = base;
+return index;
+}
+
+
+
+/*************************************************
+*        Move back in a segmented subject        *
+*************************************************/
+
+/* This is used to find the start of the data that must be copied in front of
+a search position, for lookbehinds and assertions such as \b.
+
+Arguments:
+  segments    the segment vector
+  last        the index of the last non-empty segment
+  index       a segment near the offset
+  base        the offset of that segment
+  offset      the offset to start from
+  count       the number of characters
+  utf         TRUE in UTF mode
+
+Returns:      the offset of the start of the characters
+*/
+
+static PCRE2_SIZE
+segment_back_chars(const pcre2_segment *segments, uint32_t last,
+  uint32_t index, PCRE2_SIZE base, PCRE2_SIZE offset, uint32_t count, BOOL utf)
+{
+for (; count > 0 && offset > 0; count--)
+  {
+  offset--;
+#ifdef SUPPORT_UNICODE
+  if (utf)
+    {
+    while (offset > 0)
+      {
+      index = find_segment(segments, last, index, &base, offset);
+      if (!NOT_FIRSTCU(segments[index].data[offset - base])) break;
+      offset--;
+      }
+    }
+#else
+  (void)utf;
+  (void)index;
+  (void)base;
+  (void)last;
+  (void)segments;
+#endif
+  }
+return offset;
+}
+
+
+
+/*************************************************
+*    Find where a segment can be searched alone  *
+*************************************************/
+
+/* A segment can be searched by itself, without copying, from the first
+position that has enough characters before it within the segment for any
+lookbehind, up to its usable end. The first segment of the subject needs no
+characters before its positions. This function finds the range; the start is
+greater than the end if there is no such position.
+
+Arguments:
+  code        the compiled pattern
+  segment     the segment
+  first       TRUE if nothing precedes the segment
+  final       TRUE if nothing follows the segment
+  window      the number of characters that must precede a position
+  endptr      where to return the end of the range
+
+Returns:      the start of the range
+*/
+
+static PCRE2_SIZE
+direct_range(const pcre2_real_code *code, const pcre2_segment *segment,
+  BOOL first, BOOL final, uint32_t window, PCRE2_SIZE *endptr)
+{
+PCRE2_SPTR data = segment->data;
+PCRE2_SIZE length = segment->length;
+PCRE2_SIZE offset = 0;
+#ifdef SUPPORT_UNICODE
+BOOL utf = (code->overall_options & PCRE2_UTF) != 0;
+#endif
+
+*endptr = final? length : usable_length(code, data, length);
+if (first) return 0;
+
+/* The segment may start with the end of a character from the previous one,
+so count one more character than needed. */
+
+for (window++; window > 0; window--)
+  {
+  if (offset >= length) return *endptr + 1;
+  offset++;
+#ifdef SUPPORT_UNICODE
+  if (utf) { while (offset < length && NOT_FIRSTCU(data[offset])) offset++; }
+#endif
+  }
+
+if (offset > *endptr || (offset == *endptr && !final)) return *endptr + 1;
+return offset;
+}
+
+
+
+#ifdef SUPPORT_UNICODE
+/*************************************************
+*       Check UTF in a segmented subject         *
+*************************************************/
+
+/* The interior of each segment is checked in place, but a character that is
+split between segments is first copied into a small buffer. Checking starts at
+the same place as in pcre2_match(), that is, before the starting offset by the
+maximum lookbehind.
+
+Arguments:
+  segments     the segment vector
+  last         the index of the last non-empty segment
+  from         the offset at which to start checking
+  erroroffset  where to put the offset of an error
+
+Returns:       0 if the subject is valid, or a UTF error code
+*/
+
+static int
+check_segments(const pcre2_segment *segments, uint32_t last, PCRE2_SIZE from,
+  PCRE2_SIZE *erroroffset)
+{
+PCRE2_UCHAR carry[12];
+PCRE2_SIZE carry_start = 0;
+PCRE2_SIZE base = 0;
+uint32_t carry_count = 0;
+uint32_t index;
+int rc;
+
+for (index = 0; index <= last; base += segments[index++].length)
+  {
+  PCRE2_SPTR data = segments[index].data;
+  PCRE2_SIZE length = segments[index].length;
+  PCRE2_SIZE start, end;
+
+  if (base + length <= from) continue;
+  start = (from > base)? from - base : 0;
+
+  /* Complete a character that started in an earlier segment. */
+
+  if (carry_count > 0)
+    {
+#if PCRE2_CODE_UNIT_WIDTH == 8
+    uint32_t needed = 1 + PRIV(utf8_table4)[carry[0] & 0x3fu];
+#else
+    uint32_t needed = 2;
+#endif
+    while (carry_count < needed &&
+           carry_count < sizeof(carry)/sizeof(PCRE2_UCHAR) && start < length)
+      carry[carry_count++] = data[start++];
+    if (carry_count < needed && index < last) continue;
+    rc = PRIV(valid_utf)(carry, carry_count, erroroffset);
+    if (rc != 0)
+      {
+      *erroroffset += carry_start;
+      return rc;
+      }
+    carry_count = 0;
+    }
+
+  /* Check the rest of the segment, except for a final incomplete character,
+  which is carried forward. */
+
+  end = length;
+  if (index < last)
+    {
+#if PCRE2_CODE_UNIT_WIDTH == 8
+    PCRE2_SIZE i = end;
+    while (i > start && end - i < 3 && NOT_FIRSTCU(data[i-1])) i--;
+    if (i > start && data[i-1] >= 0xc0u &&
+        end - i < PRIV(utf8_table4)[data[i-1] & 0x3fu])
+      end = i - 1;
+#elif PCRE2_CODE_UNIT_WIDTH == 16
+    if (end > start && (data[end-1] & 0xfc00u) == 0xd800u) end--;
+#endif
+    }
+
+  /* A truncated character just before the cut is the start of an invalid
+  sequence that continues in the next segment, so it is carried forward as
+  well, and the error is diagnosed when the sequence is complete. */
+
+  rc = PRIV(valid_utf)(data + start, end - start, erroroffset);
+  if (rc != 0)
+    {
+#if PCRE2_CODE_UNIT_WIDTH == 8
+    if (index < last && rc <= PCRE2_ERROR_UTF8_ERR1 &&
+        rc >= PCRE2_ERROR_UTF8_ERR5)
+      end = start + *erroroffset;
+    else
+#elif PCRE2_CODE_UNIT_WIDTH == 16
+    if (index < last && rc == PCRE2_ERROR_UTF16_ERR1)
+      end = start + *erroroffset;
+    else
+#endif
+      {
+      *erroroffset += base + start;
+      return rc;
+      }
+    }
+
+  if (end < length)
+    {
+    carry_start = base + end;
+    while (end < length) carry[carry_count++] = data[end++];
+    }
+  }
+
+return 0;
+}
+#endif  /* SUPPORT_UNICODE */
+
+
+
+/*************************************************
+*         Match a segmented subject              *
+*************************************************/
+
+/* This function is shared by pcre2_match_segments() and
+pcre2_dfa_match_segments(). The subject is the concatenation of the segments.
+Where possible, a segment is searched in place, with PCRE2_PARTIAL_HARD unless
+it is the last. Near the start of a segment, where lookbehinds need characters
+from the previous segment, and where a partial match runs off the end of a
+segment, a "bridge" buffer is built from a copy of just the data that is
+needed, and searched instead. A bridge is extended as long as a partial match
+that starts before the next place where a segment can be searched alone
+continues to its end. A bridge never starts within the lookbehind of a search
+position, so \A cannot match at its start. For a pattern whose matches depend
+on where the search starts, a single bridge that holds the rest of the subject
+is searched.
+
+Arguments:
+  code          the compiled pattern
+  segments      the segment vector
+  count         the number of segments
+  start_offset  where to start matching in the whole subject
+  options       option bits
+  match_data    points to a match data block
+  mcontext      points to a match context or is NULL
+  workspace     the DFA workspace, or NULL for pcre2_match()
+  wscount       the number of ints in the workspace
+
+Returns:        the return from the matching function
+*/
+
+static int
+match_segments(const pcre2_code *code, const pcre2_segment *segments,
+  uint32_t count, PCRE2_SIZE start_offset, uint32_t options,
+  pcre2_match_data *match_data, pcre2_match_context *mcontext,
+  int *workspace, PCRE2_SIZE wscount)
+{
+static const PCRE2_UCHAR empty[1] = { 0 };
+const pcre2_real_code *re = (const pcre2_real_code *)code;
+pcre2_memctl *memctl;
+PCRE2_UCHAR *bridge = NULL;
+PCRE2_SIZE bridge_size = 0;
+PCRE2_SIZE total = 0;
+PCRE2_SIZE base = 0;
+PCRE2_SIZE pos = start_offset;
+uint32_t window, index, last = 0;
+uint32_t moptions;
+BOOL utf, anchored, whole;
+BOOL forced;
+int rc;
+
+if (code == NULL || match_data == NULL || (segments == NULL && count != 0))
+  return PCRE2_ERROR_NULL;
+if ((options & ~PUBLIC_SEGMENT_OPTIONS) != 0) return PCRE2_ERROR_BADOPTION;
+
+for (index = 0; index < count; index++)
+  {
+  if (segments[index].length == 0) continue;
+  if (segments[index].data == NULL) return PCRE2_ERROR_NULL;
+  total += segments[index].length;
+  last = index;
+  }
+if (start_offset > total) return PCRE2_ERROR_BADOFFSET;
+
+/* An empty subject is matched directly. */
+
+if (total == 0)
+  {
+  return (workspace == NULL)?
+    pcre2_match(code, empty, 0, 0, options, match_data, mcontext) :
+    pcre2_dfa_match(code, empty, 0, 0, options & ~PCRE2_NO_JIT, match_data,
+      mcontext, workspace, wscount);
+  }
+
+utf = (re->overall_options & PCRE2_UTF) != 0;
+anchored = ((options | re->overall_options) & PCRE2_ANCHORED) != 0;
+whole = start_dependent(re, options);
+window = re->max_lookbehind + 1;
+if (window < 2) window = 2;
+memctl = (mcontext != NULL)? &mcontext->memctl : (pcre2_memctl *)&re->memctl;
+
+/* Check UTF once for the whole subject, in the same way as pcre2_match(),
+including the check that the starting offset is at the start of a character.
+The matching functions are then told not to check. */
+
+#ifdef SUPPORT_UNICODE
+if (utf && (options & PCRE2_NO_UTF_CHECK) == 0 &&
+    (re->overall_options & PCRE2_MATCH_INVALID_UTF) == 0)
+  {
+  PCRE2_SIZE from;
+  index = find_segment(segments, last, 0, &base, start_offset);
+  if (start_offset < total &&
+      NOT_FIRSTCU(segments[index].data[start_offset - base]))
+    {
+    if (start_offset > 0) return PCRE2_ERROR_BADUTFOFFSET;
+#if PCRE2_CODE_UNIT_WIDTH == 8
+    return PCRE2_ERROR_UTF8_ERR20;
+#else
+    return PCRE2_ERROR_UTF16_ERR3;
+#endif
+    }
+  from = segment_back_chars(segments, last, index, base, start_offset,
+    re->max_lookbehind, TRUE);
+  rc = check_segments(segments, last, from, &(match_data->startchar));
+  if (rc != 0)
+    {
+    match_data->rc = rc;
+    return rc;
+    }
+  }
+#endif
+
+moptions = (options & ~(PCRE2_NOTEMPTY_ATSTART|PCRE2_NOTEOL)) |
+  PCRE2_NO_UTF_CHECK;
+if (workspace != NULL) moptions &= ~PCRE2_NO_JIT;
+index = 0;
+base = 0;
+forced = whole;
+
+for (;;)
+  {
+  PCRE2_SIZE offset, direct_start, direct_end;
+  PCRE2_SIZE zone, need, bend;
+  PCRE2_SIZE cstart = 0, blength = 0, ustart = 0;
+  uint32_t xoptions = (pos == start_offset)?
+    (options & PCRE2_NOTEMPTY_ATSTART) : 0;
+  BOOL final = FALSE;
+
+  index = find_segment(segments, last, index, &base, pos);
+  offset = pos - base;
+  direct_start = direct_range(re, segments + index, base == 0, index == last,
+    window, &direct_end);
+
+  /* Search the segment in place if possible. */
+
+  if (!forced && offset >= direct_start &&
+      (offset < direct_end || (index == last && offset == direct_end)))
+    {
+    xoptions |= moptions;
+    if (base > 0) xoptions |= PCRE2_NOTBOL;
+    if (index < last) xoptions |= PCRE2_PARTIAL_HARD;
+      else xoptions |= options & PCRE2_NOTEOL;
+
+    rc = (workspace == NULL)?
+      pcre2_match(code, segments[index].data, direct_end, offset, xoptions,
+        match_data, mcontext) :
+      pcre2_dfa_match(code, segments[index].data, direct_end, offset,
+        xoptions, match_data, mcontext, workspace, wscount);
+
+    if (rc == PCRE2_ERROR_PARTIAL)
+      {
+      pos = base + match_data->ovector[0];
+      forced = TRUE;
+      continue;
+      }
+    if (rc == PCRE2_ERROR_NOMATCH)
+      {
+      if (index == last || anchored) break;
+      pos = base + direct_end;
+      continue;
+      }
+    if (rc >= 0) adjust_offsets(match_data, rc, base, PCRE2_UNSET);
+    break;
+    }
+
+  /* Otherwise, find the end of the zone of starting positions for which a
+  bridge is needed: the first later position where a segment can be searched
+  alone. After a partial match in the current segment, this must be in a later
+  segment. When the whole subject is to be searched at once, there is none. */
+
+  zone = total + 1;
+  if (!forced && offset < direct_start &&
+      (direct_start < direct_end ||
+        (index == last && direct_start == direct_end)))
+    zone = base + direct_start;
+  else if (!whole)
+    {
+    PCRE2_SIZE zbase = base + segments[index].length;
+    uint32_t j;
+    for (j = index + 1; j <= last; zbase += segments[j++].length)
+      {
+      PCRE2_SIZE zstart, zend;
+      if (segments[j].length == 0) continue;
+      zstart = direct_range(re, segments + j, FALSE, j == last, window, &zend);
+      if (zstart < zend || (j == last && zstart == zend))
+        {
+        zone = zbase + zstart;
+        break;
+        }
+      }
+    }
+  forced = FALSE;
+
+  /* Build a bridge whose usable part reaches the end of the zone, and search
+  it. As long as a partial match starts within the zone, extend the bridge and
+  search again from the start of the partial match. */
+
+  need = zone;
+  bend = (zone > total)? total : zone;
+
+  for (;;)
+    {
+    PCRE2_SIZE copied, cbase;
+    uint32_t cindex;
+
+    cstart = segment_back_chars(segments, last, index, base, pos, window, utf);
+
+    /* Copy the data into the bridge, extending it until its usable part
+    reaches what is needed. */
+
+    for (;;)
+      {
+      if (bend - cstart > bridge_size)
+        {
+        PCRE2_SIZE newsize = (bridge_size == 0)?
+          STREAM_START_SIZE : bridge_size;
+        while (newsize < bend - cstart) newsize *= 2;
+        if (bridge != NULL) memctl->free(bridge, memctl->memory_data);
+        bridge = memctl->malloc(CU2BYTES(newsize), memctl->memory_data);
+        if (bridge == NULL) return PCRE2_ERROR_NOMEMORY;
+        bridge_size = newsize;
+        }
+
+      cbase = base;
+      cindex = find_segment(segments, last, index, &cbase, cstart);
+      for (copied = 0; copied < bend - cstart;
+           cbase += segments[cindex++].length)
+        {
+        PCRE2_SIZE from = cstart + copied - cbase;
+        PCRE2_SIZE n = segments[cindex].length - from;
+        if (segments[cindex].length <= from) continue;
+        if (n > bend - cstart - copied) n = bend - cstart - copied;
+        memcpy(bridge + copied, segments[cindex].data + from, CU2BYTES(n));
+        copied += n;
+        }
+
+      final = bend == total;
+      blength = final? bend - cstart : usable_length(re, bridge, bend - cstart);
+      if (final || cstart + blength >= need) break;
+      bend += (bend - cstart > 64)? bend - cstart : 64;
+      if (bend > total) bend = total;
+      }
+
+    xoptions |= moptions;
+    if (cstart > 0) xoptions |= PCRE2_NOTBOL;
+    if (!final) xoptions |= PCRE2_PARTIAL_HARD;
+      else xoptions |= options & PCRE2_NOTEOL;
+
+    rc = (workspace == NULL)?
+      pcre2_match(code, bridge, blength, pos - cstart, xoptions, match_data,
+        mcontext) :
+      pcre2_dfa_match(code, bridge, blength, pos - cstart, xoptions,
+        match_data, mcontext, workspace, wscount);
+
+    ustart = cstart + blength;
+    if (rc != PCRE2_ERROR_PARTIAL) break;
+    pos = cstart + match_data->ovector[0];
+    if (pos >= zone) break;
+    need = ustart + 1;
+    bend += (bend - cstart > 64)? bend - cstart : 64;
+    if (bend > total) bend = total;
+    xoptions = (pos == start_offset)? (options & PCRE2_NOTEMPTY_ATSTART) : 0;
+    }
+
+  if (rc == PCRE2_ERROR_PARTIAL) continue;
+  if (rc == PCRE2_ERROR_NOMATCH)
+    {
+    if (final || anchored) break;
+    pos = ustart;
+    continue;
+    }
+  if (rc >= 0) adjust_offsets(match_data, rc, cstart, PCRE2_UNSET);
+  break;
+  }
+
+if (bridge != NULL) memctl->free(bridge, memctl->memory_data);
+return rc;
+}
+
+
+
+/*************************************************
+*       Match segments with pcre2_match()        *
+*************************************************/
+
+/* The matches are the same as those that pcre2_match() finds in the
+concatenation of the segments, and the offsets are relative to it.
+
+Arguments:
+  code          points to the compiled pattern
+  segments      points to a vector of segments
+  count         the number of segments
+  start_offset  where to start in the whole subject
+  options       option bits
+  match_data    points to a match data block
+  mcontext      points to a match context or is NULL
+
+Returns:        as for pcre2_match(), except that partial matching is not
+                  supported
+*/
+
+PCRE2_EXP_DEFN int PCRE2_CALL_CONVENTION
+pcre2_match_segments(const pcre2_code *code, const pcre2_segment *segments,
+  uint32_t count, PCRE2_SIZE start_offset, uint32_t options,
+  pcre2_match_data *match_data, pcre2_match_context *mcontext)
+{
+return match_segments(code, segments, count, start_offset, options,
+  match_data, mcontext, NULL, 0);
+}
+
+
+
+/*************************************************
+*     Match segments with pcre2_dfa_match()      *
+*************************************************/
+
+/* As for pcre2_match_segments(), but using the alternative matching function.
+
+Arguments:
+  code          points to the compiled pattern
+  segments      points to a vector of segments
+  count         the number of segments
+  start_offset  where to start in the whole subject
+  options       option bits
+  match_data    points to a match data block
+  mcontext      points to a match context or is NULL
+  workspace     pointer to workspace vector
+  wscount       size of workspace vector
+
+Returns:        as for pcre2_dfa_match(), except that partial matching is not
+                  supported
+*/
+
+PCRE2_EXP_DEFN int PCRE2_CALL_CONVENTION
+pcre2_dfa_match_segments(const pcre2_code *code,
+  const pcre2_segment *segments, uint32_t count, PCRE2_SIZE start_offset,
+  uint32_t options, pcre2_match_data *match_data,
+  pcre2_match_context *mcontext, int *workspace, PCRE2_SIZE wscount)
+{
+if (workspace == NULL) return PCRE2_ERROR_NULL;
+return match_segments(code, segments, count, start_offset, options,
+  match_data, mcontext, workspace, wscount);
+}
+
+/* End of pcre2_stream.c */
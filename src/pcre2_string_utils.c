@@ -49,6 +49,82 @@ functions work only on 8-bit data. */
 
 #include "pcre2_internal.h"
 
+/* The string search functions at the end of this module can use vector
+instructions. These macros hide the differences between the instruction sets
+and code unit widths. SIMD_ANY() is true if any lane of a comparison result is
+set. SIMD_CMPLE() compares unsigned code units; SSE2 has no such comparison, so
+it is made from a saturating subtraction for 8-bit and 16-bit units and from a
+signed comparison with the top bits flipped for 32-bit units. */
+
+#if defined PCRE2_SIMD_SSE2
+#include <emmintrin.h>
+typedef __m128i simd_vector;
+#define SIMD_LOAD(p)     _mm_loadu_si128((const __m128i *)(p))
+#define SIMD_AND(a, b)   _mm_and_si128(a, b)
+#define SIMD_OR(a, b)    _mm_or_si128(a, b)
+#define SIMD_ZERO        _mm_setzero_si128()
+#define SIMD_ANY(v)      (_mm_movemask_epi8(v) != 0)
+#if PCRE2_CODE_UNIT_WIDTH == 8
+#define SIMD_SET(c)      _mm_set1_epi8((char)(c))
+#define SIMD_CMPEQ(a, b) _mm_cmpeq_epi8(a, b)
+#define SIMD_SUB(a, b)   _mm_sub_epi8(a, b)
+#define SIMD_CMPLE(a, b) _mm_cmpeq_epi8(_mm_subs_epu8(a, b), SIMD_ZERO)
+#elif PCRE2_CODE_UNIT_WIDTH == 16
+#define SIMD_SET(c)      _mm_set1_epi16((short)(c))
+#define SIMD_CMPEQ(a, b) _mm_cmpeq_epi16(a, b)
+#define SIMD_SUB(a, b)   _mm_sub_epi16(a, b)
+#define SIMD_CMPLE(a, b) _mm_cmpeq_epi16(_mm_subs_epu16(a, b), SIMD_ZERO)
+#else
+#define SIMD_SET(c)      _mm_set1_epi32((int)(c))
+#define SIMD_CMPEQ(a, b) _mm_cmpeq_epi32(a, b)
+#define SIMD_SUB(a, b)   _mm_sub_epi32(a, b)
+#define SIMD_CMPLE(a, b) _mm_cmpeq_epi32(_mm_cmpgt_epi32( \
+  _mm_xor_si128(a, SIMD_SET(0x80000000u)), \
+  _mm_xor_si128(b, SIMD_SET(0x80000000u))), SIMD_ZERO)
+#endif
+
+#elif defined PCRE2_SIMD_NEON
+#include <arm_neon.h>
+#if PCRE2_CODE_UNIT_WIDTH == 8
+typedef uint8x16_t simd_vector;
+#define SIMD_LOAD(p)     vld1q_u8(p)
+#define SIMD_AND(a, b)   vandq_u8(a, b)
+#define SIMD_OR(a, b)    vorrq_u8(a, b)
+#define SIMD_ZERO        vdupq_n_u8(0)
+#define SIMD_ANY(v)      (vmaxvq_u8(v) != 0)
+#define SIMD_SET(c)      vdupq_n_u8(c)
+#define SIMD_CMPEQ(a, b) vceqq_u8(a, b)
+#define SIMD_SUB(a, b)   vsubq_u8(a, b)
+#define SIMD_CMPLE(a, b) vcleq_u8(a, b)
+#elif PCRE2_CODE_UNIT_WIDTH == 16
+typedef uint16x8_t simd_vector;
+#define SIMD_LOAD(p)     vld1q_u16(p)
+#define SIMD_AND(a, b)   vandq_u16(a, b)
+#define SIMD_OR(a, b)    vorrq_u16(a, b)
+#define SIMD_ZERO        vdupq_n_u16(0)
+#define SIMD_ANY(v)      (vmaxvq_u16(v) != 0)
+#define SIMD_SET(c)      vdupq_n_u16(c)
+#define SIMD_CMPEQ(a, b) vceqq_u16(a, b)
+#define SIMD_SUB(a, b)   vsubq_u16(a, b)
+#define SIMD_CMPLE(a, b) vcleq_u16(a, b)
+#else
+typedef uint32x4_t simd_vector;
+#define SIMD_LOAD(p)     vld1q_u32(p)
+#define SIMD_AND(a, b)   vandq_u32(a, b)
+#define SIMD_OR(a, b)    vorrq_u32(a, b)
+#define SIMD_ZERO        vdupq_n_u32(0)
+#define SIMD_ANY(v)      (vmaxvq_u32(v) != 0)
+#define SIMD_SET(c)      vdupq_n_u32(c)
+#define SIMD_CMPEQ(a, b) vceqq_u32(a, b)
+#define SIMD_SUB(a, b)   vsubq_u32(a, b)
+#define SIMD_CMPLE(a, b) vcleq_u32(a, b)
+#endif
+#endif
+
+#if defined PCRE2_SIMD_SSE2 || defined PCRE2_SIMD_NEON
+#define SIMD_UNITS (16/(PCRE2_CODE_UNIT_WIDTH/8))  /* Code units per vector */
+#endif
+
 
 /*************************************************
 *    Emulated memmove() for systems without it   *
@@ -234,4 +310,261 @@ while (*str2 != 0) *t++ = *str2++;
 return t - str1;
 }
 
+
+/*************************************************
+*      Find a string within a PCRE2 string       *
+*************************************************/
+
+/* This function is used by the matching functions to look for a required
+literal string in the subject. When vector instructions are available (see
+pcre2_internal.h), each step checks 16 bytes' worth of starting positions for
+both the first and the last code unit of the string, which rejects most
+positions without looking at the rest of it. Otherwise, memchr() is used to
+find the first code unit in the 8-bit library, and a simple loop in the others.
+
+Arguments:
+  start      where to start looking
+  end        end of the string to search
+  string     the string to look for
+  length     its length (at least 1)
+
+Returns:     pointer to the first occurrence, or NULL if there is none
+*/
+
+PCRE2_SPTR
+PRIV(find_string)(PCRE2_SPTR start, PCRE2_SPTR end, PCRE2_SPTR string,
+  PCRE2_SIZE length)
+{
+PCRE2_SPTR p = start;
+PCRE2_SPTR last;
+PCRE2_UCHAR c0 = string[0];
+PCRE2_UCHAR cn = string[length - 1];
+
+if ((PCRE2_SIZE)(end - start) < length) return NULL;
+last = end - length;    /* Last possible starting point */
+
+#ifdef SIMD_UNITS
+  {
+  simd_vector v0 = SIMD_SET(c0);
+  simd_vector vn = SIMD_SET(cn);
+
+  for (; last - p >= SIMD_UNITS - 1; p += SIMD_UNITS)
+    {
+    unsigned int i;
+    simd_vector eq = SIMD_AND(SIMD_CMPEQ(SIMD_LOAD(p), v0),
+      SIMD_CMPEQ(SIMD_LOAD(p + length - 1), vn));
+
+    if (!SIMD_ANY(eq)) continue;
+
+    /* At least one position in this block has matching first and last code
+    units; check them in order. */
+
+    for (i = 0; i < SIMD_UNITS; i++)
+      {
+      if (p[i] == c0 && p[i + length - 1] == cn &&
+          memcmp(p + i, string, CU2BYTES(length)) == 0)
+        return p + i;
+      }
+    }
+  }
+#endif  /* SIMD_UNITS */
+
+/* Check the remaining positions. */
+
+#if PCRE2_CODE_UNIT_WIDTH == 8
+for (; p <= last; p++)
+  {
+  p = memchr(p, c0, last - p + 1);
+  if (p == NULL) return NULL;
+  if (p[length - 1] == cn && memcmp(p, string, length) == 0) return p;
+  }
+#else
+for (; p <= last; p++)
+  {
+  if (*p == c0 && p[length - 1] == cn &&
+      memcmp(p, string, CU2BYTES(length)) == 0)
+    return p;
+  }
+#endif
+
+return NULL;
+}
+
+
+
+/*************************************************
+*      Find one of a set of strings              *
+*************************************************/
+
+/* This function is used by the matching functions to find the first place in
+the subject where any of a small set of literal strings of the same length
+starts. It works like find_string() above, but each step checks the first two
+code units of every string in the set, so that positions where none of them
+can start are skipped quickly. The strings are stored one after the other.
+
+Arguments:
+  start      where to start looking
+  end        end of the string to search
+  strings    the strings to look for
+  count      the number of strings (at most START_LITERALS_MAX)
+  length     their length (at least 2)
+
+Returns:     pointer to the first occurrence, or NULL if there is none
+*/
+
+PCRE2_SPTR
+PRIV(find_string_set)(PCRE2_SPTR start, PCRE2_SPTR end, PCRE2_SPTR strings,
+  uint32_t count, uint32_t length)
+{
+PCRE2_SPTR p = start;
+PCRE2_SPTR last;
+PCRE2_SPTR s;
+PCRE2_SPTR strings_end = strings + count * length;
+
+if ((PCRE2_SIZE)(end - start) < length) return NULL;
+last = end - length;    /* Last possible starting point */
+
+#ifdef SIMD_UNITS
+  {
+  simd_vector v0[START_LITERALS_MAX];
+  simd_vector v1[START_LITERALS_MAX];
+  uint32_t i;
+
+  for (i = 0; i < count; i++)
+    {
+    v0[i] = SIMD_SET(strings[i*length]);
+    v1[i] = SIMD_SET(strings[i*length + 1]);
+    }
+
+  for (; last - p >= SIMD_UNITS - 1; p += SIMD_UNITS)
+    {
+    simd_vector d0 = SIMD_LOAD(p);
+    simd_vector d1 = SIMD_LOAD(p + 1);
+    simd_vector eq = SIMD_ZERO;
+
+    for (i = 0; i < count; i++)
+      eq = SIMD_OR(eq, SIMD_AND(SIMD_CMPEQ(d0, v0[i]), SIMD_CMPEQ(d1, v1[i])));
+
+    if (!SIMD_ANY(eq)) continue;
+
+    /* At least one position in this block starts with the first two code
+    units of one of the strings; check them in order. */
+
+    for (i = 0; i < SIMD_UNITS; i++)
+      {
+      for (s = strings; s < strings_end; s += length)
+        {
+        if (p[i] == s[0] && memcmp(p + i, s, CU2BYTES(length)) == 0)
+          return p + i;
+        }
+      }
+    }
+  }
+#endif  /* SIMD_UNITS */
+
+/* Check the remaining positions. */
+
+for (; p <= last; p++)
+  {
+  for (s = strings; s < strings_end; s += length)
+    {
+    if (*p == *s && memcmp(p, s, CU2BYTES(length)) == 0) return p;
+    }
+  }
+
+return NULL;
+}
+
+
+
+/*************************************************
+*      Find a code unit in the start bitmap      *
+*************************************************/
+
+/* This function is used by the matching functions to find the first code
+unit that is in the starting code unit bitmap of a pattern, using the ranges
+that pcre2_study() saved to cover the bitmap, if any. When vector instructions are
+available, each step subtracts the first code unit of each range from 16
+bytes' worth of code units and compares the results with the size of the range,
+so that a block of code units that are all outside the ranges is skipped at
+once. Because the ranges may cover code units that are not in the bitmap,
+units within them are checked against the bitmap. In the 16-bit and 32-bit
+libraries, all code units greater than 254 use the 255 bit.
+
+Arguments:
+  start      where to start looking
+  end        end of the string to search
+  bitmap     the starting code unit bitmap
+  ranges     pairs of first and last code units of the ranges
+  count      the number of ranges (at most START_RANGES_MAX)
+
+Returns:     pointer to the first code unit in the bitmap, or end if there is
+               none
+*/
+
+PCRE2_SPTR
+PRIV(find_start_bits)(PCRE2_SPTR start, PCRE2_SPTR end, const uint8_t *bitmap,
+  const uint8_t *ranges, uint32_t count)
+{
+PCRE2_SPTR p = start;
+
+#ifdef SIMD_UNITS
+if (count > 0)
+  {
+  simd_vector first[START_RANGES_MAX];
+  simd_vector size[START_RANGES_MAX];
+  uint32_t i;
+
+  for (i = 0; i < count; i++)
+    {
+    uint32_t last = ranges[2*i + 1];
+#if PCRE2_CODE_UNIT_WIDTH != 8
+    if (last == 255) last = MAX_NON_UTF_CHAR;
+#endif
+    first[i] = SIMD_SET(ranges[2*i]);
+    size[i] = SIMD_SET(last - ranges[2*i]);
+    }
+
+  for (; end - p >= SIMD_UNITS; p += SIMD_UNITS)
+    {
+    simd_vector data = SIMD_LOAD(p);
+    simd_vector in = SIMD_ZERO;
+
+    for (i = 0; i < count; i++)
+      in = SIMD_OR(in, SIMD_CMPLE(SIMD_SUB(data, first[i]), size[i]));
+
+    if (!SIMD_ANY(in)) continue;
+
+    /* At least one code unit in this block is within a range; check them in
+    order. */
+
+    for (i = 0; i < SIMD_UNITS; i++)
+      {
+      uint32_t c = p[i];
+#if PCRE2_CODE_UNIT_WIDTH != 8
+      if (c > 255) c = 255;
+#endif
+      if ((bitmap[c/8] & (1u << (c&7))) != 0) return p + i;
+      }
+    }
+  }
+#else
+(void)ranges;
+(void)count;
+#endif  /* SIMD_UNITS */
+
+/* Check the remaining code units. */
+
+for (; p < end; p++)
+  {
+  uint32_t c = *p;
+#if PCRE2_CODE_UNIT_WIDTH != 8
+  if (c > 255) c = 255;
+#endif
+  if ((bitmap[c/8] & (1u << (c&7))) != 0) break;
+  }
+
+return p;
+}
+
 /* End of pcre2_string_utils.c */
@@ -1652,6 +1652,434 @@ return yield;
 
 
 
+/*************************************************
+*      Find a required literal string            *
+*************************************************/
+
+/* This function is called for a pattern with only one top-level branch. It
+scans the items in the branch for the longest run of consecutive literal code
+units, which must appear in any subject that the pattern matches. Only caseful
+characters are used. A repeat such as a{3} adds three copies of its character,
+and a+ adds its character but ends the run. Groups are not examined, so
+they end a run. Nothing is recorded for a pattern that contains (*ACCEPT),
+because a match may then end before the run is reached, nor for runs shorter
+than three code units, for which the first and last code unit checks are almost
+as good.
+If the run is the first item in the pattern, PCRE2_LITSTART is set, because
+every match must then start with the literal.
+
+Arguments:
+  re          points to the compiled pattern
+  code        points to the top-level bracket
+  utf         TRUE in UTF mode
+
+Returns:      nothing
+*/
+
+static void
+set_required_literal(pcre2_real_code *re, PCRE2_SPTR code, BOOL utf)
+{
+PCRE2_UCHAR buffer[REQ_LITERAL_MAX];
+PCRE2_SPTR first = code + 1 + LINK_SIZE;
+PCRE2_SPTR cc = first;
+uint32_t length = 0;
+uint32_t best = 0;
+BOOL atstart = FALSE;
+BOOL bestatstart = FALSE;
+BOOL done = FALSE;
+
+(void)utf;   /* Avoid compiler warning when UTF is not supported */
+
+if ((re->flags & PCRE2_HASACCEPT) != 0 || code[GET(code, 1)] != OP_KET)
+  return;
+
+while (!done)
+  {
+  PCRE2_SPTR item = cc;
+  PCRE2_SPTR chars = NULL;
+  uint32_t clen = 1;
+  uint32_t count = 0;
+  BOOL endrun = TRUE;
+
+  switch (*cc)
+    {
+    case OP_CHAR:
+    case OP_EXACT:
+    case OP_PLUS:
+    case OP_MINPLUS:
+    case OP_POSPLUS:
+    chars = cc + PRIV(OP_lengths)[*cc] - 1;
+    count = (*cc == OP_EXACT)? GET2(cc, 1) : 1;
+    endrun = *cc != OP_CHAR && *cc != OP_EXACT;
+    /* Fall through */
+
+    case OP_CHARI:
+    case OP_NOT:
+    case OP_NOTI:
+    case OP_STAR:
+    case OP_MINSTAR:
+    case OP_QUERY:
+    case OP_MINQUERY:
+    case OP_UPTO:
+    case OP_MINUPTO:
+    case OP_POSSTAR:
+    case OP_POSQUERY:
+    case OP_POSUPTO:
+    case OP_STARI:
+    case OP_MINSTARI:
+    case OP_PLUSI:
+    case OP_MINPLUSI:
+    case OP_QUERYI:
+    case OP_MINQUERYI:
+    case OP_UPTOI:
+    case OP_MINUPTOI:
+    case OP_EXACTI:
+    case OP_POSSTARI:
+    case OP_POSPLUSI:
+    case OP_POSQUERYI:
+    case OP_POSUPTOI:
+    case OP_NOTSTAR:
+    case OP_NOTMINSTAR:
+    case OP_NOTPLUS:
+    case OP_NOTMINPLUS:
+    case OP_NOTQUERY:
+    case OP_NOTMINQUERY:
+    case OP_NOTUPTO:
+    case OP_NOTMINUPTO:
+    case OP_NOTEXACT:
+    case OP_NOTPOSSTAR:
+    case OP_NOTPOSPLUS:
+    case OP_NOTPOSQUERY:
+    case OP_NOTPOSUPTO:
+    case OP_NOTSTARI:
+    case OP_NOTMINSTARI:
+    case OP_NOTPLUSI:
+    case OP_NOTMINPLUSI:
+    case OP_NOTQUERYI:
+    case OP_NOTMINQUERYI:
+    case OP_NOTUPTOI:
+    case OP_NOTMINUPTOI:
+    case OP_NOTEXACTI:
+    case OP_NOTPOSSTARI:
+    case OP_NOTPOSPLUSI:
+    case OP_NOTPOSQUERYI:
+    case OP_NOTPOSUPTOI:
+    cc += PRIV(OP_lengths)[*cc];
+#ifdef SUPPORT_UNICODE
+    if (utf && HAS_EXTRALEN(cc[-1]))
+      {
+      clen += GET_EXTRALEN(cc[-1]);
+      cc += GET_EXTRALEN(cc[-1]);
+      }
+#endif
+    break;
+
+    case OP_TYPESTAR:
+    case OP_TYPEMINSTAR:
+    case OP_TYPEPLUS:
+    case OP_TYPEMINPLUS:
+    case OP_TYPEQUERY:
+    case OP_TYPEMINQUERY:
+    case OP_TYPEUPTO:
+    case OP_TYPEMINUPTO:
+    case OP_TYPEEXACT:
+    case OP_TYPEPOSSTAR:
+    case OP_TYPEPOSPLUS:
+    case OP_TYPEPOSQUERY:
+    case OP_TYPEPOSUPTO:
+    cc += PRIV(OP_lengths)[*cc];
+#ifdef SUPPORT_UNICODE
+    if (cc[-1] == OP_PROP || cc[-1] == OP_NOTPROP) cc += 2;
+#endif
+    break;
+
+#if defined SUPPORT_UNICODE || PCRE2_CODE_UNIT_WIDTH != 8
+    case OP_XCLASS:
+    cc += GET(cc, 1);
+    break;
+#endif
+
+    case OP_MARK:
+    case OP_COMMIT_ARG:
+    case OP_PRUNE_ARG:
+    case OP_SKIP_ARG:
+    case OP_THEN_ARG:
+    cc += PRIV(OP_lengths)[*cc] + cc[1];
+    break;
+
+    case OP_CALLOUT_STR:
+    cc += GET(cc, 1 + 2*LINK_SIZE);
+    break;
+
+    /* Skip over a group. */
+
+    case OP_ASSERT:
+    case OP_ASSERT_NOT:
+    case OP_ASSERTBACK:
+    case OP_ASSERTBACK_NOT:
+    case OP_ASSERT_NA:
+    case OP_ASSERTBACK_NA:
+    case OP_ONCE:
+    case OP_SCRIPT_RUN:
+    case OP_BRA:
+    case OP_BRAPOS:
+    case OP_CBRA:
+    case OP_CBRAPOS:
+    case OP_COND:
+    case OP_SBRA:
+    case OP_SBRAPOS:
+    case OP_SCBRA:
+    case OP_SCBRAPOS:
+    case OP_SCOND:
+    do cc += GET(cc, 1); while (*cc == OP_ALT);
+    cc += PRIV(OP_lengths)[*cc];
+    break;
+
+    /* The end of the top-level branch */
+
+    case OP_KET:
+    done = TRUE;
+    break;
+
+    default:
+    cc += PRIV(OP_lengths)[*cc];
+    break;
+    }
+
+  /* Add any literal characters to the current run, as far as there is room.
+  The character is the last item in the fixed part of the opcode. */
+
+  if (chars != NULL)
+    {
+    if (length == 0) atstart = item == first;
+    for (; count > 0 && length < REQ_LITERAL_MAX; count--)
+      {
+      uint32_t i;
+      for (i = 0; i < clen && length < REQ_LITERAL_MAX; i++)
+        buffer[length++] = chars[i];
+      }
+    }
+
+  if (endrun)
+    {
+    if (length > best)
+      {
+      best = length;
+      bestatstart = atstart;
+      memcpy(re->req_literal, buffer, CU2BYTES(length));
+      }
+    length = 0;
+    }
+  }
+
+if (best >= 3)
+  {
+  re->req_literal_length = (uint16_t)best;
+  if (bestatstart) re->flags |= PCRE2_LITSTART;
+  }
+}
+
+
+
+/*************************************************
+*   Get the literal prefix of a branch           *
+*************************************************/
+
+/* This function copies the caseful literal characters at the start of a
+branch into a buffer, stopping at the first item that is not a literal
+character or when START_LITERAL_LENGTH code units have been copied. As in
+set_required_literal(), a+ contributes one character and ends the prefix.
+
+Arguments:
+  cc          points to the first item in the branch
+  utf         TRUE in UTF mode
+  buffer      where to put the prefix
+
+Returns:      the length of the prefix in code units
+*/
+
+static uint32_t
+literal_prefix(PCRE2_SPTR cc, BOOL utf, PCRE2_UCHAR *buffer)
+{
+uint32_t length = 0;
+
+(void)utf;   /* Avoid compiler warning when UTF is not supported */
+
+for (;;)
+  {
+  PCRE2_SPTR chars;
+  uint32_t clen = 1;
+  uint32_t count;
+
+  switch (*cc)
+    {
+    case OP_CHAR:
+    case OP_EXACT:
+    case OP_PLUS:
+    case OP_MINPLUS:
+    case OP_POSPLUS:
+    break;
+
+    default:
+    return length;
+    }
+
+  chars = cc + PRIV(OP_lengths)[*cc] - 1;
+  count = (*cc == OP_EXACT)? GET2(cc, 1) : 1;
+#ifdef SUPPORT_UNICODE
+  if (utf && HAS_EXTRALEN(chars[0])) clen += GET_EXTRALEN(chars[0]);
+#endif
+
+  for (; count > 0; count--)
+    {
+    uint32_t i;
+    for (i = 0; i < clen; i++)
+      {
+      if (length >= START_LITERAL_LENGTH) return length;
+      buffer[length++] = chars[i];
+      }
+    }
+
+  if (*cc != OP_CHAR && *cc != OP_EXACT) return length;
+  cc = chars + clen;
+  }
+}
+
+
+
+/*************************************************
+*      Find a set of starting literals           *
+*************************************************/
+
+/* When a pattern consists of a number of alternatives, or starts with a group
+that does, and every alternative starts with literal characters, such as
+(?:GET|POST|PUT|DELETE) /api, the start bitmap is a weak filter if the first
+characters are common in subjects. Instead, the literal prefixes of the
+alternatives, all cut to the length of the shortest, are saved, and the
+matching functions search for the first place where any of them occurs.
+Nothing is saved if there are more than START_LITERALS_MAX alternatives or if
+any prefix is shorter than two code units.
+
+Arguments:
+  re          points to the compiled pattern
+  code        points to the top-level bracket
+  utf         TRUE in UTF mode
+
+Returns:      nothing
+*/
+
+static void
+set_start_literals(pcre2_real_code *re, PCRE2_SPTR code, BOOL utf)
+{
+PCRE2_UCHAR buffer[START_LITERALS_MAX][START_LITERAL_LENGTH];
+PCRE2_SPTR cc = code;
+uint32_t count = 0;
+uint32_t length = START_LITERAL_LENGTH;
+uint32_t i;
+
+/* With only one top-level branch, look for a group at its start. Such a group
+must always be entered, even if it is repeated. */
+
+if (code[GET(code, 1)] != OP_ALT)
+  {
+  cc = code + 1 + LINK_SIZE;
+  if (*cc != OP_BRA && *cc != OP_CBRA) return;
+  }
+
+do
+  {
+  uint32_t len;
+  PCRE2_SPTR branch = cc + 1 + LINK_SIZE;
+
+  if (*cc == OP_CBRA) branch += IMM2_SIZE;
+  if (count >= START_LITERALS_MAX) return;
+  len = literal_prefix(branch, utf, buffer[count++]);
+  if (len < 2) return;
+  if (len < length) length = len;
+  cc += GET(cc, 1);
+  }
+while (*cc == OP_ALT);
+
+if (count < 2) return;
+
+for (i = 0; i < count; i++)
+  memcpy(re->start_literals + i * length, buffer[i], CU2BYTES(length));
+re->start_literal_count = (uint8_t)count;
+re->start_literal_length = (uint8_t)length;
+}
+
+
+
+/*************************************************
+*     Cover the start bitmap with ranges         *
+*************************************************/
+
+/* The matching functions can search for a code unit that is in the starting
+code unit bitmap several code units at a time if the bitmap is described by a
+few ranges, because a code unit can be tested against a range with one
+subtraction and one comparison. If there are more than START_RANGES_MAX runs
+of set bits, the closest runs are merged, so the ranges may cover code units
+that are not in the bitmap. Such code units are rejected by checking the
+bitmap when one is found, but the ranges are not saved if they cover more than
+twice as many code units as the bitmap contains, because then they are a poor
+filter. A range that ends at 255 includes all wider code units in the 16-bit
+and 32-bit libraries.
+
+Argument:   points to the compiled pattern
+Returns:    nothing
+*/
+
+static void
+set_start_ranges(pcre2_real_code *re)
+{
+uint8_t first[128];
+uint8_t last[128];
+uint32_t count = 0;
+uint32_t bits = 0;
+uint32_t covered = 0;
+uint32_t c, i;
+
+for (c = 0; c < 256; c++)
+  {
+  if ((re->start_bitmap[c/8] & (1u << (c&7))) == 0) continue;
+  bits++;
+  if (count > 0 && last[count - 1] == c - 1) last[count - 1] = c; else
+    {
+    first[count] = last[count] = c;
+    count++;
+    }
+  }
+
+/* Merge the two runs that have the smallest gap between them until there
+are few enough. */
+
+while (count > START_RANGES_MAX)
+  {
+  uint32_t best = 0;
+  for (i = 1; i < count - 1; i++)
+    if (first[i+1] - last[i] < first[best+1] - last[best]) best = i;
+  last[best] = last[best+1];
+  count--;
+  for (i = best + 1; i < count; i++)
+    {
+    first[i] = first[i+1];
+    last[i] = last[i+1];
+    }
+  }
+
+for (i = 0; i < count; i++) covered += last[i] - first[i] + 1;
+if (count == 0 || covered > 2 * bits) return;
+
+for (i = 0; i < count; i++)
+  {
+  re->start_ranges[2*i] = first[i];
+  re->start_ranges[2*i + 1] = last[i];
+  }
+re->start_range_count = (uint8_t)count;
+}
+
+
+
 /*************************************************
 *          Study a compiled expression           *
 *************************************************/
@@ -1787,6 +2215,14 @@ if ((re->flags & (PCRE2_FIRSTSET|PCRE2_STARTLINE)) == 0)
     }
   }
 
+/* Look for a required literal string and for a set of literal strings, one
+of which must start any match. If there is a starting code unit bitmap, see if
+it can be described by a few ranges. */
+
+set_required_literal(re, code, utf);
+set_start_literals(re, code, utf);
+if ((re->flags & PCRE2_FIRSTMAPSET) != 0) set_start_ranges(re);
+
 /* Find the minimum length of subject string. If the pattern can match an empty
 string, the minimum length is already known. If the pattern contains (*ACCEPT)
 all bets are off, and we don't even try to find a minimum length. If there are
@@ -254,10 +254,11 @@ lengthleft = buff_length = *blength;
 *blength = PCRE2_UNSET;
 ovecsave[0] = ovecsave[1] = ovecsave[2] = PCRE2_UNSET;
 
-/* Partial matching is not valid. This must come after setting *blength to
-PCRE2_UNSET, so as not to imply an offset in the replacement. */
+/* Partial matching and PCRE2_NO_OVECTOR are not valid. This must come after
+setting *blength to PCRE2_UNSET, so as not to imply an offset in the
+replacement. */
 
-if ((options & (PCRE2_PARTIAL_HARD|PCRE2_PARTIAL_SOFT)) != 0)
+if ((options & (PCRE2_PARTIAL_HARD|PCRE2_PARTIAL_SOFT|PCRE2_NO_OVECTOR)) != 0)
   return PCRE2_ERROR_BADOPTION;
   
 /* Validate length and find the end of the replacement. A NULL replacement of 
@@ -309,6 +310,11 @@ else if (use_existing_match)
   if (internal_match_data == NULL) return PCRE2_ERROR_NOMEMORY;
   memcpy(internal_match_data, match_data, offsetof(pcre2_match_data, ovector)
     + 2*pairs*sizeof(PCRE2_SIZE));
+  internal_match_data->heapframes = NULL;
+  internal_match_data->heapframes_size = 0;
+  internal_match_data->resume = NULL;
+  internal_match_data->profile = NULL;
+  internal_match_data->profile_size = 0;
   match_data = internal_match_data;
   }
 
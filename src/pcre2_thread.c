@@ -0,0 +1,198 @@
+/*************************************************
+*      Perl-Compatible Regular Expressions       *
+*************************************************/
+
+/* PCRE is a library of functions to support regular expressions whose syntax
+and semantics are as close as possible to those of the Perl 5 language.
+
+                       Written by Philip Hazel
+     Original API code Copyright (c) 1997-2012 University of Cambridge
+          New API code Copyright (c) 2016-2022 University of Cambridge
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the University of Cambridge nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+
+/* This module contains the few thread, mutex, and condition variable functions
+that are needed by pcre2_match_parallel() and the match pool functions, as thin
+wrappers round POSIX threads or the Windows equivalents. They exist only when
+thread support is enabled at build time. */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "pcre2_internal.h"
+
+#ifdef SUPPORT_THREADS
+
+/*************************************************
+*              Start a new thread                *
+*************************************************/
+
+/*
+Arguments:
+  handle      where to put the thread's handle
+  function    the function that the thread runs
+  data        the argument for the function
+
+Returns:      TRUE if the thread was started
+*/
+
+BOOL
+PRIV(thread_create)(thread_handle *handle, thread_function function,
+  void *data)
+{
+#ifdef _WIN32
+*handle = CreateThread(NULL, 0, function, data, 0, NULL);
+return *handle != NULL;
+#else
+return pthread_create(handle, NULL, function, data) == 0;
+#endif
+}
+
+
+
+/*************************************************
+*         Wait for a thread to finish            *
+*************************************************/
+
+void
+PRIV(thread_join)(thread_handle handle)
+{
+#ifdef _WIN32
+WaitForSingleObject(handle, INFINITE);
+CloseHandle(handle);
+#else
+pthread_join(handle, NULL);
+#endif
+}
+
+
+
+/*************************************************
+*               Mutex functions                  *
+*************************************************/
+
+BOOL
+PRIV(mutex_init)(thread_mutex *mutex)
+{
+#ifdef _WIN32
+InitializeCriticalSection(mutex);
+return TRUE;
+#else
+return pthread_mutex_init(mutex, NULL) == 0;
+#endif
+}
+
+void
+PRIV(mutex_destroy)(thread_mutex *mutex)
+{
+#ifdef _WIN32
+DeleteCriticalSection(mutex);
+#else
+pthread_mutex_destroy(mutex);
+#endif
+}
+
+void
+PRIV(mutex_lock)(thread_mutex *mutex)
+{
+#ifdef _WIN32
+EnterCriticalSection(mutex);
+#else
+pthread_mutex_lock(mutex);
+#endif
+}
+
+void
+PRIV(mutex_unlock)(thread_mutex *mutex)
+{
+#ifdef _WIN32
+LeaveCriticalSection(mutex);
+#else
+pthread_mutex_unlock(mutex);
+#endif
+}
+
+
+
+
+/*************************************************
+*         Condition variable functions           *
+*************************************************/
+
+BOOL
+PRIV(cond_init)(thread_cond *cond)
+{
+#ifdef _WIN32
+InitializeConditionVariable(cond);
+return TRUE;
+#else
+return pthread_cond_init(cond, NULL) == 0;
+#endif
+}
+
+void
+PRIV(cond_destroy)(thread_cond *cond)
+{
+#ifdef _WIN32
+(void)cond;   /* Windows condition variables need no cleanup */
+#else
+pthread_cond_destroy(cond);
+#endif
+}
+
+/* The mutex must be locked by the caller; it is released while waiting and
+locked again before returning. */
+
+void
+PRIV(cond_wait)(thread_cond *cond, thread_mutex *mutex)
+{
+#ifdef _WIN32
+SleepConditionVariableCS(cond, mutex, INFINITE);
+#else
+pthread_cond_wait(cond, mutex);
+#endif
+}
+
+void
+PRIV(cond_broadcast)(thread_cond *cond)
+{
+#ifdef _WIN32
+WakeAllConditionVariable(cond);
+#else
+pthread_cond_broadcast(cond);
+#endif
+}
+
+#endif  /* SUPPORT_THREADS */
+
+/* End of pcre2_thread.c */
@@ -0,0 +1,319 @@
+/*************************************************
+*      Perl-Compatible Regular Expressions       *
+*************************************************/
+
+/* PCRE is a library of functions to support regular expressions whose syntax
+and semantics are as close as possible to those of the Perl 5 language.
+
+                       Written by Philip Hazel
+          New API code Copyright (c) 2022 University of Cambridge
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the University of Cambridge nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+
+/* This program tests the multi-threaded code in match pools. It is built and
+run only when PCRE2 has thread support, because otherwise a pool has a single
+worker and the pool tests in pcre2test cover everything. The output of
+pcre2test is the same whatever the number of threads, so it cannot show that
+more than one thread took part in a run; that, and the rule that no subject is
+started after a callback has stopped a run, are checked here. Only the 8-bit
+library is used. */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+typedef CRITICAL_SECTION test_mutex;
+#define MUTEX_INIT(m)    InitializeCriticalSection(m)
+#define MUTEX_LOCK(m)    EnterCriticalSection(m)
+#define MUTEX_UNLOCK(m)  LeaveCriticalSection(m)
+#define MUTEX_DESTROY(m) DeleteCriticalSection(m)
+#define PAUSE()          Sleep(10)
+#else
+#include <pthread.h>
+#include <time.h>
+typedef pthread_mutex_t test_mutex;
+#define MUTEX_INIT(m)    pthread_mutex_init(m, NULL)
+#define MUTEX_LOCK(m)    pthread_mutex_lock(m)
+#define MUTEX_UNLOCK(m)  pthread_mutex_unlock(m)
+#define MUTEX_DESTROY(m) pthread_mutex_destroy(m)
+#define PAUSE()          { struct timespec ts = { 0, 10000000 }; \
+                           nanosleep(&ts, NULL); }
+#endif
+
+#define PCRE2_CODE_UNIT_WIDTH 8
+#include "pcre2.h"
+
+#ifndef SUPPORT_THREADS
+#error pcre2_thread_test needs a build with thread support
+#endif
+
+#define THREADS    4
+#define SUBJECTS   4000
+#define RUNS       200
+#define STOP_RUNS  50
+#define MAXWORKERS 16
+
+/* The data shared by the callbacks of one run. The match data block that a
+callback is given belongs to the worker that matched the subject, so counting
+the different blocks counts the workers that took part. */
+
+typedef struct run_data {
+  test_mutex mutex;
+  pcre2_match_data *workers[MAXWORKERS];
+  uint32_t worker_count;
+  uint32_t calls;
+  uint32_t calls_at_stop;
+  int bad;
+} run_data;
+
+static PCRE2_SPTR subjects[SUBJECTS];
+static char subject_text[SUBJECTS][32];
+
+
+
+/*************************************************
+*       Callback that records the workers        *
+*************************************************/
+
+static int
+record_callback(uint32_t index, int rc, pcre2_match_data *match_data,
+  void *data)
+{
+run_data *rd = (run_data *)data;
+uint32_t i;
+int expect = (index % 3 == 0)? PCRE2_ERROR_NOMATCH : 2;
+
+MUTEX_LOCK(&rd->mutex);
+rd->calls++;
+if (rc != expect) rd->bad = 1;
+for (i = 0; i < rd->worker_count; i++)
+  if (rd->workers[i] == match_data) break;
+if (i >= rd->worker_count && rd->worker_count < MAXWORKERS)
+  rd->workers[rd->worker_count++] = match_data;
+MUTEX_UNLOCK(&rd->mutex);
+return 0;
+}
+
+
+
+/*************************************************
+*        Callback that stops a run early         *
+*************************************************/
+
+/* The run is stopped when the subject with index STOP_INDEX has been matched,
+and the number of callbacks up to then is remembered. The run does not stop
+until this callback has returned, so any other callback that is made after
+that point pauses, to give the stopping thread time to stop the run. Without
+this, the other workers could legitimately start more subjects before the
+stop takes effect. */
+
+#define STOP_INDEX 1
+#define STOP_VALUE 99
+
+static int
+stop_callback(uint32_t index, int rc, pcre2_match_data *match_data,
+  void *data)
+{
+run_data *rd = (run_data *)data;
+int stopping;
+(void)rc;
+(void)match_data;
+
+MUTEX_LOCK(&rd->mutex);
+rd->calls++;
+if (index == STOP_INDEX) rd->calls_at_stop = rd->calls;
+stopping = rd->calls_at_stop != 0;
+MUTEX_UNLOCK(&rd->mutex);
+if (index == STOP_INDEX) return STOP_VALUE;
+if (stopping) PAUSE();
+return 0;
+}
+
+
+
+/*************************************************
+*      Check that several workers take part      *
+*************************************************/
+
+/* Every third subject does not match. The results from the pool must agree
+with those of pcre2_match(), every subject must be seen once by the callback,
+and in at least one of the runs more than one worker must have matched
+subjects. A run can legitimately be done by one thread if the others are slow
+to start, so many runs are tried. */
+
+static int
+test_workers(pcre2_match_pool *pool)
+{
+PCRE2_SIZE *results = malloc(2 * SUBJECTS * sizeof(PCRE2_SIZE));
+uint32_t most = 0;
+int run, yield = 0;
+
+if (results == NULL)
+  {
+  printf("** Failed to get memory\n");
+  return 1;
+  }
+
+for (run = 0; run < RUNS; run++)
+  {
+  int rc;
+  uint32_t i;
+  run_data rd;
+
+  memset(&rd, 0, sizeof(run_data));
+  MUTEX_INIT(&rd.mutex);
+  rc = pcre2_match_pool_run(pool, subjects, NULL, SUBJECTS, 0, results,
+    record_callback, &rd, NULL);
+  MUTEX_DESTROY(&rd.mutex);
+
+  if (rc != SUBJECTS - (SUBJECTS + 2)/3 || rd.calls != SUBJECTS || rd.bad)
+    {
+    printf("** Pool run %d: rc=%d calls=%u\n", run, rc, rd.calls);
+    yield = 1;
+    break;
+    }
+
+  for (i = 0; i < SUBJECTS; i++)
+    {
+    PCRE2_SIZE start = (i % 3 == 0)? PCRE2_UNSET : 1;
+    if (results[2*i] != start)
+      {
+      printf("** Pool run %d: wrong result for subject %u\n", run, i);
+      yield = 1;
+      break;
+      }
+    }
+  if (yield != 0) break;
+  if (rd.worker_count > most) most = rd.worker_count;
+  }
+
+if (yield == 0 && most < 2)
+  {
+  printf("** No pool run used more than one worker\n");
+  yield = 1;
+  }
+
+free(results);
+return yield;
+}
+
+
+
+/*************************************************
+*    Check that a stopped run starts no more     *
+*************************************************/
+
+/* Once a callback has stopped a run, a worker may finish the subject it is
+matching, but must not start another one, even if it has just stolen part of
+another worker's range. So after the stopping callback there can be at most
+one more callback for each of the other workers. */
+
+static int
+test_stop(pcre2_match_pool *pool)
+{
+int run;
+
+for (run = 0; run < STOP_RUNS; run++)
+  {
+  int rc;
+  run_data rd;
+
+  memset(&rd, 0, sizeof(run_data));
+  MUTEX_INIT(&rd.mutex);
+  rc = pcre2_match_pool_run(pool, subjects, NULL, SUBJECTS, 0, NULL,
+    stop_callback, &rd, NULL);
+  MUTEX_DESTROY(&rd.mutex);
+
+  if (rc != STOP_VALUE || rd.calls_at_stop == 0 ||
+      rd.calls - rd.calls_at_stop > THREADS - 1)
+    {
+    printf("** Stopped run %d: rc=%d, %u callbacks after the stop\n", run, rc,
+      rd.calls - rd.calls_at_stop);
+    return 1;
+    }
+  }
+
+return 0;
+}
+
+
+
+/*************************************************
+*                 Main program                   *
+*************************************************/
+
+int
+main(void)
+{
+int errorcode, yield;
+PCRE2_SIZE erroroffset;
+pcre2_code *code;
+pcre2_match_pool *pool;
+uint32_t i;
+
+for (i = 0; i < SUBJECTS; i++)
+  {
+  sprintf(subject_text[i], "%s%u", (i % 3 == 0)? "xyz" : "xabc", i);
+  subjects[i] = (PCRE2_SPTR)subject_text[i];
+  }
+
+code = pcre2_compile((PCRE2_SPTR)"a(b)c\\d+", PCRE2_ZERO_TERMINATED, 0,
+  &errorcode, &erroroffset, NULL);
+if (code == NULL)
+  {
+  printf("** Compile failed: error %d\n", errorcode);
+  return 1;
+  }
+
+pool = pcre2_match_pool_create(code, THREADS, 0, NULL);
+if (pool == NULL)
+  {
+  printf("** Failed to create a match pool\n");
+  pcre2_code_free(code);
+  return 1;
+  }
+
+yield = test_workers(pool) | test_stop(pool);
+
+pcre2_match_pool_free(pool);
+pcre2_code_free(code);
+if (yield == 0) printf("Match pool thread tests passed\n");
+return yield;
+}
+
+/* End of pcre2_thread_test.c */
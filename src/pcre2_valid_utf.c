@@ -70,6 +70,124 @@ return 0;
 #else  /* UTF is supported */
 
 
+/* Long runs of code units that are complete characters on their own are
+checked several at a time, using vector instructions when they are available
+(see pcre2_internal.h). A unit that may need further checking causes a drop
+back to the code that checks one character at a time, so that the error codes
+and offsets are unchanged. */
+
+#if defined PCRE2_SIMD_SSE2
+#include <emmintrin.h>
+#elif defined PCRE2_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+/* A "simple" code unit is an ASCII character in UTF-8, a character that is
+not a surrogate in UTF-16, and a character that is neither a surrogate nor
+greater than 0x10ffff in UTF-32. */
+
+#if PCRE2_CODE_UNIT_WIDTH == 8
+#define SIMPLE_UNIT(c) ((c) < 0x80)
+#elif PCRE2_CODE_UNIT_WIDTH == 16
+#define SIMPLE_UNIT(c) (((c) & 0xf800) != 0xd800)
+#else
+#define SIMPLE_UNIT(c) (((c) & 0xfffff800u) != 0xd800u && (c) <= 0x10ffffu)
+#endif
+
+/* In UTF-8 and UTF-16, runs are looked for only at the start of each block of
+BLOCK_UNITS code units, so that text that mixes simple and other characters
+costs no more per character than checking one at a time. */
+
+#if defined PCRE2_SIMD_SSE2 || defined PCRE2_SIMD_NEON
+#define STEP_UNITS (32/(PCRE2_CODE_UNIT_WIDTH/8))
+#define BLOCK_UNITS (4*STEP_UNITS)
+#endif
+
+
+
+/*************************************************
+*        Count leading simple code units         *
+*************************************************/
+
+/* Each step of the vector loop checks 32 bytes. When a step finds a unit that
+is not simple, the scalar loop finds exactly where it is.
+
+Arguments:
+  string       points to the string
+  length       length of string
+
+Returns:       the number of simple code units at the start of the string
+*/
+
+static PCRE2_SIZE
+simple_units(PCRE2_SPTR string, PCRE2_SIZE length)
+{
+PCRE2_SPTR p = string;
+
+#ifdef STEP_UNITS
+#define HALF_UNITS (STEP_UNITS/2)
+
+for (; length >= STEP_UNITS; p += STEP_UNITS, length -= STEP_UNITS)
+  {
+#ifdef PCRE2_SIMD_SSE2
+  __m128i v1 = _mm_loadu_si128((const __m128i *)p);
+  __m128i v2 = _mm_loadu_si128((const __m128i *)(p + HALF_UNITS));
+#if PCRE2_CODE_UNIT_WIDTH == 8
+  if (_mm_movemask_epi8(_mm_or_si128(v1, v2)) != 0) break;
+#elif PCRE2_CODE_UNIT_WIDTH == 16
+  __m128i mask = _mm_set1_epi16((short)0xf800);
+  __m128i surr = _mm_set1_epi16((short)0xd800);
+  v1 = _mm_cmpeq_epi16(_mm_and_si128(v1, mask), surr);
+  v2 = _mm_cmpeq_epi16(_mm_and_si128(v2, mask), surr);
+  if (_mm_movemask_epi8(_mm_or_si128(v1, v2)) != 0) break;
+#else
+  /* SSE2 has only signed comparisons, so flip the top bits first. */
+  __m128i mask = _mm_set1_epi32((int)0xfffff800);
+  __m128i surr = _mm_set1_epi32(0xd800);
+  __m128i bias = _mm_set1_epi32(INT32_MIN);
+  __m128i max = _mm_set1_epi32(INT32_MIN + 0x10ffff);
+  __m128i bad = _mm_or_si128(
+    _mm_or_si128(_mm_cmpeq_epi32(_mm_and_si128(v1, mask), surr),
+                 _mm_cmpeq_epi32(_mm_and_si128(v2, mask), surr)),
+    _mm_or_si128(_mm_cmpgt_epi32(_mm_xor_si128(v1, bias), max),
+                 _mm_cmpgt_epi32(_mm_xor_si128(v2, bias), max)));
+  if (_mm_movemask_epi8(bad) != 0) break;
+#endif
+
+#else  /* PCRE2_SIMD_NEON */
+#if PCRE2_CODE_UNIT_WIDTH == 8
+  uint8x16_t v = vorrq_u8(vld1q_u8(p), vld1q_u8(p + HALF_UNITS));
+  if (vmaxvq_u8(v) >= 0x80) break;
+#elif PCRE2_CODE_UNIT_WIDTH == 16
+  uint16x8_t mask = vdupq_n_u16(0xf800);
+  uint16x8_t surr = vdupq_n_u16(0xd800);
+  uint16x8_t bad = vorrq_u16(
+    vceqq_u16(vandq_u16(vld1q_u16(p), mask), surr),
+    vceqq_u16(vandq_u16(vld1q_u16(p + HALF_UNITS), mask), surr));
+  if (vmaxvq_u16(bad) != 0) break;
+#else
+  uint32x4_t mask = vdupq_n_u32(0xfffff800u);
+  uint32x4_t surr = vdupq_n_u32(0xd800u);
+  uint32x4_t max = vdupq_n_u32(0x10ffffu);
+  uint32x4_t v1 = vld1q_u32(p);
+  uint32x4_t v2 = vld1q_u32(p + HALF_UNITS);
+  uint32x4_t bad = vorrq_u32(
+    vorrq_u32(vceqq_u32(vandq_u32(v1, mask), surr),
+              vceqq_u32(vandq_u32(v2, mask), surr)),
+    vorrq_u32(vcgtq_u32(v1, max), vcgtq_u32(v2, max)));
+  if (vmaxvq_u32(bad) != 0) break;
+#endif
+#endif  /* PCRE2_SIMD_SSE2 */
+  }
+
+#undef HALF_UNITS
+#endif  /* STEP_UNITS */
+
+for (; length > 0 && SIMPLE_UNIT(*p); p++, length--) {}
+return (PCRE2_SIZE)(p - string);
+}
+
+
 
 /*************************************************
 *           Validate a UTF string                *
@@ -131,186 +249,199 @@ PCRE2_ERROR_UTF8_ERR20  Isolated 0x80 byte (not within UTF-8 character)
 PCRE2_ERROR_UTF8_ERR21  Byte with the illegal value 0xfe or 0xff
 */
 
-for (p = string; length > 0; p++)
+p = string;
+while (length > 0)
   {
-  uint32_t ab, d;
-
-  c = *p;
-  length--;
+  PCRE2_SIZE stop = 0;
 
-  if (c < 128) continue;                /* ASCII character */
-
-  if (c < 0xc0)                         /* Isolated 10xx xxxx byte */
-    {
-    *erroroffset = (PCRE2_SIZE)(p - string);
-    return PCRE2_ERROR_UTF8_ERR20;
-    }
-
-  if (c >= 0xfe)                        /* Invalid 0xfe or 0xff bytes */
-    {
-    *erroroffset = (PCRE2_SIZE)(p - string);
-    return PCRE2_ERROR_UTF8_ERR21;
-    }
-
-  ab = PRIV(utf8_table4)[c & 0x3f];     /* Number of additional bytes (1-5) */
-  if (length < ab)                      /* Missing bytes */
-    {
-    *erroroffset = (PCRE2_SIZE)(p - string);
-    switch(ab - length)
-      {
-      case 1: return PCRE2_ERROR_UTF8_ERR1;
-      case 2: return PCRE2_ERROR_UTF8_ERR2;
-      case 3: return PCRE2_ERROR_UTF8_ERR3;
-      case 4: return PCRE2_ERROR_UTF8_ERR4;
-      case 5: return PCRE2_ERROR_UTF8_ERR5;
-      }
-    }
-  length -= ab;                         /* Length remaining */
-
-  /* Check top bits in the second byte */
+#ifdef STEP_UNITS
+  PCRE2_SIZE n = simple_units(p, length);
+  p += n;
+  length -= n;
+  if (length > BLOCK_UNITS) stop = length - BLOCK_UNITS;
+#endif
 
-  if (((d = *(++p)) & 0xc0) != 0x80)
+  for (; length > stop; p++)
     {
-    *erroroffset = (int)(p - string) - 1;
-    return PCRE2_ERROR_UTF8_ERR6;
-    }
+    uint32_t ab, d;
 
-  /* For each length, check that the remaining bytes start with the 0x80 bit
-  set and not the 0x40 bit. Then check for an overlong sequence, and for the
-  excluded range 0xd800 to 0xdfff. */
+    c = *p;
+    length--;
 
-  switch (ab)
-    {
-    /* 2-byte character. No further bytes to check for 0x80. Check first byte
-    for for xx00 000x (overlong sequence). */
+    if (c < 128) continue;                /* ASCII character */
 
-    case 1: if ((c & 0x3e) == 0)
+    if (c < 0xc0)                         /* Isolated 10xx xxxx byte */
       {
-      *erroroffset = (int)(p - string) - 1;
-      return PCRE2_ERROR_UTF8_ERR15;
+      *erroroffset = (PCRE2_SIZE)(p - string);
+      return PCRE2_ERROR_UTF8_ERR20;
       }
-    break;
-
-    /* 3-byte character. Check third byte for 0x80. Then check first 2 bytes
-      for 1110 0000, xx0x xxxx (overlong sequence) or
-          1110 1101, 1010 xxxx (0xd800 - 0xdfff) */
 
-    case 2:
-    if ((*(++p) & 0xc0) != 0x80)     /* Third byte */
+    if (c >= 0xfe)                        /* Invalid 0xfe or 0xff bytes */
       {
-      *erroroffset = (int)(p - string) - 2;
-      return PCRE2_ERROR_UTF8_ERR7;
+      *erroroffset = (PCRE2_SIZE)(p - string);
+      return PCRE2_ERROR_UTF8_ERR21;
       }
-    if (c == 0xe0 && (d & 0x20) == 0)
-      {
-      *erroroffset = (int)(p - string) - 2;
-      return PCRE2_ERROR_UTF8_ERR16;
-      }
-    if (c == 0xed && d >= 0xa0)
+
+    ab = PRIV(utf8_table4)[c & 0x3f];     /* Number of additional bytes (1-5) */
+    if (length < ab)                      /* Missing bytes */
       {
-      *erroroffset = (int)(p - string) - 2;
-      return PCRE2_ERROR_UTF8_ERR14;
+      *erroroffset = (PCRE2_SIZE)(p - string);
+      switch(ab - length)
+        {
+        case 1: return PCRE2_ERROR_UTF8_ERR1;
+        case 2: return PCRE2_ERROR_UTF8_ERR2;
+        case 3: return PCRE2_ERROR_UTF8_ERR3;
+        case 4: return PCRE2_ERROR_UTF8_ERR4;
+        case 5: return PCRE2_ERROR_UTF8_ERR5;
+        }
       }
-    break;
+    length -= ab;                         /* Length remaining */
 
-    /* 4-byte character. Check 3rd and 4th bytes for 0x80. Then check first 2
-       bytes for for 1111 0000, xx00 xxxx (overlong sequence), then check for a
-       character greater than 0x0010ffff (f4 8f bf bf) */
+    /* Check top bits in the second byte */
 
-    case 3:
-    if ((*(++p) & 0xc0) != 0x80)     /* Third byte */
+    if (((d = *(++p)) & 0xc0) != 0x80)
       {
-      *erroroffset = (int)(p - string) - 2;
-      return PCRE2_ERROR_UTF8_ERR7;
-      }
-    if ((*(++p) & 0xc0) != 0x80)     /* Fourth byte */
-      {
-      *erroroffset = (int)(p - string) - 3;
-      return PCRE2_ERROR_UTF8_ERR8;
-      }
-    if (c == 0xf0 && (d & 0x30) == 0)
-      {
-      *erroroffset = (int)(p - string) - 3;
-      return PCRE2_ERROR_UTF8_ERR17;
-      }
-    if (c > 0xf4 || (c == 0xf4 && d > 0x8f))
-      {
-      *erroroffset = (int)(p - string) - 3;
-      return PCRE2_ERROR_UTF8_ERR13;
+      *erroroffset = (int)(p - string) - 1;
+      return PCRE2_ERROR_UTF8_ERR6;
       }
-    break;
-
-    /* 5-byte and 6-byte characters are not allowed by RFC 3629, and will be
-    rejected by the length test below. However, we do the appropriate tests
-    here so that overlong sequences get diagnosed, and also in case there is
-    ever an option for handling these larger code points. */
 
-    /* 5-byte character. Check 3rd, 4th, and 5th bytes for 0x80. Then check for
-    1111 1000, xx00 0xxx */
+    /* For each length, check that the remaining bytes start with the 0x80 bit
+    set and not the 0x40 bit. Then check for an overlong sequence, and for the
+    excluded range 0xd800 to 0xdfff. */
 
-    case 4:
-    if ((*(++p) & 0xc0) != 0x80)     /* Third byte */
+    switch (ab)
       {
-      *erroroffset = (int)(p - string) - 2;
-      return PCRE2_ERROR_UTF8_ERR7;
+      /* 2-byte character. No further bytes to check for 0x80. Check first byte
+      for for xx00 000x (overlong sequence). */
+
+      case 1: if ((c & 0x3e) == 0)
+        {
+        *erroroffset = (int)(p - string) - 1;
+        return PCRE2_ERROR_UTF8_ERR15;
+        }
+      break;
+
+      /* 3-byte character. Check third byte for 0x80. Then check first 2 bytes
+        for 1110 0000, xx0x xxxx (overlong sequence) or
+            1110 1101, 1010 xxxx (0xd800 - 0xdfff) */
+
+      case 2:
+      if ((*(++p) & 0xc0) != 0x80)     /* Third byte */
+        {
+        *erroroffset = (int)(p - string) - 2;
+        return PCRE2_ERROR_UTF8_ERR7;
+        }
+      if (c == 0xe0 && (d & 0x20) == 0)
+        {
+        *erroroffset = (int)(p - string) - 2;
+        return PCRE2_ERROR_UTF8_ERR16;
+        }
+      if (c == 0xed && d >= 0xa0)
+        {
+        *erroroffset = (int)(p - string) - 2;
+        return PCRE2_ERROR_UTF8_ERR14;
+        }
+      break;
+
+      /* 4-byte character. Check 3rd and 4th bytes for 0x80. Then check first
+         2 bytes for for 1111 0000, xx00 xxxx (overlong sequence), then check
+         for a character greater than 0x0010ffff (f4 8f bf bf) */
+
+      case 3:
+      if ((*(++p) & 0xc0) != 0x80)     /* Third byte */
+        {
+        *erroroffset = (int)(p - string) - 2;
+        return PCRE2_ERROR_UTF8_ERR7;
+        }
+      if ((*(++p) & 0xc0) != 0x80)     /* Fourth byte */
+        {
+        *erroroffset = (int)(p - string) - 3;
+        return PCRE2_ERROR_UTF8_ERR8;
+        }
+      if (c == 0xf0 && (d & 0x30) == 0)
+        {
+        *erroroffset = (int)(p - string) - 3;
+        return PCRE2_ERROR_UTF8_ERR17;
+        }
+      if (c > 0xf4 || (c == 0xf4 && d > 0x8f))
+        {
+        *erroroffset = (int)(p - string) - 3;
+        return PCRE2_ERROR_UTF8_ERR13;
+        }
+      break;
+
+      /* 5-byte and 6-byte characters are not allowed by RFC 3629, and will be
+      rejected by the length test below. However, we do the appropriate tests
+      here so that overlong sequences get diagnosed, and also in case there is
+      ever an option for handling these larger code points. */
+
+      /* 5-byte character. Check 3rd, 4th, and 5th bytes for 0x80. Then check
+      for 1111 1000, xx00 0xxx */
+
+      case 4:
+      if ((*(++p) & 0xc0) != 0x80)     /* Third byte */
+        {
+        *erroroffset = (int)(p - string) - 2;
+        return PCRE2_ERROR_UTF8_ERR7;
+        }
+      if ((*(++p) & 0xc0) != 0x80)     /* Fourth byte */
+        {
+        *erroroffset = (int)(p - string) - 3;
+        return PCRE2_ERROR_UTF8_ERR8;
+        }
+      if ((*(++p) & 0xc0) != 0x80)     /* Fifth byte */
+        {
+        *erroroffset = (int)(p - string) - 4;
+        return PCRE2_ERROR_UTF8_ERR9;
+        }
+      if (c == 0xf8 && (d & 0x38) == 0)
+        {
+        *erroroffset = (int)(p - string) - 4;
+        return PCRE2_ERROR_UTF8_ERR18;
+        }
+      break;
+
+      /* 6-byte character. Check 3rd-6th bytes for 0x80. Then check for
+      1111 1100, xx00 00xx. */
+
+      case 5:
+      if ((*(++p) & 0xc0) != 0x80)     /* Third byte */
+        {
+        *erroroffset = (int)(p - string) - 2;
+        return PCRE2_ERROR_UTF8_ERR7;
+        }
+      if ((*(++p) & 0xc0) != 0x80)     /* Fourth byte */
+        {
+        *erroroffset = (int)(p - string) - 3;
+        return PCRE2_ERROR_UTF8_ERR8;
+        }
+      if ((*(++p) & 0xc0) != 0x80)     /* Fifth byte */
+        {
+        *erroroffset = (int)(p - string) - 4;
+        return PCRE2_ERROR_UTF8_ERR9;
+        }
+      if ((*(++p) & 0xc0) != 0x80)     /* Sixth byte */
+        {
+        *erroroffset = (int)(p - string) - 5;
+        return PCRE2_ERROR_UTF8_ERR10;
+        }
+      if (c == 0xfc && (d & 0x3c) == 0)
+        {
+        *erroroffset = (int)(p - string) - 5;
+        return PCRE2_ERROR_UTF8_ERR19;
+        }
+      break;
       }
-    if ((*(++p) & 0xc0) != 0x80)     /* Fourth byte */
-      {
-      *erroroffset = (int)(p - string) - 3;
-      return PCRE2_ERROR_UTF8_ERR8;
-      }
-    if ((*(++p) & 0xc0) != 0x80)     /* Fifth byte */
-      {
-      *erroroffset = (int)(p - string) - 4;
-      return PCRE2_ERROR_UTF8_ERR9;
-      }
-    if (c == 0xf8 && (d & 0x38) == 0)
-      {
-      *erroroffset = (int)(p - string) - 4;
-      return PCRE2_ERROR_UTF8_ERR18;
-      }
-    break;
 
-    /* 6-byte character. Check 3rd-6th bytes for 0x80. Then check for
-    1111 1100, xx00 00xx. */
+    /* Character is valid under RFC 2279, but 4-byte and 5-byte characters are
+    excluded by RFC 3629. The pointer p is currently at the last byte of the
+    character. */
 
-    case 5:
-    if ((*(++p) & 0xc0) != 0x80)     /* Third byte */
-      {
-      *erroroffset = (int)(p - string) - 2;
-      return PCRE2_ERROR_UTF8_ERR7;
-      }
-    if ((*(++p) & 0xc0) != 0x80)     /* Fourth byte */
-      {
-      *erroroffset = (int)(p - string) - 3;
-      return PCRE2_ERROR_UTF8_ERR8;
-      }
-    if ((*(++p) & 0xc0) != 0x80)     /* Fifth byte */
-      {
-      *erroroffset = (int)(p - string) - 4;
-      return PCRE2_ERROR_UTF8_ERR9;
-      }
-    if ((*(++p) & 0xc0) != 0x80)     /* Sixth byte */
-      {
-      *erroroffset = (int)(p - string) - 5;
-      return PCRE2_ERROR_UTF8_ERR10;
-      }
-    if (c == 0xfc && (d & 0x3c) == 0)
+    if (ab > 3)
       {
-      *erroroffset = (int)(p - string) - 5;
-      return PCRE2_ERROR_UTF8_ERR19;
+      *erroroffset = (int)(p - string) - ab;
+      return (ab == 4)? PCRE2_ERROR_UTF8_ERR11 : PCRE2_ERROR_UTF8_ERR12;
       }
-    break;
-    }
-
-  /* Character is valid under RFC 2279, but 4-byte and 5-byte characters are
-  excluded by RFC 3629. The pointer p is currently at the last byte of the
-  character. */
-
-  if (ab > 3)
-    {
-    *erroroffset = (int)(p - string) - ab;
-    return (ab == 4)? PCRE2_ERROR_UTF8_ERR11 : PCRE2_ERROR_UTF8_ERR12;
     }
   }
 return 0;
@@ -326,36 +457,49 @@ PCRE2_ERROR_UTF16_ERR2  Invalid low surrogate
 PCRE2_ERROR_UTF16_ERR3  Isolated low surrogate
 */
 
-for (p = string; length > 0; p++)
+p = string;
+while (length > 0)
   {
-  c = *p;
-  length--;
+  PCRE2_SIZE stop = 0;
 
-  if ((c & 0xf800) != 0xd800)
-    {
-    /* Normal UTF-16 code point. Neither high nor low surrogate. */
-    }
-  else if ((c & 0x0400) == 0)
+#ifdef STEP_UNITS
+  PCRE2_SIZE n = simple_units(p, length);
+  p += n;
+  length -= n;
+  if (length > BLOCK_UNITS) stop = length - BLOCK_UNITS;
+#endif
+
+  for (; length > stop; p++)
     {
-    /* High surrogate. Must be a followed by a low surrogate. */
-    if (length == 0)
+    c = *p;
+    length--;
+
+    if ((c & 0xf800) != 0xd800)
       {
-      *erroroffset = p - string;
-      return PCRE2_ERROR_UTF16_ERR1;
+      /* Normal UTF-16 code point. Neither high nor low surrogate. */
       }
-    p++;
-    length--;
-    if ((*p & 0xfc00) != 0xdc00)
+    else if ((c & 0x0400) == 0)
       {
-      *erroroffset = p - string - 1;
-      return PCRE2_ERROR_UTF16_ERR2;
+      /* High surrogate. Must be a followed by a low surrogate. */
+      if (length == 0)
+        {
+        *erroroffset = p - string;
+        return PCRE2_ERROR_UTF16_ERR1;
+        }
+      p++;
+      length--;
+      if ((*p & 0xfc00) != 0xdc00)
+        {
+        *erroroffset = p - string - 1;
+        return PCRE2_ERROR_UTF16_ERR2;
+        }
+      }
+    else
+      {
+      /* Isolated low surrogate. Always an error. */
+      *erroroffset = p - string;
+      return PCRE2_ERROR_UTF16_ERR3;
       }
-    }
-  else
-    {
-    /* Isolated low surrogate. Always an error. */
-    *erroroffset = p - string;
-    return PCRE2_ERROR_UTF16_ERR3;
     }
   }
 return 0;
@@ -371,26 +515,15 @@ PCRE2_ERROR_UTF32_ERR1  Surrogate character
 PCRE2_ERROR_UTF32_ERR2  Character > 0x10ffff
 */
 
-for (p = string; length > 0; length--, p++)
-  {
-  c = *p;
-  if ((c & 0xfffff800u) != 0xd800u)
-    {
-    /* Normal UTF-32 code point. Neither high nor low surrogate. */
-    if (c > 0x10ffffu)
-      {
-      *erroroffset = p - string;
-      return PCRE2_ERROR_UTF32_ERR2;
-      }
-    }
-  else
-    {
-    /* A surrogate */
-    *erroroffset = p - string;
-    return PCRE2_ERROR_UTF32_ERR1;
-    }
-  }
-return 0;
+/* Every code unit that is neither a surrogate nor too large is a character on
+its own, so the first one that is not simple is the error. */
+
+p = string + simple_units(string, length);
+if (p >= string + length) return 0;
+c = *p;
+*erroroffset = p - string;
+return ((c & 0xfffff800u) == 0xd800u)?
+  PCRE2_ERROR_UTF32_ERR1 : PCRE2_ERROR_UTF32_ERR2;
 #endif  /* CODE_UNIT_WIDTH */
 }
 #endif  /* SUPPORT_UNICODE */
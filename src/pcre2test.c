@@ -213,6 +213,7 @@ claim to be C99 don't support it (hence DISABLE_PERCENT_ZT). */
 #define MALLOCLISTSIZE 20         /* For remembering mallocs */
 #define PARENS_NEST_DEFAULT 220   /* Default parentheses nest limit */
 #define PATSTACKSIZE 20           /* Pattern stack for save/restore testing */
+#define PATTERN_SET_IDS 20        /* Ids shown for a pattern set match */
 #define REPLACE_MODSIZE 100       /* Field for reading 8-bit replacement */
 #define VERSION_SIZE 64           /* Size of buffer for the version strings */
 
@@ -519,6 +520,12 @@ so many of them that they are split into two fields. */
 #define CTL2_ALLVECTOR                   0x00000800u
 #define CTL2_NULL_SUBJECT                0x00001000u
 #define CTL2_NULL_REPLACEMENT            0x00002000u
+#define CTL2_HEAPFRAMES_SIZE             0x00004000u
+#define CTL2_PATTERN_SET                 0x00008000u
+#define CTL2_MATCH_COUNT                 0x00010000u
+#define CTL2_STATISTICS                  0x00020000u
+#define CTL2_PROFILE                     0x00040000u
+#define CTL2_JIT_PERF_MAP                0x00080000u
 
 #define CTL2_NL_SET                      0x40000000u  /* Informational */
 #define CTL2_BSR_SET                     0x80000000u  /* Informational */
@@ -589,12 +596,23 @@ typedef struct datctl {       /* Structure for data line modifiers. */
    int32_t  callout_data;
    int32_t  copy_numbers[MAXCPYGET];
    int32_t  get_numbers[MAXCPYGET];
+  uint32_t  batch;
+  uint32_t  match_all;
   uint32_t  oveccount;
+  uint32_t  parallel[2];
+  uint32_t  pool[2];
   uint32_t  offset;
+  uint32_t  segments;
+  uint32_t  stream;
   uint8_t   copy_names[LENCPYGET];
   uint8_t   get_names[LENCPYGET];
 } datctl;
 
+/* The match statistics block contains no code unit dependent fields, so the
+blocks of all three libraries are accessed as the 8-bit one. */
+
+typedef pcre2_match_statistics_8 statistics_block;
+
 /* Ids for which context to modify. */
 
 enum { CTX_PAT,            /* Active pattern context */
@@ -637,7 +655,9 @@ static modstruct modlist[] = {
   { "altglobal",                   MOD_PND,  MOD_CTL, CTL_ALTGLOBAL,              PO(control) },
   { "anchored",                    MOD_PD,   MOD_OPT, PCRE2_ANCHORED,             PD(options) },
   { "auto_callout",                MOD_PAT,  MOD_OPT, PCRE2_AUTO_CALLOUT,         PO(options) },
+  { "auto_engine",                 MOD_CTC,  MOD_OPT, PCRE2_EXTRA_AUTO_ENGINE,    CO(extra_options) },
   { "bad_escape_is_literal",       MOD_CTC,  MOD_OPT, PCRE2_EXTRA_BAD_ESCAPE_IS_LITERAL, CO(extra_options) },
+  { "batch",                       MOD_DAT,  MOD_INT, 0,                          DO(batch) },
   { "bincode",                     MOD_PAT,  MOD_CTL, CTL_BINCODE,                PO(control) },
   { "bsr",                         MOD_CTC,  MOD_BSR, 0,                          CO(bsr_convention) },
   { "callout_capture",             MOD_DAT,  MOD_CTL, CTL_CALLOUT_CAPTURE,        DO(control) },
@@ -655,6 +675,7 @@ static modstruct modlist[] = {
   { "convert_length",              MOD_PAT,  MOD_INT, 0,                          PO(convert_length) },
   { "copy",                        MOD_DAT,  MOD_NN,  DO(copy_numbers),           DO(copy_names) },
   { "copy_matched_subject",        MOD_DAT,  MOD_OPT, PCRE2_COPY_MATCHED_SUBJECT, DO(options) },
+  { "deadline",                    MOD_CTM,  MOD_INT, 0,                          MO(deadline) },
   { "debug",                       MOD_PAT,  MOD_CTL, CTL_DEBUG,                  PO(control) },
   { "depth_limit",                 MOD_CTM,  MOD_INT, 0,                          MO(depth_limit) },
   { "dfa",                         MOD_DAT,  MOD_CTL, CTL_DFA,                    DO(control) },
@@ -677,21 +698,27 @@ static modstruct modlist[] = {
   { "getall",                      MOD_DAT,  MOD_CTL, CTL_GETALL,                 DO(control) },
   { "global",                      MOD_PNDP, MOD_CTL, CTL_GLOBAL,                 PO(control) },
   { "heap_limit",                  MOD_CTM,  MOD_INT, 0,                          MO(heap_limit) },
+  { "heapframes_size",             MOD_DAT,  MOD_CTL, CTL2_HEAPFRAMES_SIZE,       DO(control2) },
   { "hex",                         MOD_PAT,  MOD_CTL, CTL_HEXPAT,                 PO(control) },
   { "info",                        MOD_PAT,  MOD_CTL, CTL_INFO,                   PO(control) },
   { "jit",                         MOD_PAT,  MOD_IND, 7,                          PO(jit) },
+  { "jit_perf_map",                MOD_PAT,  MOD_CTL, CTL2_JIT_PERF_MAP,          PO(control2) },
   { "jitfast",                     MOD_PAT,  MOD_CTL, CTL_JITFAST,                PO(control) },
   { "jitstack",                    MOD_PNDP, MOD_INT, 0,                          PO(jitstack) },
   { "jitverify",                   MOD_PAT,  MOD_CTL, CTL_JITVERIFY,              PO(control) },
   { "literal",                     MOD_PAT,  MOD_OPT, PCRE2_LITERAL,              PO(options) },
   { "locale",                      MOD_PAT,  MOD_STR, LOCALESIZE,                 PO(locale) },
   { "mark",                        MOD_PNDP, MOD_CTL, CTL_MARK,                   PO(control) },
+  { "match_all",                   MOD_DAT,  MOD_INT, 0,                          DO(match_all) },
+  { "match_count",                 MOD_DAT,  MOD_CTL, CTL2_MATCH_COUNT,           DO(control2) },
   { "match_invalid_utf",           MOD_PAT,  MOD_OPT, PCRE2_MATCH_INVALID_UTF,    PO(options) },
   { "match_limit",                 MOD_CTM,  MOD_INT, 0,                          MO(match_limit) },
   { "match_line",                  MOD_CTC,  MOD_OPT, PCRE2_EXTRA_MATCH_LINE,     CO(extra_options) },
   { "match_unset_backref",         MOD_PAT,  MOD_OPT, PCRE2_MATCH_UNSET_BACKREF,  PO(options) },
   { "match_word",                  MOD_CTC,  MOD_OPT, PCRE2_EXTRA_MATCH_WORD,     CO(extra_options) },
   { "max_pattern_length",          MOD_CTC,  MOD_SIZ, 0,                          CO(max_pattern_length) },
+  { "memo_limit",                  MOD_CTM,  MOD_INT, 0,                          MO(memo_limit) },
+  { "memoize",                     MOD_DATP, MOD_OPT, PCRE2_MEMOIZE,              DO(options) },
   { "memory",                      MOD_PD,   MOD_CTL, CTL_MEMORY,                 PD(control) },
   { "multiline",                   MOD_PATP, MOD_OPT, PCRE2_MULTILINE,            PO(options) },
   { "never_backslash_c",           MOD_PAT,  MOD_OPT, PCRE2_NEVER_BACKSLASH_C,    PO(options) },
@@ -702,6 +729,7 @@ static modstruct modlist[] = {
   { "no_auto_possess",             MOD_PATP, MOD_OPT, PCRE2_NO_AUTO_POSSESS,      PO(options) },
   { "no_dotstar_anchor",           MOD_PAT,  MOD_OPT, PCRE2_NO_DOTSTAR_ANCHOR,    PO(options) },
   { "no_jit",                      MOD_DATP, MOD_OPT, PCRE2_NO_JIT,               DO(options) },
+  { "no_ovector",                  MOD_DAT,  MOD_OPT, PCRE2_NO_OVECTOR,           DO(options) },
   { "no_start_optimize",           MOD_PATP, MOD_OPT, PCRE2_NO_START_OPTIMIZE,    PO(options) },
   { "no_utf_check",                MOD_PD,   MOD_OPT, PCRE2_NO_UTF_CHECK,         PD(options) },
   { "notbol",                      MOD_DAT,  MOD_OPT, PCRE2_NOTBOL,               DO(options) },
@@ -714,13 +742,17 @@ static modstruct modlist[] = {
   { "offset",                      MOD_DAT,  MOD_INT, 0,                          DO(offset) },
   { "offset_limit",                MOD_CTM,  MOD_SIZ, 0,                          MO(offset_limit)},
   { "ovector",                     MOD_DAT,  MOD_INT, 0,                          DO(oveccount) },
+  { "parallel",                    MOD_DAT,  MOD_IN2, 0,                          DO(parallel) },
   { "parens_nest_limit",           MOD_CTC,  MOD_INT, 0,                          CO(parens_nest_limit) },
   { "partial_hard",                MOD_DAT,  MOD_OPT, PCRE2_PARTIAL_HARD,         DO(options) },
   { "partial_soft",                MOD_DAT,  MOD_OPT, PCRE2_PARTIAL_SOFT,         DO(options) },
+  { "pattern_set",                 MOD_PAT,  MOD_CTL, CTL2_PATTERN_SET,           PO(control2) },
   { "ph",                          MOD_DAT,  MOD_OPT, PCRE2_PARTIAL_HARD,         DO(options) },
+  { "pool",                        MOD_DAT,  MOD_IN2, 0,                          DO(pool) },
   { "posix",                       MOD_PAT,  MOD_CTL, CTL_POSIX,                  PO(control) },
   { "posix_nosub",                 MOD_PAT,  MOD_CTL, CTL_POSIX|CTL_POSIX_NOSUB,  PO(control) },
   { "posix_startend",              MOD_DAT,  MOD_IN2, 0,                          DO(startend) },
+  { "profile",                     MOD_DAT,  MOD_CTL, CTL2_PROFILE,               DO(control2) },
   { "ps",                          MOD_DAT,  MOD_OPT, PCRE2_PARTIAL_SOFT,         DO(options) },
   { "push",                        MOD_PAT,  MOD_CTL, CTL_PUSH,                   PO(control) },
   { "pushcopy",                    MOD_PAT,  MOD_CTL, CTL_PUSHCOPY,               PO(control) },
@@ -728,9 +760,13 @@ static modstruct modlist[] = {
   { "recursion_limit",             MOD_CTM,  MOD_INT, 0,                          MO(depth_limit) },  /* Obsolete synonym */
   { "regerror_buffsize",           MOD_PAT,  MOD_INT, 0,                          PO(regerror_buffsize) },
   { "replace",                     MOD_PND,  MOD_STR, REPLACE_MODSIZE,            PO(replacement) },
+  { "segments",                    MOD_DAT,  MOD_INT, 0,                          DO(segments) },
   { "stackguard",                  MOD_PAT,  MOD_INT, 0,                          PO(stackguard_test) },
   { "startchar",                   MOD_PND,  MOD_CTL, CTL_STARTCHAR,              PO(control) },
   { "startoffset",                 MOD_DAT,  MOD_INT, 0,                          DO(offset) },
+  { "statistics",                  MOD_DAT,  MOD_CTL, CTL2_STATISTICS,            DO(control2) },
+  { "step_limit",                  MOD_CTM,  MOD_INT, 0,                          MO(step_limit) },
+  { "stream",                      MOD_DAT,  MOD_INT, 0,                          DO(stream) },
   { "subject_literal",             MOD_PATP, MOD_CTL, CTL2_SUBJECT_LITERAL,       PO(control2) },
   { "substitute_callout",          MOD_PND,  MOD_CTL, CTL2_SUBSTITUTE_CALLOUT,    PO(control2) },
   { "substitute_extended",         MOD_PND,  MOD_CTL, CTL2_SUBSTITUTE_EXTENDED,   PO(control2) },
@@ -875,6 +911,12 @@ table itself easier to read. */
 #define BACKSLASH_C 1
 #endif
 
+#ifdef SUPPORT_THREADS
+#define SUPPORT_THREADS_VALUE 1
+#else
+#define SUPPORT_THREADS_VALUE 0
+#endif
+
 typedef struct coptstruct {
   const char *name;
   uint32_t    type;
@@ -899,6 +941,7 @@ static coptstruct coptlist[] = {
   { "pcre2-16",    CONF_FIX, SUPPORT_16 },
   { "pcre2-32",    CONF_FIX, SUPPORT_32 },
   { "pcre2-8",     CONF_FIX, SUPPORT_8 },
+  { "threads",     CONF_FIX, SUPPORT_THREADS_VALUE },
   { "unicode",     CONF_INT, PCRE2_CONFIG_UNICODE }
 };
 
@@ -918,6 +961,7 @@ static FILE *outfile;
 static const void *last_callout_mark;
 static PCRE2_JIT_STACK *jit_stack = NULL;
 static size_t jit_stack_size = 0;
+static void *pattern_set = NULL;
 
 static BOOL first_callout;
 static BOOL jit_was_used;
@@ -964,6 +1008,8 @@ static regex_t preg = { NULL, NULL, 0, 0, 0, 0 };
 #endif
 
 static int *dfa_workspace = NULL;
+static void *segment_list = NULL;
+static uint32_t segment_list_size = 0;
 static const uint8_t *locale_tables = NULL;
 static const uint8_t *use_tables = NULL;
 static uint8_t locale_name[32];
@@ -1158,6 +1204,17 @@ are supported. */
   else \
     a = pcre2_dfa_match_32(G(b,32),(PCRE2_SPTR32)c,d,e,f,G(g,32),h,i,j)
 
+#define PCRE2_DFA_MATCH_SEGMENTS(a,b,c,d,e,f,g,h,i,j) \
+  if (test_mode == PCRE8_MODE) \
+    a = pcre2_dfa_match_segments_8(G(b,8),(pcre2_segment_8 *)c,d,e,f, \
+      G(g,8),h,i,j); \
+  else if (test_mode == PCRE16_MODE) \
+    a = pcre2_dfa_match_segments_16(G(b,16),(pcre2_segment_16 *)c,d,e,f, \
+      G(g,16),h,i,j); \
+  else \
+    a = pcre2_dfa_match_segments_32(G(b,32),(pcre2_segment_32 *)c,d,e,f, \
+      G(g,32),h,i,j)
+
 #define PCRE2_GET_ERROR_MESSAGE(r,a,b) \
   if (test_mode == PCRE8_MODE) \
     r = pcre2_get_error_message_8(a,G(b,8),G(G(b,8),_size)); \
@@ -1182,6 +1239,30 @@ are supported. */
   else \
     a = pcre2_get_startchar_32(G(b,32))
 
+#define PCRE2_GET_MATCH_DATA_HEAPFRAMES_SIZE(a,b) \
+  if (test_mode == PCRE8_MODE) \
+    a = pcre2_get_match_data_heapframes_size_8(G(b,8)); \
+  else if (test_mode == PCRE16_MODE) \
+    a = pcre2_get_match_data_heapframes_size_16(G(b,16)); \
+  else \
+    a = pcre2_get_match_data_heapframes_size_32(G(b,32))
+
+#define PCRE2_GET_MATCH_PROFILE(a,b,c) \
+  if (test_mode == PCRE8_MODE) \
+    a = pcre2_get_match_profile_8(G(b,8),c); \
+  else if (test_mode == PCRE16_MODE) \
+    a = pcre2_get_match_profile_16(G(b,16),c); \
+  else \
+    a = pcre2_get_match_profile_32(G(b,32),c)
+
+#define PCRE2_GET_MATCH_STATISTICS(a,b) \
+  if (test_mode == PCRE8_MODE) \
+    a = (const statistics_block *)pcre2_get_match_statistics_8(G(b,8)); \
+  else if (test_mode == PCRE16_MODE) \
+    a = (const statistics_block *)pcre2_get_match_statistics_16(G(b,16)); \
+  else \
+    a = (const statistics_block *)pcre2_get_match_statistics_32(G(b,32))
+
 #define PCRE2_JIT_COMPILE(r,a,b) \
   if (test_mode == PCRE8_MODE) r = pcre2_jit_compile_8(G(a,8),b); \
   else if (test_mode == PCRE16_MODE) r = pcre2_jit_compile_16(G(a,16),b); \
@@ -1237,6 +1318,30 @@ are supported. */
   else \
     a = pcre2_match_32(G(b,32),(PCRE2_SPTR32)c,d,e,f,G(g,32),h)
 
+#define PCRE2_MATCH_ALL(r,a,b,c,d,e) \
+  if (test_mode == PCRE8_MODE) \
+    r = pcre2_match_all_8((pcre2_match_iterator_8 *)a,b,c,G(d,8),e); \
+  else if (test_mode == PCRE16_MODE) \
+    r = pcre2_match_all_16((pcre2_match_iterator_16 *)a,b,c,G(d,16),e); \
+  else \
+    r = pcre2_match_all_32((pcre2_match_iterator_32 *)a,b,c,G(d,32),e)
+
+#define PCRE2_MATCH_BATCH(r,a,b,c,d,e,f,g,h,i) \
+  if (test_mode == PCRE8_MODE) \
+    r = pcre2_match_batch_8(G(a,8),(PCRE2_SPTR8)(b),c,d,e,f,g,G(h,8),i); \
+  else if (test_mode == PCRE16_MODE) \
+    r = pcre2_match_batch_16(G(a,16),(PCRE2_SPTR16)(b),c,d,e,f,g,G(h,16),i); \
+  else \
+    r = pcre2_match_batch_32(G(a,32),(PCRE2_SPTR32)(b),c,d,e,f,g,G(h,32),i)
+
+#define PCRE2_MATCH_COUNT(r,a,b,c,d,e,f,g) \
+  if (test_mode == PCRE8_MODE) \
+    r = pcre2_match_count_8(G(a,8),(PCRE2_SPTR8)(b),c,d,e,G(f,8),g); \
+  else if (test_mode == PCRE16_MODE) \
+    r = pcre2_match_count_16(G(a,16),(PCRE2_SPTR16)(b),c,d,e,G(f,16),g); \
+  else \
+    r = pcre2_match_count_32(G(a,32),(PCRE2_SPTR32)(b),c,d,e,G(f,32),g)
+
 #define PCRE2_MATCH_DATA_CREATE(a,b,c) \
   if (test_mode == PCRE8_MODE) \
     G(a,8) = pcre2_match_data_create_8(b,c); \
@@ -1261,6 +1366,71 @@ are supported. */
   else \
     pcre2_match_data_free_32(G(a,32))
 
+#define PCRE2_MATCH_ITERATOR_CREATE(a,b,c,d,e,f,g) \
+  if (test_mode == PCRE8_MODE) \
+    a = (void *)pcre2_match_iterator_create_8(G(b,8),(PCRE2_SPTR8)(c),d,e, \
+      f,g); \
+  else if (test_mode == PCRE16_MODE) \
+    a = (void *)pcre2_match_iterator_create_16(G(b,16),(PCRE2_SPTR16)(c),d,e, \
+      f,g); \
+  else \
+    a = (void *)pcre2_match_iterator_create_32(G(b,32),(PCRE2_SPTR32)(c),d,e, \
+      f,g)
+
+#define PCRE2_MATCH_ITERATOR_FREE(a) \
+  if (test_mode == PCRE8_MODE) \
+    pcre2_match_iterator_free_8((pcre2_match_iterator_8 *)a); \
+  else if (test_mode == PCRE16_MODE) \
+    pcre2_match_iterator_free_16((pcre2_match_iterator_16 *)a); \
+  else \
+    pcre2_match_iterator_free_32((pcre2_match_iterator_32 *)a)
+
+#define PCRE2_MATCH_PARALLEL(r,a,b,c,d,e,f,g,h,i,j) \
+  if (test_mode == PCRE8_MODE) \
+    r = pcre2_match_parallel_8(G(a,8),(PCRE2_SPTR8)(b),c,d,e,f,g,h,i,j); \
+  else if (test_mode == PCRE16_MODE) \
+    r = pcre2_match_parallel_16(G(a,16),(PCRE2_SPTR16)(b),c,d,e,f,g,h,i,j); \
+  else \
+    r = pcre2_match_parallel_32(G(a,32),(PCRE2_SPTR32)(b),c,d,e,f,g,h,i,j)
+
+#define PCRE2_MATCH_POOL_CREATE(a,b,c,d,e) \
+  if (test_mode == PCRE8_MODE) \
+    a = (void *)pcre2_match_pool_create_8(G(b,8),c,d,e); \
+  else if (test_mode == PCRE16_MODE) \
+    a = (void *)pcre2_match_pool_create_16(G(b,16),c,d,e); \
+  else \
+    a = (void *)pcre2_match_pool_create_32(G(b,32),c,d,e)
+
+#define PCRE2_MATCH_POOL_FREE(a) \
+  if (test_mode == PCRE8_MODE) \
+    pcre2_match_pool_free_8((pcre2_match_pool_8 *)a); \
+  else if (test_mode == PCRE16_MODE) \
+    pcre2_match_pool_free_16((pcre2_match_pool_16 *)a); \
+  else \
+    pcre2_match_pool_free_32((pcre2_match_pool_32 *)a)
+
+#define PCRE2_MATCH_POOL_RUN(r,a,b,c,d,e,f,g,h,i) \
+  if (test_mode == PCRE8_MODE) \
+    r = pcre2_match_pool_run_8((pcre2_match_pool_8 *)a, \
+      (const PCRE2_SPTR8 *)b,c,d,e,f, \
+      (int (*)(uint32_t, int, pcre2_match_data_8 *, void *))(g),h,i); \
+  else if (test_mode == PCRE16_MODE) \
+    r = pcre2_match_pool_run_16((pcre2_match_pool_16 *)a, \
+      (const PCRE2_SPTR16 *)b,c,d,e,f, \
+      (int (*)(uint32_t, int, pcre2_match_data_16 *, void *))(g),h,i); \
+  else \
+    r = pcre2_match_pool_run_32((pcre2_match_pool_32 *)a, \
+      (const PCRE2_SPTR32 *)b,c,d,e,f, \
+      (int (*)(uint32_t, int, pcre2_match_data_32 *, void *))(g),h,i)
+
+#define PCRE2_MATCH_SEGMENTS(a,b,c,d,e,f,g,h) \
+  if (test_mode == PCRE8_MODE) \
+    a = pcre2_match_segments_8(G(b,8),(pcre2_segment_8 *)c,d,e,f,G(g,8),h); \
+  else if (test_mode == PCRE16_MODE) \
+    a = pcre2_match_segments_16(G(b,16),(pcre2_segment_16 *)c,d,e,f,G(g,16),h); \
+  else \
+    a = pcre2_match_segments_32(G(b,32),(pcre2_segment_32 *)c,d,e,f,G(g,32),h)
+
 #define PCRE2_PATTERN_CONVERT(a,b,c,d,e,f,g) \
   if (test_mode == PCRE8_MODE) \
     a = pcre2_pattern_convert_8(G(b,8),c,d,(PCRE2_UCHAR8 **)e,f,G(g,8)); \
@@ -1277,13 +1447,78 @@ are supported. */
   else \
     a = pcre2_pattern_info_32(G(b,32),c,d)
 
-#define PCRE2_PRINTINT(a) \
+#define PCRE2_PATTERN_SET_ADD(r,a,b,c,d,e) \
   if (test_mode == PCRE8_MODE) \
-    pcre2_printint_8(compiled_code8,outfile,a); \
+    r = pcre2_pattern_set_add_8((pcre2_pattern_set_8 *)a,(PCRE2_SPTR8)b, \
+      c,d,e); \
   else if (test_mode == PCRE16_MODE) \
-    pcre2_printint_16(compiled_code16,outfile,a); \
+    r = pcre2_pattern_set_add_16((pcre2_pattern_set_16 *)a, \
+      (PCRE2_SPTR16)b,c,d,e); \
   else \
-    pcre2_printint_32(compiled_code32,outfile,a)
+    r = pcre2_pattern_set_add_32((pcre2_pattern_set_32 *)a, \
+      (PCRE2_SPTR32)b,c,d,e)
+
+#define PCRE2_PATTERN_SET_COMPILE(r,a) \
+  if (test_mode == PCRE8_MODE) \
+    r = pcre2_pattern_set_compile_8((pcre2_pattern_set_8 *)a); \
+  else if (test_mode == PCRE16_MODE) \
+    r = pcre2_pattern_set_compile_16((pcre2_pattern_set_16 *)a); \
+  else \
+    r = pcre2_pattern_set_compile_32((pcre2_pattern_set_32 *)a)
+
+#define PCRE2_PATTERN_SET_CREATE(a,b,c) \
+  if (test_mode == PCRE8_MODE) \
+    a = (void *)pcre2_pattern_set_create_8(b,c); \
+  else if (test_mode == PCRE16_MODE) \
+    a = (void *)pcre2_pattern_set_create_16(b,c); \
+  else \
+    a = (void *)pcre2_pattern_set_create_32(b,c)
+
+#define PCRE2_PATTERN_SET_DFA_MATCH(r,a,b,c,d,e,f,g,h,i) \
+  if (test_mode == PCRE8_MODE) \
+    r = pcre2_pattern_set_dfa_match_8((pcre2_pattern_set_8 *)a, \
+      (PCRE2_SPTR8)b,c,d,e,G(f,8),g,h,i); \
+  else if (test_mode == PCRE16_MODE) \
+    r = pcre2_pattern_set_dfa_match_16((pcre2_pattern_set_16 *)a, \
+      (PCRE2_SPTR16)b,c,d,e,G(f,16),g,h,i); \
+  else \
+    r = pcre2_pattern_set_dfa_match_32((pcre2_pattern_set_32 *)a, \
+      (PCRE2_SPTR32)b,c,d,e,G(f,32),g,h,i)
+
+#define PCRE2_PATTERN_SET_FREE(a) \
+  if (test_mode == PCRE8_MODE) \
+    pcre2_pattern_set_free_8((pcre2_pattern_set_8 *)a); \
+  else if (test_mode == PCRE16_MODE) \
+    pcre2_pattern_set_free_16((pcre2_pattern_set_16 *)a); \
+  else \
+    pcre2_pattern_set_free_32((pcre2_pattern_set_32 *)a)
+
+#define PCRE2_PATTERN_SET_JIT_COMPILE(r,a,b) \
+  if (test_mode == PCRE8_MODE) \
+    r = pcre2_pattern_set_jit_compile_8((pcre2_pattern_set_8 *)a,b); \
+  else if (test_mode == PCRE16_MODE) \
+    r = pcre2_pattern_set_jit_compile_16((pcre2_pattern_set_16 *)a,b); \
+  else \
+    r = pcre2_pattern_set_jit_compile_32((pcre2_pattern_set_32 *)a,b)
+
+#define PCRE2_PATTERN_SET_MATCH(r,a,b,c,d,e,f,g,h,i) \
+  if (test_mode == PCRE8_MODE) \
+    r = pcre2_pattern_set_match_8((pcre2_pattern_set_8 *)a, \
+      (PCRE2_SPTR8)b,c,d,e,G(f,8),g,h,i); \
+  else if (test_mode == PCRE16_MODE) \
+    r = pcre2_pattern_set_match_16((pcre2_pattern_set_16 *)a, \
+      (PCRE2_SPTR16)b,c,d,e,G(f,16),g,h,i); \
+  else \
+    r = pcre2_pattern_set_match_32((pcre2_pattern_set_32 *)a, \
+      (PCRE2_SPTR32)b,c,d,e,G(f,32),g,h,i)
+
+#define PCRE2_PRINTINT(a,b) \
+  if (test_mode == PCRE8_MODE) \
+    pcre2_printint_8(compiled_code8,outfile,a,b); \
+  else if (test_mode == PCRE16_MODE) \
+    pcre2_printint_16(compiled_code16,outfile,a,b); \
+  else \
+    pcre2_printint_32(compiled_code32,outfile,a,b)
 
 #define PCRE2_SERIALIZE_DECODE(r,a,b,c,d) \
   if (test_mode == PCRE8_MODE) \
@@ -1373,6 +1608,22 @@ are supported. */
   else \
     pcre2_set_heap_limit_32(G(a,32),b)
 
+#define PCRE2_SET_MATCH_DATA_PROFILE(a,b) \
+  if (test_mode == PCRE8_MODE) \
+    pcre2_set_match_data_profile_8(G(a,8),b); \
+  else if (test_mode == PCRE16_MODE) \
+    pcre2_set_match_data_profile_16(G(a,16),b); \
+  else \
+    pcre2_set_match_data_profile_32(G(a,32),b)
+
+#define PCRE2_SET_MATCH_DATA_STATISTICS(a,b) \
+  if (test_mode == PCRE8_MODE) \
+    pcre2_set_match_data_statistics_8(G(a,8),b); \
+  else if (test_mode == PCRE16_MODE) \
+    pcre2_set_match_data_statistics_16(G(a,16),b); \
+  else \
+    pcre2_set_match_data_statistics_32(G(a,32),b)
+
 #define PCRE2_SET_MATCH_LIMIT(a,b) \
   if (test_mode == PCRE8_MODE) \
     pcre2_set_match_limit_8(G(a,8),b); \
@@ -1405,6 +1656,17 @@ are supported. */
   else \
     pcre2_set_parens_nest_limit_32(G(a,32),b)
 
+#define PCRE2_SET_SEGMENT(a,b,c,d) \
+  if (test_mode == PCRE8_MODE) \
+    ((pcre2_segment_8 *)a)[b].data = (PCRE2_SPTR8)(c), \
+    ((pcre2_segment_8 *)a)[b].length = d; \
+  else if (test_mode == PCRE16_MODE) \
+    ((pcre2_segment_16 *)a)[b].data = (PCRE2_SPTR16)(c), \
+    ((pcre2_segment_16 *)a)[b].length = d; \
+  else \
+    ((pcre2_segment_32 *)a)[b].data = (PCRE2_SPTR32)(c), \
+    ((pcre2_segment_32 *)a)[b].length = d
+
 #define PCRE2_SET_SUBSTITUTE_CALLOUT(a,b,c) \
   if (test_mode == PCRE8_MODE) \
     pcre2_set_substitute_callout_8(G(a,8), \
@@ -1416,6 +1678,33 @@ are supported. */
     pcre2_set_substitute_callout_32(G(a,32), \
       (int (*)(pcre2_substitute_callout_block_32 *, void *))b,c)
 
+#define PCRE2_STREAM_CREATE(a,b,c,d) \
+  if (test_mode == PCRE8_MODE) \
+    a = (void *)pcre2_stream_create_8(G(b,8),c,d); \
+  else if (test_mode == PCRE16_MODE) \
+    a = (void *)pcre2_stream_create_16(G(b,16),c,d); \
+  else \
+    a = (void *)pcre2_stream_create_32(G(b,32),c,d)
+
+#define PCRE2_STREAM_FEED(r,a,b,c,d,e,f) \
+  if (test_mode == PCRE8_MODE) \
+    r = pcre2_stream_feed_8((pcre2_stream_8 *)a,(PCRE2_SPTR8)(b),c,d, \
+      G(e,8),f); \
+  else if (test_mode == PCRE16_MODE) \
+    r = pcre2_stream_feed_16((pcre2_stream_16 *)a,(PCRE2_SPTR16)(b),c,d, \
+      G(e,16),f); \
+  else \
+    r = pcre2_stream_feed_32((pcre2_stream_32 *)a,(PCRE2_SPTR32)(b),c,d, \
+      G(e,32),f)
+
+#define PCRE2_STREAM_FREE(a) \
+  if (test_mode == PCRE8_MODE) \
+    pcre2_stream_free_8((pcre2_stream_8 *)a); \
+  else if (test_mode == PCRE16_MODE) \
+    pcre2_stream_free_16((pcre2_stream_16 *)a); \
+  else \
+    pcre2_stream_free_32((pcre2_stream_32 *)a)
+
 #define PCRE2_SUBSTITUTE(a,b,c,d,e,f,g,h,i,j,k,l) \
   if (test_mode == PCRE8_MODE) \
     a = pcre2_substitute_8(G(b,8),(PCRE2_SPTR8)c,d,e,f,G(g,8),h, \
@@ -1687,6 +1976,14 @@ the three different cases. */
     a = G(pcre2_dfa_match_,BITTWO)(G(b,BITTWO),(G(PCRE2_SPTR,BITTWO))c,d,e,f, \
       G(g,BITTWO),h,i,j)
 
+#define PCRE2_DFA_MATCH_SEGMENTS(a,b,c,d,e,f,g,h,i,j) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    a = G(pcre2_dfa_match_segments_,BITONE)(G(b,BITONE), \
+      (G(pcre2_segment_,BITONE) *)c,d,e,f,G(g,BITONE),h,i,j); \
+  else \
+    a = G(pcre2_dfa_match_segments_,BITTWO)(G(b,BITTWO), \
+      (G(pcre2_segment_,BITTWO) *)c,d,e,f,G(g,BITTWO),h,i,j)
+
 #define PCRE2_GET_ERROR_MESSAGE(r,a,b) \
   if (test_mode == G(G(PCRE,BITONE),_MODE)) \
     r = G(pcre2_get_error_message_,BITONE)(a,G(b,BITONE),G(G(b,BITONE),_size/BYTEONE)); \
@@ -1705,6 +2002,26 @@ the three different cases. */
   else \
     a = G(pcre2_get_startchar_,BITTWO)(G(b,BITTWO))
 
+#define PCRE2_GET_MATCH_DATA_HEAPFRAMES_SIZE(a,b) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    a = G(pcre2_get_match_data_heapframes_size_,BITONE)(G(b,BITONE)); \
+  else \
+    a = G(pcre2_get_match_data_heapframes_size_,BITTWO)(G(b,BITTWO))
+
+#define PCRE2_GET_MATCH_PROFILE(a,b,c) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    a = G(pcre2_get_match_profile_,BITONE)(G(b,BITONE),c); \
+  else \
+    a = G(pcre2_get_match_profile_,BITTWO)(G(b,BITTWO),c)
+
+#define PCRE2_GET_MATCH_STATISTICS(a,b) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    a = (const statistics_block *) \
+      G(pcre2_get_match_statistics_,BITONE)(G(b,BITONE)); \
+  else \
+    a = (const statistics_block *) \
+      G(pcre2_get_match_statistics_,BITTWO)(G(b,BITTWO))
+
 #define PCRE2_JIT_COMPILE(r,a,b) \
   if (test_mode == G(G(PCRE,BITONE),_MODE)) \
     r = G(pcre2_jit_compile_,BITONE)(G(a,BITONE),b); \
@@ -1757,6 +2074,30 @@ the three different cases. */
     a = G(pcre2_match_,BITTWO)(G(b,BITTWO),(G(PCRE2_SPTR,BITTWO))c,d,e,f, \
       G(g,BITTWO),h)
 
+#define PCRE2_MATCH_ALL(r,a,b,c,d,e) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    r = G(pcre2_match_all_,BITONE)((G(pcre2_match_iterator_,BITONE) *)a, \
+      b,c,G(d,BITONE),e); \
+  else \
+    r = G(pcre2_match_all_,BITTWO)((G(pcre2_match_iterator_,BITTWO) *)a, \
+      b,c,G(d,BITTWO),e)
+
+#define PCRE2_MATCH_BATCH(r,a,b,c,d,e,f,g,h,i) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    r = G(pcre2_match_batch_,BITONE)(G(a,BITONE), \
+      (G(PCRE2_SPTR,BITONE))(b),c,d,e,f,g,G(h,BITONE),i); \
+  else \
+    r = G(pcre2_match_batch_,BITTWO)(G(a,BITTWO), \
+      (G(PCRE2_SPTR,BITTWO))(b),c,d,e,f,g,G(h,BITTWO),i)
+
+#define PCRE2_MATCH_COUNT(r,a,b,c,d,e,f,g) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    r = G(pcre2_match_count_,BITONE)(G(a,BITONE), \
+      (G(PCRE2_SPTR,BITONE))(b),c,d,e,G(f,BITONE),g); \
+  else \
+    r = G(pcre2_match_count_,BITTWO)(G(a,BITTWO), \
+      (G(PCRE2_SPTR,BITTWO))(b),c,d,e,G(f,BITTWO),g)
+
 #define PCRE2_MATCH_DATA_CREATE(a,b,c) \
   if (test_mode == G(G(PCRE,BITONE),_MODE)) \
     G(a,BITONE) = G(pcre2_match_data_create_,BITONE)(b,c); \
@@ -1775,6 +2116,60 @@ the three different cases. */
   else \
     G(pcre2_match_data_free_,BITTWO)(G(a,BITTWO))
 
+#define PCRE2_MATCH_ITERATOR_CREATE(a,b,c,d,e,f,g) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    a = (void *)G(pcre2_match_iterator_create_,BITONE)(G(b,BITONE), \
+      (G(PCRE2_SPTR,BITONE))(c),d,e,f,g); \
+  else \
+    a = (void *)G(pcre2_match_iterator_create_,BITTWO)(G(b,BITTWO), \
+      (G(PCRE2_SPTR,BITTWO))(c),d,e,f,g)
+
+#define PCRE2_MATCH_ITERATOR_FREE(a) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    G(pcre2_match_iterator_free_,BITONE)((G(pcre2_match_iterator_,BITONE) *)a); \
+  else \
+    G(pcre2_match_iterator_free_,BITTWO)((G(pcre2_match_iterator_,BITTWO) *)a)
+
+#define PCRE2_MATCH_PARALLEL(r,a,b,c,d,e,f,g,h,i,j) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    r = G(pcre2_match_parallel_,BITONE)(G(a,BITONE), \
+      (G(PCRE2_SPTR,BITONE))(b),c,d,e,f,g,h,i,j); \
+  else \
+    r = G(pcre2_match_parallel_,BITTWO)(G(a,BITTWO), \
+      (G(PCRE2_SPTR,BITTWO))(b),c,d,e,f,g,h,i,j)
+
+#define PCRE2_MATCH_POOL_CREATE(a,b,c,d,e) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    a = (void *)G(pcre2_match_pool_create_,BITONE)(G(b,BITONE),c,d,e); \
+  else \
+    a = (void *)G(pcre2_match_pool_create_,BITTWO)(G(b,BITTWO),c,d,e)
+
+#define PCRE2_MATCH_POOL_FREE(a) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    G(pcre2_match_pool_free_,BITONE)((G(pcre2_match_pool_,BITONE) *)a); \
+  else \
+    G(pcre2_match_pool_free_,BITTWO)((G(pcre2_match_pool_,BITTWO) *)a)
+
+#define PCRE2_MATCH_POOL_RUN(r,a,b,c,d,e,f,g,h,i) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    r = G(pcre2_match_pool_run_,BITONE)((G(pcre2_match_pool_,BITONE) *)a, \
+      (const G(PCRE2_SPTR,BITONE) *)b,c,d,e,f, \
+      (int (*)(uint32_t, int, G(pcre2_match_data_,BITONE) *, void *))(g), \
+      h,i); \
+  else \
+    r = G(pcre2_match_pool_run_,BITTWO)((G(pcre2_match_pool_,BITTWO) *)a, \
+      (const G(PCRE2_SPTR,BITTWO) *)b,c,d,e,f, \
+      (int (*)(uint32_t, int, G(pcre2_match_data_,BITTWO) *, void *))(g), \
+      h,i)
+
+#define PCRE2_MATCH_SEGMENTS(a,b,c,d,e,f,g,h) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    a = G(pcre2_match_segments_,BITONE)(G(b,BITONE), \
+      (G(pcre2_segment_,BITONE) *)c,d,e,f,G(g,BITONE),h); \
+  else \
+    a = G(pcre2_match_segments_,BITTWO)(G(b,BITTWO), \
+      (G(pcre2_segment_,BITTWO) *)c,d,e,f,G(g,BITTWO),h)
+
 #define PCRE2_PATTERN_CONVERT(a,b,c,d,e,f,g) \
   if (test_mode == G(G(PCRE,BITONE),_MODE)) \
     a = G(pcre2_pattern_convert_,BITONE)(G(b,BITONE),c,d,(G(PCRE2_UCHAR,BITONE) **)e,f,G(g,BITONE)); \
@@ -1787,11 +2182,66 @@ the three different cases. */
   else \
     a = G(pcre2_pattern_info_,BITTWO)(G(b,BITTWO),c,d)
 
-#define PCRE2_PRINTINT(a) \
+#define PCRE2_PATTERN_SET_ADD(r,a,b,c,d,e) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    r = G(pcre2_pattern_set_add_,BITONE)((G(pcre2_pattern_set_,BITONE) *)a, \
+      (G(PCRE2_SPTR,BITONE))b,c,d,e); \
+  else \
+    r = G(pcre2_pattern_set_add_,BITTWO)((G(pcre2_pattern_set_,BITTWO) *)a, \
+      (G(PCRE2_SPTR,BITTWO))b,c,d,e)
+
+#define PCRE2_PATTERN_SET_COMPILE(r,a) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    r = G(pcre2_pattern_set_compile_,BITONE)( \
+      (G(pcre2_pattern_set_,BITONE) *)a); \
+  else \
+    r = G(pcre2_pattern_set_compile_,BITTWO)((G(pcre2_pattern_set_,BITTWO) *)a)
+
+#define PCRE2_PATTERN_SET_CREATE(a,b,c) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    a = (void *)G(pcre2_pattern_set_create_,BITONE)(b,c); \
+  else \
+    a = (void *)G(pcre2_pattern_set_create_,BITTWO)(b,c)
+
+#define PCRE2_PATTERN_SET_DFA_MATCH(r,a,b,c,d,e,f,g,h,i) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    r = G(pcre2_pattern_set_dfa_match_,BITONE)( \
+      (G(pcre2_pattern_set_,BITONE) *)a,(G(PCRE2_SPTR,BITONE))b,c,d,e, \
+      G(f,BITONE),g,h,i); \
+  else \
+    r = G(pcre2_pattern_set_dfa_match_,BITTWO)( \
+      (G(pcre2_pattern_set_,BITTWO) *)a,(G(PCRE2_SPTR,BITTWO))b,c,d,e, \
+      G(f,BITTWO),g,h,i)
+
+#define PCRE2_PATTERN_SET_FREE(a) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    G(pcre2_pattern_set_free_,BITONE)((G(pcre2_pattern_set_,BITONE) *)a); \
+  else \
+    G(pcre2_pattern_set_free_,BITTWO)((G(pcre2_pattern_set_,BITTWO) *)a)
+
+#define PCRE2_PATTERN_SET_JIT_COMPILE(r,a,b) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    r = G(pcre2_pattern_set_jit_compile_,BITONE)( \
+      (G(pcre2_pattern_set_,BITONE) *)a,b); \
+  else \
+    r = G(pcre2_pattern_set_jit_compile_,BITTWO)( \
+      (G(pcre2_pattern_set_,BITTWO) *)a,b)
+
+#define PCRE2_PATTERN_SET_MATCH(r,a,b,c,d,e,f,g,h,i) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    r = G(pcre2_pattern_set_match_,BITONE)( \
+      (G(pcre2_pattern_set_,BITONE) *)a,(G(PCRE2_SPTR,BITONE))b,c,d,e, \
+      G(f,BITONE),g,h,i); \
+  else \
+    r = G(pcre2_pattern_set_match_,BITTWO)( \
+      (G(pcre2_pattern_set_,BITTWO) *)a,(G(PCRE2_SPTR,BITTWO))b,c,d,e, \
+      G(f,BITTWO),g,h,i)
+
+#define PCRE2_PRINTINT(a,b) \
  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
-    G(pcre2_printint_,BITONE)(G(compiled_code,BITONE),outfile,a); \
+    G(pcre2_printint_,BITONE)(G(compiled_code,BITONE),outfile,a,b); \
   else \
-    G(pcre2_printint_,BITTWO)(G(compiled_code,BITTWO),outfile,a)
+    G(pcre2_printint_,BITTWO)(G(compiled_code,BITTWO),outfile,a,b)
 
 #define PCRE2_SERIALIZE_DECODE(r,a,b,c,d) \
  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
@@ -1861,6 +2311,18 @@ the three different cases. */
   else \
     G(pcre2_set_heap_limit_,BITTWO)(G(a,BITTWO),b)
 
+#define PCRE2_SET_MATCH_DATA_PROFILE(a,b) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    G(pcre2_set_match_data_profile_,BITONE)(G(a,BITONE),b); \
+  else \
+    G(pcre2_set_match_data_profile_,BITTWO)(G(a,BITTWO),b)
+
+#define PCRE2_SET_MATCH_DATA_STATISTICS(a,b) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    G(pcre2_set_match_data_statistics_,BITONE)(G(a,BITONE),b); \
+  else \
+    G(pcre2_set_match_data_statistics_,BITTWO)(G(a,BITTWO),b)
+
 #define PCRE2_SET_MATCH_LIMIT(a,b) \
   if (test_mode == G(G(PCRE,BITONE),_MODE)) \
     G(pcre2_set_match_limit_,BITONE)(G(a,BITONE),b); \
@@ -1885,6 +2347,14 @@ the three different cases. */
   else \
     G(pcre2_set_parens_nest_limit_,BITTWO)(G(a,BITTWO),b)
 
+#define PCRE2_SET_SEGMENT(a,b,c,d) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    ((G(pcre2_segment_,BITONE) *)a)[b].data = (G(PCRE2_SPTR,BITONE))(c), \
+    ((G(pcre2_segment_,BITONE) *)a)[b].length = d; \
+  else \
+    ((G(pcre2_segment_,BITTWO) *)a)[b].data = (G(PCRE2_SPTR,BITTWO))(c), \
+    ((G(pcre2_segment_,BITTWO) *)a)[b].length = d
+
 #define PCRE2_SET_SUBSTITUTE_CALLOUT(a,b,c) \
   if (test_mode == G(G(PCRE,BITONE),_MODE)) \
     G(pcre2_set_substitute_callout_,BITONE)(G(a,BITONE), \
@@ -1893,6 +2363,26 @@ the three different cases. */
     G(pcre2_set_substitute_callout_,BITTWO)(G(a,BITTWO), \
       (int (*)(G(pcre2_substitute_callout_block_,BITTWO) *, void *))b,c)
 
+#define PCRE2_STREAM_CREATE(a,b,c,d) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    a = (void *)G(pcre2_stream_create_,BITONE)(G(b,BITONE),c,d); \
+  else \
+    a = (void *)G(pcre2_stream_create_,BITTWO)(G(b,BITTWO),c,d)
+
+#define PCRE2_STREAM_FEED(r,a,b,c,d,e,f) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    r = G(pcre2_stream_feed_,BITONE)((G(pcre2_stream_,BITONE) *)a, \
+      (G(PCRE2_SPTR,BITONE))(b),c,d,G(e,BITONE),f); \
+  else \
+    r = G(pcre2_stream_feed_,BITTWO)((G(pcre2_stream_,BITTWO) *)a, \
+      (G(PCRE2_SPTR,BITTWO))(b),c,d,G(e,BITTWO),f)
+
+#define PCRE2_STREAM_FREE(a) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    G(pcre2_stream_free_,BITONE)((G(pcre2_stream_,BITONE) *)a); \
+  else \
+    G(pcre2_stream_free_,BITTWO)((G(pcre2_stream_,BITTWO) *)a)
+
 #define PCRE2_SUBSTITUTE(a,b,c,d,e,f,g,h,i,j,k,l) \
   if (test_mode == G(G(PCRE,BITONE),_MODE)) \
     a = G(pcre2_substitute_,BITONE)(G(b,BITONE),(G(PCRE2_SPTR,BITONE))c,d,e,f, \
@@ -2051,10 +2541,18 @@ the three different cases. */
   pcre2_converted_pattern_free_8((PCRE2_UCHAR8 *)a)
 #define PCRE2_DFA_MATCH(a,b,c,d,e,f,g,h,i,j) \
   a = pcre2_dfa_match_8(G(b,8),(PCRE2_SPTR8)c,d,e,f,G(g,8),h,i,j)
+#define PCRE2_DFA_MATCH_SEGMENTS(a,b,c,d,e,f,g,h,i,j) \
+  a = pcre2_dfa_match_segments_8(G(b,8),(pcre2_segment_8 *)c,d,e,f,G(g,8),h,i,j)
 #define PCRE2_GET_ERROR_MESSAGE(r,a,b) \
   r = pcre2_get_error_message_8(a,G(b,8),G(G(b,8),_size))
 #define PCRE2_GET_OVECTOR_COUNT(a,b) a = pcre2_get_ovector_count_8(G(b,8))
 #define PCRE2_GET_STARTCHAR(a,b) a = pcre2_get_startchar_8(G(b,8))
+#define PCRE2_GET_MATCH_DATA_HEAPFRAMES_SIZE(a,b) \
+  a = pcre2_get_match_data_heapframes_size_8(G(b,8))
+#define PCRE2_GET_MATCH_PROFILE(a,b,c) \
+  a = pcre2_get_match_profile_8(G(b,8),c)
+#define PCRE2_GET_MATCH_STATISTICS(a,b) \
+  a = (const statistics_block *)pcre2_get_match_statistics_8(G(b,8))
 #define PCRE2_JIT_COMPILE(r,a,b) r = pcre2_jit_compile_8(G(a,8),b)
 #define PCRE2_JIT_FREE_UNUSED_MEMORY(a) pcre2_jit_free_unused_memory_8(G(a,8))
 #define PCRE2_JIT_MATCH(a,b,c,d,e,f,g,h) \
@@ -2067,13 +2565,51 @@ the three different cases. */
 #define PCRE2_MAKETABLES(a) a = pcre2_maketables_8(NULL)
 #define PCRE2_MATCH(a,b,c,d,e,f,g,h) \
   a = pcre2_match_8(G(b,8),(PCRE2_SPTR8)c,d,e,f,G(g,8),h)
+#define PCRE2_MATCH_ALL(r,a,b,c,d,e) \
+  r = pcre2_match_all_8((pcre2_match_iterator_8 *)a,b,c,G(d,8),e)
+#define PCRE2_MATCH_BATCH(r,a,b,c,d,e,f,g,h,i) \
+  r = pcre2_match_batch_8(G(a,8),(PCRE2_SPTR8)(b),c,d,e,f,g,G(h,8),i)
+#define PCRE2_MATCH_COUNT(r,a,b,c,d,e,f,g) \
+  r = pcre2_match_count_8(G(a,8),(PCRE2_SPTR8)(b),c,d,e,G(f,8),g)
 #define PCRE2_MATCH_DATA_CREATE(a,b,c) G(a,8) = pcre2_match_data_create_8(b,c)
 #define PCRE2_MATCH_DATA_CREATE_FROM_PATTERN(a,b,c) \
   G(a,8) = pcre2_match_data_create_from_pattern_8(G(b,8),c)
 #define PCRE2_MATCH_DATA_FREE(a) pcre2_match_data_free_8(G(a,8))
+#define PCRE2_MATCH_ITERATOR_CREATE(a,b,c,d,e,f,g) \
+  a = (void *)pcre2_match_iterator_create_8(G(b,8),(PCRE2_SPTR8)(c),d,e,f,g)
+#define PCRE2_MATCH_ITERATOR_FREE(a) \
+  pcre2_match_iterator_free_8((pcre2_match_iterator_8 *)a)
+#define PCRE2_MATCH_PARALLEL(r,a,b,c,d,e,f,g,h,i,j) \
+  r = pcre2_match_parallel_8(G(a,8),(PCRE2_SPTR8)(b),c,d,e,f,g,h,i,j)
+#define PCRE2_MATCH_POOL_CREATE(a,b,c,d,e) \
+  a = (void *)pcre2_match_pool_create_8(G(b,8),c,d,e)
+#define PCRE2_MATCH_POOL_FREE(a) \
+  pcre2_match_pool_free_8((pcre2_match_pool_8 *)a)
+#define PCRE2_MATCH_POOL_RUN(r,a,b,c,d,e,f,g,h,i) \
+  r = pcre2_match_pool_run_8((pcre2_match_pool_8 *)a, \
+    (const PCRE2_SPTR8 *)b,c,d,e,f, \
+    (int (*)(uint32_t, int, pcre2_match_data_8 *, void *))(g),h,i)
+#define PCRE2_MATCH_SEGMENTS(a,b,c,d,e,f,g,h) \
+  a = pcre2_match_segments_8(G(b,8),(pcre2_segment_8 *)c,d,e,f,G(g,8),h)
 #define PCRE2_PATTERN_CONVERT(a,b,c,d,e,f,g) a = pcre2_pattern_convert_8(G(b,8),c,d,(PCRE2_UCHAR8 **)e,f,G(g,8))
 #define PCRE2_PATTERN_INFO(a,b,c,d) a = pcre2_pattern_info_8(G(b,8),c,d)
-#define PCRE2_PRINTINT(a) pcre2_printint_8(compiled_code8,outfile,a)
+#define PCRE2_PATTERN_SET_ADD(r,a,b,c,d,e) \
+  r = pcre2_pattern_set_add_8((pcre2_pattern_set_8 *)a,(PCRE2_SPTR8)b,c,d,e)
+#define PCRE2_PATTERN_SET_COMPILE(r,a) \
+  r = pcre2_pattern_set_compile_8((pcre2_pattern_set_8 *)a)
+#define PCRE2_PATTERN_SET_CREATE(a,b,c) \
+  a = (void *)pcre2_pattern_set_create_8(b,c)
+#define PCRE2_PATTERN_SET_DFA_MATCH(r,a,b,c,d,e,f,g,h,i) \
+  r = pcre2_pattern_set_dfa_match_8((pcre2_pattern_set_8 *)a, \
+    (PCRE2_SPTR8)b,c,d,e,G(f,8),g,h,i)
+#define PCRE2_PATTERN_SET_FREE(a) \
+  pcre2_pattern_set_free_8((pcre2_pattern_set_8 *)a)
+#define PCRE2_PATTERN_SET_JIT_COMPILE(r,a,b) \
+  r = pcre2_pattern_set_jit_compile_8((pcre2_pattern_set_8 *)a,b)
+#define PCRE2_PATTERN_SET_MATCH(r,a,b,c,d,e,f,g,h,i) \
+  r = pcre2_pattern_set_match_8((pcre2_pattern_set_8 *)a,(PCRE2_SPTR8)b, \
+    c,d,e,G(f,8),g,h,i)
+#define PCRE2_PRINTINT(a,b) pcre2_printint_8(compiled_code8,outfile,a,b)
 #define PCRE2_SERIALIZE_DECODE(r,a,b,c,d) \
   r = pcre2_serialize_decode_8((pcre2_code_8 **)a,b,c,G(d,8))
 #define PCRE2_SERIALIZE_ENCODE(r,a,b,c,d,e) \
@@ -2090,13 +2626,25 @@ the three different cases. */
 #define PCRE2_SET_GLOB_ESCAPE(r,a,b) r = pcre2_set_glob_escape_8(G(a,8),b)
 #define PCRE2_SET_GLOB_SEPARATOR(r,a,b) r = pcre2_set_glob_separator_8(G(a,8),b)
 #define PCRE2_SET_HEAP_LIMIT(a,b) pcre2_set_heap_limit_8(G(a,8),b)
+#define PCRE2_SET_MATCH_DATA_PROFILE(a,b) \
+  pcre2_set_match_data_profile_8(G(a,8),b)
+#define PCRE2_SET_MATCH_DATA_STATISTICS(a,b) \
+  pcre2_set_match_data_statistics_8(G(a,8),b)
 #define PCRE2_SET_MATCH_LIMIT(a,b) pcre2_set_match_limit_8(G(a,8),b)
 #define PCRE2_SET_MAX_PATTERN_LENGTH(a,b) pcre2_set_max_pattern_length_8(G(a,8),b)
 #define PCRE2_SET_OFFSET_LIMIT(a,b) pcre2_set_offset_limit_8(G(a,8),b)
 #define PCRE2_SET_PARENS_NEST_LIMIT(a,b) pcre2_set_parens_nest_limit_8(G(a,8),b)
+#define PCRE2_SET_SEGMENT(a,b,c,d) \
+  ((pcre2_segment_8 *)a)[b].data = (PCRE2_SPTR8)(c), \
+  ((pcre2_segment_8 *)a)[b].length = d
 #define PCRE2_SET_SUBSTITUTE_CALLOUT(a,b,c) \
   pcre2_set_substitute_callout_8(G(a,8), \
     (int (*)(pcre2_substitute_callout_block_8 *, void *))b,c)
+#define PCRE2_STREAM_CREATE(a,b,c,d) \
+  a = (void *)pcre2_stream_create_8(G(b,8),c,d)
+#define PCRE2_STREAM_FEED(r,a,b,c,d,e,f) \
+  r = pcre2_stream_feed_8((pcre2_stream_8 *)a,(PCRE2_SPTR8)(b),c,d,G(e,8),f)
+#define PCRE2_STREAM_FREE(a) pcre2_stream_free_8((pcre2_stream_8 *)a)
 #define PCRE2_SUBSTITUTE(a,b,c,d,e,f,g,h,i,j,k,l) \
   a = pcre2_substitute_8(G(b,8),(PCRE2_SPTR8)c,d,e,f,G(g,8),h, \
     (PCRE2_SPTR8)i,j,(PCRE2_UCHAR8 *)k,l)
@@ -2158,10 +2706,18 @@ the three different cases. */
   pcre2_converted_pattern_free_16((PCRE2_UCHAR16 *)a)
 #define PCRE2_DFA_MATCH(a,b,c,d,e,f,g,h,i,j) \
   a = pcre2_dfa_match_16(G(b,16),(PCRE2_SPTR16)c,d,e,f,G(g,16),h,i,j)
+#define PCRE2_DFA_MATCH_SEGMENTS(a,b,c,d,e,f,g,h,i,j) \
+  a = pcre2_dfa_match_segments_16(G(b,16),(pcre2_segment_16 *)c,d,e,f,G(g,16),h,i,j)
 #define PCRE2_GET_ERROR_MESSAGE(r,a,b) \
   r = pcre2_get_error_message_16(a,G(b,16),G(G(b,16),_size/2))
 #define PCRE2_GET_OVECTOR_COUNT(a,b) a = pcre2_get_ovector_count_16(G(b,16))
 #define PCRE2_GET_STARTCHAR(a,b) a = pcre2_get_startchar_16(G(b,16))
+#define PCRE2_GET_MATCH_DATA_HEAPFRAMES_SIZE(a,b) \
+  a = pcre2_get_match_data_heapframes_size_16(G(b,16))
+#define PCRE2_GET_MATCH_PROFILE(a,b,c) \
+  a = pcre2_get_match_profile_16(G(b,16),c)
+#define PCRE2_GET_MATCH_STATISTICS(a,b) \
+  a = (const statistics_block *)pcre2_get_match_statistics_16(G(b,16))
 #define PCRE2_JIT_COMPILE(r,a,b) r = pcre2_jit_compile_16(G(a,16),b)
 #define PCRE2_JIT_FREE_UNUSED_MEMORY(a) pcre2_jit_free_unused_memory_16(G(a,16))
 #define PCRE2_JIT_MATCH(a,b,c,d,e,f,g,h) \
@@ -2174,13 +2730,52 @@ the three different cases. */
 #define PCRE2_MAKETABLES(a) a = pcre2_maketables_16(NULL)
 #define PCRE2_MATCH(a,b,c,d,e,f,g,h) \
   a = pcre2_match_16(G(b,16),(PCRE2_SPTR16)c,d,e,f,G(g,16),h)
+#define PCRE2_MATCH_ALL(r,a,b,c,d,e) \
+  r = pcre2_match_all_16((pcre2_match_iterator_16 *)a,b,c,G(d,16),e)
+#define PCRE2_MATCH_BATCH(r,a,b,c,d,e,f,g,h,i) \
+  r = pcre2_match_batch_16(G(a,16),(PCRE2_SPTR16)(b),c,d,e,f,g,G(h,16),i)
+#define PCRE2_MATCH_COUNT(r,a,b,c,d,e,f,g) \
+  r = pcre2_match_count_16(G(a,16),(PCRE2_SPTR16)(b),c,d,e,G(f,16),g)
 #define PCRE2_MATCH_DATA_CREATE(a,b,c) G(a,16) = pcre2_match_data_create_16(b,c)
 #define PCRE2_MATCH_DATA_CREATE_FROM_PATTERN(a,b,c) \
   G(a,16) = pcre2_match_data_create_from_pattern_16(G(b,16),c)
 #define PCRE2_MATCH_DATA_FREE(a) pcre2_match_data_free_16(G(a,16))
+#define PCRE2_MATCH_ITERATOR_CREATE(a,b,c,d,e,f,g) \
+  a = (void *)pcre2_match_iterator_create_16(G(b,16),(PCRE2_SPTR16)(c),d,e,f,g)
+#define PCRE2_MATCH_ITERATOR_FREE(a) \
+  pcre2_match_iterator_free_16((pcre2_match_iterator_16 *)a)
+#define PCRE2_MATCH_PARALLEL(r,a,b,c,d,e,f,g,h,i,j) \
+  r = pcre2_match_parallel_16(G(a,16),(PCRE2_SPTR16)(b),c,d,e,f,g,h,i,j)
+#define PCRE2_MATCH_POOL_CREATE(a,b,c,d,e) \
+  a = (void *)pcre2_match_pool_create_16(G(b,16),c,d,e)
+#define PCRE2_MATCH_POOL_FREE(a) \
+  pcre2_match_pool_free_16((pcre2_match_pool_16 *)a)
+#define PCRE2_MATCH_POOL_RUN(r,a,b,c,d,e,f,g,h,i) \
+  r = pcre2_match_pool_run_16((pcre2_match_pool_16 *)a, \
+    (const PCRE2_SPTR16 *)b,c,d,e,f, \
+    (int (*)(uint32_t, int, pcre2_match_data_16 *, void *))(g),h,i)
+#define PCRE2_MATCH_SEGMENTS(a,b,c,d,e,f,g,h) \
+  a = pcre2_match_segments_16(G(b,16),(pcre2_segment_16 *)c,d,e,f,G(g,16),h)
 #define PCRE2_PATTERN_CONVERT(a,b,c,d,e,f,g) a = pcre2_pattern_convert_16(G(b,16),c,d,(PCRE2_UCHAR16 **)e,f,G(g,16))
 #define PCRE2_PATTERN_INFO(a,b,c,d) a = pcre2_pattern_info_16(G(b,16),c,d)
-#define PCRE2_PRINTINT(a) pcre2_printint_16(compiled_code16,outfile,a)
+#define PCRE2_PATTERN_SET_ADD(r,a,b,c,d,e) \
+  r = pcre2_pattern_set_add_16((pcre2_pattern_set_16 *)a, \
+    (PCRE2_SPTR16)b,c,d,e)
+#define PCRE2_PATTERN_SET_COMPILE(r,a) \
+  r = pcre2_pattern_set_compile_16((pcre2_pattern_set_16 *)a)
+#define PCRE2_PATTERN_SET_CREATE(a,b,c) \
+  a = (void *)pcre2_pattern_set_create_16(b,c)
+#define PCRE2_PATTERN_SET_DFA_MATCH(r,a,b,c,d,e,f,g,h,i) \
+  r = pcre2_pattern_set_dfa_match_16((pcre2_pattern_set_16 *)a, \
+    (PCRE2_SPTR16)b,c,d,e,G(f,16),g,h,i)
+#define PCRE2_PATTERN_SET_FREE(a) \
+  pcre2_pattern_set_free_16((pcre2_pattern_set_16 *)a)
+#define PCRE2_PATTERN_SET_JIT_COMPILE(r,a,b) \
+  r = pcre2_pattern_set_jit_compile_16((pcre2_pattern_set_16 *)a,b)
+#define PCRE2_PATTERN_SET_MATCH(r,a,b,c,d,e,f,g,h,i) \
+  r = pcre2_pattern_set_match_16((pcre2_pattern_set_16 *)a, \
+    (PCRE2_SPTR16)b,c,d,e,G(f,16),g,h,i)
+#define PCRE2_PRINTINT(a,b) pcre2_printint_16(compiled_code16,outfile,a,b)
 #define PCRE2_SERIALIZE_DECODE(r,a,b,c,d) \
   r = pcre2_serialize_decode_16((pcre2_code_16 **)a,b,c,G(d,16))
 #define PCRE2_SERIALIZE_ENCODE(r,a,b,c,d,e) \
@@ -2197,13 +2792,25 @@ the three different cases. */
 #define PCRE2_SET_GLOB_ESCAPE(r,a,b) r = pcre2_set_glob_escape_16(G(a,16),b)
 #define PCRE2_SET_GLOB_SEPARATOR(r,a,b) r = pcre2_set_glob_separator_16(G(a,16),b)
 #define PCRE2_SET_HEAP_LIMIT(a,b) pcre2_set_heap_limit_16(G(a,16),b)
+#define PCRE2_SET_MATCH_DATA_PROFILE(a,b) \
+  pcre2_set_match_data_profile_16(G(a,16),b)
+#define PCRE2_SET_MATCH_DATA_STATISTICS(a,b) \
+  pcre2_set_match_data_statistics_16(G(a,16),b)
 #define PCRE2_SET_MATCH_LIMIT(a,b) pcre2_set_match_limit_16(G(a,16),b)
 #define PCRE2_SET_MAX_PATTERN_LENGTH(a,b) pcre2_set_max_pattern_length_16(G(a,16),b)
 #define PCRE2_SET_OFFSET_LIMIT(a,b) pcre2_set_offset_limit_16(G(a,16),b)
 #define PCRE2_SET_PARENS_NEST_LIMIT(a,b) pcre2_set_parens_nest_limit_16(G(a,16),b)
+#define PCRE2_SET_SEGMENT(a,b,c,d) \
+  ((pcre2_segment_16 *)a)[b].data = (PCRE2_SPTR16)(c), \
+  ((pcre2_segment_16 *)a)[b].length = d
 #define PCRE2_SET_SUBSTITUTE_CALLOUT(a,b,c) \
   pcre2_set_substitute_callout_16(G(a,16), \
     (int (*)(pcre2_substitute_callout_block_16 *, void *))b,c)
+#define PCRE2_STREAM_CREATE(a,b,c,d) \
+  a = (void *)pcre2_stream_create_16(G(b,16),c,d)
+#define PCRE2_STREAM_FEED(r,a,b,c,d,e,f) \
+  r = pcre2_stream_feed_16((pcre2_stream_16 *)a,(PCRE2_SPTR16)(b),c,d,G(e,16),f)
+#define PCRE2_STREAM_FREE(a) pcre2_stream_free_16((pcre2_stream_16 *)a)
 #define PCRE2_SUBSTITUTE(a,b,c,d,e,f,g,h,i,j,k,l) \
   a = pcre2_substitute_16(G(b,16),(PCRE2_SPTR16)c,d,e,f,G(g,16),h, \
     (PCRE2_SPTR16)i,j,(PCRE2_UCHAR16 *)k,l)
@@ -2265,10 +2872,18 @@ the three different cases. */
   pcre2_converted_pattern_free_32((PCRE2_UCHAR32 *)a)
 #define PCRE2_DFA_MATCH(a,b,c,d,e,f,g,h,i,j) \
   a = pcre2_dfa_match_32(G(b,32),(PCRE2_SPTR32)c,d,e,f,G(g,32),h,i,j)
+#define PCRE2_DFA_MATCH_SEGMENTS(a,b,c,d,e,f,g,h,i,j) \
+  a = pcre2_dfa_match_segments_32(G(b,32),(pcre2_segment_32 *)c,d,e,f,G(g,32),h,i,j)
 #define PCRE2_GET_ERROR_MESSAGE(r,a,b) \
   r = pcre2_get_error_message_32(a,G(b,32),G(G(b,32),_size/4))
 #define PCRE2_GET_OVECTOR_COUNT(a,b) a = pcre2_get_ovector_count_32(G(b,32))
 #define PCRE2_GET_STARTCHAR(a,b) a = pcre2_get_startchar_32(G(b,32))
+#define PCRE2_GET_MATCH_DATA_HEAPFRAMES_SIZE(a,b) \
+  a = pcre2_get_match_data_heapframes_size_32(G(b,32))
+#define PCRE2_GET_MATCH_PROFILE(a,b,c) \
+  a = pcre2_get_match_profile_32(G(b,32),c)
+#define PCRE2_GET_MATCH_STATISTICS(a,b) \
+  a = (const statistics_block *)pcre2_get_match_statistics_32(G(b,32))
 #define PCRE2_JIT_COMPILE(r,a,b) r = pcre2_jit_compile_32(G(a,32),b)
 #define PCRE2_JIT_FREE_UNUSED_MEMORY(a) pcre2_jit_free_unused_memory_32(G(a,32))
 #define PCRE2_JIT_MATCH(a,b,c,d,e,f,g,h) \
@@ -2281,13 +2896,52 @@ the three different cases. */
 #define PCRE2_MAKETABLES(a) a = pcre2_maketables_32(NULL)
 #define PCRE2_MATCH(a,b,c,d,e,f,g,h) \
   a = pcre2_match_32(G(b,32),(PCRE2_SPTR32)c,d,e,f,G(g,32),h)
+#define PCRE2_MATCH_ALL(r,a,b,c,d,e) \
+  r = pcre2_match_all_32((pcre2_match_iterator_32 *)a,b,c,G(d,32),e)
+#define PCRE2_MATCH_BATCH(r,a,b,c,d,e,f,g,h,i) \
+  r = pcre2_match_batch_32(G(a,32),(PCRE2_SPTR32)(b),c,d,e,f,g,G(h,32),i)
+#define PCRE2_MATCH_COUNT(r,a,b,c,d,e,f,g) \
+  r = pcre2_match_count_32(G(a,32),(PCRE2_SPTR32)(b),c,d,e,G(f,32),g)
 #define PCRE2_MATCH_DATA_CREATE(a,b,c) G(a,32) = pcre2_match_data_create_32(b,c)
 #define PCRE2_MATCH_DATA_CREATE_FROM_PATTERN(a,b,c) \
   G(a,32) = pcre2_match_data_create_from_pattern_32(G(b,32),c)
 #define PCRE2_MATCH_DATA_FREE(a) pcre2_match_data_free_32(G(a,32))
+#define PCRE2_MATCH_ITERATOR_CREATE(a,b,c,d,e,f,g) \
+  a = (void *)pcre2_match_iterator_create_32(G(b,32),(PCRE2_SPTR32)(c),d,e,f,g)
+#define PCRE2_MATCH_ITERATOR_FREE(a) \
+  pcre2_match_iterator_free_32((pcre2_match_iterator_32 *)a)
+#define PCRE2_MATCH_PARALLEL(r,a,b,c,d,e,f,g,h,i,j) \
+  r = pcre2_match_parallel_32(G(a,32),(PCRE2_SPTR32)(b),c,d,e,f,g,h,i,j)
+#define PCRE2_MATCH_POOL_CREATE(a,b,c,d,e) \
+  a = (void *)pcre2_match_pool_create_32(G(b,32),c,d,e)
+#define PCRE2_MATCH_POOL_FREE(a) \
+  pcre2_match_pool_free_32((pcre2_match_pool_32 *)a)
+#define PCRE2_MATCH_POOL_RUN(r,a,b,c,d,e,f,g,h,i) \
+  r = pcre2_match_pool_run_32((pcre2_match_pool_32 *)a, \
+    (const PCRE2_SPTR32 *)b,c,d,e,f, \
+    (int (*)(uint32_t, int, pcre2_match_data_32 *, void *))(g),h,i)
+#define PCRE2_MATCH_SEGMENTS(a,b,c,d,e,f,g,h) \
+  a = pcre2_match_segments_32(G(b,32),(pcre2_segment_32 *)c,d,e,f,G(g,32),h)
 #define PCRE2_PATTERN_CONVERT(a,b,c,d,e,f,g) a = pcre2_pattern_convert_32(G(b,32),c,d,(PCRE2_UCHAR32 **)e,f,G(g,32))
 #define PCRE2_PATTERN_INFO(a,b,c,d) a = pcre2_pattern_info_32(G(b,32),c,d)
-#define PCRE2_PRINTINT(a) pcre2_printint_32(compiled_code32,outfile,a)
+#define PCRE2_PATTERN_SET_ADD(r,a,b,c,d,e) \
+  r = pcre2_pattern_set_add_32((pcre2_pattern_set_32 *)a, \
+    (PCRE2_SPTR32)b,c,d,e)
+#define PCRE2_PATTERN_SET_COMPILE(r,a) \
+  r = pcre2_pattern_set_compile_32((pcre2_pattern_set_32 *)a)
+#define PCRE2_PATTERN_SET_CREATE(a,b,c) \
+  a = (void *)pcre2_pattern_set_create_32(b,c)
+#define PCRE2_PATTERN_SET_DFA_MATCH(r,a,b,c,d,e,f,g,h,i) \
+  r = pcre2_pattern_set_dfa_match_32((pcre2_pattern_set_32 *)a, \
+    (PCRE2_SPTR32)b,c,d,e,G(f,32),g,h,i)
+#define PCRE2_PATTERN_SET_FREE(a) \
+  pcre2_pattern_set_free_32((pcre2_pattern_set_32 *)a)
+#define PCRE2_PATTERN_SET_JIT_COMPILE(r,a,b) \
+  r = pcre2_pattern_set_jit_compile_32((pcre2_pattern_set_32 *)a,b)
+#define PCRE2_PATTERN_SET_MATCH(r,a,b,c,d,e,f,g,h,i) \
+  r = pcre2_pattern_set_match_32((pcre2_pattern_set_32 *)a, \
+    (PCRE2_SPTR32)b,c,d,e,G(f,32),g,h,i)
+#define PCRE2_PRINTINT(a,b) pcre2_printint_32(compiled_code32,outfile,a,b)
 #define PCRE2_SERIALIZE_DECODE(r,a,b,c,d) \
   r = pcre2_serialize_decode_32((pcre2_code_32 **)a,b,c,G(d,32))
 #define PCRE2_SERIALIZE_ENCODE(r,a,b,c,d,e) \
@@ -2304,13 +2958,25 @@ the three different cases. */
 #define PCRE2_SET_GLOB_ESCAPE(r,a,b) r = pcre2_set_glob_escape_32(G(a,32),b)
 #define PCRE2_SET_GLOB_SEPARATOR(r,a,b) r = pcre2_set_glob_separator_32(G(a,32),b)
 #define PCRE2_SET_HEAP_LIMIT(a,b) pcre2_set_heap_limit_32(G(a,32),b)
+#define PCRE2_SET_MATCH_DATA_PROFILE(a,b) \
+  pcre2_set_match_data_profile_32(G(a,32),b)
+#define PCRE2_SET_MATCH_DATA_STATISTICS(a,b) \
+  pcre2_set_match_data_statistics_32(G(a,32),b)
 #define PCRE2_SET_MATCH_LIMIT(a,b) pcre2_set_match_limit_32(G(a,32),b)
 #define PCRE2_SET_MAX_PATTERN_LENGTH(a,b) pcre2_set_max_pattern_length_32(G(a,32),b)
 #define PCRE2_SET_OFFSET_LIMIT(a,b) pcre2_set_offset_limit_32(G(a,32),b)
 #define PCRE2_SET_PARENS_NEST_LIMIT(a,b) pcre2_set_parens_nest_limit_32(G(a,32),b)
+#define PCRE2_SET_SEGMENT(a,b,c,d) \
+  ((pcre2_segment_32 *)a)[b].data = (PCRE2_SPTR32)(c), \
+  ((pcre2_segment_32 *)a)[b].length = d
 #define PCRE2_SET_SUBSTITUTE_CALLOUT(a,b,c) \
   pcre2_set_substitute_callout_32(G(a,32), \
     (int (*)(pcre2_substitute_callout_block_32 *, void *))b,c)
+#define PCRE2_STREAM_CREATE(a,b,c,d) \
+  a = (void *)pcre2_stream_create_32(G(b,32),c,d)
+#define PCRE2_STREAM_FEED(r,a,b,c,d,e,f) \
+  r = pcre2_stream_feed_32((pcre2_stream_32 *)a,(PCRE2_SPTR32)(b),c,d,G(e,32),f)
+#define PCRE2_STREAM_FREE(a) pcre2_stream_free_32((pcre2_stream_32 *)a)
 #define PCRE2_SUBSTITUTE(a,b,c,d,e,f,g,h,i,j,k,l) \
   a = pcre2_substitute_32(G(b,32),(PCRE2_SPTR32)c,d,e,f,G(g,32),h, \
     (PCRE2_SPTR32)i,j,(PCRE2_UCHAR32 *)k,l)
@@ -4109,7 +4775,7 @@ Returns:      nothing
 static void
 show_controls(uint32_t controls, uint32_t controls2, const char *before)
 {
-fprintf(outfile, "%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s",
+fprintf(outfile, "%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s",
   before,
   ((controls & CTL_AFTERTEXT) != 0)? " aftertext" : "",
   ((controls & CTL_ALLAFTERTEXT) != 0)? " allaftertext" : "",
@@ -4131,22 +4797,28 @@ fprintf(outfile, "%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s
   ((controls & CTL_FULLBINCODE) != 0)? " fullbincode" : "",
   ((controls & CTL_GETALL) != 0)? " getall" : "",
   ((controls & CTL_GLOBAL) != 0)? " global" : "",
+  ((controls2 & CTL2_HEAPFRAMES_SIZE) != 0)? " heapframes_size" : "",
   ((controls & CTL_HEXPAT) != 0)? " hex" : "",
   ((controls & CTL_INFO) != 0)? " info" : "",
+  ((controls2 & CTL2_JIT_PERF_MAP) != 0)? " jit_perf_map" : "",
   ((controls & CTL_JITFAST) != 0)? " jitfast" : "",
   ((controls & CTL_JITVERIFY) != 0)? " jitverify" : "",
   ((controls & CTL_MARK) != 0)? " mark" : "",
+  ((controls2 & CTL2_MATCH_COUNT) != 0)? " match_count" : "",
   ((controls & CTL_MEMORY) != 0)? " memory" : "",
   ((controls2 & CTL2_NL_SET) != 0)? " newline" : "",
   ((controls & CTL_NULLCONTEXT) != 0)? " null_context" : "",
   ((controls2 & CTL2_NULL_REPLACEMENT) != 0)? " null_replacement" : "",
   ((controls2 & CTL2_NULL_SUBJECT) != 0)? " null_subject" : "",
+  ((controls2 & CTL2_PATTERN_SET) != 0)? " pattern_set" : "",
   ((controls & CTL_POSIX) != 0)? " posix" : "",
   ((controls & CTL_POSIX_NOSUB) != 0)? " posix_nosub" : "",
+  ((controls2 & CTL2_PROFILE) != 0)? " profile" : "",
   ((controls & CTL_PUSH) != 0)? " push" : "",
   ((controls & CTL_PUSHCOPY) != 0)? " pushcopy" : "",
   ((controls & CTL_PUSHTABLESCOPY) != 0)? " pushtablescopy" : "",
   ((controls & CTL_STARTCHAR) != 0)? " startchar" : "",
+  ((controls2 & CTL2_STATISTICS) != 0)? " statistics" : "",
   ((controls2 & CTL2_SUBSTITUTE_CALLOUT) != 0)? " substitute_callout" : "",
   ((controls2 & CTL2_SUBSTITUTE_EXTENDED) != 0)? " substitute_extended" : "",
   ((controls2 & CTL2_SUBSTITUTE_LITERAL) != 0)? " substitute_literal" : "",
@@ -4235,9 +4907,10 @@ show_compile_extra_options(uint32_t options, const char *before,
   const char *after)
 {
 if (options == 0) fprintf(outfile, "%s <none>%s", before, after);
-else fprintf(outfile, "%s%s%s%s%s%s%s%s",
+else fprintf(outfile, "%s%s%s%s%s%s%s%s%s",
   before,
   ((options & PCRE2_EXTRA_ALLOW_SURROGATE_ESCAPES) != 0)? " allow_surrogate_escapes" : "",
+  ((options & PCRE2_EXTRA_AUTO_ENGINE) != 0)? " auto_engine" : "",
   ((options & PCRE2_EXTRA_BAD_ESCAPE_IS_LITERAL) != 0)? " bad_escape_is_literal" : "",
   ((options & PCRE2_EXTRA_ALT_BSUX) != 0)? " extra_alt_bsux" : "",
   ((options & PCRE2_EXTRA_MATCH_WORD) != 0)? " match_word" : "",
@@ -4258,13 +4931,15 @@ else fprintf(outfile, "%s%s%s%s%s%s%s%s",
 static void
 show_match_options(uint32_t options)
 {
-fprintf(outfile, "%s%s%s%s%s%s%s%s%s%s%s%s%s",
+fprintf(outfile, "%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s",
   ((options & PCRE2_ANCHORED) != 0)? " anchored" : "",
   ((options & PCRE2_COPY_MATCHED_SUBJECT) != 0)? " copy_matched_subject" : "",
   ((options & PCRE2_DFA_RESTART) != 0)? " dfa_restart" : "",
   ((options & PCRE2_DFA_SHORTEST) != 0)? " dfa_shortest" : "",
   ((options & PCRE2_ENDANCHORED) != 0)? " endanchored" : "",
+  ((options & PCRE2_MEMOIZE) != 0)? " memoize" : "",
   ((options & PCRE2_NO_JIT) != 0)? " no_jit" : "",
+  ((options & PCRE2_NO_OVECTOR) != 0)? " no_ovector" : "",
   ((options & PCRE2_NO_UTF_CHECK) != 0)? " no_utf_check" : "",
   ((options & PCRE2_NOTBOL) != 0)? " notbol" : "",
   ((options & PCRE2_NOTEMPTY) != 0)? " notempty" : "",
@@ -4403,6 +5078,67 @@ return 0;
 
 
 
+/*************************************************
+*      Callback for pcre2_match_parallel()       *
+*************************************************/
+
+/* Each match is shown in the same way as for match_all.
+
+Arguments:
+  start     the offset of the start of the match
+  end       the offset of the end of the match
+  data      the subject
+
+Returns:    0
+*/
+
+static int
+parallel_callback(PCRE2_SIZE start, PCRE2_SIZE end, void *data)
+{
+BOOL utf = (FLD(compiled_code, overall_options) & PCRE2_UTF) != 0;
+
+if (start > end)
+  {
+  PCRE2_SIZE temp = start;
+  start = end;
+  end = temp;
+  fprintf(outfile, "Start of matched string is beyond its end - "
+    "displaying from end to start.\n");
+  }
+fprintf(outfile, " 0: ");
+PCHARSV(data, start, end - start, utf, outfile);
+fprintf(outfile, "\n");
+return 0;
+}
+
+
+
+/*************************************************
+*        Callback for a match pool run           *
+*************************************************/
+
+/* This may be called in any of the pool's threads, so it just records the
+return for the subject, to be shown afterwards.
+
+Arguments:
+  index       the index of the subject
+  rc          the return from matching it
+  match_data  the worker's match data (not used)
+  data        the vector of returns
+
+Returns:      0
+*/
+
+static int
+pool_callback(uint32_t index, int rc, void *match_data, void *data)
+{
+(void)match_data;
+((int *)data)[index] = rc;
+return 0;
+}
+
+
+
 /*************************************************
 *        Show information about a pattern        *
 *************************************************/
@@ -4426,7 +5162,7 @@ BOOL utf = (FLD(compiled_code, overall_options) & PCRE2_UTF) != 0;
 if ((pat_patctl.control & (CTL_BINCODE|CTL_FULLBINCODE)) != 0)
   {
   fprintf(outfile, "------------------------------------------------------------------\n");
-  PCRE2_PRINTINT((pat_patctl.control & CTL_FULLBINCODE) != 0);
+  PCRE2_PRINTINT((pat_patctl.control & CTL_FULLBINCODE) != 0, NULL);
   }
 
 if ((pat_patctl.control & CTL_INFO) != 0)
@@ -4744,6 +5480,19 @@ if ((pat_patctl.control & CTL_INFO) != 0)
   if ((FLD(compiled_code, overall_options) & PCRE2_NO_START_OPTIMIZE) == 0)
     fprintf(outfile, "Subject length lower bound = %d\n", minlength);
 
+  if ((extra_options & PCRE2_EXTRA_AUTO_ENGINE) != 0)
+    {
+    uint32_t engines;
+    pattern_info(PCRE2_INFO_ELIGIBLE_ENGINES, &engines, FALSE);
+    fprintf(outfile, "Eligible engines:%s%s%s%s%s%s\n",
+      ((engines & PCRE2_ENGINE_INTERPRETER) != 0)? " interpreter" : "",
+      ((engines & PCRE2_ENGINE_JIT) != 0)? " jit" : "",
+      ((engines & PCRE2_ENGINE_ONEPASS) != 0)? " onepass" : "",
+      ((engines & PCRE2_ENGINE_BITPARALLEL) != 0)? " bitparallel" : "",
+      ((engines & PCRE2_ENGINE_MEMOIZE) != 0)? " memoize" : "",
+      ((engines & PCRE2_ENGINE_DFA) != 0)? " dfa" : "");
+    }
+
   if (pat_patctl.jit != 0 && (pat_patctl.control & CTL_JITVERIFY) != 0)
     {
     if (FLD(compiled_code, executable_jit) != NULL)
@@ -5248,6 +5997,11 @@ if (pat_patctl.jit == 0 &&
     (pat_patctl.control & (CTL_JITVERIFY|CTL_JITFAST)) != 0)
   pat_patctl.jit = JIT_DEFAULT;
 
+/* A perf map for the JIT code is requested by an extra JIT option. */
+
+if (pat_patctl.jit != 0 && (pat_patctl.control2 & CTL2_JIT_PERF_MAP) != 0)
+  pat_patctl.jit |= PCRE2_JIT_PERF_MAP;
+
 /* Now copy the pattern to pbuffer8 for use in 8-bit testing and for reflecting
 in callouts. Convert from hex if requested (literal strings in quotes may be
 present within the hexadecimal pairs). The result must necessarily be fewer
@@ -5806,6 +6560,64 @@ and PCRE2_NEVER_UCP are invalid with it. */
 
 if ((pat_patctl.options & PCRE2_LITERAL) != 0) use_forbid_utf = 0;
 
+/* For a pattern set, each line of the pattern is added to a new set, which is
+then compiled, and JIT-compiled if requested. An empty pattern is then compiled
+in the normal way below so that the subject lines are processed. */
+
+if ((pat_patctl.control2 & CTL2_PATTERN_SET) != 0)
+  {
+  int rc;
+  uint32_t id = 0;
+  PCRE2_SIZE i, start = 0;
+  PCRE2_SIZE length = (patlen == PCRE2_ZERO_TERMINATED)?
+    valgrind_access_length - 1 : patlen;
+  uint8_t *pattern = CASTVAR(uint8_t *, pbuffer);
+
+  if (pattern_set != NULL)
+    {
+    PCRE2_PATTERN_SET_FREE(pattern_set);
+    pattern_set = NULL;
+    }
+
+  PCRE2_PATTERN_SET_CREATE(pattern_set, pat_patctl.options|use_forbid_utf,
+    use_pat_context);
+  if (pattern_set == NULL)
+    {
+    fprintf(outfile, "** Failed to create a pattern set: unsupported "
+      "option\n");
+    return PR_SKIP;
+    }
+
+  for (i = 0; i <= length; i++)
+    {
+    uint8_t *line = pattern + start * code_unit_size;
+    if (i < length && CODE_UNIT(pattern, i) != '\n') continue;
+    PCRE2_PATTERN_SET_ADD(rc, pattern_set, line, i - start, 0, &erroroffset);
+    if (rc != 0)
+      {
+      fprintf(outfile, "Failed: error %d at offset %d in pattern %d: ", rc,
+        (int)erroroffset, id);
+      if (!print_error_message(rc, "", "\n")) return PR_ABEND;
+      return PR_SKIP;
+      }
+    id++;
+    start = i + 1;
+    }
+
+  PCRE2_PATTERN_SET_COMPILE(rc, pattern_set);
+  if (rc != 0)
+    {
+    fprintf(outfile, "Failed: error %d: ", rc);
+    if (!print_error_message(rc, "", "\n")) return PR_ABEND;
+    return PR_SKIP;
+    }
+  if (pat_patctl.jit != 0)
+    {
+    PCRE2_PATTERN_SET_JIT_COMPILE(jitrc, pattern_set, pat_patctl.jit);
+    }
+  patlen = 0;
+  }
+
 /* Compile many times when timing. */
 
 if (timeit > 0)
@@ -6639,6 +7451,7 @@ PCRE2_SIZE len, ulen, arg_ulen;
 uint32_t gmatched;
 uint32_t c, k;
 uint32_t g_notempty = 0;
+uint32_t segment_count = 0;
 uint8_t *p, *pp, *start_rep;
 size_t needlen;
 void *use_dat_context;
@@ -7101,8 +7914,14 @@ if ((pat_patctl.control & CTL_POSIX) != 0)
     prmsg(&msg, "copy");
   if (dat_datctl.get_numbers[0] >= 0 || dat_datctl.get_names[0] != 0)
     prmsg(&msg, "get");
+  if (dat_datctl.batch != 0) prmsg(&msg, "batch");
   if (dat_datctl.jitstack != 0) prmsg(&msg, "jitstack");
+  if (dat_datctl.match_all != 0) prmsg(&msg, "match_all");
   if (dat_datctl.offset != 0) prmsg(&msg, "offset");
+  if (dat_datctl.parallel[0] != 0) prmsg(&msg, "parallel");
+  if (dat_datctl.pool[0] != 0) prmsg(&msg, "pool");
+  if (dat_datctl.segments != 0) prmsg(&msg, "segments");
+  if (dat_datctl.stream != 0) prmsg(&msg, "stream");
 
   if ((dat_datctl.options & ~POSIX_SUPPORTED_MATCH_OPTIONS) != 0)
     {
@@ -7209,6 +8028,16 @@ if ((dat_datctl.control & (CTL_ALLUSEDTEXT|CTL_DFA)) == CTL_ALLUSEDTEXT &&
   dat_datctl.control &= ~CTL_ALLUSEDTEXT;
   }
 
+/* A global search needs the end of each match, which no_ovector does not
+provide. */
+
+if ((dat_datctl.options & PCRE2_NO_OVECTOR) != 0 &&
+    (dat_datctl.control & CTL_ANYGLOB) != 0)
+  {
+  fprintf(outfile, "** Global matching is not supported with no_ovector: ignored\n");
+  dat_datctl.control &= ~CTL_ANYGLOB;
+  }
+
 /* Handle passing the subject as zero-terminated. */
 
 if ((dat_datctl.control & CTL_ZERO_TERMINATE) != 0)
@@ -7291,6 +8120,518 @@ if (CASTVAR(void *, match_data) == NULL)
 
 ovector = FLD(match_data, ovector);
 PCRE2_GET_OVECTOR_COUNT(oveccount, match_data);
+PCRE2_SET_MATCH_DATA_STATISTICS(match_data,
+  (dat_datctl.control2 & CTL2_STATISTICS) != 0);
+PCRE2_SET_MATCH_DATA_PROFILE(match_data,
+  (dat_datctl.control2 & CTL2_PROFILE) != 0);
+
+/* For a pattern set, show the ids of the patterns that match. No other
+processing is done. */
+
+if (pattern_set != NULL)
+  {
+  int rc;
+  uint32_t ids[PATTERN_SET_IDS];
+
+  if ((dat_datctl.control & CTL_DFA) != 0)
+    {
+    PCRE2_PATTERN_SET_DFA_MATCH(rc, pattern_set, pp, arg_ulen,
+      dat_datctl.offset, dat_datctl.options, match_data, use_dat_context, ids,
+      PATTERN_SET_IDS);
+    }
+  else
+    {
+    PCRE2_PATTERN_SET_MATCH(rc, pattern_set, pp, arg_ulen, dat_datctl.offset,
+      dat_datctl.options, match_data, use_dat_context, ids, PATTERN_SET_IDS);
+    }
+
+  if (rc < 0)
+    {
+    fprintf(outfile, "Failed: error %d: ", rc);
+    if (!print_error_message(rc, "", "\n")) return PR_ABEND;
+    }
+  else if (rc == 0) fprintf(outfile, "No match\n");
+  else
+    {
+    int i;
+    fprintf(outfile, "Patterns:");
+    for (i = 0; i < rc && i < PATTERN_SET_IDS; i++)
+      fprintf(outfile, " %u", ids[i]);
+    if (rc > PATTERN_SET_IDS) fprintf(outfile, " (%d in all)", rc);
+    fprintf(outfile, "\n");
+    }
+  return PR_OK;
+  }
+
+/* For batch, split the subject into subjects of the given size, which are
+passed to pcre2_match_batch() as one buffer with a vector of offsets. Whether
+each one matches is shown, with the start of its first match unless no_ovector
+is set, followed by the match bitmap. No other processing is done. */
+
+if (dat_datctl.batch != 0)
+  {
+  int rc;
+  uint32_t i;
+  uint32_t count = (uint32_t)((arg_ulen + dat_datctl.batch - 1)/
+    dat_datctl.batch);
+  uint32_t options = dat_datctl.options & ~PCRE2_NO_OVECTOR;
+  BOOL show_starts = (dat_datctl.options & PCRE2_NO_OVECTOR) == 0;
+  PCRE2_SIZE *offsets;
+  PCRE2_SIZE *starts;
+  uint8_t *bitmap;
+
+  if (dat_datctl.match_all != 0 || dat_datctl.offset != 0 ||
+      dat_datctl.parallel[0] != 0 || dat_datctl.pool[0] != 0 ||
+      dat_datctl.segments != 0 || dat_datctl.stream != 0 ||
+      dat_datctl.replacement[0] != 0 ||
+      dat_datctl.copy_numbers[0] >= 0 || dat_datctl.copy_names[0] != 0 ||
+      dat_datctl.get_numbers[0] >= 0 || dat_datctl.get_names[0] != 0 ||
+      (dat_datctl.control & (CTL_DFA|CTL_FINDLIMITS|CTL_GETALL|
+        CTL_ZERO_TERMINATE)) != 0 ||
+      (dat_datctl.control2 & CTL2_MATCH_COUNT) != 0 || timeitm > 0)
+    {
+    fprintf(outfile, "** Batch is not supported with copy, dfa, find_limits, "
+      "get, getall, match_all,\n** match_count, offset, parallel, pool, "
+      "replace, segments, stream, timing, or\n** zero_terminate\n");
+    return PR_OK;
+    }
+
+  /* An empty subject is passed as one empty subject. */
+
+  if (count == 0) count = 1;
+  offsets = malloc((count + 1) * sizeof(PCRE2_SIZE));
+  starts = malloc(count * sizeof(PCRE2_SIZE));
+  bitmap = malloc((count + 7)/8);
+  if (offsets == NULL || starts == NULL || bitmap == NULL)
+    {
+    fprintf(outfile, "** Failed to get memory for a batch of %u\n", count);
+    free(offsets);
+    free(starts);
+    free(bitmap);
+    return PR_ABEND;
+    }
+
+  for (i = 0; i < count; i++)
+    offsets[i] = ((PCRE2_SIZE)i * dat_datctl.batch < arg_ulen)?
+      (PCRE2_SIZE)i * dat_datctl.batch : arg_ulen;
+  offsets[count] = arg_ulen;
+  memset(bitmap, 0, (count + 7)/8);
+
+  PCRE2_MATCH_BATCH(rc, compiled_code, pp, offsets, count, options, bitmap,
+    show_starts? starts : NULL, match_data, use_dat_context);
+
+  if (rc < 0)
+    {
+    fprintf(outfile, "Failed: error %d: ", rc);
+    if (!print_error_message(rc, "", "\n")) return PR_ABEND;
+    }
+  else
+    {
+    for (i = 0; i < count; i++)
+      {
+      BOOL matched = (bitmap[i/8] & (1u << (i%8))) != 0;
+      fprintf(outfile, "%2u: ", i);
+      PCHARSV(pp, offsets[i], offsets[i+1] - offsets[i], utf, outfile);
+      if (!matched) fprintf(outfile, " - no match\n");
+      else if (!show_starts) fprintf(outfile, " - match\n");
+      else fprintf(outfile, " - match at %lu\n", (unsigned long int)starts[i]);
+      }
+    fprintf(outfile, "Bitmap:");
+    for (i = 0; i < (count + 7)/8; i++) fprintf(outfile, " %02x", bitmap[i]);
+    fprintf(outfile, "\nMatched: %d\n", rc);
+    }
+
+  free(offsets);
+  free(starts);
+  free(bitmap);
+  return PR_OK;
+  }
+
+/* For match_count, show only the number of matches. No other processing is
+done. */
+
+if ((dat_datctl.control2 & CTL2_MATCH_COUNT) != 0)
+  {
+  int rc;
+
+  if (dat_datctl.match_all != 0 || dat_datctl.parallel[0] != 0 ||
+      dat_datctl.pool[0] != 0 || dat_datctl.segments != 0 ||
+      dat_datctl.stream != 0 || dat_datctl.replacement[0] != 0 ||
+      dat_datctl.copy_numbers[0] >= 0 || dat_datctl.copy_names[0] != 0 ||
+      dat_datctl.get_numbers[0] >= 0 || dat_datctl.get_names[0] != 0 ||
+      (dat_datctl.control & (CTL_DFA|CTL_FINDLIMITS|CTL_GETALL)) != 0 ||
+      timeitm > 0)
+    {
+    fprintf(outfile, "** Match_count is not supported with copy, dfa, "
+      "find_limits, get, getall,\n** match_all, parallel, pool, replace, "
+      "segments, stream, or timing\n");
+    return PR_OK;
+    }
+
+  PCRE2_MATCH_COUNT(rc, compiled_code, pp,
+    ((dat_datctl.control & CTL_ZERO_TERMINATE) != 0)? PCRE2_ZERO_TERMINATED :
+      arg_ulen, dat_datctl.offset, dat_datctl.options, match_data,
+      use_dat_context);
+  if (rc >= 0) fprintf(outfile, "Count: %d\n", rc);
+  else
+    {
+    fprintf(outfile, "Failed: error %d: ", rc);
+    if (!print_error_message(rc, "", "\n")) return PR_ABEND;
+    }
+  return PR_OK;
+  }
+
+/* For match_all, find every match with a match iterator, fetching the given
+number of offset pairs per call. Only the matched strings are shown. No other
+processing is done. */
+
+if (dat_datctl.match_all != 0)
+  {
+  int rc;
+  BOOL matched = FALSE;
+  PCRE2_SIZE *offsets;
+  void *iterator;
+
+  if (dat_datctl.parallel[0] != 0 || dat_datctl.pool[0] != 0 ||
+      dat_datctl.segments != 0 || dat_datctl.stream != 0 ||
+      dat_datctl.replacement[0] != 0 ||
+      dat_datctl.copy_numbers[0] >= 0 || dat_datctl.copy_names[0] != 0 ||
+      dat_datctl.get_numbers[0] >= 0 || dat_datctl.get_names[0] != 0 ||
+      (dat_datctl.control & (CTL_DFA|CTL_FINDLIMITS|CTL_GETALL)) != 0 ||
+      timeitm > 0)
+    {
+    fprintf(outfile, "** Match_all is not supported with copy, dfa, "
+      "find_limits, get, getall,\n** parallel, pool, replace, segments, "
+      "stream, or timing\n");
+    return PR_OK;
+    }
+
+  offsets = malloc(2 * sizeof(PCRE2_SIZE) * dat_datctl.match_all);
+  if (offsets == NULL)
+    {
+    fprintf(outfile, "** Failed to get memory for %u offset pairs\n",
+      dat_datctl.match_all);
+    return PR_ABEND;
+    }
+
+  PCRE2_MATCH_ITERATOR_CREATE(iterator, compiled_code, pp,
+    ((dat_datctl.control & CTL_ZERO_TERMINATE) != 0)? PCRE2_ZERO_TERMINATED :
+      arg_ulen, dat_datctl.offset, dat_datctl.options, NULL);
+  if (iterator == NULL)
+    {
+    fprintf(outfile, "** Failed to create a match iterator: check the "
+      "options\n");
+    free(offsets);
+    return PR_OK;
+    }
+
+  for (;;)
+    {
+    uint32_t i;
+    PCRE2_MATCH_ALL(rc, iterator, offsets, dat_datctl.match_all, match_data,
+      use_dat_context);
+    if (rc <= 0) break;
+    matched = TRUE;
+    for (i = 0; i < 2*(uint32_t)rc; i += 2)
+      {
+      PCRE2_SIZE start = offsets[i];
+      PCRE2_SIZE end = offsets[i+1];
+      if (start > end)
+        {
+        start = offsets[i+1];
+        end = offsets[i];
+        fprintf(outfile, "Start of matched string is beyond its end - "
+          "displaying from end to start.\n");
+        }
+      fprintf(outfile, " 0: ");
+      if (end > arg_ulen)
+        fprintf(outfile, "ERROR: bad value(s) for offset(s): 0x%lx 0x%lx",
+          (unsigned long int)start, (unsigned long int)end);
+      else PCHARSV(pp, start, end - start, utf, outfile);
+      fprintf(outfile, "\n");
+      }
+    }
+
+  if (rc < 0 && rc != PCRE2_ERROR_NOMATCH)
+    {
+    fprintf(outfile, "Failed: error %d: ", rc);
+    if (!print_error_message(rc, "", "\n")) return PR_ABEND;
+    }
+  else if (!matched) fprintf(outfile, "No match\n");
+
+  PCRE2_MATCH_ITERATOR_FREE(iterator);
+  free(offsets);
+  return PR_OK;
+  }
+
+/* For parallel, find every match with pcre2_match_parallel(), using the given
+number of threads and chunk size, and show the matched strings. No other
+processing is done. */
+
+if (dat_datctl.parallel[0] != 0)
+  {
+  int rc;
+
+  if (dat_datctl.match_all != 0 || dat_datctl.pool[0] != 0 ||
+      dat_datctl.segments != 0 || dat_datctl.stream != 0 ||
+      dat_datctl.replacement[0] != 0 ||
+      dat_datctl.copy_numbers[0] >= 0 || dat_datctl.copy_names[0] != 0 ||
+      dat_datctl.get_numbers[0] >= 0 || dat_datctl.get_names[0] != 0 ||
+      (dat_datctl.control & (CTL_DFA|CTL_FINDLIMITS|CTL_GETALL|
+        CTL_MEMORY)) != 0 ||
+      timeitm > 0)
+    {
+    fprintf(outfile, "** Parallel is not supported with copy, dfa, "
+      "find_limits, get, getall,\n** match_all, memory, pool, replace, "
+      "segments, stream, or timing\n");
+    show_memory = FALSE;
+    return PR_OK;
+    }
+
+  PCRE2_MATCH_PARALLEL(rc, compiled_code, pp,
+    ((dat_datctl.control & CTL_ZERO_TERMINATE) != 0)? PCRE2_ZERO_TERMINATED :
+      arg_ulen, dat_datctl.offset, dat_datctl.options,
+      dat_datctl.parallel[0], dat_datctl.parallel[1], parallel_callback, pp,
+      use_dat_context);
+
+  if (rc < 0)
+    {
+    fprintf(outfile, "Failed: error %d: ", rc);
+    if (!print_error_message(rc, "", "\n")) return PR_ABEND;
+    }
+  else if (rc == 0) fprintf(outfile, "No match\n");
+  return PR_OK;
+  }
+
+/* For pool, split the subject into subjects of the given size (or use it
+whole if the size is zero), and match them with a match pool that has the
+given number of threads. Whether each one matches is shown, with its first
+matched string, followed by the number that match. Unless no_ovector is set, a
+callback records the return for each subject, so that errors can be shown for
+the subjects that had them. No other processing is done. */
+
+if (dat_datctl.pool[0] != 0)
+  {
+  int rc;
+  uint32_t i, count;
+  uint32_t size = dat_datctl.pool[1];
+  uint32_t options = dat_datctl.options & ~PCRE2_NO_OVECTOR;
+  BOOL use_callback = (dat_datctl.options & PCRE2_NO_OVECTOR) == 0;
+  void **subjects;
+  PCRE2_SIZE *lengths;
+  PCRE2_SIZE *results;
+  int *returns;
+  void *pool;
+
+  if (dat_datctl.offset != 0 || dat_datctl.segments != 0 ||
+      dat_datctl.stream != 0 || dat_datctl.replacement[0] != 0 ||
+      dat_datctl.copy_numbers[0] >= 0 || dat_datctl.copy_names[0] != 0 ||
+      dat_datctl.get_numbers[0] >= 0 || dat_datctl.get_names[0] != 0 ||
+      (dat_datctl.control & (CTL_DFA|CTL_FINDLIMITS|CTL_GETALL|CTL_MEMORY|
+        CTL_ZERO_TERMINATE)) != 0 || timeitm > 0)
+    {
+    fprintf(outfile, "** Pool is not supported with copy, dfa, find_limits, "
+      "get, getall, memory,\n** offset, replace, segments, stream, timing, or "
+      "zero_terminate\n");
+    show_memory = FALSE;
+    return PR_OK;
+    }
+
+  /* An empty subject is passed as one empty subject. */
+
+  if (size == 0 || size > arg_ulen) size = (uint32_t)arg_ulen;
+  count = (size == 0)? 1 : (uint32_t)((arg_ulen + size - 1)/size);
+  subjects = malloc(count * sizeof(void *));
+  lengths = malloc(count * sizeof(PCRE2_SIZE));
+  results = malloc(2 * count * sizeof(PCRE2_SIZE));
+  returns = malloc(count * sizeof(int));
+  if (subjects == NULL || lengths == NULL || results == NULL ||
+      returns == NULL)
+    {
+    fprintf(outfile, "** Failed to get memory for a pool run of %u\n", count);
+    free(subjects);
+    free(lengths);
+    free(results);
+    free(returns);
+    return PR_ABEND;
+    }
+
+  for (i = 0; i < count; i++)
+    {
+    PCRE2_SIZE start = (PCRE2_SIZE)i * size;
+    lengths[i] = arg_ulen - start;
+    if (lengths[i] > size) lengths[i] = size;
+    subjects[i] = pp + start * code_unit_size;
+    returns[i] = 0;
+    }
+
+  PCRE2_MATCH_POOL_CREATE(pool, compiled_code, dat_datctl.pool[0],
+    (PCRE2_SIZE)jit_stack_size * 1024, NULL);
+  if (pool == NULL)
+    {
+    fprintf(outfile, "** Failed to create a match pool\n");
+    rc = 0;
+    }
+  else
+    {
+    PCRE2_MATCH_POOL_RUN(rc, pool, subjects, lengths, count, options, results,
+      use_callback? pool_callback : NULL, returns, use_dat_context);
+    PCRE2_MATCH_POOL_FREE(pool);
+
+    for (i = 0; i < count; i++)
+      {
+      PCRE2_SIZE start = results[2*i];
+      PCRE2_SIZE end = results[2*i+1];
+      fprintf(outfile, "%2u: ", i);
+      PCHARSV(subjects[i], 0, lengths[i], utf, outfile);
+      if (returns[i] < 0 && returns[i] != PCRE2_ERROR_NOMATCH)
+        fprintf(outfile, " - error %d\n", returns[i]);
+      else if (start == PCRE2_UNSET) fprintf(outfile, " - no match\n");
+      else
+        {
+        fprintf(outfile, " - match at %lu: ", (unsigned long int)start);
+        if (start <= end && end <= lengths[i])
+          {
+          PCHARSV(subjects[i], start, end - start, utf, outfile);
+          }
+        fprintf(outfile, "\n");
+        }
+      }
+
+    if (rc < 0)
+      {
+      fprintf(outfile, "Failed: error %d: ", rc);
+      if (!print_error_message(rc, "", "\n")) return PR_ABEND;
+      }
+    else fprintf(outfile, "Matched: %d\n", rc);
+    }
+
+  free(subjects);
+  free(lengths);
+  free(results);
+  free(returns);
+  return PR_OK;
+  }
+
+/* For a segmented subject, split the subject into pieces of the given size,
+which are then passed to pcre2_[dfa_]match_segments() instead of the subject.
+The match data does not then refer to the subject, so the functions that
+extract substrings cannot be tested. */
+
+if (dat_datctl.segments != 0)
+  {
+  uint32_t i;
+
+  if (dat_datctl.stream != 0 || dat_datctl.replacement[0] != 0 ||
+      dat_datctl.copy_numbers[0] >= 0 || dat_datctl.copy_names[0] != 0 ||
+      dat_datctl.get_numbers[0] >= 0 || dat_datctl.get_names[0] != 0 ||
+      (dat_datctl.control & (CTL_FINDLIMITS|CTL_GETALL|CTL_ZERO_TERMINATE))
+        != 0 || timeitm > 0)
+    {
+    fprintf(outfile, "** Segments are not supported with copy, find_limits, "
+      "get, getall, replace, stream,\n** timing, or zero_terminate\n");
+    return PR_OK;
+    }
+
+  segment_count = (uint32_t)((arg_ulen + dat_datctl.segments - 1)/
+    dat_datctl.segments);
+  if (segment_count > segment_list_size)
+    {
+    free(segment_list);
+    segment_list_size = segment_count;
+
+    /* The segment structures have the same layout in all widths. */
+
+    segment_list = malloc(segment_list_size * sizeof(pcre2_segment_8));
+    if (segment_list == NULL)
+      {
+      fprintf(outfile, "** Failed to get memory for %u segments\n",
+        segment_list_size);
+      segment_list_size = 0;
+      return PR_ABEND;
+      }
+    }
+
+  for (i = 0; i < segment_count; i++)
+    {
+    PCRE2_SIZE start = (PCRE2_SIZE)i * dat_datctl.segments;
+    PCRE2_SIZE length = arg_ulen - start;
+    if (length > dat_datctl.segments) length = dat_datctl.segments;
+    PCRE2_SET_SEGMENT(segment_list, i, pp + start * code_unit_size, length);
+    }
+  }
+
+/* For a stream, feed the subject in chunks of the given size, showing each
+match as soon as the stream reports it. The offsets are relative to the whole
+subject, so the matched strings are shown from it. No other processing is
+done. */
+
+if (dat_datctl.stream != 0)
+  {
+  int rc = PCRE2_ERROR_NOMATCH;
+  BOOL matched = FALSE;
+  uint32_t i;
+  PCRE2_SIZE fed = 0;
+  void *stream;
+
+  PCRE2_STREAM_CREATE(stream, compiled_code, dat_datctl.options |
+    (((dat_datctl.control & CTL_DFA) != 0)? PCRE2_STREAM_DFA : 0), NULL);
+  if (stream == NULL)
+    {
+    fprintf(outfile, "** Failed to create a stream: unsupported options or pattern\n");
+    return PR_OK;
+    }
+
+  for (;;)
+    {
+    PCRE2_SIZE chunk = 0;
+    uint32_t foptions = 0;
+
+    /* After "no match", more data is needed; after a match, call again with
+    no data to get the next one. */
+
+    if (rc == PCRE2_ERROR_NOMATCH)
+      {
+      if (fed > arg_ulen) break;
+      chunk = arg_ulen - fed;
+      if (chunk > dat_datctl.stream) chunk = dat_datctl.stream;
+        else foptions = PCRE2_STREAM_END;
+      }
+
+    PCRE2_STREAM_FEED(rc, stream, pp + fed * code_unit_size, chunk, foptions,
+      match_data, use_dat_context);
+    fed += chunk;
+    if (foptions != 0) fed++;  /* Mark the end as fed */
+
+    if (rc == PCRE2_ERROR_NOMATCH) continue;
+    if (rc < 0)
+      {
+      fprintf(outfile, "Failed: error %d: ", rc);
+      if (!print_error_message(rc, "", "\n")) return PR_ABEND;
+      break;
+      }
+
+    matched = TRUE;
+    if (rc == 0) rc = (int)oveccount;
+    for (i = 0; i < 2*(uint32_t)rc; i += 2)
+      {
+      PCRE2_SIZE start = ovector[i];
+      PCRE2_SIZE end = ovector[i+1];
+      fprintf(outfile, "%2d: ", i/2);
+      if (start == PCRE2_UNSET && end == PCRE2_UNSET)
+        fprintf(outfile, "<unset>");
+      else if (start > end || end > arg_ulen)
+        fprintf(outfile, "ERROR: bad value(s) for offset(s): 0x%lx 0x%lx",
+          (unsigned long int)start, (unsigned long int)end);
+      else PCHARSV(pp, start, end - start, utf, outfile);
+      fprintf(outfile, "\n");
+      }
+    }
+
+  if (!matched && rc == PCRE2_ERROR_NOMATCH) fprintf(outfile, "No match\n");
+  PCRE2_STREAM_FREE(stream);
+  return PR_OK;
+  }
 
 /* Replacement processing is ignored for DFA matching. */
 
@@ -7604,10 +8945,14 @@ for (gmatched = 0;; gmatched++)
     }
 
   /* Otherwise just run a single match, setting up a callout if required (the
-  default). There is a copy of the pattern in pbuffer8 for use by callouts. */
+  default). There is a copy of the pattern in pbuffer8 for use by callouts. A
+  match that is suspended because of a step limit is resumed until it
+  finishes, and the number of suspensions is shown. */
 
   else
     {
+    int suspensions = 0;
+
     if ((dat_datctl.control & CTL_CALLOUT_NONE) == 0)
       {
       PCRE2_SET_CALLOUT(dat_context, callout_function,
@@ -7629,9 +8974,26 @@ for (gmatched = 0;; gmatched++)
         dfa_workspace = (int *)malloc(DFA_WS_DIMENSION*sizeof(int));
       if (dfa_matched++ == 0)
         dfa_workspace[0] = -1;  /* To catch bad restart */
-      PCRE2_DFA_MATCH(capcount, compiled_code, pp, arg_ulen,
-        dat_datctl.offset, dat_datctl.options | g_notempty, match_data,
-        use_dat_context, dfa_workspace, DFA_WS_DIMENSION);
+      if (dat_datctl.segments != 0)
+        PCRE2_DFA_MATCH_SEGMENTS(capcount, compiled_code, segment_list,
+          segment_count, dat_datctl.offset, dat_datctl.options | g_notempty,
+          match_data, use_dat_context, dfa_workspace, DFA_WS_DIMENSION);
+      else
+        {
+        PCRE2_DFA_MATCH(capcount, compiled_code, pp, arg_ulen,
+          dat_datctl.offset, dat_datctl.options | g_notempty, match_data,
+          use_dat_context, dfa_workspace, DFA_WS_DIMENSION);
+        while (capcount == PCRE2_ERROR_SUSPENDED)
+          {
+          suspensions++;
+          PCRE2_DFA_MATCH(capcount, compiled_code, pp, arg_ulen,
+            dat_datctl.offset, dat_datctl.options | g_notempty | PCRE2_RESUME,
+            match_data, use_dat_context, dfa_workspace, DFA_WS_DIMENSION);
+          }
+        }
+      if (suspensions > 0)
+        fprintf(outfile, "Suspended %d time%s\n", suspensions,
+          (suspensions == 1)? "" : "s");
       if (capcount == 0)
         {
         fprintf(outfile, "Matched, but offsets vector is too small to show all matches\n");
@@ -7640,12 +9002,28 @@ for (gmatched = 0;; gmatched++)
       }
     else
       {
-      if ((pat_patctl.control & CTL_JITFAST) != 0)
+      if (dat_datctl.segments != 0)
+        PCRE2_MATCH_SEGMENTS(capcount, compiled_code, segment_list,
+          segment_count, dat_datctl.offset, dat_datctl.options | g_notempty,
+          match_data, use_dat_context);
+      else if ((pat_patctl.control & CTL_JITFAST) != 0)
         PCRE2_JIT_MATCH(capcount, compiled_code, pp, arg_ulen, dat_datctl.offset,
           dat_datctl.options | g_notempty, match_data, use_dat_context);
       else
+        {
         PCRE2_MATCH(capcount, compiled_code, pp, arg_ulen, dat_datctl.offset,
           dat_datctl.options | g_notempty, match_data, use_dat_context);
+        while (capcount == PCRE2_ERROR_SUSPENDED)
+          {
+          suspensions++;
+          PCRE2_MATCH(capcount, compiled_code, pp, arg_ulen,
+            dat_datctl.offset, dat_datctl.options | g_notempty | PCRE2_RESUME,
+            match_data, use_dat_context);
+          }
+        }
+      if (suspensions > 0)
+        fprintf(outfile, "Suspended %d time%s\n", suspensions,
+          (suspensions == 1)? "" : "s");
       if (capcount == 0)
         {
         fprintf(outfile, "Matched, but too many substrings\n");
@@ -7654,6 +9032,69 @@ for (gmatched = 0;; gmatched++)
       }
     }
 
+  /* Show the size of the backtracking frames vector that pcre2_match() has
+  left in the match data block, if requested. */
+
+  if ((dat_datctl.control2 & CTL2_HEAPFRAMES_SIZE) != 0 &&
+      (dat_datctl.control & CTL_DFA) == 0)
+    {
+    PCRE2_SIZE heapframes_size;
+    PCRE2_GET_MATCH_DATA_HEAPFRAMES_SIZE(heapframes_size, match_data);
+    fprintf(outfile, "Heapframes size in match_data: %" SIZ_FORM "\n",
+      heapframes_size);
+    }
+
+  /* Show the statistics of the match, if requested. The size of the frames
+  is not shown because it depends on the code unit width. JIT matching records
+  only the engine, so its counts are shown as "n/a" rather than as zeros. */
+
+  if ((dat_datctl.control2 & CTL2_STATISTICS) != 0)
+    {
+    const statistics_block *stats;
+    PCRE2_GET_MATCH_STATISTICS(stats, match_data);
+    if (stats->engine == PCRE2_ENGINE_JIT)
+      {
+      fprintf(outfile, "Statistics: JIT engine, n/a calls, n/a backtracks, "
+        "n/a peak frames\n");
+      fprintf(outfile, "Start positions: n/a tried, skipped n/a by first code "
+        "unit, n/a by start bitmap, n/a by required code unit\n");
+      }
+    else
+      {
+      fprintf(outfile, "Statistics: %s engine, %" SIZ_FORM " calls, %" SIZ_FORM
+        " backtracks, %" SIZ_FORM " peak frames\n",
+        (stats->engine == PCRE2_ENGINE_ONEPASS)? "one-pass" :
+        (stats->engine == PCRE2_ENGINE_BITPARALLEL)? "bit-parallel" :
+        (stats->engine == PCRE2_ENGINE_MEMOIZE)? "memoizing" :
+        (stats->engine == PCRE2_ENGINE_DFA)? "DFA" : "interpreter",
+        stats->match_calls, stats->backtracks, stats->peak_frames);
+      fprintf(outfile, "Start positions: %" SIZ_FORM " tried, skipped %"
+        SIZ_FORM " by first code unit, %" SIZ_FORM " by start bitmap, %"
+        SIZ_FORM " by required code unit\n", stats->start_positions,
+        stats->skipped_first_cu, stats->skipped_start_bits,
+        stats->skipped_req_cu);
+      }
+    }
+
+  /* Show the opcode profile of the match, if requested, as counts beside the
+  compiled code. Offsets and lengths are shown only if the pattern has
+  fullbincode. */
+
+  if ((dat_datctl.control2 & CTL2_PROFILE) != 0)
+    {
+    PCRE2_SIZE profile_length;
+    const PCRE2_SIZE *profile;
+    PCRE2_GET_MATCH_PROFILE(profile, match_data, &profile_length);
+    if (profile == NULL)
+      fprintf(outfile, "No profile available\n");
+    else
+      {
+      fprintf(outfile, "Profile:\n"
+        "------------------------------------------------------------------\n");
+      PCRE2_PRINTINT((pat_patctl.control & CTL_FULLBINCODE) != 0, profile);
+      }
+    }
+
   /* The result of the match is now in capcount. First handle a successful
   match. If pp was forced to be NULL (to test NULL handling) it will have been
   treated as an empty string if the length was zero. So re-create that for
@@ -8241,6 +9682,7 @@ printf("     newline        newline type [CR, LF, CRLF, ANYCRLF, ANY, NUL]\n");
 printf("     pcre2-8        8 bit library support enabled [0, 1]\n");
 printf("     pcre2-16       16 bit library support enabled [0, 1]\n");
 printf("     pcre2-32       32 bit library support enabled [0, 1]\n");
+printf("     threads        thread support for parallel matching [0, 1]\n");
 printf("     unicode        Unicode and UTF support enabled [0, 1]\n");
 printf("  -d            set default pattern modifier 'debug'\n");
 printf("  -dfa          set default subject modifier 'dfa'\n");
@@ -8402,6 +9844,12 @@ else
   printf("  No just-in-time compiler support\n");
   }
 
+#ifdef SUPPORT_THREADS
+printf("  Thread support for parallel matching and match pools\n");
+#else
+printf("  No thread support\n");
+#endif
+
 (void)PCRE2_CONFIG(PCRE2_CONFIG_NEWLINE, &optval);
 print_newline_config(optval, FALSE);
 (void)PCRE2_CONFIG(PCRE2_CONFIG_BSR, &optval);
@@ -9167,7 +10615,8 @@ max_oveccount = DEFAULT_OVECCOUNT;
   (void)G(pcre2_set_max_pattern_length_,BITS)(G(pat_context,BITS), 0); \
   (void)G(pcre2_set_offset_limit_,BITS)(G(dat_context,BITS), 0); \
   (void)G(pcre2_set_recursion_memory_management_,BITS)(G(dat_context,BITS), my_malloc, my_free, NULL); \
-  (void)G(pcre2_get_match_data_size_,BITS)(G(match_data,BITS))
+  (void)G(pcre2_get_match_data_size_,BITS)(G(match_data,BITS)); \
+  (void)G(pcre2_set_match_data_heapframes_limit_,BITS)(G(match_data,BITS), UINT32_MAX)
 
 
 /* Call the appropriate functions for the current mode, and exercise some
@@ -9300,6 +10749,11 @@ while (notdone)
         SUB1(pcre2_code_free, compiled_code);
         SET(compiled_code, NULL);
         }
+      if (pattern_set != NULL)
+        {
+        PCRE2_PATTERN_SET_FREE(pattern_set);
+        pattern_set = NULL;
+        }
       skipping = FALSE;
       setlocale(LC_CTYPE, "C");
       }
@@ -9389,10 +10843,15 @@ free(buffer);
 free(dbuffer);
 free(pbuffer8);
 free(dfa_workspace);
+free(segment_list);
 free((void *)locale_tables);
 free(tables3);
 PCRE2_MATCH_DATA_FREE(match_data);
 SUB1(pcre2_code_free, compiled_code);
+if (pattern_set != NULL)
+  {
+  PCRE2_PATTERN_SET_FREE(pattern_set);
+  }
 
 while(patstacknext-- > 0)
   {
@@ -293,6 +293,7 @@ static const sljit_u8 freg_lmap[SLJIT_NUMBER_OF_FLOAT_REGISTERS + 1] = {
 static sljit_s32 cpu_has_sse2 = -1;
 #endif
 static sljit_s32 cpu_has_cmov = -1;
+static sljit_s32 cpu_has_avx2 = -1;
 
 #ifdef _WIN32_WCE
 #include <cmnintrin.h>
@@ -374,6 +375,96 @@ static void get_cpu_features(void)
 	cpu_has_cmov = (features >> 15) & 0x1;
 }
 
+/* Executes the cpuid instruction with leaf info[0] and subleaf info[2],
+   and stores eax, ebx, ecx and edx into info[0..3]. */
+static void execute_cpu_id(sljit_u32 info[4])
+{
+#if defined(_MSC_VER) && _MSC_VER >= 1600
+
+	int CPUInfo[4];
+	__cpuidex(CPUInfo, (int)info[0], (int)info[2]);
+	info[0] = (sljit_u32)CPUInfo[0];
+	info[1] = (sljit_u32)CPUInfo[1];
+	info[2] = (sljit_u32)CPUInfo[2];
+	info[3] = (sljit_u32)CPUInfo[3];
+
+#elif defined(__GNUC__) || defined(__INTEL_COMPILER) || defined(__SUNPRO_C)
+
+	/* AT&T syntax. */
+	__asm__ (
+#if (defined SLJIT_CONFIG_X86_32 && SLJIT_CONFIG_X86_32)
+		/* Ebx may be the PIC register on x86-32. */
+		"movl %%ebx, %%esi\n"
+		"cpuid\n"
+		"xchgl %%ebx, %%esi\n"
+		: "+a" (info[0]), "=S" (info[1]), "+c" (info[2]), "=d" (info[3])
+#else
+		"cpuid\n"
+		: "+a" (info[0]), "=b" (info[1]), "+c" (info[2]), "=d" (info[3])
+#endif
+	);
+
+#else
+
+	/* Not supported: report no features. */
+	info[0] = info[1] = info[2] = info[3] = 0;
+
+#endif
+}
+
+/* Returns with the low 32 bits of the XCR0 register. Must only be
+   called when cpuid reports that the OSXSAVE feature is enabled. */
+static sljit_u32 execute_get_xcr0(void)
+{
+#if defined(_MSC_VER) && _MSC_VER >= 1600
+
+	return (sljit_u32)_xgetbv(0);
+
+#elif defined(__GNUC__) || defined(__INTEL_COMPILER) || defined(__SUNPRO_C)
+
+	sljit_u32 eax, edx;
+
+	/* The xgetbv instruction, which older assemblers do not know. */
+	__asm__ (
+		".byte 0x0f, 0x01, 0xd0\n"
+		: "=a" (eax), "=d" (edx)
+		: "c" (0)
+	);
+	return eax;
+
+#else
+
+	return 0;
+
+#endif
+}
+
+static void get_avx2_support(void)
+{
+	sljit_u32 info[4];
+
+	cpu_has_avx2 = 0;
+
+	info[0] = 0;
+	info[2] = 0;
+	execute_cpu_id(info);
+	if (info[0] < 7)
+		return;
+
+	/* The AVX (bit 28) and OSXSAVE (bit 27) flags must be set in ecx, and
+	   the operating system must save both the xmm and ymm registers. */
+	info[0] = 1;
+	info[2] = 0;
+	execute_cpu_id(info);
+	if ((info[2] & 0x18000000) != 0x18000000 || (execute_get_xcr0() & 0x6) != 0x6)
+		return;
+
+	info[0] = 7;
+	info[2] = 0;
+	execute_cpu_id(info);
+	cpu_has_avx2 = (info[1] >> 5) & 0x1;
+}
+
 static sljit_u8 get_jump_code(sljit_uw type)
 {
 	switch (type) {
@@ -674,6 +765,11 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_has_cpu_feature(sljit_s32 feature_type)
 		return 1;
 #endif
 
+	case SLJIT_HAS_AVX2:
+		if (cpu_has_avx2 == -1)
+			get_avx2_support();
+		return cpu_has_avx2;
+
 	default:
 		return 0;
 	}